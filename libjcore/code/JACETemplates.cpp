@@ -23,12 +23,19 @@ const JSize JMessageProtocolT::kDOSSeparatorLength    = 2;
 const JCharacter* JMessageProtocolT::kStdDisconnectStr = "\0";
 const JSize JMessageProtocolT::kStdDisconnectLength    = 1;
 
+const JUInt32 JMessageProtocolT::kBinaryDisconnectLength = 0xFFFFFFFF;
+
 // JBroadcaster message types
 
 const JCharacter* JMessageProtocolT::kMessageReady = "MessageReady::JMessageProtocolT";
 const JCharacter* JMessageProtocolT::kReceivedDisconnect =
 	"ReceivedDisconnect::JMessageProtocolT";
 
+const JCharacter* JNetworkProtocolBaseT::kHighWatermark =
+	"HighWatermark::JNetworkProtocolBaseT";
+const JCharacter* JNetworkProtocolBaseT::kLowWatermark =
+	"LowWatermark::JNetworkProtocolBaseT";
+
 const JCharacter* JAsynchDataReceiverT::kDataReady = "DataReady::JAsynchDataReceiverT";
 
 #include <ace/SOCK_Stream.h>
@@ -61,3 +68,7 @@ template class ACE_Thru_Task<ACE_MT_SYNCH>;
 #define JTemplateType iovec
 #include <JArray.tmpls>
 #undef JTemplateType
+
+#define JTemplateType JNetworkProtocolBaseT::Block
+#include <JArray.tmpls>
+#undef JTemplateType
@@ -14,6 +14,20 @@
 	To listen for the death of a sender, override ReceiveGoingAway().
 	*** Be sure to read the warnings associated with using this function!
 
+	To make many changes without flooding the recipients, create a StBatch
+	on the stack.  Until it goes out of scope, each message that can be
+	copied is held back, and the following messages are merged into it
+	when possible, e.g., JOrderedSetT::ElementsInserted for adjacent
+	elements.  Messages are still delivered in order, and a message that
+	cannot be merged is delivered right after the one that is held back.
+	Objects that start listening during a batch may receive a message
+	about an earlier change.  The StBatch must not outlive the sender.
+
+	Receive() functions that handle many message types can use a
+	MessageTable instead of calling Is() for each type.  The table maps
+	the type to a value that can be used in a switch statement, so the
+	cost does not depend on the number of types.
+
 	Because the overhead is so low if there is nobody to broadcast to or
 	nobody to listen to, there is no point in making a separate JListener class.
 
@@ -29,24 +43,105 @@
 #include <JCoreStdInc.h>
 #include <JBroadcaster.h>
 #include <JPtrArray.h>
-#include <JTaskIterator.h>
 #include <jAssert.h>
 
-// A derived class is needed because of cross-dependencies between JBroadcaster
-// and JCollection.  Typedefs cannot be forward declared in header files, and
-// JBroadcasterList must be forward declared.
+/******************************************************************************
+ JBroadcaster::BroadcastLink
+
+	One connection between a sender and a recipient.  It is in two doubly
+	linked lists at the same time:  the sender's list of recipients and
+	the recipient's list of senders.  This way, either object can remove
+	it without searching.
+
+ ******************************************************************************/
+
+class JBroadcaster::BroadcastLink
+{
+public:
+
+	BroadcastLink
+		(
+		JBroadcaster* s,
+		JBroadcaster* r
+		)
+		:
+		sender(s),
+		recipient(r),
+		prevRecipient(NULL),
+		nextRecipient(NULL),
+		prevSender(NULL),
+		nextSender(NULL)
+	{ };
+
+	JBroadcaster*	sender;
+	JBroadcaster*	recipient;
+	BroadcastLink*	prevRecipient;		// sender's list
+	BroadcastLink*	nextRecipient;
+	BroadcastLink*	prevSender;			// recipient's list
+	BroadcastLink*	nextSender;
+};
+
+/******************************************************************************
+ JBroadcaster::BroadcastCursor
+
+	Position of one active broadcast.  Broadcasts can be nested, so the
+	sender keeps a stack of them.  Each one lives on the stack of
+	BroadcastPrivate(), so broadcasting never allocates memory.
+
+	When a link is removed, every cursor that points to it is moved to the
+	next one.  New recipients are prepended, so they only receive the next
+	message.  If the sender is deleted, the cursors are told to stop.
 
-class JBroadcasterList : public JPtrArray<JBroadcaster>
+ ******************************************************************************/
+
+class JBroadcaster::BroadcastCursor
 {
 public:
 
-	JBroadcasterList()
+	BroadcastCursor
+		(
+		JBroadcaster* b
+		)
 		:
-		JPtrArray<JBroadcaster>(JPtrArrayT::kForgetAll)
-		{ };
+		next(b->itsFirstRecipient),
+		senderDeleted(kJFalse),
+		outer(b->itsCursor)
+	{
+		b->itsCursor = this;
+	};
+
+	BroadcastLink*		next;
+	JBoolean			senderDeleted;
+	BroadcastCursor*	outer;
 };
 
-typedef JTaskIterator<JBroadcaster>	JBroadcasterIterator;
+/******************************************************************************
+ JBroadcaster::MessageBatch
+
+	State of the active StBatch objects.  It only exists while a batch is
+	open, so it costs nothing the rest of the time.  StBatch does not
+	create it if nobody is listening.
+
+ ******************************************************************************/
+
+class JBroadcaster::MessageBatch
+{
+public:
+
+	MessageBatch()
+		:
+		depth(0),
+		pending(NULL)
+	{ };
+
+	~MessageBatch()
+	{
+		delete pending;
+	};
+
+	JSize		depth;		// nested StBatch objects
+	Message*	pending;	// held back until the batch ends
+};
 
 /******************************************************************************
  Constructor
@@ -55,8 +150,13 @@ typedef JTaskIterator<JBroadcaster>	JBroadcasterIterator;
 
 JBroadcaster::JBroadcaster()
 {
-	itsSenders    = NULL;
-	itsRecipients = NULL;
+	itsFirstSender    = NULL;
+	itsFirstRecipient = NULL;
+	itsLastRecipient  = NULL;
+	itsSenderCount    = 0;
+	itsRecipientCount = 0;
+	itsCursor         = NULL;
+	itsBatch          = NULL;
 	itsIsBroadcasting = kJTrue;
 	itsIsListening = kJTrue;
 }
@@ -75,8 +175,13 @@ JBroadcaster::JBroadcaster
 	const JBroadcaster& source
 	)
 {
-	itsSenders    = NULL;
-	itsRecipients = NULL;
+	itsFirstSender    = NULL;
+	itsFirstRecipient = NULL;
+	itsLastRecipient  = NULL;
+	itsSenderCount    = 0;
+	itsRecipientCount = 0;
+	itsCursor         = NULL;
+	itsBatch          = NULL;
 	itsIsBroadcasting = kJTrue;
 	itsIsListening = kJTrue;
 }
@@ -84,36 +189,32 @@ JBroadcaster::JBroadcaster
 /******************************************************************************
  Destructor
 
-	Close all connections.
+	Close all connections.  Each one is removed from the other object's
+	list in constant time, so this is linear in the number of connections.
 
  ******************************************************************************/
 
 JBroadcaster::~JBroadcaster()
 {
-	if (itsRecipients != NULL)
+	for (BroadcastCursor* c = itsCursor; c != NULL; c = c->outer)
 		{
-		while (itsRecipients != NULL && !itsRecipients->IsEmpty())
-			{
-			JBroadcaster* aRecipient = itsRecipients->LastElement();
-			itsRecipients->RemoveElement(itsRecipients->GetElementCount());
-			aRecipient->RemoveSender(this);
-			aRecipient->ReceiveGoingAway(this);		// do this last in case they die
-			}
-
-		delete itsRecipients;
+		c->next          = NULL;
+		c->senderDeleted = kJTrue;
 		}
 
-	if (itsSenders != NULL)
+	while (itsLastRecipient != NULL)
 		{
-		const JSize count = itsSenders->GetElementCount();
-		for (JIndex i=1; i<=count; i++)
-			{
-			JBroadcaster* aSender = itsSenders->NthElement(i);
-			aSender->RemoveRecipient(this);
-			}
+		JBroadcaster* aRecipient = itsLastRecipient->recipient;
+		Unlink(itsLastRecipient);
+		aRecipient->ReceiveGoingAway(this);		// do this last in case they die
+		}
 
-		delete itsSenders;
+	while (itsFirstSender != NULL)
+		{
+		Unlink(itsFirstSender);
 		}
+
+	delete itsBatch;		// nobody can receive a message from a dead sender
 }
 
 /******************************************************************************
@@ -143,8 +244,8 @@ JBroadcaster::operator=
 /******************************************************************************
  ListenTo (protected)
 
-	Open a connection by adding the given object to this object's sender list,
-	and adding this object to the given object's recipient list.
+	Open a connection by adding a link to this object's sender list and
+	to the given object's recipient list.
 
 	If the connection already exists, then we do nothing.
 
@@ -159,19 +260,40 @@ JBroadcaster::ListenTo
 	assert( csender != NULL );
 
 	JBroadcaster* sender = const_cast<JBroadcaster*>(csender);
-	if (itsSenders == NULL || !itsSenders->Includes(sender))
+	if (FindLink(sender) != NULL)
+		{
+		return;
+		}
+
+	BroadcastLink* link = new BroadcastLink(sender, this);
+	assert( link != NULL );
+
+	link->nextSender = itsFirstSender;
+	if (itsFirstSender != NULL)
+		{
+		itsFirstSender->prevSender = link;
+		}
+	itsFirstSender = link;
+	itsSenderCount++;
+
+	link->nextRecipient = sender->itsFirstRecipient;	// so it gets the -next- message
+	if (sender->itsFirstRecipient != NULL)
+		{
+		sender->itsFirstRecipient->prevRecipient = link;
+		}
+	else
 		{
-		AddSender(sender);
-		sender->AddRecipient(this);
+		sender->itsLastRecipient = link;
 		}
+	sender->itsFirstRecipient = link;
+	sender->itsRecipientCount++;
 }
 
 /******************************************************************************
  StopListening (protected)
 
-	Close a connection by removing the given object from this object's
-	sender list, and removing this object from the given objects's
-	recipient list.
+	Close a connection by removing the link from this object's sender
+	list and from the given object's recipient list.
 
  ******************************************************************************/
 
@@ -181,11 +303,10 @@ JBroadcaster::StopListening
 	const JBroadcaster* csender
 	)
 {
-	JBroadcaster* sender = const_cast<JBroadcaster*>(csender);
-	if (itsSenders != NULL && itsSenders->Includes(sender))
+	BroadcastLink* link = FindLink(csender);
+	if (link != NULL)
 		{
-		RemoveSender(sender);
-		sender->RemoveRecipient(this);
+		Unlink(link);
 		}
 }
 
@@ -198,135 +319,131 @@ JBoolean
 JBroadcaster::HasSenders()
 	const
 {
-	return JNegate(itsSenders == NULL || itsSenders->IsEmpty());
+	return JI2B( itsFirstSender != NULL );
 }
 
 JSize
 JBroadcaster::GetSenderCount()
 	const
 {
-	if (itsSenders != NULL)
-		{
-		return itsSenders->GetElementCount();
-		}
-	else
-		{
-		return 0;
-		}
+	return itsSenderCount;
 }
 
 JBoolean
 JBroadcaster::HasRecipients()
 	const
 {
-	return JNegate(itsRecipients == NULL || itsRecipients->IsEmpty());
+	return JI2B( itsFirstRecipient != NULL );
 }
 
 JSize
 JBroadcaster::GetRecipientCount()
 	const
 {
-	if (itsRecipients != NULL)
-		{
-		return itsRecipients->GetElementCount();
-		}
-	else
-		{
-		return 0;
-		}
+	return itsRecipientCount;
 }
 
 /******************************************************************************
- AddRecipient (private)
+ FindLink (private)
 
-	Add the given object to the recipient list.  Called by ListenTo().
+	Returns the link from the given sender to us, or NULL.  We search the
+	shorter of the two lists.  Usually, this is our own list of senders,
+	which is short even when the sender has thousands of recipients.
 
  ******************************************************************************/
 
-void
-JBroadcaster::AddRecipient
+JBroadcaster::BroadcastLink*
+JBroadcaster::FindLink
 	(
-	JBroadcaster* recipient
+	const JBroadcaster* sender
 	)
+	const
 {
-	if (itsRecipients == NULL)
+	if (itsSenderCount <= sender->itsRecipientCount)
 		{
-		itsRecipients = new JBroadcasterList;
-		assert( itsRecipients != NULL );
+		for (BroadcastLink* link = itsFirstSender; link != NULL; link = link->nextSender)
+			{
+			if (link->sender == sender)
+				{
+				return link;
+				}
+			}
+		}
+	else
+		{
+		for (BroadcastLink* link = sender->itsFirstRecipient; link != NULL; link = link->nextRecipient)
+			{
+			if (link->recipient == this)
+				{
+				return link;
+				}
+			}
 		}
 
-	itsRecipients->Prepend(recipient);	// so it gets the -next- message
+	return NULL;
 }
 
 /******************************************************************************
- RemoveRecipient (private)
+ Unlink (static private)
 
-	Remove the given object from the recipient list. The object will cease
-	receiving messages.  Called by StopListening().
+	Removes the link from both lists and deletes it.  Active broadcasts
+	that were about to visit it skip to the next recipient.
 
  ******************************************************************************/
 
 void
-JBroadcaster::RemoveRecipient
+JBroadcaster::Unlink
 	(
-	JBroadcaster* recipient
+	BroadcastLink* link
 	)
 {
-	if (itsRecipients != NULL)
+	JBroadcaster* sender = link->sender;
+	for (BroadcastCursor* c = sender->itsCursor; c != NULL; c = c->outer)
 		{
-		itsRecipients->Remove(recipient);
-		if (itsRecipients->IsEmpty())
+		if (c->next == link)
 			{
-			delete itsRecipients;
-			itsRecipients = NULL;
+			c->next = link->nextRecipient;
 			}
 		}
-}
 
-/******************************************************************************
- AddSender (private)
-
-	Add the given object to the sender list.  Called by ListenTo().
-
- ******************************************************************************/
-
-void
-JBroadcaster::AddSender
-	(
-	JBroadcaster* sender
-	)
-{
-	if (itsSenders == NULL)
+	if (link->prevRecipient != NULL)
 		{
-		itsSenders = new JBroadcasterList;
-		assert( itsSenders != NULL );
+		link->prevRecipient->nextRecipient = link->nextRecipient;
+		}
+	else
+		{
+		sender->itsFirstRecipient = link->nextRecipient;
 		}
 
-	itsSenders->Prepend(sender);
-}
-
-/******************************************************************************
- RemoveSender (private)
+	if (link->nextRecipient != NULL)
+		{
+		link->nextRecipient->prevRecipient = link->prevRecipient;
+		}
+	else
+		{
+		sender->itsLastRecipient = link->prevRecipient;
+		}
 
-	Remove the given object from the sender list.  Called by StopListening().
+	sender->itsRecipientCount--;
 
- ******************************************************************************/
+	JBroadcaster* recipient = link->recipient;
+	if (link->prevSender != NULL)
+		{
+		link->prevSender->nextSender = link->nextSender;
+		}
+	else
+		{
+		recipient->itsFirstSender = link->nextSender;
+		}
 
-void
-JBroadcaster::RemoveSender
-	(
-	JBroadcaster* sender
-	)
-{
-	if (itsSenders != NULL)
+	if (link->nextSender != NULL)
 		{
-		itsSenders->Remove(sender);
-		if (itsSenders->IsEmpty())
-			{
-			delete itsSenders;
-			itsSenders = NULL;
-			}
+		link->nextSender->prevSender = link->prevSender;
 		}
+
+	recipient->itsSenderCount--;
+
+	delete link;
 }
 
 /******************************************************************************
@@ -365,16 +482,131 @@ JBroadcaster::BroadcastPrivate
 	const Message& message
 	)
 {
-	assert( (IsBroadcasting() == kJTrue) && (itsRecipients != NULL) );
+	assert( (IsBroadcasting() == kJTrue) && (itsFirstRecipient != NULL) );
 
-	JBroadcasterIterator	iterator(itsRecipients, kJIteratorStartAtBeginning);
-	JBroadcaster*			recipient;
+	if (itsBatch != NULL)
+		{
+		if (itsBatch->pending != NULL && (itsBatch->pending)->Merge(message))
+			{
+			return;
+			}
+		else if (!FlushBatch())
+			{
+			return;		// we were deleted
+			}
+
+		Message* copy = message.Copy();
+		if (copy != NULL)
+			{
+			itsBatch->pending = copy;
+			return;
+			}
+		}
+
+	Deliver(message);
+}
 
-	while (iterator.Next(&recipient))
+/******************************************************************************
+ Deliver (private)
+
+	Calls Receive() for each recipient.  Returns kJFalse if we were
+	deleted, in which case the caller must not touch any member data.
+
+ ******************************************************************************/
+
+JBoolean
+JBroadcaster::Deliver
+	(
+	const Message& message
+	)
+{
+	BroadcastCursor cursor(this);
+	while (cursor.next != NULL)
 		{
+		JBroadcaster* recipient = cursor.next->recipient;
+		cursor.next             = cursor.next->nextRecipient;
+
 		if (recipient->IsListening() == kJTrue)
 			recipient->Receive(this, message);
 		}
+
+	if (!cursor.senderDeleted)
+		{
+		itsCursor = cursor.outer;
+		return kJTrue;
+		}
+	else
+		{
+		return kJFalse;
+		}
+}
+
+/******************************************************************************
+ BeginBatch (private)
+
+	Called by StBatch.  Batches can be nested.
+
+ ******************************************************************************/
+
+void
+JBroadcaster::BeginBatch()
+{
+	if (itsBatch == NULL)
+		{
+		itsBatch = new MessageBatch;
+		assert( itsBatch != NULL );
+		}
+
+	itsBatch->depth++;
+}
+
+/******************************************************************************
+ EndBatch (private)
+
+	Called by StBatch.  When the outermost batch ends, the message that was
+	held back is delivered.
+
+ ******************************************************************************/
+
+void
+JBroadcaster::EndBatch()
+{
+	assert( itsBatch != NULL && itsBatch->depth > 0 );
+
+	itsBatch->depth--;
+	if (itsBatch->depth == 0 && FlushBatch())
+		{
+		delete itsBatch;
+		itsBatch = NULL;
+		}
+}
+
+/******************************************************************************
+ FlushBatch (private)
+
+	Delivers the message that was held back.  If a recipient broadcasts
+	another message from us, it is held back in turn, so we loop until
+	there is nothing left.  Returns kJFalse if we were deleted.
+
+ ******************************************************************************/
+
+JBoolean
+JBroadcaster::FlushBatch()
+{
+	while (itsBatch->pending != NULL)
+		{
+		Message* message  = itsBatch->pending;
+		itsBatch->pending = NULL;
+
+		const JBoolean alive = Deliver(*message);
+		delete message;
+		if (!alive)
+			{
+			return kJFalse;
+			}
+		}
+
+	return kJTrue;
 }
 
 /******************************************************************************
@@ -430,16 +662,27 @@ JBroadcaster::BroadcastWithFeedbackPrivate
 	Message* message
 	)
 {
-	assert( (IsBroadcasting() == kJTrue) && (itsRecipients != NULL) );
+	assert( (IsBroadcasting() == kJTrue) && (itsFirstRecipient != NULL) );
 
-	JBroadcasterIterator	iterator(itsRecipients, kJIteratorStartAtBeginning);
-	JBroadcaster*			recipient;
+	if (itsBatch != NULL && !FlushBatch())
+		{
+		return;		// we were deleted
+		}
 
-	while (iterator.Next(&recipient))
+	BroadcastCursor cursor(this);
+	while (cursor.next != NULL)
 		{
+		JBroadcaster* recipient = cursor.next->recipient;
+		cursor.next             = cursor.next->nextRecipient;
+
 		if (recipient->IsListening() == kJTrue)
 			recipient->ReceiveWithFeedback(this, message);
 		}
+
+	if (!cursor.senderDeleted)
+		{
+		itsCursor = cursor.outer;
+		}
 }
 
 /******************************************************************************
@@ -503,6 +746,106 @@ JBroadcaster::Message::~Message()
 {
 }
 
+/******************************************************************************
+ Copy (virtual)
+
+	Derived classes can override this to let StBatch hold the message back.
+	The default is to deliver it immediately.
+
+ ******************************************************************************/
+
+JBroadcaster::Message*
+JBroadcaster::Message::Copy()
+	const
+{
+	return NULL;
+}
+
+/******************************************************************************
+ Merge (virtual)
+
+	Called on a held back message with the next one.  If the two can be
+	described by this message alone, update it and return kJTrue.
+
+ ******************************************************************************/
+
+JBoolean
+JBroadcaster::Message::Merge
+	(
+	const Message& next
+	)
+{
+	return kJFalse;
+}
+
+/******************************************************************************
+ JBroadcaster::MessageTable
+
+	Maps message types to values, so Receive() can switch on the result of
+	Lookup().  This is usually a static object in the .cpp file, filled in
+	the first time it is needed.  Like JBroadcaster, it may only be used on
+	the main thread.
+
+ ******************************************************************************/
+
+/******************************************************************************
+ Constructor
+
+ ******************************************************************************/
+
+JBroadcaster::MessageTable::MessageTable()
+	:
+	itsValueList(NULL),
+	itsValueCount(0)
+{
+}
+
+/******************************************************************************
+ Destructor
+
+ ******************************************************************************/
+
+JBroadcaster::MessageTable::~MessageTable()
+{
+	delete [] itsValueList;
+}
+
+/******************************************************************************
+ Add
+
+	value must not be zero, because Lookup() returns zero for types that
+	were not added.
+
+ ******************************************************************************/
+
+void
+JBroadcaster::MessageTable::Add
+	(
+	const JCharacter*	type,
+	const JIndex		value
+	)
+{
+	assert( value != 0 );
+
+	const JIndex id = JRTTIBase::GetTypeID(type);
+	if (id > itsValueCount)
+		{
+		JIndex* newList = new JIndex [ id ];
+		assert( newList != NULL );
+
+		for (JIndex i=0; i<id; i++)
+			{
+			newList[i] = (i < itsValueCount ? itsValueList[i] : 0);
+			}
+
+		delete [] itsValueList;
+		itsValueList  = newList;
+		itsValueCount = id;
+		}
+
+	itsValueList[ id-1 ] = value;
+}
+
 #define JTemplateType JBroadcaster
 #include <JPtrArray.tmpls>
 #undef JTemplateType
@@ -16,8 +16,6 @@
 
 #include <JRTTIBase.h>
 
-class JBroadcasterList;
-
 class JBroadcaster
 {
 public:
@@ -28,6 +26,11 @@ public:
 
 			virtual	~Message();
 
+			// for batching -- see StBatch
+
+			virtual Message*	Copy() const;
+			virtual JBoolean	Merge(const Message& next);
+
 		protected:
 
 			Message(const JCharacter* type)
@@ -49,6 +52,42 @@ public:
 	};
 	friend class StStopListening;
 
+	class StBatch
+	{
+public:
+		StBatch(JBroadcaster* broad)
+			{ mBroadcaster = broad; mActive = broad->HasRecipients(); if (mActive) mBroadcaster->BeginBatch(); }
+		~StBatch()
+			{ if (mActive) mBroadcaster->EndBatch(); }
+	private:
+		JBroadcaster*	mBroadcaster;
+		JBoolean		mActive;	// nobody to batch for if nobody is listening
+	};
+	friend class StBatch;
+
+	class MessageTable
+		{
+		public:
+
+			MessageTable();
+			~MessageTable();
+
+			void	Add(const JCharacter* type, const JIndex value);
+			JIndex	Lookup(const Message& message) const;
+
+		private:
+
+			JIndex*	itsValueList;	// indexed by type ID - 1, 0 if not added
+			JSize	itsValueCount;
+
+		private:
+
+			// not allowed
+
+			MessageTable(const MessageTable& source);
+			const MessageTable& operator=(const MessageTable& source);
+		};
+
 public:
 
 	JBroadcaster();
@@ -86,21 +125,32 @@ protected:
 
 private:
 
-	JBroadcasterList*	itsSenders;			// the objects to which we listen
-	JBroadcasterList*	itsRecipients;		// the objects that listen to us
+	class BroadcastLink;
+	class BroadcastCursor;
+	class MessageBatch;
+
+	BroadcastLink*		itsFirstSender;		// the objects to which we listen
+	BroadcastLink*		itsFirstRecipient;	// the objects that listen to us
+	BroadcastLink*		itsLastRecipient;
+	JSize				itsSenderCount;
+	JSize				itsRecipientCount;
+	BroadcastCursor*	itsCursor;			// active broadcasts, innermost first
+	MessageBatch*		itsBatch;			// NULL unless inside StBatch
 	JBoolean			itsIsBroadcasting;	// actively broadcasting
 	JBoolean			itsIsListening;		// actively listening
 
 private:
 
-	void	AddRecipient(JBroadcaster* aRecipient);
-	void	RemoveRecipient(JBroadcaster* aRecipient);
-
-	void	AddSender(JBroadcaster* aSender);
-	void	RemoveSender(JBroadcaster* aSender);
+	BroadcastLink*	FindLink(const JBroadcaster* sender) const;
+	static void		Unlink(BroadcastLink* link);
 
 	void	BroadcastPrivate(const Message& message);
 	void	BroadcastWithFeedbackPrivate(Message* message);
+
+	JBoolean	Deliver(const Message& message);
+	void		BeginBatch();
+	void		EndBatch();
+	JBoolean	FlushBatch();
 };
 
 inline void JBroadcaster::SetBroadcasting(JBoolean broadcasting)
@@ -131,7 +181,8 @@ inline JBoolean JBroadcaster::IsListening() const
 	message must be derived from JBroadcaster::Message and should contain
 	all the information necessary to process the message.
 
-	We use an iterator because anything could happen while calling Receive().
+	We use a BroadcastCursor because anything could happen while calling
+	Receive().
 
 	By inlining this part of the function, we avoid the overhead of a
 	function call unless somebody is actually listening.
@@ -144,7 +195,7 @@ JBroadcaster::Broadcast
 	const Message& message
 	)
 {
-	if ((IsBroadcasting() == kJTrue) && (itsRecipients != NULL))
+	if ((IsBroadcasting() == kJTrue) && (itsFirstRecipient != NULL))
 		{
 		BroadcastPrivate(message);
 		}
@@ -158,7 +209,7 @@ JBroadcaster::Broadcast
 	send the message as a non-const object and let the receiver who understands
 	the message deal with it.
 
-	We use an iterator because anything could happen while calling
+	We use a BroadcastCursor because anything could happen while calling
 	ReceiveWithFeedback().
 
 	By inlining this part of the function, we avoid the overhead of a
@@ -172,10 +223,28 @@ JBroadcaster::BroadcastWithFeedback
 	Message* message
 	)
 {
-	if ((IsBroadcasting() == kJTrue) && (itsRecipients != NULL))
+	if ((IsBroadcasting() == kJTrue) && (itsFirstRecipient != NULL))
 		{
 		BroadcastWithFeedbackPrivate(message);
 		}
 }
 
+/******************************************************************************
+ MessageTable::Lookup
+
+	Returns the value that was added for the message's type, or 0.
+
+ ******************************************************************************/
+
+inline JIndex
+JBroadcaster::MessageTable::Lookup
+	(
+	const Message& message
+	)
+	const
+{
+	const JIndex id = message.GetTypeID();
+	return (id <= itsValueCount ? itsValueList[ id-1 ] : 0);
+}
+
 #endif
@@ -84,8 +84,6 @@ protected:
 
 	JSize GetIndex() const;
 
-	static JDualHashValue DualHash(const JHashValue hash);
-
 	void Step();
 
 private:
@@ -96,9 +94,13 @@ private:
 	JHashValue     itsHashValue;
 	JSize          itsInitialIndex;
 	JSize          itsIndex;
-	JDualHashValue itsIncrement; // Needed for double hashing
+	unsigned char  itsCtrlValue;	// control byte for itsHashValue
 
 	JSize itsInitialCount;
+
+private:
+
+	JBoolean Advance(const JHashRecordT::CtrlMatch type);
 };
 
 /******************************************************************************
@@ -257,28 +259,11 @@ JConstHashCursor<V>::GetIndex() const
 	return itsIndex;
 }
 
-/******************************************************************************
- DualHash (static protected)
-
-	The secondary hash function which allows double-hashing.
-
- *****************************************************************************/
-
-template <class V>
-inline JDualHashValue
-JConstHashCursor<V>::DualHash
-	(
-	const JHashValue hashValue
-	)
-{
-	return JDualHash(hashValue);
-}
-
 /******************************************************************************
  Step (protected)
 
-	Advances the index by the increment, wrapping to the tablesize.  No safety
-	of any kind.
+	Advances the index by one, wrapping to the tablesize.  No safety of any
+	kind.
 
  *****************************************************************************/
 
@@ -286,7 +271,7 @@ template <class V>
 inline void
 JConstHashCursor<V>::Step()
 {
-	itsIndex = itsTable->HashToIndex(itsIndex+itsIncrement);
+	itsIndex = itsTable->HashToIndex(itsIndex+1);
 }
 
 #endif
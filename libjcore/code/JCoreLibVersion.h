@@ -20,6 +20,135 @@
 
 static const char* kCurrentJCoreLibVersionStr = "2.5.0";
 
+// version 2.6.0:
+//	Created JStaticStringTable to store strings in a binary format that
+//		can be memory mapped and searched without parsing.
+//	JStringManager:
+//		Added kBinaryFormat.  Binary string databases are memory mapped,
+//			and each string is only converted to a JString when it is
+//			first requested.
+//		Added Register() for binary tables generated by compile_jstrings.
+//		*** GetElement() and Contains() also find strings in the binary
+//			tables.  Only the const version of GetElement() is available.
+//		Added WriteBinaryFile().
+//	JImage:
+//		Added virtual function SetColorRow() to set an entire row at once.
+//		ReadGD() decodes by row and caches color conversions for true color
+//			images, so loading large PNG and JPEG files is much faster.
+//	Created JTrace and JTraceZone to record where time is spent and write
+//		it in Chrome's trace format.  Use J_TRACE_ZONE(), which compiles
+//		away unless J_USE_TRACING is set in include/make/jx_constants.
+//	JTextEditor, JTEStyler:
+//		Instrumented layout and styling with trace zones.
+//	Created JWorkerPool and JWorkerTask to run long operations on
+//		background threads and broadcast the results on the main thread.
+//	JMemoryManager:
+//		Added sampling heap profile, controlled by JMM_SAMPLE_INTERVAL and
+//			JMM_SAMPLE_MIN_SIZE.  It is cheap enough to leave on in
+//			production.
+//		Added PrintHeapProfile() and WriteHeapProfile().  The profile can
+//			also be written by sending the signal given by JMM_PROFILE_SIGNAL.
+//	jNew.h:
+//		Replaces the nothrow versions of operator new and delete, too.
+//	JHashTable:
+//		Uses linear probing and an array of control bytes, which are scanned
+//			16 at a time with SSE2.  Removing an element usually leaves an
+//			empty slot instead of a deleted one.
+//		*** JConstHashCursor::DualHash() has been removed.
+//	Added JHashString(), which is much faster than JHash7Bit() and JHash8Bit().
+//	JStringMap:
+//		Uses JHashString().
+//		Copied keys are packed into blocks.  Removing an element can move
+//			the other keys.
+//		Added GetKeyStorageSize().
+//	Created JDirTreeSearch to search a directory tree for several names at
+//		once, using multiple threads.  It can keep an index of the tree to
+//		speed up later searches.
+//	JSearchSubdirs():
+//		Uses JDirTreeSearch.  The tree is searched breadth-first, so the
+//			match closest to startPath is found.
+//	JMessageProtocol:
+//		Received data is kept in one buffer and messages are parsed in place,
+//			so each message is copied only when it is read.
+//		*** MessageReady is constructed from (data, length).  Added GetData()
+//			and GetLength().  PeekMessage() copies the data the first time
+//			it is called.
+//		Added UseBinaryProtocol() to send each message with its length
+//			instead of a separator, so messages can contain any data.
+//		Default buffer size is now 16K.
+//	JNetworkProtocolBase:
+//		Asynch data is queued in a chain of blocks and sent with sendmsg(),
+//			so queueing does not move the pending data.
+//		Flush() empties the queue, so the data is no longer sent twice.
+//		*** Now derives from virtual JBroadcaster.  Broadcasts HighWatermark
+//			and LowWatermark so senders can throttle themselves.  Added
+//			Get/SetWatermarks() and IsAboveHighWatermark().
+//		Added GetPendingByteCount(), GetSendCount(), GetSystemCallCount(),
+//			and ResetSendStatistics().
+//	JExecute():
+//		Uses posix_spawn() instead of fork() when it is available, so
+//			starting a program no longer copies the parent's page tables.
+//		The parent's ends of the pipes are marked close-on-exec.
+//	jProcessUtil:
+//		Added JWillUseSpawn() and JShouldUseSpawn().
+//	JProcess:
+//		CheckForFinishedChild() reaps every child that has finished, not
+//			just one.  The objects are found via a hash table keyed by pid.
+//	JThisProcess:
+//		Added ChildProcessFinished() so event loops can reap children as
+//			soon as SIGCHLD arrives.  It never misses a signal, even when
+//			more than 32 are pending.
+//	*** JOutPipeStream:
+//		Output is buffered.  Flush the stream (e.g., via endl) when the other
+//			end needs to see it, or pass zero for the new bufferSize
+//			argument to the constructor.
+//		Writes that do not fit in the buffer are sent with the buffered
+//			data in a single writev().
+//		Added Get/SetBufferSize(), WillBlock(), ShouldBlock(),
+//			HasPendingOutput(), and FlushPendingOutput() so output to a
+//			non-blocking pipe can be finished by the event loop.
+//	JBroadcaster:
+//		Each connection is stored once, in a list owned by the sender and
+//			a list owned by the recipient, so connecting and disconnecting
+//			no longer search the sender's recipients.  Deleting an object
+//			with many connections takes linear time.
+//		Added StBatch to hold back messages until a series of changes is
+//			finished.  Messages that override the new virtual functions
+//			Message::Copy() and Message::Merge() are combined.
+//	JOrderedSet:
+//		ElementsInserted, ElementsRemoved, and ElementChanged can be merged
+//			by JBroadcaster::StBatch.
+//	JPtrArray:
+//		CopyPointers() and CopyObjects() broadcast a single ElementsInserted
+//			message.
+//	JTableData:
+//		RectChanged can be merged by JBroadcaster::StBatch.
+//	JRTTIBase:
+//		Is() is inline and only calls strcmp() if the first characters match.
+//		Added GetTypeID(), which maps each type string to a small integer.
+//	JBroadcaster:
+//		Added MessageTable, so Receive() can switch on the message type
+//			instead of calling Is() for each type.  JTable uses it.
+//	JString:
+//		*** Strings of up to 15 characters are stored inside the object
+//			instead of on the heap, so JStrings must never be copied with
+//			memcpy().
+//		Added GetView() and JStringView, which refers to characters without
+//			copying them.  Contains(), Locate*Substring(), BeginsWith(),
+//			EndsWith(), JStringCompare(), ==, and != accept views.
+//	JRegex:
+//		Match() accepts JStringView.
+//		Matching no longer allocates or leaks the match array for
+//			patterns with fewer than 10 subexpressions.
+//	Added JHashString(const JStringView&).
+//	JMDIServer:
+//		*** Requests are sent as a single binary JMessageProtocol message,
+//			so older versions of a program cannot talk to newer versions.
+//		*** Now derives from JBroadcaster.
+//		Registers with ACE_Reactor::instance() and accepts every waiting
+//			connection at once.  Each request is handled as soon as it
+//			arrives, after the reply has been sent.
+
 // version 2.5.0:
 //	*** All egcs thunks hacks have been removed.
 //	JTextEditor:
@@ -0,0 +1,817 @@
+/******************************************************************************
+ JDirTreeSearch.cpp
+
+	Searches a directory tree for one or more files or directories.
+
+	The tree is searched breadth-first, one level at a time.  The
+	directories in each level are divided among several threads, and the
+	results are merged in sorted order, so the same match is found no
+	matter how the work was divided.  If a name exists in more than one
+	place, the one closest to the starting directory is found.
+
+	Directories are read directly, without sorting the entries or calling
+	stat() on them.  Only symbolic links, and entries whose type is not
+	reported by the file system, require a system call.  On Linux, we use
+	getdents64() to avoid the overhead of readdir().
+
+	If ShouldIndex(kJTrue) is called, the contents of each directory are
+	kept in memory.  Later searches only check the modification time of
+	each directory, so repeated searches of a large tree are much faster.
+	The index does not notice if the target of a symbolic link changes.
+
+	BASE CLASS = none
+
+ ******************************************************************************/
+
+#include <JCoreStdInc.h>
+#include <JDirTreeSearch.h>
+#include <JProgressDisplay.h>
+#include <JPtrArray-JString.h>
+#include <JMinMax.h>
+#include <jDirUtil.h>
+#include <ace/OS_NS_unistd.h>
+#include <ace/OS_NS_sys_stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <string.h>
+#include <jAssert.h>
+
+#if defined __linux__
+#include <sys/syscall.h>
+#if defined SYS_getdents64
+#define J_USE_GETDENTS
+#endif
+#endif
+
+// JMemoryManager is not thread-safe.
+
+#if defined ACE_HAS_THREADS && ACE_MT_SAFE && ! defined _J_ARRAY_NEW_OVERRIDABLE
+#define J_DIR_SEARCH_THREADS
+#include <ace/Thread.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Guard_T.h>
+#endif
+
+const JSize kDefaultMaxThreadCount = 8;
+const JSize kMinEntryBufferSize    = 1024;
+
+enum
+{
+	kFileEntry     = 'f',
+	kDirEntry      = 'd',
+	kFileLinkEntry = 'F',		// symbolic link to a file
+	kDirLinkEntry  = 'D',		// symbolic link to a directory
+	kOtherEntry    = 'o'
+};
+
+/******************************************************************************
+ JDirTreeSearch::DirEntries
+
+	The entries in one directory, packed into a single block:  the type,
+	the name, and a terminating null for each one.
+
+ ******************************************************************************/
+
+struct JDirTreeSearch::DirEntries
+{
+	time_t	modTime;
+	JSize	size;
+	JSize	capacity;
+	char*	data;
+
+	DirEntries()
+		:
+		modTime(0),
+		size(0),
+		capacity(0),
+		data(NULL)
+	{ };
+
+	~DirEntries()
+	{
+		delete [] data;
+	};
+
+	void
+	Append
+		(
+		const char			type,
+		const JCharacter*	name
+		)
+	{
+		const JSize length = strlen(name);
+		if (size + length + 2 > capacity)
+			{
+			const JSize newCapacity = JMax(2 * capacity, size + length + 2 + kMinEntryBufferSize);
+
+			char* newData = new char [ newCapacity ];
+			assert( newData != NULL );
+			if (data != NULL)
+				{
+				memcpy(newData, data, size);
+				delete [] data;
+				}
+			data     = newData;
+			capacity = newCapacity;
+			}
+
+		data[ size ] = type;
+		memcpy(data + size + 1, name, length + 1);
+		size += length + 2;
+	};
+};
+
+/******************************************************************************
+ JDirTreeSearch::DirResult
+
+	What one thread found in one directory.  matchName is empty for each
+	target that was not found.
+
+ ******************************************************************************/
+
+struct JDirTreeSearch::DirResult
+{
+	JPtrArray<JString>	subdirList;
+	JString*			matchName;		// one for each target
+	JBoolean*			exactMatch;		// one for each target
+	DirEntries*			newEntries;		// NULL unless indexing
+
+	DirResult
+		(
+		const JSize targetCount
+		)
+		:
+		subdirList(JPtrArrayT::kDeleteAll),
+		newEntries(NULL)
+	{
+		matchName = new JString [ targetCount ];
+		assert( matchName != NULL );
+
+		exactMatch = new JBoolean [ targetCount ];
+		assert( exactMatch != NULL );
+	};
+
+	~DirResult()
+	{
+		delete [] matchName;
+		delete [] exactMatch;
+		delete newEntries;
+	};
+};
+
+/******************************************************************************
+ JDirTreeSearch::Level
+
+	Shared by all the threads that search one level of the tree.
+
+ ******************************************************************************/
+
+struct JDirTreeSearch::Level
+{
+	const JPtrArray<JString>*			dirList;
+	JSize								targetCount;
+	const Target*						targetList;
+	const JStringPtrMap<DirEntries>*	index;			// NULL if not indexing
+	DirResult**							resultList;		// one for each directory
+
+	JIndex				nextDir;		// protected by lock
+	JSize				doneCount;		// protected by lock
+	volatile JBoolean	cancelled;
+
+#ifdef J_DIR_SEARCH_THREADS
+	ACE_Thread_Mutex	lock;
+
+	static ACE_THR_FUNC_RETURN	Main(void* data);
+#endif
+};
+
+/******************************************************************************
+ Constructor
+
+	maxThreadCount = 0 means one thread per processor, up to 8.
+
+ ******************************************************************************/
+
+JDirTreeSearch::JDirTreeSearch
+	(
+	const JSize maxThreadCount
+	)
+	:
+	itsMaxThreadCount(1),
+	itsIndexFlag(kJFalse),
+	itsIndex(NULL)
+{
+#ifdef J_DIR_SEARCH_THREADS
+
+	itsMaxThreadCount = maxThreadCount;
+	if (itsMaxThreadCount == 0)
+		{
+		const long cpuCount = ACE_OS::num_processors_online();
+		itsMaxThreadCount   = JMin(kDefaultMaxThreadCount,
+								   (JSize) JMax(1L, cpuCount));
+		}
+
+#endif
+}
+
+/******************************************************************************
+ Destructor
+
+ ******************************************************************************/
+
+JDirTreeSearch::~JDirTreeSearch()
+{
+	delete itsIndex;
+}
+
+/******************************************************************************
+ Index
+
+	Turning off indexing discards the index.
+
+ ******************************************************************************/
+
+void
+JDirTreeSearch::ShouldIndex
+	(
+	const JBoolean index
+	)
+{
+	itsIndexFlag = index;
+	if (!itsIndexFlag)
+		{
+		ClearIndex();
+		}
+}
+
+JSize
+JDirTreeSearch::GetIndexedDirCount()
+	const
+{
+	return (itsIndex != NULL ? itsIndex->GetElementCount() : 0);
+}
+
+void
+JDirTreeSearch::ClearIndex()
+{
+	delete itsIndex;
+	itsIndex = NULL;
+}
+
+/******************************************************************************
+ Search
+
+	Searches startPath and all its subdirectories for each target.  For
+	each target, path is set to the directory containing it.  newName is
+	set to the actual name, which is useful if !caseSensitive.
+
+	Symbolic links to directories are not followed.
+
+	Returns kJTrue if every target was found.  If pg is not NULL, it must
+	have been started, and the search can be cancelled.
+
+ ******************************************************************************/
+
+JBoolean
+JDirTreeSearch::Search
+	(
+	const JCharacter*	startPath,
+	const JSize			count,
+	Target*				list,
+	JProgressDisplay*	pg,
+	JBoolean*			cancelled
+	)
+{
+	assert( !JStringEmpty(startPath) );
+
+	for (JIndex i=0; i<count; i++)
+		{
+		assert( !JStringEmpty(list[i].name) && list[i].name[0] != '/' );
+
+		list[i].found = kJFalse;
+		list[i].path->Clear();
+		if (list[i].newName != NULL)
+			{
+			list[i].newName->Clear();
+			}
+		}
+
+	if (itsIndexFlag && itsIndex == NULL)
+		{
+		itsIndex = new JStringPtrMap<DirEntries>(JPtrArrayT::kDeleteAll);
+		assert( itsIndex != NULL );
+		}
+
+	JPtrArray<JString>* dirList = new JPtrArray<JString>(JPtrArrayT::kDeleteAll);
+	assert( dirList != NULL );
+	dirList->Append(startPath);
+
+	JPtrArray<JString>* nextDirList = new JPtrArray<JString>(JPtrArrayT::kDeleteAll);
+	assert( nextDirList != NULL );
+
+	JBoolean wasCancelled = kJFalse, allFound = kJFalse;
+	while (!dirList->IsEmpty())
+		{
+		if (!ScanLevel(*dirList, count, list, nextDirList, pg))
+			{
+			wasCancelled = kJTrue;
+			break;
+			}
+
+		allFound = kJTrue;
+		for (JIndex i=0; i<count; i++)
+			{
+			if (!list[i].found)
+				{
+				allFound = kJFalse;
+				break;
+				}
+			}
+
+		if (allFound)
+			{
+			break;
+			}
+
+		JPtrArray<JString>* tmp = dirList;
+		dirList     = nextDirList;
+		nextDirList = tmp;
+		nextDirList->DeleteAll();
+		}
+
+	delete dirList;
+	delete nextDirList;
+
+	if (cancelled != NULL)
+		{
+		*cancelled = wasCancelled;
+		}
+	return allFound;
+}
+
+/******************************************************************************
+ ScanLevel (private)
+
+	Reads every directory in dirList and appends their subdirectories to
+	nextDirList.  Returns kJFalse if the user cancelled.
+
+	The main thread also scans directories, because it has to wait anyway
+	and because only it can update the progress display.
+
+ ******************************************************************************/
+
+JBoolean
+JDirTreeSearch::ScanLevel
+	(
+	const JPtrArray<JString>&	dirList,
+	const JSize					count,
+	Target*						list,
+	JPtrArray<JString>*			nextDirList,
+	JProgressDisplay*			pg
+	)
+{
+	const JSize dirCount = dirList.GetElementCount();
+
+	Level level;
+	level.dirList     = &dirList;
+	level.targetCount = count;
+	level.targetList  = list;
+	level.index       = itsIndex;
+	level.nextDir     = 1;
+	level.doneCount   = 0;
+	level.cancelled   = kJFalse;
+
+	level.resultList = new DirResult* [ dirCount ];
+	assert( level.resultList != NULL );
+	memset(level.resultList, 0, dirCount * sizeof(DirResult*));
+
+#ifdef J_DIR_SEARCH_THREADS
+
+	const JSize threadCount = JMin(itsMaxThreadCount, dirCount) - 1;
+
+	ACE_thread_t* threadList = NULL;
+	JSize startCount         = 0;
+	if (threadCount > 0)
+		{
+		threadList = new ACE_thread_t [ threadCount ];
+		assert( threadList != NULL );
+
+		while (startCount < threadCount &&
+			   ACE_Thread::spawn(Level::Main, &level, THR_NEW_LWP | THR_JOINABLE,
+								 threadList + startCount) == 0)
+			{
+			startCount++;
+			}
+		}
+
+	ScanDirs(&level, pg);
+
+	for (JIndex i=0; i<startCount; i++)
+		{
+		ACE_thread_t departed;
+		ACE_THR_FUNC_RETURN status;
+		ACE_Thread::join(threadList[i], &departed, &status);
+		}
+
+	delete [] threadList;
+
+#else
+
+	ScanDirs(&level, pg);
+
+#endif
+
+	// merge the results in order, so the first match is always the same
+
+	for (JIndex i=1; i<=dirCount; i++)
+		{
+		DirResult* result = level.resultList[i-1];
+		if (result == NULL)
+			{
+			continue;
+			}
+
+		const JString* path = dirList.NthElement(i);
+		for (JIndex j=0; j<count; j++)
+			{
+			if (!list[j].found && !(result->matchName[j]).IsEmpty())
+				{
+				const JBoolean ok = JGetTrueName(*path, list[j].path);
+				assert( ok );
+				if (list[j].newName != NULL)
+					{
+					*(list[j].newName) = result->matchName[j];
+					}
+				list[j].found = kJTrue;
+				}
+			}
+
+		nextDirList->CopyPointers(result->subdirList, JPtrArrayT::kDeleteAll, kJTrue);
+		result->subdirList.RemoveAll();
+
+		if (result->newEntries != NULL && itsIndex != NULL)
+			{
+			itsIndex->SetElement(*path, result->newEntries, JPtrArrayT::kDelete);
+			result->newEntries = NULL;
+			}
+
+		delete result;
+		}
+
+	delete [] level.resultList;
+	return !level.cancelled;
+}
+
+/******************************************************************************
+ ScanDirs (static private)
+
+	Scans directories until there are none left in the level.  Only the
+	main thread passes a progress display.
+
+ ******************************************************************************/
+
+#ifdef J_DIR_SEARCH_THREADS
+
+ACE_THR_FUNC_RETURN
+JDirTreeSearch::Level::Main
+	(
+	void* data
+	)
+{
+	ScanDirs(static_cast<Level*>(data), NULL);
+	return 0;
+}
+
+#endif
+
+void
+JDirTreeSearch::ScanDirs
+	(
+	Level*				level,
+	JProgressDisplay*	pg
+	)
+{
+	const JSize dirCount = (level->dirList)->GetElementCount();
+
+	JSize reportedCount = 0;
+	while (!level->cancelled)
+		{
+		JIndex i;
+		JSize doneCount;
+		{
+#ifdef J_DIR_SEARCH_THREADS
+		ACE_Guard<ACE_Thread_Mutex> guard(level->lock);
+#endif
+		i         = level->nextDir++;
+		doneCount = level->doneCount;
+		}
+
+		if (pg != NULL && doneCount > reportedCount)
+			{
+			if (!pg->IncrementProgress(doneCount - reportedCount))
+				{
+				level->cancelled = kJTrue;
+				break;
+				}
+			reportedCount = doneCount;
+			}
+
+		if (i > dirCount)
+			{
+			break;
+			}
+
+		DirResult* result = new DirResult(level->targetCount);
+		assert( result != NULL );
+
+		ScanDir(*level, *((level->dirList)->NthElement(i)), result);
+		level->resultList[i-1] = result;
+
+		{
+#ifdef J_DIR_SEARCH_THREADS
+		ACE_Guard<ACE_Thread_Mutex> guard(level->lock);
+#endif
+		level->doneCount++;
+		}
+		}
+}
+
+/******************************************************************************
+ ScanDir (static private)
+
+	This is called from several threads at once, so it must not modify
+	anything except result.
+
+ ******************************************************************************/
+
+void
+JDirTreeSearch::ScanDir
+	(
+	const Level&	level,
+	const JString&	path,
+	DirResult*		result
+	)
+{
+	const JSize targetCount = level.targetCount;
+
+	// partial paths like "X11/Xlib.h" can only be checked directly
+
+	for (JIndex i=0; i<targetCount; i++)
+		{
+		const Target& t = level.targetList[i];
+		result->exactMatch[i] = kJFalse;
+		if (!t.found && strchr(t.name, '/') != NULL)
+			{
+			const JString fullName = JCombinePathAndName(path, t.name);
+			if (( t.isFile && JFileExists(fullName)) ||
+				(!t.isFile && JDirectoryExists(fullName)))
+				{
+				result->matchName[i]  = t.name;
+				result->exactMatch[i] = kJTrue;
+				}
+			}
+		}
+
+	// use the index, if it is still valid
+
+	const DirEntries* entries = NULL;
+	if (level.index != NULL)
+		{
+		ACE_stat info;
+		const DirEntries* e;
+		if (ACE_OS::stat(path, &info) == 0 &&
+			(level.index)->GetElement(path, &e) && e->modTime == info.st_mtime)
+			{
+			entries = e;
+			}
+		}
+
+	DirEntries localEntries;
+	if (entries == NULL)
+		{
+		DirEntries* e = &localEntries;
+		if (level.index != NULL)
+			{
+			e = result->newEntries = new DirEntries;
+			assert( e != NULL );
+			}
+
+		if (!ReadDir(path, JI2B(level.index != NULL), e))
+			{
+			return;
+			}
+		entries = e;
+		}
+
+	// check each entry
+
+	const char* end = entries->data + entries->size;
+	for (const char* p = entries->data; p < end; )
+		{
+		const char type        = *p;
+		const JCharacter* name = p+1;
+		p += strlen(name) + 2;
+
+		const JBoolean isFile = JI2B(type == kFileEntry || type == kFileLinkEntry);
+		const JBoolean isDir  = JI2B(type == kDirEntry  || type == kDirLinkEntry);
+		if (isFile || isDir)
+			{
+			for (JIndex i=0; i<targetCount; i++)
+				{
+				const Target& t = level.targetList[i];
+				if (t.found || t.isFile != isFile || result->exactMatch[i])
+					{
+					continue;
+					}
+
+				const JBoolean exact = JI2B(strcmp(t.name, name) == 0);
+				if (exact ||
+					(!t.caseSensitive && JStringCompare(t.name, name, kJFalse) == 0 &&
+					 ((result->matchName[i]).IsEmpty() ||
+					  strcmp(name, result->matchName[i]) < 0)))
+					{
+					result->matchName[i]  = name;
+					result->exactMatch[i] = exact;
+					}
+				}
+			}
+
+		if (type == kDirEntry)
+			{
+			(result->subdirList).Append(JCombinePathAndName(path, name));
+			}
+		}
+
+	(result->subdirList).SetCompareFunction(JCompareStringsCaseSensitive);
+	(result->subdirList).Sort();
+}
+
+/******************************************************************************
+ ReadDir (static private)
+
+	Symbolic links are resolved, so we know whether or not they match, but
+	they are not followed.
+
+ ******************************************************************************/
+
+static void
+JDirTreeSearchAddEntry
+	(
+	const JString&						path,
+	const JCharacter*					name,
+	const int							type,
+	JDirTreeSearch::DirEntries*			entries
+	);
+
+JBoolean
+JDirTreeSearch::ReadDir
+	(
+	const JString&	path,
+	const JBoolean	getModTime,
+	DirEntries*		entries
+	)
+{
+#ifdef J_USE_GETDENTS
+
+	struct Dirent64
+	{
+		JUInt64			d_ino;
+		JInt64			d_off;
+		unsigned short	d_reclen;
+		unsigned char	d_type;
+		char			d_name[1];
+	};
+
+	const int fd = open(path, O_RDONLY | O_DIRECTORY);
+	if (fd < 0)
+		{
+		return kJFalse;
+		}
+
+	ACE_stat info;
+	if (getModTime && ACE_OS::fstat(fd, &info) == 0)
+		{
+		entries->modTime = info.st_mtime;
+		}
+
+	char buffer[ 32768 ];
+	long byteCount;
+	while ((byteCount = syscall(SYS_getdents64, fd, buffer, sizeof(buffer))) > 0)
+		{
+		for (long i=0; i<byteCount; )
+			{
+			const Dirent64* d = reinterpret_cast<const Dirent64*>(buffer + i);
+			JDirTreeSearchAddEntry(path, d->d_name, d->d_type, entries);
+			i += d->d_reclen;
+			}
+		}
+
+	close(fd);
+	return kJTrue;
+
+#else
+
+	DIR* dir = opendir(path);
+	if (dir == NULL)
+		{
+		return kJFalse;
+		}
+
+	ACE_stat info;
+	if (getModTime && ACE_OS::stat(path, &info) == 0)
+		{
+		entries->modTime = info.st_mtime;
+		}
+
+	struct dirent* d;
+	while ((d = readdir(dir)) != NULL)
+		{
+	#ifdef _DIRENT_HAVE_D_TYPE
+		JDirTreeSearchAddEntry(path, d->d_name, d->d_type, entries);
+	#else
+		JDirTreeSearchAddEntry(path, d->d_name, -1, entries);
+	#endif
+		}
+
+	closedir(dir);
+	return kJTrue;
+
+#endif
+}
+
+/******************************************************************************
+ JDirTreeSearchAddEntry (local)
+
+	type is d_type, or -1 if the file system does not provide it.
+
+ ******************************************************************************/
+
+static void
+JDirTreeSearchAddEntry
+	(
+	const JString&					path,
+	const JCharacter*				name,
+	const int						type,
+	JDirTreeSearch::DirEntries*		entries
+	)
+{
+	if (name[0] == '.' &&
+		(name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+		{
+		return;
+		}
+
+#ifdef DT_DIR
+
+	if (type == DT_DIR)
+		{
+		entries->Append(kDirEntry, name);
+		return;
+		}
+	else if (type == DT_REG)
+		{
+		entries->Append(kFileEntry, name);
+		return;
+		}
+	else if (type != DT_LNK && type != DT_UNKNOWN && type != -1)
+		{
+		entries->Append(kOtherEntry, name);
+		return;
+		}
+
+#endif
+
+	const JString fullName = JCombinePathAndName(path, name);
+
+	ACE_stat info;
+	if (ACE_OS::lstat(fullName, &info) != 0)
+		{
+		return;
+		}
+	else if (S_ISDIR(info.st_mode))
+		{
+		entries->Append(kDirEntry, name);
+		}
+	else if (S_ISREG(info.st_mode))
+		{
+		entries->Append(kFileEntry, name);
+		}
+	else if (S_ISLNK(info.st_mode) && ACE_OS::stat(fullName, &info) == 0)
+		{
+		entries->Append(S_ISDIR(info.st_mode) ? kDirLinkEntry :
+						S_ISREG(info.st_mode) ? kFileLinkEntry : kOtherEntry,
+						name);
+		}
+	else
+		{
+		entries->Append(kOtherEntry, name);
+		}
+}
+
+#define JTemplateType JDirTreeSearch::DirEntries
+#include <JStringPtrMap.tmpls>
+#undef JTemplateType
+
+#define JTemplateType JStrValue<JDirTreeSearch::DirEntries*>
+#include <JHashTable.tmpls>
+#undef JTemplateType
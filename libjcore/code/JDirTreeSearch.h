@@ -0,0 +1,112 @@
+/******************************************************************************
+ JDirTreeSearch.h
+
+	Interface for the JDirTreeSearch class
+
+ ******************************************************************************/
+
+#ifndef _H_JDirTreeSearch
+#define _H_JDirTreeSearch
+
+#if !defined _J_UNIX && !defined ACE_LACKS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <JStringPtrMap.h>
+#include <time.h>
+
+class JString;
+class JProgressDisplay;
+
+class JDirTreeSearch
+{
+public:
+
+	struct Target
+	{
+		const JCharacter*	name;			// can include partial path
+		JBoolean			isFile;
+		JBoolean			caseSensitive;	// only if no partial path
+		JString*			path;			// cleared if not found
+		JString*			newName;		// can be NULL
+		JBoolean			found;
+	};
+
+public:
+
+	JDirTreeSearch(const JSize maxThreadCount = 0);
+
+	~JDirTreeSearch();
+
+	JBoolean	Search(const JCharacter* startPath, const JSize count, Target* list,
+					   JProgressDisplay* pg = NULL, JBoolean* cancelled = NULL);
+
+	JBoolean	IsIndexing() const;
+	void		ShouldIndex(const JBoolean index);
+	JSize		GetIndexedDirCount() const;
+	void		ClearIndex();
+
+	JSize		GetMaxThreadCount() const;
+
+public:
+
+	struct DirEntries;
+	struct DirResult;
+	struct Level;
+
+	friend struct Level;
+
+private:
+
+	JSize						itsMaxThreadCount;
+	JBoolean					itsIndexFlag;
+	JStringPtrMap<DirEntries>*	itsIndex;		// NULL if not indexing
+
+private:
+
+	JBoolean	ScanLevel(const JPtrArray<JString>& dirList,
+						  const JSize count, Target* list,
+						  JPtrArray<JString>* nextDirList,
+						  JProgressDisplay* pg);
+
+	static void	ScanDirs(Level* level, JProgressDisplay* pg);
+	static void	ScanDir(const Level& level, const JString& path, DirResult* result);
+	static JBoolean	ReadDir(const JString& path, const JBoolean getModTime,
+							DirEntries* entries);
+
+	// not allowed
+
+	JDirTreeSearch(const JDirTreeSearch& source);
+	const JDirTreeSearch& operator=(const JDirTreeSearch& source);
+};
+
+
+/******************************************************************************
+ Index
+
+	The index remembers the contents of every directory that is searched,
+	so later searches of the same tree only need to check the modification
+	time of each directory.
+
+ ******************************************************************************/
+
+inline JBoolean
+JDirTreeSearch::IsIndexing()
+	const
+{
+	return itsIndexFlag;
+}
+
+/******************************************************************************
+ GetMaxThreadCount
+
+ ******************************************************************************/
+
+inline JSize
+JDirTreeSearch::GetMaxThreadCount()
+	const
+{
+	return itsMaxThreadCount;
+}
+
+#endif
@@ -26,6 +26,16 @@ public:
 		kDeleted,
 		kFull
 	};
+
+	// classes of control bytes searched by JHashTable::FindCtrl()
+
+	enum CtrlMatch
+	{
+		kMatchFull,
+		kMatchOpen,
+		kMatchHash,			// matching control byte or empty
+		kMatchHashOrOpen	// matching control byte, deleted, or empty
+	};
 };
 
 
@@ -21,13 +21,20 @@
 
 //#include <JHashTableCursor.h>
 
-	// This value comes from Sedgewick, should ensure less than five probes on average
-	// for a search miss and fewer for a hit.
+	// With linear probing, a search miss at this load examines about 13 slots
+	// on average, which is usually a single scan of one group of control bytes.
 	const JFloat kJDefaultMaxLoadFactor = 0.8;
 
 	const JFloat kJDefaultMinFillFactor = 0.1;
 	const JSize  kJDefaultLgMinTableSize = 5;
 
+	// Each slot has a control byte: 0x00-0x7F (7 bits of the hash value)
+	// when full, or one of the following values.
+
+	const unsigned char kJHashCtrlEmpty   = 0x80;
+	const unsigned char kJHashCtrlDeleted = 0xFE;
+	const JSize         kJHashGroupSize   = 16;		// control bytes scanned at once
+
 template <class V>
 class JHashTable
 {
@@ -125,12 +132,19 @@ protected:
 
 // For use by cursors
 	JSize HashToIndex(JHashValue hash) const;
+	JSize GetHomeIndex(const JHashValue hash) const;
+	void  Prefetch(const JSize index) const;
+	JSize FindCtrl(const JSize index, const JSize count, const unsigned char ctrl,
+				   const JHashRecordT::CtrlMatch type) const;
+
+	static unsigned char	HashToCtrl(const JHashValue hash);
 
 private:
 
 	JSize             itsLgSize;
 	JSize             itsMaxIndex;
 	JHashRecord<V>* itsArray;
+	unsigned char*  itsCtrl;		// one byte per slot, plus a copy of the first group
 
 	JHashCursor<V>* itsCursor;
 
@@ -150,6 +164,8 @@ private:
 private:
 
 	void     _MarkAllEmpty();
+	void     AllocateTable();
+	void     SetCtrl(const JSize index, const unsigned char ctrl);
 	JBoolean TryInsert(const JHashRecord<V>& record);
 	JBoolean TryInsertAll(const JHashTable<V>* source);
 
@@ -420,7 +436,7 @@ JHashTable<V>::IsEmpty
 	)
 	const
 {
-	return itsArray[index].IsEmpty();
+	return JI2B(itsCtrl[index] == kJHashCtrlEmpty);
 }
 
 /******************************************************************************
@@ -439,7 +455,7 @@ JHashTable<V>::IsDeleted
 	)
 	const
 {
-	return itsArray[index].IsDeleted();
+	return JI2B(itsCtrl[index] == kJHashCtrlDeleted);
 }
 
 /******************************************************************************
@@ -458,7 +474,7 @@ JHashTable<V>::IsFull
 	)
 	const
 {
-	return itsArray[index].IsFull();
+	return JI2B(itsCtrl[index] < kJHashCtrlEmpty);
 }
 
 /******************************************************************************
@@ -515,4 +531,77 @@ JHashTable<V>::HashToIndex
 	return hash & itsMaxIndex;
 }
 
+/******************************************************************************
+ GetHomeIndex (protected)
+
+	Returns the slot where the search for the given hash value starts.
+	Since the table is probed linearly, the hash value is scrambled
+	(Fibonacci hashing) so that hash functions with weak low order bits
+	do not produce long clusters.
+
+ *****************************************************************************/
+
+template <class V>
+inline JSize
+JHashTable<V>::GetHomeIndex
+	(
+	const JHashValue hash
+	)
+	const
+{
+#if JWORDSIZE == 8
+	const JHashValue product = hash * 11400714819323198485UL;
+#else
+	const JHashValue product = hash * 2654435769UL;
+#endif
+
+	return (itsLgSize == 0 ? 0 : product >> (8*sizeof(JHashValue) - itsLgSize));
+}
+
+/******************************************************************************
+ Prefetch (protected)
+
+	Starts loading the record at the given index while the control bytes
+	are being scanned, since a successful search usually ends there.
+
+ *****************************************************************************/
+
+template <class V>
+inline void
+JHashTable<V>::Prefetch
+	(
+	const JSize index
+	)
+	const
+{
+#ifdef __GNUC__
+	__builtin_prefetch(itsArray + index);
+#endif
+}
+
+/******************************************************************************
+ HashToCtrl (static protected)
+
+	Returns the 7 bits of the hash value that are stored in the control
+	byte of a full slot.  All the bits are folded together so they are
+	independent of the bits used by GetHomeIndex().
+
+ *****************************************************************************/
+
+template <class V>
+inline unsigned char
+JHashTable<V>::HashToCtrl
+	(
+	const JHashValue hash
+	)
+{
+	JHashValue h = hash;
+#if JWORDSIZE == 8
+	h ^= h >> 32;
+#endif
+	h ^= h >> 16;
+	h ^= h >> 8;
+	return (h ^ (h >> 7)) & 0x7F;
+}
+
 #endif
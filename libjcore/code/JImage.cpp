@@ -29,6 +29,11 @@
 const int kGDNoTransparentColor = -1;
 const int kGDColorScale         = 65535/255;
 
+// RGB -> JColorIndex memo used while decoding true color images
+
+const JSize kGDColorCacheBits = 10;
+const JSize kGDColorCacheSize = 1 << kGDColorCacheBits;
+
 // JError data
 
 const JCharacter* JImage::kUnknownFileType  = "UnknownFileType::JImage";
@@ -86,6 +91,28 @@ JImage::~JImage()
 {
 }
 
+/******************************************************************************
+ SetColorRow (virtual)
+
+	Sets the colors of all the pixels in row y.  colorRow must contain
+	GetWidth() entries.  Derived classes should override this to avoid
+	the per-pixel overhead of SetColor().
+
+ ******************************************************************************/
+
+void
+JImage::SetColorRow
+	(
+	const JCoordinate	y,
+	const JColorIndex*	colorRow
+	)
+{
+	for (JCoordinate x=0; x<itsWidth; x++)
+		{
+		SetColor(x,y, colorRow[x]);
+		}
+}
+
 /******************************************************************************
  GetFileType (static)
 
@@ -343,6 +370,11 @@ JImage::WriteJPEG
 	If this function returns UnknownFileType, it should be translated to
 	the approrpriate FileIsNot* message.
 
+	gd stores pixels by row, so we decode one row at a time.  True color
+	images tend to reuse a small number of colors, so we remember the
+	result of each conversion, both for runs of identical pixels and in a
+	small direct-mapped cache keyed on the gd color.
+
  ******************************************************************************/
 
 JError
@@ -382,25 +414,52 @@ JImage::ReadGD
 
 		PrepareForImageData();
 
-		for (JCoordinate x=0; x<itsWidth; x++)
+		JColorIndex* colorRow = new JColorIndex [ itsWidth ];
+		assert( colorRow != NULL );
+
+		int cacheKey [ kGDColorCacheSize ];
+		JColorIndex cacheColor [ kGDColorCacheSize ];
+		for (JIndex i=0; i<kGDColorCacheSize; i++)
 			{
-			for (JCoordinate y=0; y<itsHeight; y++)
+			cacheKey[i] = -1;		// gd never uses negative true color values
+			}
+
+		for (JCoordinate y=0; y<itsHeight; y++)
+			{
+			const int* gdRow  = image->tpixels[y];
+			int prevPixel     = -1;
+			JColorIndex color = 0;
+			for (JCoordinate x=0; x<itsWidth; x++)
 				{
-				const int c = gdImageGetPixel(image, x,y);
-				JColorIndex color;
-				itsColormap->AllocateStaticColor(gdImageRed  (image, c) * kGDColorScale,
-												 gdImageGreen(image, c) * kGDColorScale,
-												 gdImageBlue (image, c) * kGDColorScale,
-												 &color);
-				SetColor(x,y, color);
+				const int c = gdRow[x];
+				if (c != prevPixel)
+					{
+					const JIndex i =
+						((JUInt32) (((JUInt32) c) * 2654435761U)) >> (32 - kGDColorCacheBits);
+					if (cacheKey[i] != c)
+						{
+						itsColormap->AllocateStaticColor(gdTrueColorGetRed  (c) * kGDColorScale,
+														 gdTrueColorGetGreen(c) * kGDColorScale,
+														 gdTrueColorGetBlue (c) * kGDColorScale,
+														 &(cacheColor[i]));
+						cacheKey[i] = c;
+						}
+					color     = cacheColor[i];
+					prevPixel = c;
+					}
+				colorRow[x] = color;
 				}
+
+			SetColorRow(y, colorRow);
 			}
 
-		ImageDataFinished();
+		delete [] colorRow;
 
-		gdImageDestroy(image);
+		gdImageDestroy(image);	// free up memory as soon as possible
 		image = NULL;
 
+		ImageDataFinished();
+
 		return JNoError();
 		}
 	else
@@ -444,11 +503,12 @@ JImage::ReadGD
 
 		// convert image data
 
-		for (JCoordinate x=0; x<itsWidth; x++)
+		for (JCoordinate y=0; y<itsHeight; y++)
 			{
-			for (JCoordinate y=0; y<itsHeight; y++)
+			const unsigned char* gdRow = image->pixels[y];
+			for (JCoordinate x=0; x<itsWidth; x++)
 				{
-				cols[x][y] = gdImageGetPixel(image, x,y);
+				cols[x][y] = gdRow[x];
 				}
 			}
 
@@ -55,6 +55,7 @@ public:
 	virtual JColorIndex	GetColor(const JCoordinate x, const JCoordinate y) const = 0;
 	virtual void		SetColor(const JCoordinate x, const JCoordinate y,
 								 const JColorIndex color) = 0;
+	virtual void		SetColorRow(const JCoordinate y, const JColorIndex* colorRow);
 
 	virtual JBoolean	GetMask(JImageMask** mask) const = 0;
 
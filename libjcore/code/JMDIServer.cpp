@@ -23,7 +23,17 @@
 			The arguments to this function are the directory from which the
 			MDI request was made and argv[].
 
-	BASE CLASS = NONE
+	The new invocation sends its request as a single message in
+	JMessageProtocol's binary format:  the directory and then each
+	argument, each terminated by a NULL.  The acceptor and each accepted
+	connection are registered with ACE_Reactor::instance(), so everything
+	happens as soon as the event loop checks the reactor.  Every
+	connection that is waiting is accepted at once.  When a request
+	arrives, the other invocation is answered first, so it can exit, and
+	then the request is handled.  If several requests are waiting, they
+	are handled in the order in which the connections were accepted.
+
+	BASE CLASS = virtual JBroadcaster
 
 	Copyright  1997 by John Lindal. All rights reserved.
 
@@ -31,27 +41,123 @@
 
 #include <JCoreStdInc.h>
 #include <JMDIServer.h>
+#include <JMessageProtocol.h>
 #include <ace/LSOCK_Acceptor.h>
 #include <ace/LSOCK_Connector.h>
 #include <ace/LSOCK_Stream.h>
 #include <ace/UNIX_Addr.h>
+#include <ace/Reactor.h>
 #include <JString.h>
 #include <jSysUtil.h>
 #include <jFileUtil.h>
 #include <jDirUtil.h>
-#include <jErrno.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
 #include <jAssert.h>
 
-const JSize kMDIServerQSize    = 1;
+const JSize kMDIServerQSize    = 128;	// many invocations can be waiting at once
 const JSize kMDIMaxWaitTime    = 2;		// seconds
-const JCharacter kEndOfLine    = '\n';
-const JCharacter kEndOfMessage = '\0';
+const JSize kMDIMaxReplyLength = 100;
+const JCharacter kEndOfArg     = '\0';
 
 static const JCharacter* kServerReadyMsg = "JMDIServer ready";
 static const JCharacter* kServerBusyMsg  = "JMDIServer busy";
 
+typedef JMessageProtocol<ACE_LSOCK_STREAM>	RequestLink;
+
+/******************************************************************************
+ AcceptHandler (private)
+
+	Lets the reactor tell us when somebody is waiting to connect.
+
+ ******************************************************************************/
+
+class JMDIServer::AcceptHandler : public ACE_Event_Handler
+{
+public:
+
+	AcceptHandler
+		(
+		JMDIServer* server
+		)
+		:
+		itsServer(server)
+	{ };
+
+	virtual ACE_HANDLE
+	get_handle() const
+	{
+		return (itsServer->itsAcceptor)->get_handle();
+	};
+
+	virtual int
+	handle_input
+		(
+		ACE_HANDLE
+		)
+	{
+		itsServer->AcceptConnections();
+		return 0;
+	};
+
+private:
+
+	JMDIServer*	itsServer;
+};
+
+/******************************************************************************
+ Connection (private)
+
+	argList is NULL until a request arrives and is accepted, and again
+	after the request has been handled.
+
+	The link registers itself with the link's reactor, which is
+	ACE_Reactor::instance(), when it is constructed from a handle.  This
+	is done by ACE_Svc_Handler::open().  The link's destructor removes it.
+
+ ******************************************************************************/
+
+struct JMDIServer::Connection
+{
+	RequestLink*		link;
+	time_t				startTime;
+	JBoolean			finished;		// kJTrue => nothing more to receive
+	JString				dir;
+	JPtrArray<JString>*	argList;
+
+	Connection
+		(
+		const ACE_HANDLE fd
+		)
+		:
+		startTime(time(NULL)),
+		finished(kJFalse),
+		argList(NULL)
+	{
+		link = new RequestLink(fd, kJTrue);
+		assert( link != NULL );
+		link->UseBinaryProtocol();
+	};
+
+	~Connection()
+	{
+		delete link;
+		delete argList;
+	};
+
+	// stops the reactor from reporting the end of the stream
+
+	void
+	Finish()
+	{
+		finished = kJTrue;
+		(link->reactor())->remove_handler(link,
+			ACE_Event_Handler::READ_MASK | ACE_Event_Handler::DONT_CALL);
+	};
+};
+
 /******************************************************************************
  Constructor
 
@@ -61,6 +167,8 @@ JMDIServer::JMDIServer
 	(
 	const JCharacter* signature
 	)
+	:
+	itsIsHandlingFlag(kJFalse)
 {
 	const JString socketName = GetMDISocketName(signature);
 	ACE_OS::unlink(socketName);
@@ -69,8 +177,14 @@ JMDIServer::JMDIServer
 	itsAcceptor = new ACE_LSOCK_Acceptor(addr, 0, PF_UNIX, kMDIServerQSize);
 	assert( itsAcceptor != NULL );
 
-	itsSocket = new ACE_LSOCK_Stream;
-	assert( itsSocket != NULL );
+	itsConnectionList = new JPtrArray<Connection>(JPtrArrayT::kDeleteAll);
+	assert( itsConnectionList != NULL );
+
+	itsAcceptHandler = new AcceptHandler(this);
+	assert( itsAcceptHandler != NULL );
+
+	(ACE_Reactor::instance())->register_handler(itsAcceptHandler,
+												ACE_Event_Handler::ACCEPT_MASK);
 }
 
 /******************************************************************************
@@ -80,8 +194,11 @@ JMDIServer::JMDIServer
 
 JMDIServer::~JMDIServer()
 {
-	itsSocket->close();
-	delete itsSocket;
+	(ACE_Reactor::instance())->remove_handler(itsAcceptHandler,
+		ACE_Event_Handler::ACCEPT_MASK | ACE_Event_Handler::DONT_CALL);
+	delete itsAcceptHandler;
+
+	delete itsConnectionList;
 
 	itsAcceptor->remove();
 	delete itsAcceptor;
@@ -131,16 +248,32 @@ JMDIServer::WillBeMDIServer
 		return kJTrue;
 		}
 
-	JBoolean receivedFinishedFlag = kJFalse;
+	// send our request and the disconnect in a single write
+
+	JString request = JGetCurrentDirectory();
+	request.AppendCharacter(kEndOfArg);
+
+	for (JIndex i=0; i < (JSize) argc; i++)
+		{
+		request.Append(argv[i]);
+		request.AppendCharacter(kEndOfArg);
+		}
+
+	JString data;
+	AppendLength(&data, request.GetLength());
+	data.Append(request);
+	AppendLength(&data, JMessageProtocolT::kBinaryDisconnectLength);
+
+	socket.send_n(data.GetCString(), data.GetLength());
 
 	// wait for "server ok" message
 
 	JString serverStatus;
-	const JBoolean serverOK =
-		ReceiveLine(socket, kJTrue, &serverStatus, &receivedFinishedFlag);
+	const JBoolean serverOK = ReceiveReply(socket, &serverStatus);
+	socket.close();
+
 	if (!serverOK && !JUNIXSocketExists(socketName))		// user deleted dead socket
 		{
-		socket.close();
 		return kJTrue;
 		}
 	else if (!serverOK && ACE_OS::unlink(socketName) == -1)
@@ -152,7 +285,6 @@ JMDIServer::WillBeMDIServer
 		}
 	else if (!serverOK)
 		{
-		socket.close();
 		return kJTrue;
 		}
 
@@ -160,23 +292,10 @@ JMDIServer::WillBeMDIServer
 		{
 		cerr << argv[0] << " is busy, probably because of a blocking window." << endl;
 		cerr << "(e.g. a dialog or an error message)" << endl;
-		WaitForFinished(socket, receivedFinishedFlag);
 		return kJFalse;
 		}
 
 	assert( serverStatus == kServerReadyMsg );
-
-	// send our message
-
-	const JString dir = JGetCurrentDirectory();
-	SendLine(socket, dir);
-
-	for (JIndex i=0; i < (JSize) argc; i++)
-		{
-		SendLine(socket, argv[i]);
-		}
-
-	WaitForFinished(socket, receivedFinishedFlag);
 	return kJFalse;
 }
 
@@ -210,69 +329,244 @@ JMDIServer::HandleCmdLineOptions
 /******************************************************************************
  CheckForConnections
 
-	By having an existing ACE_LSOCK_Stream, accept() is as fast as possible.
+	Requests are normally handled from the reactor.  The reactor is not
+	checked while there is a blocking window, so we also accept and read
+	the connections here.  This way, the other invocation is told that we
+	are busy instead of being left waiting.  This also throws out
+	connections that have timed out.
 
  ******************************************************************************/
 
 void
 JMDIServer::CheckForConnections()
 {
-	ACE_Time_Value dontWait(0,0);
-	if (itsAcceptor->accept(*itsSocket, NULL, &dontWait) != -1)
+	AcceptConnections();
+
+	const JSize count = itsConnectionList->GetElementCount();
+	for (JIndex i=1; i<=count; i++)
 		{
-		ProcessMDIMessage();
+		Connection* connection = itsConnectionList->NthElement(i);
+		if (!connection->finished)
+			{
+			(connection->link)->handle_input((connection->link)->get_handle());
+			}
 		}
 }
 
 /******************************************************************************
- ProcessMDIMessage (private)
+ AcceptConnections (private)
 
-	Unpacks MDI request and calls HandleMDIRequest().
-	The socket is closed before returning.
+	By accepting everybody who is waiting, requests from many invocations
+	can be handled in a single pass through the event loop.
+
+	Each link is registered with the reactor, so the rest of the request
+	is read by handle_input() as soon as it arrives.
 
  ******************************************************************************/
 
 void
-JMDIServer::ProcessMDIMessage()
+JMDIServer::AcceptConnections()
 {
-	JBoolean receivedFinishedFlag = kJFalse;
+	RemoveFinishedConnections();
 
-	// tell them our status
+	ACE_Time_Value dontWait(0,0);
+	ACE_LSOCK_Stream socket;
+	while (itsAcceptor->accept(socket, NULL, &dontWait) != -1)
+		{
+		socket.enable(ACE_NONBLOCK);
+
+		Connection* connection = new Connection(socket.get_handle());
+		assert( connection != NULL );
+		itsConnectionList->Append(connection);
+		ListenTo(connection->link);
+
+		// the request is often waiting already
+
+		(connection->link)->handle_input(socket.get_handle());
+		}
+}
+
+/******************************************************************************
+ Receive (virtual protected)
+
+ ******************************************************************************/
+
+void
+JMDIServer::Receive
+	(
+	JBroadcaster*	sender,
+	const Message&	message
+	)
+{
+	Connection* connection = NULL;
+
+	const JSize count = itsConnectionList->GetElementCount();
+	for (JIndex i=1; i<=count; i++)
+		{
+		Connection* c = itsConnectionList->NthElement(i);
+		if (sender == c->link)
+			{
+			connection = c;
+			break;
+			}
+		}
 
-	if (CanAcceptMDIRequest())
+	if (connection != NULL && message.Is(JMessageProtocolT::kMessageReady))
 		{
-		SendLine(*itsSocket, kServerReadyMsg);
+		const JMessageProtocolT::MessageReady* info =
+			dynamic_cast(const JMessageProtocolT::MessageReady*, &message);
+		assert( info != NULL );
+		ReceiveRequest(connection, info->GetData(), info->GetLength());
+		HandleRequests();
+		}
+	else if (connection != NULL && message.Is(JMessageProtocolT::kReceivedDisconnect))
+		{
+		connection->Finish();
 		}
 	else
 		{
-		SendLine(*itsSocket, kServerBusyMsg);
-		WaitForFinished(*itsSocket, receivedFinishedFlag);
+		JBroadcaster::Receive(sender, message);
+		}
+}
+
+/******************************************************************************
+ ReceiveRequest (private)
+
+	Tells the other invocation our status and unpacks the request.
+
+ ******************************************************************************/
+
+void
+JMDIServer::ReceiveRequest
+	(
+	Connection*			connection,
+	const JCharacter*	data,
+	const JSize			length
+	)
+{
+	if (connection->finished)
+		{
 		return;
 		}
+	connection->Finish();
+
+	const JBoolean ok = CanAcceptMDIRequest();
+	(connection->link)->SendMessage(ok ? kServerReadyMsg : kServerBusyMsg);
+	(connection->link)->SendDisconnect();
+	if (!ok)
+		{
+		return;
+		}
+
+	connection->argList = new JPtrArray<JString>(JPtrArrayT::kDeleteAll);
+	assert( connection->argList != NULL );
+
+	JBoolean first = kJTrue;
+	const JCharacter* end = data + length;
+	while (data < end)
+		{
+		const JCharacter* argEnd =
+			static_cast<const JCharacter*>(memchr(data, kEndOfArg, end - data));
+		if (argEnd == NULL)
+			{
+			break;
+			}
+
+		if (first)
+			{
+			(connection->dir).Set(data, argEnd - data);
+			first = kJFalse;
+			}
+		else
+			{
+			(connection->argList)->Append(JString(data, argEnd - data));
+			}
+
+		data = argEnd + 1;
+		}
+}
+
+/******************************************************************************
+ HandleRequests (private)
+
+	Handles the requests that have arrived, in the order in which the
+	connections were accepted.  This is called while a link is
+	broadcasting, so the connections are not deleted here.
 
-	// receive their message
+	HandleMDIRequest() can run a nested event loop, and requests that
+	arrive meanwhile are only unpacked.  We handle them after the current
+	one, so we start over after each request.
 
-	JString dir;
-	if (!ReceiveLine(*itsSocket, kJFalse, &dir, &receivedFinishedFlag))
+ ******************************************************************************/
+
+void
+JMDIServer::HandleRequests()
+{
+	if (itsIsHandlingFlag)
 		{
-		itsSocket->close();
 		return;
 		}
+	itsIsHandlingFlag = kJTrue;
 
-	JPtrArray<JString> argList(JPtrArrayT::kDeleteAll);
-	JString tempStr;
-	while (ReceiveLine(*itsSocket, kJFalse, &tempStr, &receivedFinishedFlag))
+	JIndex i = 1;
+	while (i <= itsConnectionList->GetElementCount())
 		{
-		argList.Append(tempStr);
+		Connection* connection = itsConnectionList->NthElement(i);
+		if (connection->argList != NULL)
+			{
+			JPtrArray<JString>* argList = connection->argList;
+			connection->argList         = NULL;
+
+			if (!argList->IsEmpty())
+				{
+				HandleMDIRequest(connection->dir, *argList);
+				}
+			delete argList;
+
+			i = 1;
+			}
+		else
+			{
+			i++;
+			}
 		}
 
-	WaitForFinished(*itsSocket, receivedFinishedFlag);
+	itsIsHandlingFlag = kJFalse;
+}
 
-	// handle the request
+/******************************************************************************
+ RemoveFinishedConnections (private)
 
-	if (!argList.IsEmpty())
+	Throws out connections that have finished or timed out.  This must not
+	delete a link that is broadcasting, so it does nothing while requests
+	are being handled.
+
+ ******************************************************************************/
+
+void
+JMDIServer::RemoveFinishedConnections()
+{
+	if (itsIsHandlingFlag)
 		{
-		HandleMDIRequest(dir, argList);
+		return;
+		}
+
+	const time_t now = time(NULL);
+
+	JIndex i = 1;
+	while (i <= itsConnectionList->GetElementCount())
+		{
+		Connection* connection = itsConnectionList->NthElement(i);
+		if (connection->argList == NULL &&
+			(connection->finished ||
+			 now - connection->startTime > (time_t) kMDIMaxWaitTime))
+			{
+			itsConnectionList->DeleteElement(i);
+			}
+		else
+			{
+			i++;
+			}
 		}
 }
 
@@ -300,102 +594,66 @@ JMDIServer::GetMDISocketName
 }
 
 /******************************************************************************
- SendLine (static private)
+ AppendLength (static private)
+
+	Appends a binary message header.
 
  ******************************************************************************/
 
 void
-JMDIServer::SendLine
+JMDIServer::AppendLength
 	(
-	ACE_LSOCK_Stream&	socket,
-	const JCharacter*	line
+	JString*		data,
+	const JUInt32	length
 	)
 {
-	socket.send_n(line, strlen(line));
-
-	JCharacter c = kEndOfLine;
-	socket.send_n(&c, 1);
+	const ACE_UINT32 header = ACE_HTONL(length);
+	data->Append((const JCharacter*) &header, JMessageProtocolT::kBinaryHeaderLength);
 }
 
 /******************************************************************************
- ReceiveLine (static private)
+ ReceiveReply (static private)
 
-	Returns kJFalse if the connection times out.
+	Returns kJFalse if the server closes the connection without replying.
+	Otherwise, waits for the disconnect, so the server never writes to a
+	closed socket.
 
  ******************************************************************************/
 
 JBoolean
-JMDIServer::ReceiveLine
+JMDIServer::ReceiveReply
 	(
 	ACE_LSOCK_Stream&	socket,
-	const JBoolean		block,
-	JString*			line,
-	JBoolean*			receivedFinishedFlag
+	JString*			reply
 	)
 {
-	line->Clear();
+	reply->Clear();
 
-	const ACE_Time_Value timeout(kMDIMaxWaitTime);
-	while (!(*receivedFinishedFlag))
+	ACE_UINT32 header;
+	if (socket.recv_n(&header, JMessageProtocolT::kBinaryHeaderLength) !=
+		JMessageProtocolT::kBinaryHeaderLength)
 		{
-		JCharacter c;
-		int result;
-		if (block)
-			{
-			result = socket.recv_n(&c, 1);
-			}
-		else
-			{
-			result = socket.recv(&c, 1, &timeout);
-			}
-
-		if (result == 1 && c == kEndOfLine)
-			{
-			return kJTrue;
-			}
-		else if ((result == 1 && c == kEndOfMessage) ||
-				 jerrno() == ETIME)
-			{
-			*receivedFinishedFlag = kJTrue;
-			return kJFalse;
-			}
-		else if (result == 1)
-			{
-			line->AppendCharacter(c);
-			}
+		return kJFalse;
 		}
 
-	return kJFalse;
-}
-
-/******************************************************************************
- WaitForFinished (static private)
-
-	This tosses all unread data.
-
- ******************************************************************************/
-
-void
-JMDIServer::WaitForFinished
-	(
-	ACE_LSOCK_Stream&	socket,
-	const JBoolean		receivedFinishedFlag
-	)
-{
-	// Tell the other end that we are finished.
-
-	JCharacter c = kEndOfMessage;
-	socket.send_n(&c, 1);
-
-	// To avoid a broken pipe error, we have to wait until they are also finished.
-	// We use recv() instead of recv_n() so we get -1 if the sender dies.
-	// (Note that this also returns if recv() returns -1.)
+	const JSize length = ACE_NTOHL(header);
+	if (length > kMDIMaxReplyLength)		// includes disconnect
+		{
+		return kJFalse;
+		}
 
-	if (!receivedFinishedFlag)
+	JCharacter data[ kMDIMaxReplyLength ];
+	if (socket.recv_n(data, length) != (ssize_t) length)
 		{
-		while (socket.recv(&c, 1) == 0 || c != kEndOfMessage)
-			{ };
+		return kJFalse;
 		}
 
-	socket.close();
+	reply->Set(data, length);
+
+	socket.recv_n(&header, JMessageProtocolT::kBinaryHeaderLength);
+	return kJTrue;
 }
+
+#define JTemplateType JMDIServer::Connection
+#include <JPtrArray.tmpls>
+#undef JTemplateType
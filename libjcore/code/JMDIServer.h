@@ -14,13 +14,14 @@
 #pragma once
 #endif
 
+#include <JBroadcaster.h>
 #include <JPtrArray.h>
 
 class JString;
 class ACE_LSOCK_Acceptor;
 class ACE_LSOCK_Stream;
 
-class JMDIServer
+class JMDIServer : virtual public JBroadcaster
 {
 public:
 
@@ -44,21 +45,33 @@ protected:
 	virtual void		HandleMDIRequest(const JCharacter* dir,
 										 const JPtrArray<JString>& argList) = 0;
 
+	virtual void	Receive(JBroadcaster* sender, const Message& message);
+
+public:
+
+	class AcceptHandler;
+	struct Connection;
+
+	friend class AcceptHandler;
+
 private:
 
-	ACE_LSOCK_Acceptor*	itsAcceptor;
-	ACE_LSOCK_Stream*	itsSocket;		// always closed before returning
+	ACE_LSOCK_Acceptor*		itsAcceptor;
+	AcceptHandler*			itsAcceptHandler;
+	JPtrArray<Connection>*	itsConnectionList;	// in the order they were accepted
+	JBoolean				itsIsHandlingFlag;	// kJTrue while inside HandleRequests()
 
 private:
 
-	void			ProcessMDIMessage();
-	static JString	GetMDISocketName(const JCharacter* signature);
+	void	AcceptConnections();
+	void	ReceiveRequest(Connection* connection, const JCharacter* data,
+						   const JSize length);
+	void	HandleRequests();
+	void	RemoveFinishedConnections();
 
-	static void		SendLine(ACE_LSOCK_Stream& socket, const JCharacter* line);
-	static JBoolean	ReceiveLine(ACE_LSOCK_Stream& socket, const JBoolean block,
-								JString* line, JBoolean* receivedFinishedFlag);
-	static void		WaitForFinished(ACE_LSOCK_Stream& socket,
-									const JBoolean receivedFinishedFlag);
+	static JString	GetMDISocketName(const JCharacter* signature);
+	static void		AppendLength(JString* data, const JUInt32 length);
+	static JBoolean	ReceiveReply(ACE_LSOCK_Stream& socket, JString* reply);
 
 	// not allowed
 
@@ -153,6 +153,32 @@
 #		                       and if you turn them on you likely want to print error
 #		                       messages).
 
+#		JMM_SAMPLE_INTERVAL    If this environment variable is set to a number N,
+#		                       the manager records the file and line of one in
+#		                       every N allocations, so it can report which parts
+#		                       of the program are using the heap.  This is much
+#		                       cheaper than JMM_RECORD_ALLOCATED and can be left
+#		                       on in production.  Each sample counts as N
+#		                       allocations, so the totals are estimates.
+
+#		JMM_SAMPLE_MIN_SIZE    If this environment variable is set to a number M,
+#		                       every allocation of at least M bytes is recorded
+#		                       in the heap profile, in addition to the samples
+#		                       selected by JMM_SAMPLE_INTERVAL.
+
+#		JMM_PROFILE_SIGNAL     If this environment variable is set to a signal
+#		                       number (normally SIGUSR1 or SIGUSR2), the heap
+#		                       profile is written when JThisProcess receives
+#		                       the signal.  It is only useful if one of the
+#		                       JMM_SAMPLE variables is also set.
+
+#		JMM_PROFILE_FILE       The file to which the heap profile is written
+#		                       when JMM_PROFILE_SIGNAL is received.  If it is
+#		                       not set, the profile is printed to cout.
+
+#		                       The heap profile is also printed at exit if
+#		                       JMM_PRINT_EXIT_STATS is set.
+
 	(JMM_NO_PRINT_ERRORS is actually read in the JMMErrorPrinter proxy object.)
 
 	Setting up so many variables can be a pain, and frequently writing a
@@ -206,6 +232,7 @@
 #include <ctype.h>
 #include <stdlib.h>
 #include <new>
+#include <iomanip>
 
 #include <JString.h>
 
@@ -214,6 +241,7 @@
 #include <JMMErrorPrinter.h>
 
 #include <ace/Synch.h>
+#include <jFStreamUtil.h>
 
 #include <jAssert.h>
 #undef new
@@ -259,6 +287,80 @@ extern void debug_free(void* ptr);
 
 	JBoolean      JMemoryManager::theAbortUnknownAllocFlag = kJFalse;
 
+	JBoolean          JMemoryManager::theSampleInitFlag  = kJFalse;
+	JBoolean          JMemoryManager::theSamplingFlag    = kJFalse;
+	JSize             JMemoryManager::theSampleInterval  = 0;
+	size_t            JMemoryManager::theSampleMinSize   = 0;
+	JBoolean          JMemoryManager::theProfileBusyFlag = kJFalse;
+	int               JMemoryManager::theProfileSignal   = 0;
+	const JCharacter* JMemoryManager::theProfileFileName = NULL;
+
+// Heap profile
+
+	// Sampled allocations are aggregated by allocation site.  The table
+	// has a fixed size so that recording a sample never allocates memory.
+	// Only claiming a new slot takes a lock; the counters are updated with
+	// atomic operations, so threads never wait for each other.
+
+	struct JMMSite
+	{
+		const JCharacter* volatile file;
+		JUInt32                    line;
+		volatile long              liveCount;
+		volatile long              liveBytes;
+		volatile long              totalCount;
+		long                       lastBytes;	// when profile was last printed
+	};
+
+	const JSize kSiteTableSize = 4096;
+	static JMMSite theSiteTable[ kSiteTableSize ];
+	static volatile long theSiteTableLock     = 0;
+	static volatile long theAllocationCounter = 0;
+
+	// When sampling, every block is preceded by a header, because
+	// Delete() must be able to tell whether the block was sampled.
+
+	struct JMMSampleHeader
+	{
+		size_t  size;
+		JUInt32 site;		// index into theSiteTable, 0 if not sampled
+		JUInt32 weight;		// number of allocations represented by this one
+	};
+
+	const size_t kSampleHeaderSize = 16;	// keeps blocks aligned for any type
+
+#if defined __GNUC__ && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 1))
+
+	inline long JMMAtomicAdd(volatile long* value, const long delta)
+	{
+		return __sync_add_and_fetch(value, delta);
+	}
+
+	inline void JMMLockSiteTable()
+	{
+		while (__sync_lock_test_and_set(&theSiteTableLock, 1))
+			{ }
+	}
+
+	inline void JMMUnlockSiteTable()
+	{
+		__sync_lock_release(&theSiteTableLock);
+	}
+
+#else
+
+	// not thread safe, but races only skew the statistics
+
+	inline long JMMAtomicAdd(volatile long* value, const long delta)
+	{
+		return (*value += delta);
+	}
+
+	inline void JMMLockSiteTable() { }
+	inline void JMMUnlockSiteTable() { }
+
+#endif
+
 	// Ordinary functions
 	void JMMHandleExit();
 	
@@ -452,6 +554,16 @@ JMemoryManager::New
 	return newBlock;
 #else
 	const size_t trueSize = size ? size : 1;
+
+	if (!theSampleInitFlag)
+		{
+		InitSampling();
+		}
+	if (theSamplingFlag)
+		{
+		return NewSampled(trueSize, file, line);
+		}
+
 #ifdef DEBUG_MALLOC
 	return debug_malloc(trueSize);
 #else
@@ -497,12 +609,329 @@ JMemoryManager::Delete
 	itsLastDeleteLine = 0;
 #else
 	if (block)
+		{
+		if (theSamplingFlag)
+			{
+			block = DeleteSampled(block);
+			}
 #ifdef DEBUG_MALLOC
 		debug_free(block);
 #else
 		free(block);
 #endif
+		}
+#endif
+}
+
+/******************************************************************************
+ InitSampling (private static)
+
+	Called before the first allocation, because the choice of whether or
+	not to add a header to each block must never change.  getenv() does not
+	allocate memory, so this is safe.
+
+ *****************************************************************************/
+
+void
+JMemoryManager::InitSampling()
+{
+	theSampleInitFlag = kJTrue;
+
+	const JCharacter* interval = getenv("JMM_SAMPLE_INTERVAL");
+	if (interval != NULL)
+		{
+		const long n = strtol(interval, NULL, 0);
+		if (n > 0)
+			{
+			theSampleInterval = n;
+			}
+		}
+
+	const JCharacter* minSize = getenv("JMM_SAMPLE_MIN_SIZE");
+	if (minSize != NULL)
+		{
+		const long n = strtol(minSize, NULL, 0);
+		if (n > 0)
+			{
+			theSampleMinSize = n;
+			}
+		}
+
+	theSamplingFlag = JI2B(theSampleInterval > 0 || theSampleMinSize > 0);
+	assert( sizeof(JMMSampleHeader) <= kSampleHeaderSize );
+
+	const JCharacter* sig = getenv("JMM_PROFILE_SIGNAL");
+	if (sig != NULL)
+		{
+		theProfileSignal = strtol(sig, NULL, 0);
+		}
+
+	theProfileFileName = getenv("JMM_PROFILE_FILE");
+}
+
+/******************************************************************************
+ NewSampled (private static)
+
+ *****************************************************************************/
+
+void*
+JMemoryManager::NewSampled
+	(
+	const size_t      size,
+	const JCharacter* file,
+	const JUInt32     line
+	)
+{
+#ifdef DEBUG_MALLOC
+	unsigned char* block = (unsigned char*) debug_malloc(kSampleHeaderSize + size);
+#else
+	unsigned char* block = (unsigned char*) malloc(kSampleHeaderSize + size);
 #endif
+	if (block == NULL)
+		{
+		return NULL;
+		}
+
+	JMMSampleHeader* header = (JMMSampleHeader*) block;
+	header->size   = size;
+	header->site   = 0;
+	header->weight = 0;
+
+	if (!theProfileBusyFlag)
+		{
+		if (theSampleMinSize > 0 && size >= theSampleMinSize)
+			{
+			header->weight = 1;
+			}
+		else if (theSampleInterval > 0 &&
+				 JMMAtomicAdd(&theAllocationCounter, 1) % theSampleInterval == 0)
+			{
+			header->weight = theSampleInterval;
+			}
+
+		if (header->weight > 0)
+			{
+			header->site = FindSite(file, line);
+			}
+
+		if (header->site > 0)
+			{
+			JMMSite* site = theSiteTable + header->site - 1;
+			JMMAtomicAdd(&(site->liveCount),  header->weight);
+			JMMAtomicAdd(&(site->liveBytes),  header->weight * size);
+			JMMAtomicAdd(&(site->totalCount), header->weight);
+			}
+		}
+
+	return block + kSampleHeaderSize;
+}
+
+/******************************************************************************
+ DeleteSampled (private static)
+
+	Returns the address that must be passed to free().
+
+ *****************************************************************************/
+
+void*
+JMemoryManager::DeleteSampled
+	(
+	void* block
+	)
+{
+	JMMSampleHeader* header =
+		(JMMSampleHeader*) (((unsigned char*) block) - kSampleHeaderSize);
+
+	if (header->site > 0)
+		{
+		JMMSite* site = theSiteTable + header->site - 1;
+		JMMAtomicAdd(&(site->liveCount), - (long) header->weight);
+		JMMAtomicAdd(&(site->liveBytes), - (long) (header->weight * header->size));
+		}
+
+	return header;
+}
+
+/******************************************************************************
+ FindSite (private static)
+
+	Returns the 1-based index of the entry for the given location, or zero
+	if the table is full.  Identical file names from different translation
+	units may have different addresses, so a location can appear more than
+	once.
+
+ *****************************************************************************/
+
+JIndex
+JMemoryManager::FindSite
+	(
+	const JCharacter* file,
+	const JUInt32     line
+	)
+{
+	const JUInt32 hash = ((JUInt32) (((size_t) file) >> 2)) * 2654435761U + line * 40503U;
+
+	for (JIndex i=0; i<kSiteTableSize; i++)
+		{
+		JMMSite* site = theSiteTable + (hash + i) % kSiteTableSize;
+
+		const JCharacter* f = site->file;
+		if (f == NULL)
+			{
+			JMMLockSiteTable();
+			if (site->file == NULL)
+				{
+				site->line = line;
+				site->file = file;
+				}
+			f = site->file;
+			JMMUnlockSiteTable();
+			}
+
+		if (f == file && site->line == line)
+			{
+			return (site - theSiteTable) + 1;
+			}
+		}
+
+	return 0;
+}
+
+/******************************************************************************
+ PrintHeapProfile
+
+	Prints the estimated number of bytes currently allocated at each site,
+	largest first.  Growth is measured from the previous call.
+
+ *****************************************************************************/
+
+static int
+JMMCompareSites
+	(
+	const void* s1,
+	const void* s2
+	)
+{
+	const long b1 = theSiteTable[ *((const JIndex*) s1) ].liveBytes;
+	const long b2 = theSiteTable[ *((const JIndex*) s2) ].liveBytes;
+	return (b1 > b2 ? -1 : b1 < b2 ? +1 : 0);
+}
+
+void
+JMemoryManager::PrintHeapProfile
+	(
+	ostream& output
+	)
+{
+	if (!theSamplingFlag)
+		{
+		output << "Heap profile is not available:  set JMM_SAMPLE_INTERVAL or JMM_SAMPLE_MIN_SIZE" << endl;
+		return;
+		}
+
+	theProfileBusyFlag = kJTrue;	// don't sample our own allocations
+
+	JIndex* list = (JIndex*) malloc(kSiteTableSize * sizeof(JIndex));
+	assert( list != NULL );
+
+	JSize count     = 0;
+	long totalBytes = 0, totalCount = 0;
+	for (JIndex i=0; i<kSiteTableSize; i++)
+		{
+		if (theSiteTable[i].file != NULL && theSiteTable[i].totalCount > 0)
+			{
+			list[ count++ ] = i;
+			totalBytes     += theSiteTable[i].liveBytes;
+			totalCount     += theSiteTable[i].liveCount;
+			}
+		}
+
+	qsort(list, count, sizeof(JIndex), JMMCompareSites);
+
+	output << "\n   Heap profile (estimated):\n";
+	output << "      Sampling: ";
+	if (theSampleInterval > 0)
+		{
+		output << "1 in " << theSampleInterval << " allocations";
+		if (theSampleMinSize > 0)
+			{
+			output << ", ";
+			}
+		}
+	if (theSampleMinSize > 0)
+		{
+		output << "all allocations of at least " << theSampleMinSize << " bytes";
+		}
+	output << "\n";
+	output << "      Live bytes: " << totalBytes << " in " << totalCount << " blocks\n\n";
+
+	output << "       live bytes   live blocks        growth  total blocks  site\n";
+	for (JIndex i=0; i<count; i++)
+		{
+		JMMSite* site = theSiteTable + list[i];
+		const long bytes = site->liveBytes;
+
+		output << std::setw(17) << bytes;
+		output << std::setw(14) << site->liveCount;
+		output << std::setw(14) << bytes - site->lastBytes;
+		output << std::setw(14) << site->totalCount;
+		output << "  " << site->file << ':' << site->line << '\n';
+
+		site->lastBytes = bytes;
+		}
+	output << endl;
+
+	free(list);
+	theProfileBusyFlag = kJFalse;
+}
+
+/******************************************************************************
+ WriteHeapProfile
+
+ *****************************************************************************/
+
+JBoolean
+JMemoryManager::WriteHeapProfile
+	(
+	const JCharacter* fileName
+	)
+{
+	ofstream output(fileName);
+	PrintHeapProfile(output);
+	return JI2B( output.good() );
+}
+
+/******************************************************************************
+ HandleProfileSignal
+
+	Called by JThisProcess.  If sig is the value of JMM_PROFILE_SIGNAL, the
+	heap profile is written to JMM_PROFILE_FILE and we return kJTrue.
+	This is static so other signals do not create the memory manager.
+
+ *****************************************************************************/
+
+JBoolean
+JMemoryManager::HandleProfileSignal
+	(
+	const int sig
+	)
+{
+	if (theProfileSignal == 0 || sig != theProfileSignal)
+		{
+		return kJFalse;
+		}
+
+	JMemoryManager* mgr = Instance();
+	if (JStringEmpty(theProfileFileName))
+		{
+		mgr->PrintHeapProfile(cout);
+		}
+	else if (!mgr->WriteHeapProfile(theProfileFileName))
+		{
+		cerr << "Unable to write heap profile to " << theProfileFileName << endl;
+		}
+
+	return kJTrue;
 }
 
 /******************************************************************************
@@ -746,6 +1175,11 @@ JMemoryManager::HandleExit()
 		PrintMemoryStats();
 
 		PrintAllocated();
+
+		if (theSamplingFlag)
+			{
+			PrintHeapProfile(cout);
+			}
 		}
 }
 
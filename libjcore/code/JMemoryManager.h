@@ -80,6 +80,15 @@ public:
 
 	void PrintAllocated() const;
 
+// Heap profile (sampling)
+
+	static JBoolean IsSampling();
+
+	void     PrintHeapProfile(ostream& output);
+	JBoolean WriteHeapProfile(const JCharacter* fileName);
+
+	static JBoolean HandleProfileSignal(const int sig);
+
 	// Error notification
 
 	JBoolean GetBroadcastErrors() const;
@@ -141,6 +150,14 @@ private:
 
 	static JBoolean      theAbortUnknownAllocFlag;
 
+	static JBoolean      theSampleInitFlag;
+	static JBoolean      theSamplingFlag;
+	static JSize         theSampleInterval;
+	static size_t        theSampleMinSize;
+	static JBoolean      theProfileBusyFlag;
+	static int           theProfileSignal;
+	static const JCharacter* theProfileFileName;
+
 // Member data
 
 	JMMErrorPrinter* itsErrorPrinter;
@@ -188,6 +205,11 @@ private:
 
 	void ReadValue(JBoolean* hasValue, unsigned char* value, const JCharacter* string);
 
+	static void   InitSampling();
+	static void*  NewSampled(const size_t size, const JCharacter* file, const JUInt32 line);
+	static void*  DeleteSampled(void* block);
+	static JIndex FindSite(const JCharacter* file, const JUInt32 line);
+
 	// not allowed
 
 	JMemoryManager(const JMemoryManager& source);
@@ -368,6 +390,19 @@ JMemoryManager::RecordingAllocated() const
 	return JConvertToBoolean(itsMemoryTable != NULL);
 }
 
+/******************************************************************************
+ IsSampling (static)
+
+	Returns kJTrue if allocations are being sampled for the heap profile.
+
+ *****************************************************************************/
+
+inline JBoolean
+JMemoryManager::IsSampling()
+{
+	return theSamplingFlag;
+}
+
 /******************************************************************************
  CancelRecordAllocated
 
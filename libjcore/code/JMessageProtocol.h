@@ -13,7 +13,9 @@
 #endif
 
 #include <JNetworkProtocolBase.h>
-#include <JPtrArray-JString.h>
+#include <JArray.h>
+#include <JIndexRange.h>
+#include <JString.h>
 
 class JMessageProtocolT
 {
@@ -33,11 +35,17 @@ public:
 	static const JCharacter* kStdDisconnectStr;
 	static const JSize kStdDisconnectLength;
 
+	// binary protocol:  each message is preceded by its length,
+	// as 4 bytes in network byte order
+
+	static const JUInt32 kBinaryDisconnectLength;
+
 	// Other constants
 
 	enum
 		{
-		kDefaultBufferSize = 1024
+		kBinaryHeaderLength = 4,
+		kDefaultBufferSize  = 16384
 		};
 
 public:
@@ -51,23 +59,50 @@ public:
 		{
 		public:
 
-			MessageReady(const JString& msg)
+			MessageReady(const JCharacter* data, const JSize length)
 				:
 				JBroadcaster::Message(kMessageReady),
-				itsMessage(msg)
+				itsData(data),
+				itsLength(length),
+				itsHasMessageFlag(kJFalse)
 				{ };
 
-			// This does not remove the message from the input queue.
+			// These do not remove the message from the input queue.  The
+			// data is not terminated, and it is only valid while the
+			// message is being broadcast.
+
+			const JCharacter*
+			GetData() const
+			{
+				return itsData;
+			};
+
+			JSize
+			GetLength() const
+			{
+				return itsLength;
+			};
+
+			// This copies the data the first time it is called.
 
 			const JString&
 			PeekMessage() const
 			{
+				if (!itsHasMessageFlag)
+					{
+					itsMessage.Set(itsData, itsLength);
+					itsHasMessageFlag = kJTrue;
+					}
 				return itsMessage;
 			};
 
 		private:
 
-			const JString& itsMessage;
+			const JCharacter*	itsData;
+			const JSize			itsLength;
+
+			mutable JString		itsMessage;
+			mutable JBoolean	itsHasMessageFlag;
 		};
 
 	class ReceivedDisconnect : public JBroadcaster::Message
@@ -99,6 +134,9 @@ public:
 	void	UseMacintoshProtocol();
 	void	UseDOSProtocol();
 
+	JBoolean	UsesBinaryProtocol() const;
+	void		UseBinaryProtocol();
+
 	JBoolean	ReceivedDisconnect() const;
 	void		SendDisconnect();
 
@@ -146,12 +184,17 @@ public:
 
 private:
 
-	JPtrArray<JString>*	itsMessageList;		// parsed messages, last one is incomplete
+	JCharacter*	itsData;					// received bytes, starting with the oldest unread message
+	JSize		itsDataSize;				// space allocated for itsData
+	JSize		itsDataLength;				// number of bytes in itsData
+	JIndex		itsPartialOffset;			// start of the message being received
+	JIndex		itsScanOffset;				// where to continue looking for separators
+	JSize		itsBufferSize;				// minimum free space for each recv()
 
-	JString		itsData;					// buffer containing unprocessed bytes
-	JCharacter*	itsBuffer;					// buffer to receive raw bytes
-	JSize		itsBufferSize;
+	JArray<JIndexRange>*	itsMessageList;	// complete messages in itsData
+	JIndex					itsNextMessageIndex;
 
+	JBoolean	itsBinaryFlag;				// kJTrue => length prefix instead of separator
 	JString		itsSeparatorStr;			// sent between messages
 	JString		itsDisconnectStr;			// can be empty; sent to terminate connection
 
@@ -162,10 +205,13 @@ private:
 private:
 
 	void		JMessageProtocolX();
-	JString*	NewMessage();
+	void		PrepareBuffer();
+	JBoolean	ParseTextMessages();
+	JBoolean	ParseBinaryMessages();
+	void		MessageReceived(const JIndex offset, const JSize length);
+	JIndex		FindSequence(const JIndex offset, const JString& sequence) const;
+	JSize		GetPartialMessageLength(JIndex* offset) const;
 
-	JBoolean	LocateSequence(const JString& data, const JString& sequence,
-							   JIndex* index, JBoolean* endsWithPartial);
 	JBoolean	LocateNextSequence(const JCharacter* d, const JSize dLength,
 								   const JString& sequence, JIndex* index,
 								   JBoolean* endsWithPartial);
@@ -14,10 +14,62 @@
 
 #include <ace/Svc_Handler.h>
 #include <ace/Synch_T.h>
+#include <JArray.h>
 #include <JString.h>
 
+class JNetworkProtocolBaseT
+{
+public:
+
+	// Other constants
+
+	enum
+		{
+		kBlockSize             = 16384,		// small sends are packed into blocks
+		kDefaultHighWatermark  = 1048576,
+		kDefaultLowWatermark   = 262144
+		};
+
+	// block in the output queue
+
+	struct Block
+	{
+		JCharacter*	data;
+		JSize		size;
+		JSize		length;
+	};
+
+public:
+
+	// Broadcaster messages
+
+	static const JCharacter* kHighWatermark;
+	static const JCharacter* kLowWatermark;
+
+	class HighWatermark : public JBroadcaster::Message
+		{
+		public:
+
+			HighWatermark()
+				:
+				JBroadcaster::Message(kHighWatermark)
+				{ };
+		};
+
+	class LowWatermark : public JBroadcaster::Message
+		{
+		public:
+
+			LowWatermark()
+				:
+				JBroadcaster::Message(kLowWatermark)
+				{ };
+		};
+};
+
 template <ACE_PEER_STREAM_1>
-class JNetworkProtocolBase : public ACE_Svc_Handler<ACE_PEER_STREAM_2, ACE_SYNCH>
+class JNetworkProtocolBase : public ACE_Svc_Handler<ACE_PEER_STREAM_2, ACE_SYNCH>,
+							 virtual public JBroadcaster
 {
 public:
 
@@ -26,6 +78,7 @@ public:
 	virtual ~JNetworkProtocolBase();
 
 	JBoolean	DataPending() const;
+	JSize		GetPendingByteCount() const;
 	void		Flush();
 
 	// whether data is sent synch or asynch
@@ -33,6 +86,18 @@ public:
 	JBoolean	WillSendSynch() const;
 	void		ShouldSendSynch(const JBoolean synch = kJTrue);
 
+	// when to broadcast HighWatermark and LowWatermark
+
+	void	GetWatermarks(JSize* low, JSize* high) const;
+	void	SetWatermarks(const JSize low, const JSize high);
+	JBoolean	IsAboveHighWatermark() const;
+
+	// statistics
+
+	JSize	GetSendCount() const;
+	JSize	GetSystemCallCount() const;
+	void	ResetSendStatistics();
+
 	// ACE_Svc_Handler functions
 
 	virtual int	handle_output(ACE_HANDLE);
@@ -46,11 +111,28 @@ protected:
 
 private:
 
-	JBoolean	itsSynchFlag;	// kJTrue => synch send
-	JString		itsData;		// data waiting to be sent
+	JBoolean	itsSynchFlag;		// kJTrue => synch send
+
+	JArray<JNetworkProtocolBaseT::Block>*	itsQueue;	// data waiting to be sent
+	JIndex		itsQueueOffset;		// bytes already sent from first block
+	JSize		itsQueueLength;		// bytes waiting to be sent
+	JCharacter*	itsSpareBlock;		// kBlockSize bytes, can be NULL
+
+	JSize		itsLowWatermark;
+	JSize		itsHighWatermark;
+	JBoolean	itsAboveHighFlag;	// kJTrue => broadcast HighWatermark
+	JBoolean	itsIsDeletingFlag;	// kJTrue => inside destructor, so don't broadcast
+
+	JSize		itsSendCount;		// calls to Send()
+	JSize		itsSystemCallCount;	// calls to send(), sendmsg(), etc.
 
 private:
 
+	void	Enqueue(const JCharacter* data, const JSize length);
+	void	Dequeue(const JSize length);
+	void	ClearQueue();
+	void	UpdateWatermark();
+
 	// not allowed
 
 	JNetworkProtocolBase(const JNetworkProtocolBase& source);
@@ -103,6 +103,15 @@ private:
 						GetFirstIndex() <= index && index <= GetLastIndex() );
 			};
 
+		protected:
+
+			void
+			SetRange(const JIndex firstIndex, const JSize count)
+			{
+				itsFirstIndex = firstIndex;
+				itsCount      = count;
+			};
+
 		private:
 
 			JIndex	itsFirstIndex;
@@ -123,6 +132,9 @@ public:
 				{ };
 
 			void	AdjustIndex(JIndex* index) const;
+
+			virtual JBroadcaster::Message*	Copy() const;
+			virtual JBoolean				Merge(const JBroadcaster::Message& next);
 		};
 
 	class ElementsRemoved : public ElementMessage
@@ -135,6 +147,9 @@ public:
 				{ };
 
 			JBoolean	AdjustIndex(JIndex* index) const;
+
+			virtual JBroadcaster::Message*	Copy() const;
+			virtual JBoolean				Merge(const JBroadcaster::Message& next);
 		};
 
 	// for JBroadcasters
@@ -209,6 +224,9 @@ public:
 				:
 				ElementMessage(kElementChanged, index, 1)
 				{ };
+
+			virtual JBroadcaster::Message*	Copy() const;
+			virtual JBoolean				Merge(const JBroadcaster::Message& next);
 		};
 
 	class Sorted : public JBroadcaster::Message
@@ -10,6 +10,7 @@
 #include <JCoreStdInc.h>
 #include <JOrderedSet.h>
 #include <JOrderedSetUtil.h>
+#include <jAssert.h>
 
 // JBroadcaster message types
 
@@ -75,3 +76,117 @@ JOrderedSetT::ElementsSwapped::AdjustIndex
 {
 	JAdjustIndexAfterSwap(itsIndex1, itsIndex2, index);
 }
+
+/******************************************************************************
+ Batching (virtual)
+
+	Insertions are merged if they form a single block.
+
+ ******************************************************************************/
+
+JBroadcaster::Message*
+JOrderedSetT::ElementsInserted::Copy()
+	const
+{
+	JBroadcaster::Message* m = new ElementsInserted(GetFirstIndex(), GetCount());
+	assert( m != NULL );
+	return m;
+}
+
+JBoolean
+JOrderedSetT::ElementsInserted::Merge
+	(
+	const JBroadcaster::Message& next
+	)
+{
+	if (next.Is(kElementsInserted))
+		{
+		const ElementsInserted* info =
+			dynamic_cast(const ElementsInserted*, &next);
+		assert( info != NULL );
+
+		if (GetFirstIndex() <= info->GetFirstIndex() &&
+			info->GetFirstIndex() <= GetLastIndex() + 1)
+			{
+			SetRange(GetFirstIndex(), GetCount() + info->GetCount());
+			return kJTrue;
+			}
+		}
+
+	return kJFalse;
+}
+
+/******************************************************************************
+ Batching (virtual)
+
+	Removals are merged if the elements were adjacent before the first
+	one was removed.
+
+ ******************************************************************************/
+
+JBroadcaster::Message*
+JOrderedSetT::ElementsRemoved::Copy()
+	const
+{
+	JBroadcaster::Message* m = new ElementsRemoved(GetFirstIndex(), GetCount());
+	assert( m != NULL );
+	return m;
+}
+
+JBoolean
+JOrderedSetT::ElementsRemoved::Merge
+	(
+	const JBroadcaster::Message& next
+	)
+{
+	if (next.Is(kElementsRemoved))
+		{
+		const ElementsRemoved* info =
+			dynamic_cast(const ElementsRemoved*, &next);
+		assert( info != NULL );
+
+		if (info->GetFirstIndex() <= GetFirstIndex() &&
+			GetFirstIndex() <= info->GetLastIndex() + 1)
+			{
+			SetRange(info->GetFirstIndex(), GetCount() + info->GetCount());
+			return kJTrue;
+			}
+		}
+
+	return kJFalse;
+}
+
+/******************************************************************************
+ Batching (virtual)
+
+	Recipients only look at the first index, so we only merge repeated
+	changes to the same element.
+
+ ******************************************************************************/
+
+JBroadcaster::Message*
+JOrderedSetT::ElementChanged::Copy()
+	const
+{
+	JBroadcaster::Message* m = new ElementChanged(GetFirstIndex());
+	assert( m != NULL );
+	return m;
+}
+
+JBoolean
+JOrderedSetT::ElementChanged::Merge
+	(
+	const JBroadcaster::Message& next
+	)
+{
+	if (next.Is(kElementChanged))
+		{
+		const ElementChanged* info =
+			dynamic_cast(const ElementChanged*, &next);
+		assert( info != NULL );
+
+		return JI2B( info->GetFirstIndex() == GetFirstIndex() );
+		}
+
+	return kJFalse;
+}
@@ -2,6 +2,9 @@
  JOutPipeStream.cpp
 
 	This class provides an ostream interface to the write end of a pipe.
+	Output is buffered, so remember to flush the stream (e.g., via endl)
+	when the other end needs to see it.  Pass zero for bufferSize to
+	write every insertion immediately.
 
 	BASE CLASS = ostream
 
@@ -22,12 +25,13 @@
 JOutPipeStream::JOutPipeStream
 	(
 	const int		fd,
-	const JBoolean	close
+	const JBoolean	close,
+	const JSize		bufferSize
 	)
 	:
 	ios(&itsBuffer),
 	ostream(&itsBuffer),
-	itsBuffer(fd, close)
+	itsBuffer(fd, close, bufferSize)
 {
 }
 
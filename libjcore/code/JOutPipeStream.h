@@ -20,7 +20,8 @@ class JOutPipeStream : public ostream
 {
 public:
 
-	JOutPipeStream(const int fd, const JBoolean close);
+	JOutPipeStream(const int fd, const JBoolean close,
+				   const JSize bufferSize = JOutPipeStreambuf<char>::kDefaultBufferSize);
 
 	virtual ~JOutPipeStream();
 
@@ -29,6 +30,15 @@ public:
 	JBoolean	WillClosePipe() const;
 	void		ShouldClosePipe(const JBoolean close = kJTrue);
 
+	JSize		GetBufferSize() const;
+	void		SetBufferSize(const JSize size);
+
+	JBoolean	WillBlock() const;
+	void		ShouldBlock(const JBoolean block);
+
+	JBoolean	HasPendingOutput() const;
+	JBoolean	FlushPendingOutput();
+
 private:
 
 	JOutPipeStreambuf<char>	itsBuffer;
@@ -63,4 +73,67 @@ JOutPipeStream::ShouldClosePipe
 	itsBuffer.ShouldClosePipe(close);
 }
 
+/******************************************************************************
+ Buffer size
+
+ *****************************************************************************/
+
+inline JSize
+JOutPipeStream::GetBufferSize()
+	const
+{
+	return itsBuffer.GetBufferSize();
+}
+
+inline void
+JOutPipeStream::SetBufferSize
+	(
+	const JSize size
+	)
+{
+	itsBuffer.SetBufferSize(size);
+}
+
+/******************************************************************************
+ Blocking
+
+ *****************************************************************************/
+
+inline JBoolean
+JOutPipeStream::WillBlock()
+	const
+{
+	return itsBuffer.WillBlock();
+}
+
+inline void
+JOutPipeStream::ShouldBlock
+	(
+	const JBoolean block
+	)
+{
+	itsBuffer.ShouldBlock(block);
+}
+
+/******************************************************************************
+ Pending output
+
+	Call FlushPendingOutput() from the event loop until HasPendingOutput()
+	returns kJFalse.  This is only necessary if the pipe is non-blocking.
+
+ *****************************************************************************/
+
+inline JBoolean
+JOutPipeStream::HasPendingOutput()
+	const
+{
+	return itsBuffer.HasPendingOutput();
+}
+
+inline JBoolean
+JOutPipeStream::FlushPendingOutput()
+{
+	return itsBuffer.FlushPendingOutput();
+}
+
 #endif
@@ -17,9 +17,15 @@ public:
 
 	typedef typename std::basic_streambuf<_CharT, _Traits>::int_type int_type;
 
+	enum
+	{
+		kDefaultBufferSize = 8192
+	};
+
 public:
 
-	JOutPipeStreambuf(const int fd, const JBoolean close);
+	JOutPipeStreambuf(const int fd, const JBoolean close,
+					  const JSize bufferSize = kDefaultBufferSize);
 
 	virtual	~JOutPipeStreambuf();
 
@@ -28,15 +34,34 @@ public:
 	JBoolean	WillClosePipe() const;
 	void		ShouldClosePipe(const JBoolean close = kJTrue);
 
+	JSize		GetBufferSize() const;
+	void		SetBufferSize(const JSize size);
+
+	JBoolean	WillBlock() const;
+	void		ShouldBlock(const JBoolean block);
+
+	JBoolean	HasPendingOutput() const;
+	JBoolean	FlushPendingOutput();
+
 protected:
 
 	virtual std::streamsize	xsputn(const _CharT* s, std::streamsize n);
 	virtual int_type		overflow(int_type c);
+	virtual int				sync();
 
 private:
 
 	const int	itsDescriptor;
-	JBoolean	itsCloseFlag;	// kJTrue => close when we are destructed
+	JBoolean	itsCloseFlag;		// kJTrue => close when we are destructed
+	_CharT*		itsBuffer;
+	JSize		itsBufferSize;		// 0 => unbuffered
+	JSize		itsBufferCapacity;	// larger than itsBufferSize while output is pending
+
+private:
+
+	JBoolean	Write(const _CharT* s, const JSize n, const JBoolean wait);
+	void		Reserve(const JSize capacity);
+	void		ResetPutArea(const JSize pending);
 };
 
 #endif
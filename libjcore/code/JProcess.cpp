@@ -4,7 +4,12 @@
 	Class to represent a UNIX process.
 
 	Event loops can call CheckForFinishedChild(kJFalse) in order to
-	receive JBroadcaster messages when child processes finish.
+	receive JBroadcaster messages when child processes finish.  Every
+	finished child is reaped, so it is enough to call it once after
+	JThisProcess::ChildProcessFinished() returns kJTrue.
+
+	The objects are kept in a hash table keyed by pid, so finding the
+	objects for a finished child does not depend on how many others exist.
 
 	BASE CLASS = virtual JBroadcaster
 
@@ -14,6 +19,8 @@
 
 #include <JCoreStdInc.h>
 #include <JThisProcess.h>
+#include <JMinMax.h>
+#include <string.h>
 #include <jAssert.h>
 
 // JBroadcaster message types
@@ -22,7 +29,11 @@ const JCharacter* JProcess::kFinished = "Finished::JProcess";
 
 // static data
 
-JPtrArray<JProcess>	JProcess::theProcessList(JPtrArrayT::kForgetAll);
+JProcess**	JProcess::theProcessHash     = NULL;
+JSize		JProcess::theProcessHashSize = 0;
+JSize		JProcess::theProcessCount    = 0;
+
+const JSize kMinProcessHashSize = 64;
 
 /******************************************************************************
  Create (static)
@@ -133,25 +144,13 @@ JProcess::JProcess
 	itsIsFinishedFlag = kJFalse;
 	itsFinishedStatus = 0;
 	itsAutoDeleteFlag = kJFalse;
+	itsNextProcess    = NULL;
 
-	theProcessList.SetCompareFunction(ComparePID);
-	theProcessList.InsertSorted(this, kJTrue);
+	AddToHash(this);
 
 	JThisProcess::QuitAtExit(this, kJTrue);
 }
 
-// private -- used only by CheckForFinishedChild()
-//			  to avoid adding temporary object to theProcessList
-
-JProcess::JProcess
-	(
-	const pid_t	pid,
-	const int	x
-	)
-{
-	itsPID = pid;
-}
-
 /******************************************************************************
  Destructor
 
@@ -159,7 +158,7 @@ JProcess::JProcess
 
 JProcess::~JProcess()
 {
-	theProcessList.Remove(this);
+	RemoveFromHash(this);
 	JThisProcess::QuitAtExit(this, kJFalse);
 	JThisProcess::KillAtExit(this, kJFalse);
 }
@@ -246,8 +245,9 @@ JProcess::WaitUntilFinished()
 /******************************************************************************
  CheckForFinishedChild (static)
 
-	Checks if a child has finished.  If one has, an a JProcess object
-	exists for it, then tell it to Broadcast().
+	Reaps every child that has finished.  For each one, tells all the
+	JProcess objects with its pid to Broadcast().  If block is kJTrue,
+	waits until at least one child has finished.
 
  ******************************************************************************/
 
@@ -257,79 +257,180 @@ JProcess::CheckForFinishedChild
 	const JBoolean block
 	)
 {
-	pid_t pid;
-	ACE_exitcode status;
-	const JError err = JWaitForChild(block, &pid, &status);
-	if (err.OK() && pid > 0)
+	JBoolean wait = block;
+	while (1)
 		{
-		theProcessList.SetCompareFunction(ComparePID);
-
-		JProcess target(pid, 0);
-		JIndex i;
-		if (theProcessList.SearchSorted(&target, JOrderedSetT::kFirstMatch, &i))
+		pid_t pid;
+		ACE_exitcode status;
+		const JError err = JWaitForChild(wait, &pid, &status);
+		if (!err.OK() || pid <= 0)
 			{
-			// Broadcast message from each JProcess object with the
-			// given pid.  There could be more than one!
+			break;
+			}
 
-			// Since theProcessList may be changed by code in some Receive(),
-			// we first collect all the objects that need to broadcast,
-			// and then we tell each one to broadcast.
+		BroadcastFinished(pid, status);
+		wait = kJFalse;
+		}
+}
 
-			JPtrArray<JProcess> list(JPtrArrayT::kForgetAll);
-			const JSize processCount = theProcessList.GetElementCount();
-			while (i <= processCount)
-				{
-				JProcess* p = theProcessList.NthElement(i);
-				if (p->GetPID() != pid)
-					{
-					break;
-					}
-
-				list.Append(p);
-				i++;
-				}
+/******************************************************************************
+ BroadcastFinished (static private)
 
-			const JSize bcastCount = list.GetElementCount();
-			for (i=1; i<=bcastCount; i++)
-				{
-				JProcess* p = list.NthElement(i);
-				const JBoolean autoDelete = p->itsAutoDeleteFlag;	// save since Broadcast() might delete it
-				p->itsIsFinishedFlag = kJTrue;
-				p->itsFinishedStatus = status;
-				p->Broadcast(Finished(status));
-				if (autoDelete)
-					{
-					delete p;
-					}
-				}
+	Broadcast message from each JProcess object with the given pid.
+	There could be more than one!
+
+ ******************************************************************************/
+
+void
+JProcess::BroadcastFinished
+	(
+	const pid_t			pid,
+	const ACE_exitcode	status
+	)
+{
+	if (theProcessHash == NULL)
+		{
+		return;
+		}
+
+	// Since the hash table may be changed by code in some Receive(),
+	// we first collect all the objects that need to broadcast, and
+	// then we tell each one to broadcast.
+
+	JPtrArray<JProcess> list(JPtrArrayT::kForgetAll);
+
+	const JIndex h = ((JIndex) pid) & (theProcessHashSize - 1);
+	for (JProcess* p = theProcessHash[h]; p != NULL; p = p->itsNextProcess)
+		{
+		if (p->itsPID == pid)
+			{
+			list.Append(p);
+			}
+		}
+
+	const JSize count = list.GetElementCount();
+	for (JIndex i=1; i<=count; i++)
+		{
+		JProcess* p = list.NthElement(i);
+		const JBoolean autoDelete = p->itsAutoDeleteFlag;	// save since Broadcast() might delete it
+		p->itsIsFinishedFlag = kJTrue;
+		p->itsFinishedStatus = status;
+		p->Broadcast(Finished(status));
+		if (autoDelete)
+			{
+			delete p;
 			}
 		}
 }
 
 /******************************************************************************
- ComparePID (static private)
+ AddToHash (static private)
+
+	Objects with the same pid stay in the order in which they were
+	created.
 
  ******************************************************************************/
 
-JOrderedSetT::CompareResult
-JProcess::ComparePID
+void
+JProcess::AddToHash
 	(
-	JProcess* const & p1,
-	JProcess* const & p2
+	JProcess* p
 	)
 {
-	if (p1->GetPID() > p2->GetPID())
+	if (theProcessCount >= theProcessHashSize)
 		{
-		return JOrderedSetT::kFirstGreaterSecond;
+		ResizeHash(JMax(kMinProcessHashSize, 2 * theProcessHashSize));
 		}
-	else if (p1->GetPID() < p2->GetPID())
+
+	JProcess** q = theProcessHash + (((JIndex) p->itsPID) & (theProcessHashSize - 1));
+	while (*q != NULL)
 		{
-		return JOrderedSetT::kFirstLessSecond;
+		q = &((*q)->itsNextProcess);
 		}
-	else
+
+	*q                = p;
+	p->itsNextProcess = NULL;
+	theProcessCount++;
+}
+
+/******************************************************************************
+ RemoveFromHash (static private)
+
+ ******************************************************************************/
+
+void
+JProcess::RemoveFromHash
+	(
+	JProcess* p
+	)
+{
+	if (theProcessHash == NULL)
+		{
+		return;
+		}
+
+	JProcess** q = theProcessHash + (((JIndex) p->itsPID) & (theProcessHashSize - 1));
+	while (*q != NULL)
+		{
+		if (*q == p)
+			{
+			*q = p->itsNextProcess;
+			theProcessCount--;
+			break;
+			}
+		q = &((*q)->itsNextProcess);
+		}
+}
+
+/******************************************************************************
+ ResizeHash (static private)
+
+	pids are usually allocated sequentially, so the low bits are a good
+	hash.  Each chain keeps its order, because the objects are moved in
+	order.
+
+ ******************************************************************************/
+
+void
+JProcess::ResizeHash
+	(
+	const JSize size
+	)
+{
+	JProcess** newHash = new JProcess* [ size ];
+	assert( newHash != NULL );
+	memset(newHash, 0, size * sizeof(JProcess*));
+
+	JProcess** tail = new JProcess* [ size ];
+	assert( tail != NULL );
+	memset(tail, 0, size * sizeof(JProcess*));
+
+	for (JIndex i=0; i<theProcessHashSize; i++)
 		{
-		return JOrderedSetT::kFirstEqualSecond;
+		JProcess* p = theProcessHash[i];
+		while (p != NULL)
+			{
+			JProcess* next    = p->itsNextProcess;
+			const JIndex h    = ((JIndex) p->itsPID) & (size - 1);
+			p->itsNextProcess = NULL;
+			if (tail[h] == NULL)
+				{
+				newHash[h] = p;
+				}
+			else
+				{
+				tail[h]->itsNextProcess = p;
+				}
+			tail[h] = p;
+			p       = next;
+			}
 		}
+
+	delete [] tail;
+	delete [] theProcessHash;
+
+	theProcessHash     = newHash;
+	theProcessHashSize = size;
 }
 
 #define JTemplateType JProcess
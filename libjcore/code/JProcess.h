@@ -90,15 +90,18 @@ private:
 	JBoolean	itsIsFinishedFlag;
 	int			itsFinishedStatus;
 	JBoolean	itsAutoDeleteFlag;	// kJTrue => delete when process is finished
+	JProcess*	itsNextProcess;		// next object in the same hash bucket
 
-	static JPtrArray<JProcess>	theProcessList;		// sorted by pid
+	static JProcess**	theProcessHash;		// chains of objects, hashed by pid
+	static JSize		theProcessHashSize;	// power of 2
+	static JSize		theProcessCount;
 
 private:
 
-	JProcess(const pid_t pid, const int x);
-
-	static JOrderedSetT::CompareResult
-		ComparePID(JProcess* const & p1, JProcess* const & p2);
+	static void	AddToHash(JProcess* p);
+	static void	RemoveFromHash(JProcess* p);
+	static void	ResizeHash(const JSize size);
+	static void	BroadcastFinished(const pid_t pid, const ACE_exitcode status);
 
 	// not allowed
 
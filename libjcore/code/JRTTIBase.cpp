@@ -10,6 +10,12 @@
 	mistype the constant, the compiler will complain.  If they mistype the
 	string, it will be a very subtle bug.
 
+	GetTypeID() maps each type string to a small integer, starting at 1.
+	Strings with the same characters get the same ID, even if they are
+	stored at different addresses.  This makes it possible to look up
+	the handler for a message in an array instead of comparing strings.
+	Like JBroadcaster, the IDs may only be used on the main thread.
+
 	BASE CLASS = none
 
 	Copyright  1997 by John Lindal. All rights reserved.
@@ -21,6 +27,24 @@
 #include <string.h>
 #include <jAssert.h>
 
+// type ID tables -- plain data, so they can be used during static init
+
+struct JRTTITypeSlot
+{
+	const JCharacter*	type;
+	JIndex				id;
+};
+
+static JRTTITypeSlot*		theTypeSlotList  = NULL;	// open hash, keyed on the pointer
+static JSize				theTypeSlotSize  = 0;		// power of 2
+static JSize				theTypeSlotCount = 0;
+static const JCharacter**	theTypeList      = NULL;	// first string seen for each ID
+static JSize				theTypeListSize  = 0;
+static JSize				theTypeCount     = 0;
+
+static JIndex	jFindTypeString(const JCharacter* type);
+static void		jInsertTypeSlot(const JCharacter* type, const JIndex id);
+
 /******************************************************************************
  Destructor
 
@@ -31,19 +55,146 @@ JRTTIBase::~JRTTIBase()
 }
 
 /******************************************************************************
- Is
+ IsSameString (private)
 
-	Returns kJTrue if we are of the given type.
+	Called by Is() when the pointers differ.  type must not be NULL, which
+	would mean that a static constant was used before it was initialized.
+	jAssert.h cannot be included in the header, so the check is here.
 
  ******************************************************************************/
 
 JBoolean
-JRTTIBase::Is
+JRTTIBase::IsSameString
 	(
 	const JCharacter* type
 	)
 	const
 {
-	assert( type != NULL );	// make sure static constant was initialized
-	return JI2B( type == itsType || strcmp(type, itsType) == 0 );
+	assert( type != NULL );
+	return JI2B( strcmp(type, itsType) == 0 );
+}
+
+/******************************************************************************
+ GetTypeID (static)
+
+	Returns the ID of the given type string, assigning a new one if it has
+	not been seen before.  Each address is looked up by pointer after the
+	first time, so type should be a static constant.
+
+ ******************************************************************************/
+
+JIndex
+JRTTIBase::GetTypeID
+	(
+	const JCharacter* type
+	)
+{
+	assert( type != NULL );
+
+	if (theTypeSlotSize > 0)
+		{
+		JIndex i = (((unsigned long) type) >> 3) & (theTypeSlotSize - 1);
+		while (theTypeSlotList[i].type != NULL)
+			{
+			if (theTypeSlotList[i].type == type)
+				{
+				return theTypeSlotList[i].id;
+				}
+			i = (i+1) & (theTypeSlotSize - 1);
+			}
+		}
+
+	const JIndex id = jFindTypeString(type);
+	jInsertTypeSlot(type, id);
+	return id;
+}
+
+/******************************************************************************
+ jFindTypeString (local)
+
+	Called once for each new address.  Returns the ID of the string, or
+	assigns the next one.
+
+ ******************************************************************************/
+
+JIndex
+jFindTypeString
+	(
+	const JCharacter* type
+	)
+{
+	for (JIndex i=0; i<theTypeCount; i++)
+		{
+		if (strcmp(theTypeList[i], type) == 0)
+			{
+			return i+1;
+			}
+		}
+
+	if (theTypeCount >= theTypeListSize)
+		{
+		const JSize newSize = (theTypeListSize == 0 ? 64 : 2 * theTypeListSize);
+
+		const JCharacter** newList = new const JCharacter* [ newSize ];
+		assert( newList != NULL );
+		if (theTypeCount > 0)
+			{
+			memcpy(newList, theTypeList, theTypeCount * sizeof(const JCharacter*));
+			}
+
+		delete [] theTypeList;
+		theTypeList     = newList;
+		theTypeListSize = newSize;
+		}
+
+	theTypeList[ theTypeCount ] = type;
+	theTypeCount++;
+	return theTypeCount;
+}
+
+/******************************************************************************
+ jInsertTypeSlot (local)
+
+	The table is kept at most half full, so the probe sequences stay short.
+
+ ******************************************************************************/
+
+void
+jInsertTypeSlot
+	(
+	const JCharacter*	type,
+	const JIndex		id
+	)
+{
+	if (2 * (theTypeSlotCount + 1) > theTypeSlotSize)
+		{
+		JRTTITypeSlot* oldList = theTypeSlotList;
+		const JSize oldSize    = theTypeSlotSize;
+
+		theTypeSlotSize = (oldSize == 0 ? 128 : 2 * oldSize);
+		theTypeSlotList = new JRTTITypeSlot [ theTypeSlotSize ];
+		assert( theTypeSlotList != NULL );
+		memset(theTypeSlotList, 0, theTypeSlotSize * sizeof(JRTTITypeSlot));
+
+		theTypeSlotCount = 0;
+		for (JIndex i=0; i<oldSize; i++)
+			{
+			if (oldList[i].type != NULL)
+				{
+				jInsertTypeSlot(oldList[i].type, oldList[i].id);
+				}
+			}
+
+		delete [] oldList;
+		}
+
+	JIndex i = (((unsigned long) type) >> 3) & (theTypeSlotSize - 1);
+	while (theTypeSlotList[i].type != NULL)
+		{
+		i = (i+1) & (theTypeSlotSize - 1);
+		}
+
+	theTypeSlotList[i].type = type;
+	theTypeSlotList[i].id   = id;
+	theTypeSlotCount++;
 }
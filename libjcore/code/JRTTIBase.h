@@ -30,18 +30,72 @@ public:
 		return itsType;
 	};
 
+	JIndex			GetTypeID() const;
+	static JIndex	GetTypeID(const JCharacter* type);
+
 protected:
 
 	JRTTIBase(const JCharacter* type)
 		:
-		itsType(type)
+		itsType(type),
+		itsTypeID(0)
 	{ };
 
 private:
 
-	const JCharacter* itsType;
+	const JCharacter*	itsType;
+	mutable JIndex		itsTypeID;	// 0 until GetTypeID() is called
+
+private:
+
+	JBoolean	IsSameString(const JCharacter* type) const;
 };
 
+/******************************************************************************
+ Is
+
+	Returns kJTrue if we are of the given type.
+
+	Type strings are normally static constants, so comparing the pointers
+	is the fast path.  A NULL type is passed to IsSameString(), which
+	asserts.
+
+ ******************************************************************************/
+
+inline JBoolean
+JRTTIBase::Is
+	(
+	const JCharacter* type
+	)
+	const
+{
+	if (type == NULL)
+		{
+		return IsSameString(type);
+		}
+
+	return JI2B( type == itsType || (*type == *itsType && IsSameString(type)) );
+}
+
+/******************************************************************************
+ GetTypeID
+
+	Returns a small integer that identifies our type.  It is looked up the
+	first time it is needed and then remembered.
+
+ ******************************************************************************/
+
+inline JIndex
+JRTTIBase::GetTypeID()
+	const
+{
+	if (itsTypeID == 0)
+		{
+		itsTypeID = GetTypeID(itsType);
+		}
+	return itsTypeID;
+}
+
 /******************************************************************************
  Comparison operators
 
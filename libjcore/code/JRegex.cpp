@@ -667,6 +667,61 @@ JRegex::MatchWithin
 	return RegExec(str, range.first-1, range.last, &r, NULL);
 }
 
+/******************************************************************************
+ Match (JStringView)
+
+	These work like the versions that take JCharacter*, but they use the
+	length of the view instead of calling strlen(), so the view can be
+	part of a larger string and it can contain NULLs.  The ranges are
+	relative to the start of the view.
+
+	As with MatchWithin(), the character after the view must be readable.
+	This is always true for JString::GetView().  With PCRE, $ matches at
+	the end of the view.  With the old regex library, it only matches
+	there if the next character is a newline or the termination.
+
+ *****************************************************************************/
+
+JBoolean
+JRegex::Match
+	(
+	const JStringView& str
+	)
+	const
+{
+	JIndexRange r;
+	return RegExec(str.GetCharacters(), 0, str.GetLength(), &r, NULL);
+}
+
+JBoolean
+JRegex::Match
+	(
+	const JStringView&	str,
+	JIndexRange*		match
+	)
+	const
+{
+	assert( match != NULL );
+	assert( !IsMatchOnly() );
+
+	return RegExec(str.GetCharacters(), 0, str.GetLength(), match, NULL);
+}
+
+JBoolean
+JRegex::Match
+	(
+	const JStringView&		str,
+	JArray<JIndexRange>*	subMatchList
+	)
+	const
+{
+	assert( subMatchList != NULL );
+	assert( !IsMatchOnly() );
+
+	JIndexRange r;
+	return RegExec(str.GetCharacters(), 0, str.GetLength(), &r, subMatchList);
+}
+
 /******************************************************************************
 
  	Iterator versions
@@ -1766,8 +1821,13 @@ JRegex::RegComp()
 /******************************************************************************
  RegExec (private)
 
+	Small match arrays are kept on the stack, so a simple match does not
+	allocate anything.
+
  *****************************************************************************/
 
+const JSize kStackMatchCount = 30;
+
 inline JIndexRange
 jMakeIndexRange
 	(
@@ -1805,6 +1865,8 @@ JRegex::RegExec
 	regmatch_t* pmatch   = NULL;
 	JSize nmatch         = 1;
 
+	regmatch_t stackMatch [ kStackMatchCount ];
+
 #ifdef PCRE_MAJOR
 	nmatch = (subCount+1)*3;
 #else
@@ -1814,8 +1876,15 @@ JRegex::RegExec
 		}
 #endif
 
-	pmatch = new regmatch_t[ nmatch ];
-	assert( pmatch != NULL );
+	if (nmatch <= kStackMatchCount)
+		{
+		pmatch = stackMatch;
+		}
+	else
+		{
+		pmatch = new regmatch_t[ nmatch ];
+		assert( pmatch != NULL );
+		}
 
 #ifdef PCRE_MAJOR
 	int returnCode = pcre_exec(itsRegex, NULL, str, length, offset,
@@ -1846,6 +1915,7 @@ JRegex::RegExec
 	const int returnCode = regexec(&itsRegex, str, nmatch, pmatch, eFlags);
 #endif
 
+	JBoolean found = kJFalse;
 	if (returnCode == 0)
 		{
 		*matchRange = jMakeIndexRange(pmatch[0]);
@@ -1865,7 +1935,7 @@ JRegex::RegExec
 				}
 			}
 
-		return kJTrue;
+		found = kJTrue;
 		}
 	else if (returnCode == REG_NOMATCH)
 		{
@@ -1878,13 +1948,18 @@ JRegex::RegExec
 			matchList->RemoveAll();
 			}
 */
-		return kJFalse;
 		}
 	else
 		{
 		assert( 0 );	// unexpected error
-		return kJFalse;
 		}
+
+	if (pmatch != stackMatch)
+		{
+		delete [] pmatch;
+		}
+
+	return found;
 }
 
 /******************************************************************************
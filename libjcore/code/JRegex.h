@@ -102,6 +102,11 @@ public:
 	// Count all matches
 	JSize    MatchAll(const JCharacter* str) const;
 
+	// Match a view, without copying it
+	JBoolean Match(const JStringView& str) const;
+	JBoolean Match(const JStringView& str, JIndexRange* match) const;
+	JBoolean Match(const JStringView& str, JArray<JIndexRange>* subMatchList) const;
+
 // These versions return the overall match ranges
 
 	// First match
@@ -0,0 +1,646 @@
+/******************************************************************************
+ JStaticStringTable.cpp
+
+	Read-only table of id -> string pairs stored in a compact binary format
+	that can be compiled into a program or memory mapped from a file.
+	Lookups use a minimal perfect hash, so they touch only a few bytes of
+	the table, and no strings are copied until the caller asks for them.
+
+	The format is:  (all integers are 4 bytes, least significant byte first)
+
+		"JSTB"
+		count			number of strings
+		bucketCount
+		seed[bucketCount]
+		offset[count]	position of each slot's entry, relative to "JSTB"
+		entries:		idLength valueLength id\0 value\0
+
+	An id hashes with seed 0 to select a bucket.  The bucket's seed then
+	hashes the id to its slot.  Write() chooses the seeds so every id gets
+	its own slot.  Since any string hashes to some slot, lookups always
+	compare the id stored in the slot.
+
+	GetString() converts each string to a JString the first time it is
+	requested and keeps it until the table is deleted.  This is the only
+	state that changes after construction, so it is protected by a lock.
+
+	BASE CLASS = none
+
+ ******************************************************************************/
+
+#include <JCoreStdInc.h>
+#include <JStaticStringTable.h>
+#include <JString.h>
+#include <jStreamUtil.h>
+#include <ace/Mem_Map.h>
+#include <string.h>
+#include <jAssert.h>
+
+#if defined ACE_HAS_THREADS && ACE_MT_SAFE
+#define J_STRING_TABLE_LOCK
+#include <ace/Thread_Mutex.h>
+#include <ace/Guard_T.h>
+#endif
+
+static const JCharacter* kMagic = "JSTB";
+
+const JSize kMagicLength     = 4;
+const JSize kHeaderSize      = kMagicLength + 2*4;
+const JSize kEntryHeaderSize = 2*4;
+const JSize kKeysPerBucket   = 4;
+
+/******************************************************************************
+ Constructor
+
+	The data is not copied, so it must remain valid for the lifetime of
+	the object.  This is intended for tables compiled into the program.
+
+ ******************************************************************************/
+
+JStaticStringTable::JStaticStringTable
+	(
+	const unsigned char*	data,
+	const JSize				length
+	)
+	:
+	itsData(data),
+	itsLength(length),
+	itsOwnedData(NULL),
+	itsMemMap(NULL)
+{
+	Init();
+}
+
+// private
+
+JStaticStringTable::JStaticStringTable
+	(
+	unsigned char*	data,
+	const JSize		length,
+	ACE_Mem_Map*	map
+	)
+	:
+	itsData(data),
+	itsLength(length),
+	itsOwnedData(map == NULL ? data : NULL),
+	itsMemMap(map)
+{
+	Init();
+}
+
+/******************************************************************************
+ Create (static)
+
+	Memory maps the given file.  The table starts offset bytes into the
+	file.  Returns kJFalse if the file could not be mapped or does not
+	contain a valid table.
+
+ ******************************************************************************/
+
+JBoolean
+JStaticStringTable::Create
+	(
+	const JCharacter*		fileName,
+	const JSize				offset,
+	JStaticStringTable**	table
+	)
+{
+	*table = NULL;
+
+	ACE_Mem_Map* map = new ACE_Mem_Map;
+	assert( map != NULL );
+
+	if (map->map(fileName, -1, O_RDONLY, ACE_DEFAULT_FILE_PERMS,
+				 PROT_READ, ACE_MAP_PRIVATE) == -1 ||
+		map->size() < offset)
+		{
+		delete map;
+		return kJFalse;
+		}
+
+	*table = new JStaticStringTable(((unsigned char*) map->addr()) + offset,
+									map->size() - offset, map);
+	assert( *table != NULL );
+
+	if (!(**table).IsValid())
+		{
+		delete *table;
+		*table = NULL;
+		}
+	return JI2B( *table != NULL );
+}
+
+/******************************************************************************
+ Create (static)
+
+	Reads the rest of the stream into memory.  Use this only when the data
+	does not come from a file.
+
+ ******************************************************************************/
+
+JBoolean
+JStaticStringTable::Create
+	(
+	istream&				input,
+	JStaticStringTable**	table
+	)
+{
+	*table = NULL;
+
+	JString data;
+	JReadAll(input, &data);
+
+	const JSize length  = data.GetLength();
+	unsigned char* copy = new unsigned char [ length ];
+	assert( copy != NULL );
+	memcpy(copy, data.GetCString(), length);
+
+	*table = new JStaticStringTable(copy, length, NULL);
+	assert( *table != NULL );
+
+	if (!(**table).IsValid())
+		{
+		delete *table;
+		*table = NULL;
+		}
+	return JI2B( *table != NULL );
+}
+
+/******************************************************************************
+ Destructor
+
+ ******************************************************************************/
+
+JStaticStringTable::~JStaticStringTable()
+{
+	if (itsStringList != NULL)
+		{
+		for (JIndex i=0; i<itsCount; i++)
+			{
+			delete itsStringList[i];
+			}
+		delete [] itsStringList;
+		}
+
+#ifdef J_STRING_TABLE_LOCK
+	delete itsStringLock;
+#endif
+
+	delete [] itsOwnedData;
+	delete itsMemMap;
+}
+
+/******************************************************************************
+ Init (private)
+
+	Checks that the header is consistent with the amount of data.  Entries
+	are checked when they are accessed, so mapped files are not paged in.
+
+ ******************************************************************************/
+
+void
+JStaticStringTable::Init()
+{
+	itsCount       = 0;
+	itsBucketCount = 0;
+	itsStringList  = NULL;
+	itsStringLock  = NULL;
+
+#ifdef J_STRING_TABLE_LOCK
+	itsStringLock = new ACE_Thread_Mutex;
+	assert( itsStringLock != NULL );
+#endif
+
+	if (itsData == NULL || itsLength < kHeaderSize ||
+		memcmp(itsData, kMagic, kMagicLength) != 0)
+		{
+		itsData = NULL;
+		return;
+		}
+
+	const JSize count       = ReadUInt32(kMagicLength);
+	const JSize bucketCount = ReadUInt32(kMagicLength + 4);
+	const JSize maxCount    = (itsLength - kHeaderSize) / 4;
+	if ((count > 0 && bucketCount == 0) ||
+		count > maxCount || bucketCount > maxCount - count)
+		{
+		itsData = NULL;
+		return;
+		}
+
+	itsCount       = count;
+	itsBucketCount = bucketCount;
+}
+
+/******************************************************************************
+ Includes
+
+ ******************************************************************************/
+
+JBoolean
+JStaticStringTable::Includes
+	(
+	const JCharacter* id
+	)
+	const
+{
+	const JCharacter* value;
+	JSize length;
+	return GetElement(id, &value, &length);
+}
+
+/******************************************************************************
+ GetElement
+
+	Returns the string associated with the given id.  The string is nul
+	terminated, but it can also contain nul characters, so the length is
+	returned separately.
+
+ ******************************************************************************/
+
+JBoolean
+JStaticStringTable::GetElement
+	(
+	const JCharacter*	id,
+	const JCharacter**	value,
+	JSize*				length
+	)
+	const
+{
+	JIndex slot;
+	return FindSlot(id, &slot, value, length);
+}
+
+/******************************************************************************
+ GetString
+
+	Returns the string associated with the given id as a JString.  The
+	JString is owned by the table, so it remains valid until the table is
+	deleted.  This is safe to call from any thread.
+
+ ******************************************************************************/
+
+JBoolean
+JStaticStringTable::GetString
+	(
+	const JCharacter*	id,
+	const JString**		s
+	)
+	const
+{
+	*s = NULL;
+
+	JIndex slot;
+	const JCharacter* value;
+	JSize length;
+	if (!FindSlot(id, &slot, &value, &length))
+		{
+		return kJFalse;
+		}
+
+#ifdef J_STRING_TABLE_LOCK
+	ACE_Guard<ACE_Thread_Mutex> guard(*itsStringLock);
+#endif
+
+	if (itsStringList == NULL)
+		{
+		itsStringList = new JString* [ itsCount ];
+		assert( itsStringList != NULL );
+		memset(itsStringList, 0, itsCount * sizeof(JString*));
+		}
+
+	if (itsStringList[slot] == NULL)
+		{
+		itsStringList[slot] = new JString(value, length);
+		assert( itsStringList[slot] != NULL );
+		}
+
+	*s = itsStringList[slot];
+	return kJTrue;
+}
+
+/******************************************************************************
+ FindSlot (private)
+
+	Returns the slot (zero-based) that contains the given id.
+
+ ******************************************************************************/
+
+JBoolean
+JStaticStringTable::FindSlot
+	(
+	const JCharacter*	id,
+	JIndex*				slot,
+	const JCharacter**	value,
+	JSize*				length
+	)
+	const
+{
+	if (itsCount == 0)
+		{
+		return kJFalse;
+		}
+
+	const JSize idLength  = strlen(id);
+	const JIndex bucket   = Hash(id, idLength, 0) % itsBucketCount;
+	const JUInt32 seed    = ReadUInt32(kHeaderSize + 4*bucket);
+	*slot                 = Hash(id, idLength, seed) % itsCount;
+
+	const JCharacter* slotID;
+	JSize slotIDLength;
+	return JI2B(GetEntry(*slot, &slotID, &slotIDLength, value, length) &&
+				slotIDLength == idLength &&
+				memcmp(slotID, id, idLength) == 0);
+}
+
+/******************************************************************************
+ GetElement
+
+	Returns the contents of the given slot.  This is useful for iterating
+	over all the strings in the table.
+
+ ******************************************************************************/
+
+JBoolean
+JStaticStringTable::GetElement
+	(
+	const JIndex		index,
+	const JCharacter**	id,
+	const JCharacter**	value,
+	JSize*				length
+	)
+	const
+{
+	assert( 1 <= index && index <= itsCount );
+
+	JSize idLength;
+	return GetEntry(index-1, id, &idLength, value, length);
+}
+
+/******************************************************************************
+ GetEntry (private)
+
+	Returns kJFalse if the entry does not fit inside the data.
+
+ ******************************************************************************/
+
+JBoolean
+JStaticStringTable::GetEntry
+	(
+	const JIndex		slot,
+	const JCharacter**	id,
+	JSize*				idLength,
+	const JCharacter**	value,
+	JSize*				valueLength
+	)
+	const
+{
+	const JSize offset = ReadUInt32(kHeaderSize + 4*(itsBucketCount + slot));
+	if (offset < kHeaderSize || offset > itsLength - kEntryHeaderSize)
+		{
+		return kJFalse;
+		}
+
+	*idLength    = ReadUInt32(offset);
+	*valueLength = ReadUInt32(offset + 4);
+
+	const JSize start = offset + kEntryHeaderSize;
+	const JSize avail = itsLength - start;
+	if (*idLength >= avail || *valueLength >= avail - *idLength - 1)
+		{
+		return kJFalse;
+		}
+
+	*id    = (const JCharacter*) (itsData + start);
+	*value = *id + *idLength + 1;
+	return kJTrue;
+}
+
+/******************************************************************************
+ ReadUInt32 (private)
+
+	The data is not necessarily aligned, so we assemble the bytes.
+
+ ******************************************************************************/
+
+JUInt32
+JStaticStringTable::ReadUInt32
+	(
+	const JSize offset
+	)
+	const
+{
+	const unsigned char* p = itsData + offset;
+	return (((JUInt32) p[0])       |
+			((JUInt32) p[1] <<  8) |
+			((JUInt32) p[2] << 16) |
+			((JUInt32) p[3] << 24));
+}
+
+/******************************************************************************
+ Hash (static private)
+
+	FNV-1a, followed by a final mix so the low bits depend on every
+	character.
+
+ ******************************************************************************/
+
+JUInt32
+JStaticStringTable::Hash
+	(
+	const JCharacter*	s,
+	const JSize			length,
+	const JUInt32		seed
+	)
+{
+	JUInt32 h = 2166136261U ^ (JUInt32) (seed * 2654435769U);
+	for (JIndex i=0; i<length; i++)
+		{
+		h = (JUInt32) ((h ^ (unsigned char) s[i]) * 16777619U);
+		}
+
+	h ^= h >> 16;
+	h  = (JUInt32) (h * 2246822507U);
+	h ^= h >> 13;
+	return h;
+}
+
+/******************************************************************************
+ Write (static)
+
+	Writes the contents of the map in binary format.  Buckets are placed
+	largest first, since small buckets are easier to fit into the slots
+	that remain.
+
+ ******************************************************************************/
+
+static void
+jWriteUInt32
+	(
+	ostream&		output,
+	const JUInt32	value
+	)
+{
+	const unsigned char b[4] =
+		{
+		(unsigned char) (value & 0xFF),
+		(unsigned char) ((value >> 8) & 0xFF),
+		(unsigned char) ((value >> 16) & 0xFF),
+		(unsigned char) ((value >> 24) & 0xFF)
+		};
+	output.write((const char*) b, 4);
+}
+
+void
+JStaticStringTable::Write
+	(
+	ostream&						output,
+	const JStringPtrMap<JString>&	map
+	)
+{
+	const JSize count       = map.GetElementCount();
+	const JSize bucketCount = JMax((JSize) 1, (count + kKeysPerBucket-1) / kKeysPerBucket);
+
+	const JCharacter** id = new const JCharacter* [ count+1 ];
+	const JString** value = new const JString* [ count+1 ];
+	JSize* idLength       = new JSize [ count+1 ];
+	JIndex* bucket        = new JIndex [ count+1 ];
+	assert( id != NULL && value != NULL && idLength != NULL && bucket != NULL );
+
+	JSize* bucketSize  = new JSize [ bucketCount+1 ];
+	JIndex* bucketNext = new JIndex [ bucketCount+1 ];
+	JUInt32* seed      = new JUInt32 [ bucketCount ];
+	assert( bucketSize != NULL && bucketNext != NULL && seed != NULL );
+
+	JSize i = 0;
+	for (i=0; i<bucketCount; i++)
+		{
+		bucketSize[i] = 0;
+		seed[i]       = 0;
+		}
+
+	JSize maxBucketSize = 0;
+	JStringPtrMapCursor<JString> cursor(const_cast<JStringPtrMap<JString>*>(&map));
+	for (i=0; cursor.Next(); i++)
+		{
+		id[i]       = cursor.GetKey();
+		value[i]    = cursor.GetValue();
+		idLength[i] = strlen(id[i]);
+		bucket[i]   = Hash(id[i], idLength[i], 0) % bucketCount;
+
+		bucketSize[ bucket[i] ]++;
+		maxBucketSize = JMax(maxBucketSize, bucketSize[ bucket[i] ]);
+		}
+	assert( i == count );
+
+	// sort the keys by bucket:  member[ bucketNext[b] ... ] belong to bucket b
+
+	JIndex* member = new JIndex [ count+1 ];
+	assert( member != NULL );
+
+	bucketNext[0] = 0;
+	for (i=1; i<=bucketCount; i++)
+		{
+		bucketNext[i] = bucketNext[i-1] + bucketSize[i-1];
+		}
+	for (i=0; i<count; i++)
+		{
+		member[ bucketNext[ bucket[i] ]++ ] = i;
+		}
+
+	// find a seed for each bucket that puts its keys into empty slots
+
+	JIndex* slotOwner = new JIndex [ count+1 ];		// index+1 of owner, 0 if empty
+	JIndex* slot      = new JIndex [ maxBucketSize+1 ];
+	assert( slotOwner != NULL && slot != NULL );
+
+	for (i=0; i<count; i++)
+		{
+		slotOwner[i] = 0;
+		}
+
+	for (JSize size=maxBucketSize; size>0; size--)
+		{
+		for (JIndex b=0; b<bucketCount; b++)
+			{
+			if (bucketSize[b] != size)
+				{
+				continue;
+				}
+
+			const JSize n       = bucketSize[b];
+			const JIndex* owner = member + bucketNext[b] - n;
+
+			JUInt32 s = 1;
+			while (1)
+				{
+				JBoolean ok = kJTrue;
+				for (JIndex j=0; j<n && ok; j++)
+					{
+					slot[j] = Hash(id[ owner[j] ], idLength[ owner[j] ], s) % count;
+					ok      = JI2B( slotOwner[ slot[j] ] == 0 );
+					for (JIndex k=0; k<j && ok; k++)
+						{
+						ok = JI2B( slot[k] != slot[j] );
+						}
+					}
+
+				if (ok)
+					{
+					break;
+					}
+
+				s++;
+				assert( s != 0 );
+				}
+
+			seed[b] = s;
+			for (JIndex j=0; j<n; j++)
+				{
+				slotOwner[ slot[j] ] = owner[j] + 1;
+				}
+			}
+		}
+
+	// write the header and index
+
+	output.write(kMagic, kMagicLength);
+	jWriteUInt32(output, count);
+	jWriteUInt32(output, bucketCount);
+
+	for (i=0; i<bucketCount; i++)
+		{
+		jWriteUInt32(output, seed[i]);
+		}
+
+	JSize offset = kHeaderSize + 4*(bucketCount + count);
+	for (i=0; i<count; i++)
+		{
+		jWriteUInt32(output, offset);
+
+		const JIndex j = slotOwner[i] - 1;
+		offset += kEntryHeaderSize + idLength[j] + 1 + (value[j])->GetLength() + 1;
+		}
+
+	// write the entries in slot order
+
+	for (i=0; i<count; i++)
+		{
+		const JIndex j = slotOwner[i] - 1;
+		jWriteUInt32(output, idLength[j]);
+		jWriteUInt32(output, (value[j])->GetLength());
+		output.write(id[j], idLength[j] + 1);
+		output.write((value[j])->GetCString(), (value[j])->GetLength() + 1);
+		}
+
+	delete [] id;
+	delete [] value;
+	delete [] idLength;
+	delete [] bucket;
+	delete [] bucketSize;
+	delete [] bucketNext;
+	delete [] seed;
+	delete [] slotOwner;
+	delete [] member;
+	delete [] slot;
+}
@@ -0,0 +1,104 @@
+/******************************************************************************
+ JStaticStringTable.h
+
+	Interface for the JStaticStringTable class
+
+ ******************************************************************************/
+
+#ifndef _H_JStaticStringTable
+#define _H_JStaticStringTable
+
+#if !defined _J_UNIX && !defined ACE_LACKS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <JStringPtrMap.h>
+
+class JString;
+class ACE_Mem_Map;
+class ACE_Thread_Mutex;
+
+class JStaticStringTable
+{
+public:
+
+	JStaticStringTable(const unsigned char* data, const JSize length);
+
+	static JBoolean	Create(const JCharacter* fileName, const JSize offset,
+						   JStaticStringTable** table);
+	static JBoolean	Create(istream& input, JStaticStringTable** table);
+
+	~JStaticStringTable();
+
+	JBoolean	IsValid() const;
+	JSize		GetElementCount() const;
+
+	JBoolean	Includes(const JCharacter* id) const;
+	JBoolean	GetElement(const JCharacter* id,
+						   const JCharacter** value, JSize* length) const;
+	JBoolean	GetElement(const JIndex index, const JCharacter** id,
+						   const JCharacter** value, JSize* length) const;
+	JBoolean	GetString(const JCharacter* id, const JString** s) const;
+
+	static void	Write(ostream& output, const JStringPtrMap<JString>& map);
+
+private:
+
+	const unsigned char*	itsData;
+	JSize					itsLength;
+	unsigned char*			itsOwnedData;	// NULL unless we copied the data
+	ACE_Mem_Map*			itsMemMap;		// NULL unless we mapped a file
+
+	JSize	itsCount;		// number of strings == number of slots
+	JSize	itsBucketCount;
+
+	mutable JString**	itsStringList;	// NULL until GetString() is called
+	ACE_Thread_Mutex*	itsStringLock;	// NULL unless threads are enabled
+
+private:
+
+	JStaticStringTable(unsigned char* data, const JSize length, ACE_Mem_Map* map);
+
+	void		Init();
+	JBoolean	FindSlot(const JCharacter* id, JIndex* slot,
+						 const JCharacter** value, JSize* length) const;
+	JBoolean	GetEntry(const JIndex slot, const JCharacter** id, JSize* idLength,
+						 const JCharacter** value, JSize* valueLength) const;
+	JUInt32		ReadUInt32(const JSize offset) const;
+
+	static JUInt32	Hash(const JCharacter* s, const JSize length, const JUInt32 seed);
+
+	// not allowed
+
+	JStaticStringTable(const JStaticStringTable& source);
+	const JStaticStringTable& operator=(const JStaticStringTable& source);
+};
+
+
+/******************************************************************************
+ IsValid
+
+	Returns kJFalse if the data did not contain a well-formed table.
+
+ ******************************************************************************/
+
+inline JBoolean
+JStaticStringTable::IsValid()
+	const
+{
+	return JConvertToBoolean( itsData != NULL );
+}
+
+/******************************************************************************
+ GetElementCount
+
+ ******************************************************************************/
+
+inline JSize
+JStaticStringTable::GetElementCount()
+	const
+{
+	return itsCount;
+}
+
+#endif
@@ -14,6 +14,12 @@
 	names, operator< and operator> are not case sensitive.  One should therefore
 	not mix == with < and > when comparing strings.
 
+	Strings of up to kSmallBufferSize characters are stored in itsSmallBuffer
+	instead of on the heap, so temporary JStrings are cheap as long as they
+	are short.  Because itsString can point into the object itself, JStrings
+	must never be copied with memcpy().  To avoid copying a substring at all,
+	use GetView().
+
 	Since strstream doesn't provide the control we need when converting a number
 	to a string, we use the NumConvert and StrUtil modules.  We include them at
 	the end of the file so they are completely hidden and JString is self-contained.
@@ -56,14 +62,12 @@ static void	double2str(double doubleVal, int afterDec, int sigDigitCount,
 
 JString::JString()
 	:
+	itsString( itsSmallBuffer ),
+	itsStringLength( 0 ),
+	itsAllocLength( kSmallBufferSize ),
 	itsBlockSize( kDefaultBlockSize )
 {
-	itsStringLength = 0;
-	itsAllocLength  = itsBlockSize;
-
-	itsString = new JCharacter [ itsAllocLength+1 ];
-	assert( itsString != NULL );
-	itsString [ 0 ] = '\0';
+	itsSmallBuffer [ 0 ] = '\0';
 }
 
 JString::JString
@@ -71,10 +75,11 @@ JString::JString
 	const JCharacter* str
 	)
 	:
+	itsString( itsSmallBuffer ),
+	itsStringLength( 0 ),
+	itsAllocLength( kSmallBufferSize ),
 	itsBlockSize( kDefaultBlockSize )
 {
-	itsAllocLength = 0;
-	itsString      = NULL;		// makes delete [] safe inside CopyToPrivateString
 	CopyToPrivateString(str);
 }
 
@@ -84,10 +89,11 @@ JString::JString
 	const JSize			length
 	)
 	:
+	itsString( itsSmallBuffer ),
+	itsStringLength( 0 ),
+	itsAllocLength( kSmallBufferSize ),
 	itsBlockSize( kDefaultBlockSize )
 {
-	itsAllocLength = 0;
-	itsString      = NULL;		// makes delete [] safe inside CopyToPrivateString
 	CopyToPrivateString(length > 0 ? str : "", length);		// allow NULL,0
 }
 
@@ -97,10 +103,11 @@ JString::JString
 	const JIndexRange&	range
 	)
 	:
+	itsString( itsSmallBuffer ),
+	itsStringLength( 0 ),
+	itsAllocLength( kSmallBufferSize ),
 	itsBlockSize( kDefaultBlockSize )
 {
-	itsAllocLength = 0;
-	itsString      = NULL;		// makes delete [] safe inside CopyToPrivateString
 	CopyToPrivateString(str + range.first-1, range.GetLength());
 }
 
@@ -113,19 +120,21 @@ JString::JString
 	const JInteger			sigDigitCount
 	)
 	:
+	itsString( itsSmallBuffer ),
+	itsStringLength( 0 ),
+	itsAllocLength( kSmallBufferSize ),
 	itsBlockSize( kDefaultBlockSize )
 {
 	assert( precision >= -1 );
 
-	itsAllocLength = 50;
+	// format on the stack, so short results can use itsSmallBuffer
 
-	itsString = new JCharacter [ itsAllocLength+1 ];
-	assert( itsString != NULL );
+	JCharacter s[ 51 ];
 	double2str(number, precision, sigDigitCount,
 			   (expDisplay == kUseGivenExponent ? exponent : expDisplay),
-			   itsString);
+			   s);
 
-	itsStringLength = strlen(itsString);
+	CopyToPrivateString(s);
 }
 
 JString::JString
@@ -135,10 +144,11 @@ JString::JString
 	const JBoolean	pad
 	)
 	:
+	itsString( itsSmallBuffer ),
+	itsStringLength( 0 ),
+	itsAllocLength( kSmallBufferSize ),
 	itsBlockSize( kDefaultBlockSize )
 {
-	itsAllocLength = 0;
-	itsString      = NULL;		// makes delete [] safe inside CopyToPrivateString
 
 	if (number == 0)
 		{
@@ -193,13 +203,27 @@ JString::JString
 	const std::string& s
 	)
 	:
+	itsString( itsSmallBuffer ),
+	itsStringLength( 0 ),
+	itsAllocLength( kSmallBufferSize ),
 	itsBlockSize( kDefaultBlockSize )
 {
-	itsAllocLength = 0;
-	itsString      = NULL;		// makes delete [] safe inside CopyToPrivateString
 	CopyToPrivateString(s.data(), s.length());
 }
 
+JString::JString
+	(
+	const JStringView& s
+	)
+	:
+	itsString( itsSmallBuffer ),
+	itsStringLength( 0 ),
+	itsAllocLength( kSmallBufferSize ),
+	itsBlockSize( kDefaultBlockSize )
+{
+	CopyToPrivateString(s.GetCharacters(), s.GetLength());
+}
+
 /******************************************************************************
  Copy constructor
 
@@ -213,11 +237,11 @@ JString::JString
 	const JString& source
 	)
 	:
+	itsString( itsSmallBuffer ),
+	itsStringLength( 0 ),
+	itsAllocLength( kSmallBufferSize ),
 	itsBlockSize( source.itsBlockSize )
 {
-	itsAllocLength = 0;
-	itsString      = NULL;		// makes delete [] safe inside CopyToPrivateString
-
 	CopyToPrivateString(source.itsString, source.itsStringLength);
 }
 
@@ -228,7 +252,41 @@ JString::JString
 
 JString::~JString()
 {
-	delete [] itsString;
+	FreeString(itsString);
+}
+
+/******************************************************************************
+ AllocateString (private)
+
+	Returns space for allocLength characters plus the termination and
+	updates itsAllocLength.  Short strings get itsSmallBuffer, so they
+	never touch the heap.  The caller must copy the old characters and
+	then pass the old string to FreeString().
+
+	*** The caller must not ask for itsSmallBuffer while it is in use.
+
+ ******************************************************************************/
+
+JCharacter*
+JString::AllocateString
+	(
+	const JSize allocLength
+	)
+{
+	if (allocLength <= kSmallBufferSize)
+		{
+		assert( itsString != itsSmallBuffer );
+		itsAllocLength = kSmallBufferSize;
+		return itsSmallBuffer;
+		}
+	else
+		{
+		itsAllocLength = allocLength;
+
+		JCharacter* str = new JCharacter [ itsAllocLength + 1 ];
+		assert( str != NULL );
+		return str;
+		}
 }
 
 /******************************************************************************
@@ -249,19 +307,16 @@ JString::CopyToPrivateString
 {
 	assert( str != itsString );
 
-	if (itsAllocLength < length || itsAllocLength == 0)
+	if (itsAllocLength < length)
 		{
-		itsAllocLength = length + itsBlockSize;
-
 		// We allocate the new memory first.
 		// If new fails, we still have the old string data.
 
-		JCharacter* newString = new JCharacter [ itsAllocLength + 1 ];
-		assert( newString != NULL );
+		JCharacter* newString = AllocateString(length + itsBlockSize);
 
 		// now it's safe to throw out the old data
 
-		delete [] itsString;
+		FreeString(itsString);
 		itsString = newString;
 		}
 
@@ -304,12 +359,10 @@ JString::InsertSubstring
 
 	if (itsAllocLength < itsStringLength + insertLength)
 		{
-		itsAllocLength = itsStringLength + insertLength + itsBlockSize;
-
 		// allocate space for the combined string
 
-		JCharacter* newString = new JCharacter [ itsAllocLength + 1 ];
-		assert( newString != NULL );
+		JCharacter* newString =
+			AllocateString(itsStringLength + insertLength + itsBlockSize);
 
 		insertionPtr = newString + insertionOffset;
 
@@ -324,7 +377,7 @@ JString::InsertSubstring
 
 		// throw out our original string and save the new one
 
-		delete [] itsString;
+		FreeString(itsString);
 		itsString = newString;
 		}
 
@@ -454,20 +507,17 @@ JString::Clear()
 
 	// If we are using too much memory, reallocate.
 
-	if (itsAllocLength > itsBlockSize)
+	if (itsString != itsSmallBuffer && itsAllocLength > itsBlockSize)
 		{
-		itsAllocLength = itsBlockSize;
-
 		// throw out the old data
 
-		delete [] itsString;
+		FreeString(itsString);
 
 		// Having just released a block of memory at least as large as the
 		// one we are requesting, the system must really be screwed if this
 		// call to new doesn't work.
 
-		itsString = new JCharacter [ itsAllocLength + 1 ];
-		assert( itsString != NULL );
+		itsString = AllocateString(itsBlockSize);
 		}
 
 	// clear the string
@@ -529,14 +579,11 @@ JString::TrimWhitespace()
 
 	const JSize newLength = lastCharIndex - firstCharIndex + 1;
 
-	if (itsAllocLength > newLength + itsBlockSize)
+	if (itsString != itsSmallBuffer && itsAllocLength > newLength + itsBlockSize)
 		{
-		itsAllocLength = newLength + itsBlockSize;
-
 		// allocate space for the new string + termination
 
-		JCharacter* newString = new JCharacter[ itsAllocLength+1 ];
-		assert( newString != NULL );
+		JCharacter* newString = AllocateString(newLength + itsBlockSize);
 
 		// copy the non-blank characters to the new string
 
@@ -544,7 +591,7 @@ JString::TrimWhitespace()
 
 		// throw out our original string and save the new one
 
-		delete [] itsString;
+		FreeString(itsString);
 		itsString = newString;
 		}
 
@@ -856,6 +903,29 @@ JString::GetSubstring
 		}
 }
 
+/******************************************************************************
+ GetView
+
+	Like GetSubstring(), but does not copy the characters.  The view is
+	only valid until the string is modified.
+
+	Not inline because it uses assert.
+
+ ******************************************************************************/
+
+JStringView
+JString::GetView
+	(
+	const JIndexRange& range
+	)
+	const
+{
+	assert( !range.IsNothing() );
+	assert( range.IsEmpty() || RangeValid(range) );
+
+	return JStringView(itsString, range);
+}
+
 /******************************************************************************
  Extract
 
@@ -919,14 +989,12 @@ JString::ReplaceSubstring
 
 	// If we don't have space, or would use too much space, reallocate.
 
-	if (itsAllocLength < newLength || itsAllocLength > newLength + itsBlockSize)
+	if (itsAllocLength < newLength ||
+		(itsString != itsSmallBuffer && itsAllocLength > newLength + itsBlockSize))
 		{
-		itsAllocLength = newLength + itsBlockSize;
-
 		// allocate space for the result
 
-		JCharacter* newString = new JCharacter[ itsAllocLength+1 ];
-		assert( newString != NULL );
+		JCharacter* newString = AllocateString(newLength + itsBlockSize);
 
 		// place the characters in front and behind
 
@@ -935,7 +1003,7 @@ JString::ReplaceSubstring
 
 		// throw out the original string and save the new one
 
-		delete [] itsString;
+		FreeString(itsString);
 		itsString = newString;
 		}
 
@@ -1201,19 +1269,16 @@ JString::Read
 	const JSize	count
 	)
 {
-	if (itsAllocLength < count || itsAllocLength == 0)
+	if (itsAllocLength < count)
 		{
-		itsAllocLength = count + itsBlockSize;
-
 		// We allocate the new memory first.
 		// If new fails, we still have the old string data.
 
-		JCharacter* newString = new JCharacter [ itsAllocLength + 1 ];
-		assert( newString != NULL );
+		JCharacter* newString = AllocateString(count + itsBlockSize);
 
 		// now it's safe to throw out the old data
 
-		delete [] itsString;
+		FreeString(itsString);
 		itsString = newString;
 		}
 
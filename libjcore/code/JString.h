@@ -16,6 +16,7 @@
 
 #include <JPtrArray.h>
 #include <JIndexRange.h>
+#include <JStringView.h>
 #include <string.h>
 
 class JString
@@ -59,6 +60,7 @@ public:
 			const JInteger exponent = 0, const JInteger sigDigitCount = 0);
 	JString(const JUInt number, const Base base, const JBoolean pad = kJFalse);
 	JString(const std::string& s);
+	explicit JString(const JStringView& s);
 
 	~JString();
 
@@ -78,6 +80,7 @@ public:
 	void	Set(const JCharacter* str, const JIndexRange& range);
 	void	Set(const std::string& str);
 	void	Set(const std::string& str, const JIndexRange& range);
+	void	Set(const JStringView& str);
 
 	JBoolean			ContainsNULL() const;
 	const JCharacter*	GetCString() const;
@@ -100,6 +103,7 @@ public:
 	void	Append(const JCharacter* str);
 	void	Append(const JCharacter* str, const JSize length);
 	void	Append(const std::string& str);
+	void	Append(const JStringView& str);
 	void	AppendCharacter(const JCharacter c);
 
 	JBoolean	IsEmpty() const;
@@ -126,6 +130,7 @@ public:
 	JBoolean	Contains(const JCharacter* str, const JSize length,
 						 const JBoolean caseSensitive = kJTrue) const;
 	JBoolean	Contains(const std::string& str, const JBoolean caseSensitive = kJTrue) const;
+	JBoolean	Contains(const JStringView& str, const JBoolean caseSensitive = kJTrue) const;
 
 	JBoolean	LocateSubstring(const JString& str, JIndex* startIndex) const;
 	JBoolean	LocateSubstring(const JCharacter* str, JIndex* startIndex) const;
@@ -140,6 +145,9 @@ public:
 								const JBoolean caseSensitive, JIndex* startIndex) const;
 	JBoolean	LocateSubstring(const std::string& str, const JBoolean caseSensitive,
 								JIndex* startIndex) const;
+	JBoolean	LocateSubstring(const JStringView& str, JIndex* startIndex) const;
+	JBoolean	LocateSubstring(const JStringView& str, const JBoolean caseSensitive,
+								JIndex* startIndex) const;
 
 	JBoolean	LocateNextSubstring(const JString& str, JIndex* startIndex) const;
 	JBoolean	LocateNextSubstring(const JCharacter* str, JIndex* startIndex) const;
@@ -154,6 +162,9 @@ public:
 									const JBoolean caseSensitive, JIndex* startIndex) const;
 	JBoolean	LocateNextSubstring(const std::string& str, const JBoolean caseSensitive,
 									JIndex* startIndex) const;
+	JBoolean	LocateNextSubstring(const JStringView& str, JIndex* startIndex) const;
+	JBoolean	LocateNextSubstring(const JStringView& str, const JBoolean caseSensitive,
+									JIndex* startIndex) const;
 
 	JBoolean	LocatePrevSubstring(const JString& str, JIndex* startIndex) const;
 	JBoolean	LocatePrevSubstring(const JCharacter* str, JIndex* startIndex) const;
@@ -168,6 +179,9 @@ public:
 									const JBoolean caseSensitive, JIndex* startIndex) const;
 	JBoolean	LocatePrevSubstring(const std::string& str, const JBoolean caseSensitive,
 									JIndex* startIndex) const;
+	JBoolean	LocatePrevSubstring(const JStringView& str, JIndex* startIndex) const;
+	JBoolean	LocatePrevSubstring(const JStringView& str, const JBoolean caseSensitive,
+									JIndex* startIndex) const;
 
 	JBoolean	LocateLastSubstring(const JString& str, JIndex* startIndex) const;
 	JBoolean	LocateLastSubstring(const JCharacter* str, JIndex* startIndex) const;
@@ -182,22 +196,30 @@ public:
 									const JBoolean caseSensitive, JIndex* startIndex) const;
 	JBoolean	LocateLastSubstring(const std::string& str, const JBoolean caseSensitive,
 									JIndex* startIndex) const;
+	JBoolean	LocateLastSubstring(const JStringView& str, JIndex* startIndex) const;
+	JBoolean	LocateLastSubstring(const JStringView& str, const JBoolean caseSensitive,
+									JIndex* startIndex) const;
 
 	JBoolean	BeginsWith(const JString& str, const JBoolean caseSensitive = kJTrue) const;
 	JBoolean	BeginsWith(const JCharacter* str, const JBoolean caseSensitive = kJTrue) const;
 	JBoolean	BeginsWith(const JCharacter* str, const JSize length,
 						   const JBoolean caseSensitive = kJTrue) const;
 	JBoolean	BeginsWith(const std::string& str, const JBoolean caseSensitive = kJTrue) const;
+	JBoolean	BeginsWith(const JStringView& str, const JBoolean caseSensitive = kJTrue) const;
 
 	JBoolean	EndsWith(const JString& str, const JBoolean caseSensitive = kJTrue) const;
 	JBoolean	EndsWith(const JCharacter* str, const JBoolean caseSensitive = kJTrue) const;
 	JBoolean	EndsWith(const JCharacter* str, const JSize length,
 						 const JBoolean caseSensitive = kJTrue) const;
 	JBoolean	EndsWith(const std::string& str, const JBoolean caseSensitive = kJTrue) const;
+	JBoolean	EndsWith(const JStringView& str, const JBoolean caseSensitive = kJTrue) const;
 
 	JString		GetSubstring(const JIndex firstCharIndex, const JIndex lastCharIndex) const;
 	JString		GetSubstring(const JIndexRange& range) const;	// allows empty range
 
+	JStringView	GetView() const;
+	JStringView	GetView(const JIndexRange& range) const;		// allows empty range
+
 	void		Extract(const JArray<JIndexRange>& rangeList,
 						JPtrArray<JString>* substringList) const;
 
@@ -265,15 +287,26 @@ public:
 	static JBoolean	ConvertToUInt(const JCharacter* str,
 								  JUInt* value, const JSize base = 10);
 
+private:
+
+	enum
+	{
+		kSmallBufferSize = 15	// number of characters stored without using the heap
+	};
+
 private:
 
 	JCharacter* itsString;			// characters
 	JSize		itsStringLength;	// number of characters used
 	JSize		itsAllocLength;		// number of characters we have space for
 	JSize		itsBlockSize;		// size by which to shrink and grow allocation
+	JCharacter	itsSmallBuffer[ kSmallBufferSize+1 ];	// itsString for short strings
 
 private:
 
+	JCharacter*	AllocateString(const JSize allocLength);
+	void		FreeString(JCharacter* str);
+
 	void		CopyToPrivateString(const JCharacter* str);
 	void		CopyToPrivateString(const JCharacter* str, const JSize length);
 
@@ -299,6 +332,8 @@ int JStringCompare(const JCharacter* s1, const JCharacter* s2,
 int JStringCompare(const JCharacter* s1, const JSize length1,
 				   const JCharacter* s2, const JSize length2,
 				   const JBoolean caseSensitive = kJTrue);
+int JStringCompare(const JStringView& s1, const JStringView& s2,
+				   const JBoolean caseSensitive = kJTrue);
 
 JBoolean	JCompareMaxN(const JCharacter* s1, const JCharacter* s2, const JSize N,
 						 const JBoolean caseSensitive = kJTrue);
@@ -402,6 +437,21 @@ JString::GetLength()
 	return itsStringLength;
 }
 
+/******************************************************************************
+ GetView
+
+	Returns the characters without copying them.  The view is only valid
+	until the string is modified.
+
+ ******************************************************************************/
+
+inline JStringView
+JString::GetView()
+	const
+{
+	return JStringView(itsString, itsStringLength);
+}
+
 /******************************************************************************
  Convert to number
 
@@ -670,6 +720,29 @@ JString::LocateSubstring
 	return LocateSubstring(str.data(), str.length(), caseSensitive, startIndex);
 }
 
+inline JBoolean
+JString::LocateSubstring
+	(
+	const JStringView&	str,
+	JIndex*				startIndex
+	)
+	const
+{
+	return LocateSubstring(str.GetCharacters(), str.GetLength(), kJTrue, startIndex);
+}
+
+inline JBoolean
+JString::LocateSubstring
+	(
+	const JStringView&	str,
+	const JBoolean		caseSensitive,
+	JIndex*				startIndex
+	)
+	const
+{
+	return LocateSubstring(str.GetCharacters(), str.GetLength(), caseSensitive, startIndex);
+}
+
 /******************************************************************************
  LocateNextSubstring
 
@@ -756,6 +829,29 @@ JString::LocateNextSubstring
 	return LocateNextSubstring(str.data(), str.length(), caseSensitive, startIndex);
 }
 
+inline JBoolean
+JString::LocateNextSubstring
+	(
+	const JStringView&	str,
+	JIndex*				startIndex
+	)
+	const
+{
+	return LocateNextSubstring(str.GetCharacters(), str.GetLength(), kJTrue, startIndex);
+}
+
+inline JBoolean
+JString::LocateNextSubstring
+	(
+	const JStringView&	str,
+	const JBoolean		caseSensitive,
+	JIndex*				startIndex
+	)
+	const
+{
+	return LocateNextSubstring(str.GetCharacters(), str.GetLength(), caseSensitive, startIndex);
+}
+
 /******************************************************************************
  LocatePrevSubstring
 
@@ -842,6 +938,29 @@ JString::LocatePrevSubstring
 	return LocatePrevSubstring(str.data(), str.length(), caseSensitive, startIndex);
 }
 
+inline JBoolean
+JString::LocatePrevSubstring
+	(
+	const JStringView&	str,
+	JIndex*				startIndex
+	)
+	const
+{
+	return LocatePrevSubstring(str.GetCharacters(), str.GetLength(), kJTrue, startIndex);
+}
+
+inline JBoolean
+JString::LocatePrevSubstring
+	(
+	const JStringView&	str,
+	const JBoolean		caseSensitive,
+	JIndex*				startIndex
+	)
+	const
+{
+	return LocatePrevSubstring(str.GetCharacters(), str.GetLength(), caseSensitive, startIndex);
+}
+
 /******************************************************************************
  LocateLastSubstring
 
@@ -928,6 +1047,29 @@ JString::LocateLastSubstring
 	return LocateLastSubstring(str.data(), str.length(), caseSensitive, startIndex);
 }
 
+inline JBoolean
+JString::LocateLastSubstring
+	(
+	const JStringView&	str,
+	JIndex*				startIndex
+	)
+	const
+{
+	return LocateLastSubstring(str.GetCharacters(), str.GetLength(), kJTrue, startIndex);
+}
+
+inline JBoolean
+JString::LocateLastSubstring
+	(
+	const JStringView&	str,
+	const JBoolean		caseSensitive,
+	JIndex*				startIndex
+	)
+	const
+{
+	return LocateLastSubstring(str.GetCharacters(), str.GetLength(), caseSensitive, startIndex);
+}
+
 /******************************************************************************
  Contains
 
@@ -982,6 +1124,18 @@ JString::Contains
 	return LocateSubstring(str, caseSensitive, &i);
 }
 
+inline JBoolean
+JString::Contains
+	(
+	const JStringView&	str,
+	const JBoolean		caseSensitive
+	)
+	const
+{
+	JIndex i;
+	return LocateSubstring(str, caseSensitive, &i);
+}
+
 /******************************************************************************
  BeginsWith
 
@@ -1020,6 +1174,17 @@ JString::BeginsWith
 	return BeginsWith(str.data(), str.length(), caseSensitive);
 }
 
+inline JBoolean
+JString::BeginsWith
+	(
+	const JStringView&	str,
+	const JBoolean		caseSensitive
+	)
+	const
+{
+	return BeginsWith(str.GetCharacters(), str.GetLength(), caseSensitive);
+}
+
 /******************************************************************************
  EndsWith
 
@@ -1058,6 +1223,17 @@ JString::EndsWith
 	return EndsWith(str.data(), str.length(), caseSensitive);
 }
 
+inline JBoolean
+JString::EndsWith
+	(
+	const JStringView&	str,
+	const JBoolean		caseSensitive
+	)
+	const
+{
+	return EndsWith(str.GetCharacters(), str.GetLength(), caseSensitive);
+}
+
 /******************************************************************************
  Concatenation
 
@@ -1243,6 +1419,15 @@ JString::Append
 	InsertSubstring(str.data(), str.length(), itsStringLength+1);
 }
 
+inline void
+JString::Append
+	(
+	const JStringView& str
+	)
+{
+	InsertSubstring(str.GetCharacters(), str.GetLength(), itsStringLength+1);
+}
+
 /******************************************************************************
  ReplaceSubstring
 
@@ -1648,6 +1833,117 @@ operator!=
 	return (JStringCompare(s, s.GetLength(), str.data(), str.length(), kJTrue) != 0);
 }
 
+/******************************************************************************
+ Equality with JStringView (case-sensitive)
+
+	Comparing a view never copies the characters.
+
+ ******************************************************************************/
+
+// operator==
+
+inline int
+operator==
+	(
+	const JStringView& s1,
+	const JStringView& s2
+	)
+{
+	return (JStringCompare(s1, s2, kJTrue) == 0);
+}
+
+inline int
+operator==
+	(
+	const JString&		s1,
+	const JStringView&	s2
+	)
+{
+	return (JStringCompare(s1, s1.GetLength(), s2.GetCharacters(), s2.GetLength(), kJTrue) == 0);
+}
+
+inline int
+operator==
+	(
+	const JStringView&	s1,
+	const JString&		s2
+	)
+{
+	return (JStringCompare(s1.GetCharacters(), s1.GetLength(), s2, s2.GetLength(), kJTrue) == 0);
+}
+
+inline int
+operator==
+	(
+	const JStringView&	s,
+	const JCharacter*	str
+	)
+{
+	return (JStringCompare(s.GetCharacters(), s.GetLength(), str, strlen(str), kJTrue) == 0);
+}
+
+inline int
+operator==
+	(
+	const JCharacter*	str,
+	const JStringView&	s
+	)
+{
+	return (JStringCompare(str, strlen(str), s.GetCharacters(), s.GetLength(), kJTrue) == 0);
+}
+
+// operator!=
+
+inline int
+operator!=
+	(
+	const JStringView& s1,
+	const JStringView& s2
+	)
+{
+	return (JStringCompare(s1, s2, kJTrue) != 0);
+}
+
+inline int
+operator!=
+	(
+	const JString&		s1,
+	const JStringView&	s2
+	)
+{
+	return (JStringCompare(s1, s1.GetLength(), s2.GetCharacters(), s2.GetLength(), kJTrue) != 0);
+}
+
+inline int
+operator!=
+	(
+	const JStringView&	s1,
+	const JString&		s2
+	)
+{
+	return (JStringCompare(s1.GetCharacters(), s1.GetLength(), s2, s2.GetLength(), kJTrue) != 0);
+}
+
+inline int
+operator!=
+	(
+	const JStringView&	s,
+	const JCharacter*	str
+	)
+{
+	return (JStringCompare(s.GetCharacters(), s.GetLength(), str, strlen(str), kJTrue) != 0);
+}
+
+inline int
+operator!=
+	(
+	const JCharacter*	str,
+	const JStringView&	s
+	)
+{
+	return (JStringCompare(str, strlen(str), s.GetCharacters(), s.GetLength(), kJTrue) != 0);
+}
+
 /******************************************************************************
  Comparison (case-insensitive)
 
@@ -1929,6 +2225,37 @@ JStringCompare
 	return JStringCompare(s1.data(), s1.length(), s2, s2.GetLength(), caseSensitive);
 }
 
+inline int
+JStringCompare
+	(
+	const JStringView&	s1,
+	const JStringView&	s2,
+	const JBoolean		caseSensitive
+	)
+{
+	return JStringCompare(s1.GetCharacters(), s1.GetLength(),
+						  s2.GetCharacters(), s2.GetLength(), caseSensitive);
+}
+
+/******************************************************************************
+ FreeString (private)
+
+	Deletes the given string unless it is itsSmallBuffer.
+
+ ******************************************************************************/
+
+inline void
+JString::FreeString
+	(
+	JCharacter* str
+	)
+{
+	if (str != itsSmallBuffer)
+		{
+		delete [] str;
+		}
+}
+
 /******************************************************************************
  CopyToPrivateString (private)
 
@@ -2069,6 +2396,33 @@ JString::Set
 		}
 }
 
+inline void
+JString::Set
+	(
+	const JStringView& str
+	)
+{
+	const JCharacter* s = str.GetCharacters();
+	const JSize length  = str.GetLength();
+
+	if (s == itsString && length == itsStringLength)
+		{
+		return;
+		}
+	else if (itsString <= s && s <= itsString + itsStringLength)
+		{
+		// view into ourselves:  the characters can overlap
+
+		memmove(itsString, s, length);
+		itsString[ length ] = '\0';
+		itsStringLength     = length;
+		}
+	else
+		{
+		CopyToPrivateString(s, length);
+		}
+}
+
 /******************************************************************************
  Assignment operator
 
@@ -18,6 +18,12 @@
 	The comment ends at the end of the line.  Inside the string, quotes and
 	backslashes must be preceded by a backslash.
 
+	If the file format is kBinaryFormat, the newline is followed by a
+	JStaticStringTable, which compile_jstrings can generate.  Such files
+	are memory mapped, and strings are only converted to JStrings when
+	they are requested.  Since parsing is skipped entirely, this is much
+	faster for large programs.
+
 	Certain strings cannot be overridden because tampering with them
 	would be considered illegal.  These include VERSION, COPYRIGHT, and
 	LICENSE.
@@ -35,6 +41,7 @@
 
 #include <JCoreStdInc.h>
 #include <JStringManager.h>
+#include <JStaticStringTable.h>
 #include <JStringPtrMapCursor.h>
 #include <JSubstitute.h>
 #include <JString.h>
@@ -70,6 +77,9 @@ JStringManager::JStringManager()
 {
 	itsReplaceEngine = new JSubstitute;
 	assert( itsReplaceEngine != NULL );
+
+	itsTableList = new JPtrArray<JStaticStringTable>(JPtrArrayT::kDeleteAll);
+	assert( itsTableList != NULL );
 }
 
 /******************************************************************************
@@ -80,6 +90,7 @@ JStringManager::JStringManager()
 JStringManager::~JStringManager()
 {
 	delete itsReplaceEngine;
+	delete itsTableList;
 }
 
 /******************************************************************************
@@ -88,6 +99,10 @@ JStringManager::~JStringManager()
 	We assert that the id exists because it's a programmer error otherwise.
 	If you don't want this behavior, use GetElement().
 
+	Strings from binary tables are converted to JStrings the first time
+	they are requested.  The tables own these JStrings, so looking up a
+	string never modifies the map.
+
  *****************************************************************************/
 
 static const JString theMissingString = "<string not found>";
@@ -100,16 +115,96 @@ JStringManager::Get
 	const
 {
 	const JString* s;
-	const JBoolean found = GetElement(id, &s);
-	if (found)
+	if (!GetElement(id, &s))
 		{
-		assert( s != NULL );
+		s = &theMissingString;
+		}
+	return *s;
+}
+
+/******************************************************************************
+ Contains
+
+	These hide the versions inherited from JStringPtrMap, so they also
+	find the strings in the binary tables.
+
+ *****************************************************************************/
+
+JBoolean
+JStringManager::Contains
+	(
+	const JCharacter* id
+	)
+	const
+{
+	const JString* s;
+	return GetElement(id, &s);
+}
+
+/******************************************************************************
+ GetElement
+
+ *****************************************************************************/
+
+JBoolean
+JStringManager::GetElement
+	(
+	const JCharacter*	id,
+	const JString**		s
+	)
+	const
+{
+	if (JStringPtrMap<JString>::GetElement(id, s))
+		{
+		assert( *s != NULL );
+		return kJTrue;
 		}
 	else
 		{
-		s = &theMissingString;
+		return GetTableString(id, s);
 		}
-	return *s;
+}
+
+/******************************************************************************
+ GetTableString (private)
+
+	Later tables override earlier ones, except for strings that cannot be
+	overridden.
+
+ *****************************************************************************/
+
+JBoolean
+JStringManager::GetTableString
+	(
+	const JCharacter*	id,
+	const JString**		s
+	)
+	const
+{
+	const JSize count = itsTableList->GetElementCount();
+	if (CanOverride(id))
+		{
+		for (JIndex i=count; i>=1; i--)
+			{
+			if ((itsTableList->NthElement(i))->GetString(id, s))
+				{
+				return kJTrue;
+				}
+			}
+		}
+	else
+		{
+		for (JIndex i=1; i<=count; i++)
+			{
+			if ((itsTableList->NthElement(i))->GetString(id, s))
+				{
+				return kJTrue;
+				}
+			}
+		}
+
+	*s = NULL;
+	return kJFalse;
 }
 
 /******************************************************************************
@@ -257,6 +352,47 @@ JStringManager::Register
 	MergeFile(tempFileName);
 	JRemoveFile(tempFileName);
 
+	MergeUserFiles(signature);
+}
+
+/******************************************************************************
+ Register
+
+	Uses a binary table generated by compile_jstrings --binary --code as
+	the default data.  The table is not copied, so it must be static.
+
+	tableSize should be the result of sizeof().
+
+ *****************************************************************************/
+
+void
+JStringManager::Register
+	(
+	const JCharacter*		signature,
+	const unsigned char*	defaultTable,
+	const JSize				tableSize
+	)
+{
+	JStaticStringTable* table = new JStaticStringTable(defaultTable, tableSize);
+	assert( table != NULL && table->IsValid() );
+	MergeTable(table);
+
+	MergeUserFiles(signature);
+}
+
+/******************************************************************************
+ MergeUserFiles (private)
+
+	Searches the string data directories for files matching the signature.
+
+ *****************************************************************************/
+
+void
+JStringManager::MergeUserFiles
+	(
+	const JCharacter* signature
+	)
+{
 	if (!JStringEmpty(signature))
 		{
 		const JCharacter* lang = getenv("LANG");
@@ -309,15 +445,30 @@ JStringManager::MergeFile
 	)
 {
 	std::ifstream input(fileName);
-	if (input.good())
+	if (!input.good())
 		{
-		MergeFile(input, debug);
-		return kJTrue;
+		return kJFalse;
+		}
+
+	JUInt format;
+	input >> format;
+	if (!input.fail() && format == kBinaryFormat)
+		{
+		input.get();	// newline
+		JStaticStringTable* table;
+		if (JStaticStringTable::Create(fileName, JTellg(input), &table))
+			{
+			MergeTable(table);
+			}
 		}
 	else
 		{
-		return kJFalse;
+		input.clear();
+		JSeekg(input, 0);
+		MergeFile(input, debug);
 		}
+
+	return kJTrue;
 }
 
 void
@@ -329,7 +480,21 @@ JStringManager::MergeFile
 {
 	JUInt format;
 	input >> format;
-	if (format != kASCIIFormat)
+	if (input.fail())
+		{
+		return;
+		}
+	else if (format == kBinaryFormat)
+		{
+		input.get();	// newline
+		JStaticStringTable* table;
+		if (JStaticStringTable::Create(input, &table))
+			{
+			MergeTable(table);
+			}
+		return;
+		}
+	else if (format != kASCIIFormat)
 		{
 		return;
 		}
@@ -372,13 +537,92 @@ JStringManager::MergeFile
 			{
 			SetElement(id, s, JPtrArrayT::kDelete);
 			}
-		else if (!SetNewElement(id, s))
+		else if (Contains(id) || !SetNewElement(id, s))
 			{
 			delete s;
 			}
 		}
 }
 
+/******************************************************************************
+ MergeTable (private)
+
+	We take ownership of the table.  Strings that we already have and that
+	the table overrides are discarded, so Get() will find the table's
+	version.
+
+ *****************************************************************************/
+
+void
+JStringManager::MergeTable
+	(
+	JStaticStringTable* table
+	)
+{
+	JPtrArray<JString> idList(JPtrArrayT::kDeleteAll);
+
+	JStringPtrMapCursor<JString> cursor(this);
+	while (cursor.Next())
+		{
+		const JCharacter* id = cursor.GetKey();
+		if (CanOverride(id) && table->Includes(id))
+			{
+			JString* s = new JString(id);
+			assert( s != NULL );
+			idList.Append(s);
+			}
+		}
+
+	const JSize count = idList.GetElementCount();
+	for (JIndex i=1; i<=count; i++)
+		{
+		DeleteElement(*(idList.NthElement(i)));
+		}
+
+	itsTableList->Append(table);
+}
+
+/******************************************************************************
+ GetAllStrings (private)
+
+	Fills the given map with every string, including the ones in the
+	binary tables.  The map must not own its contents.
+
+ *****************************************************************************/
+
+void
+JStringManager::GetAllStrings
+	(
+	JStringPtrMap<JString>* map
+	)
+	const
+{
+	JStringPtrMapCursor<JString> cursor(const_cast<JStringManager*>(this));
+	while (cursor.Next())
+		{
+		map->SetNewElement(cursor.GetKey(), cursor.GetValue());
+		}
+
+	const JSize tableCount = itsTableList->GetElementCount();
+	for (JIndex i=1; i<=tableCount; i++)
+		{
+		const JStaticStringTable* table = itsTableList->NthElement(i);
+
+		const JSize count = table->GetElementCount();
+		for (JIndex j=1; j<=count; j++)
+			{
+			const JCharacter *id, *value;
+			JSize length;
+			const JString* s;
+			if (table->GetElement(j, &id, &value, &length) &&
+				!map->Contains(id) && GetElement(id, &s))
+				{
+				map->SetNewElement(id, const_cast<JString*>(s));
+				}
+			}
+		}
+}
+
 /******************************************************************************
  CanOverride (static)
 
@@ -413,12 +657,41 @@ JStringManager::WriteFile
 	)
 	const
 {
+	JStringPtrMap<JString> map(JPtrArrayT::kForgetAll);
+	GetAllStrings(&map);
+
 	output << (long) kASCIIFormat << endl;
 
-	JStringPtrMapCursor<JString> cursor(const_cast<JStringManager*>(this));
+	JStringPtrMapCursor<JString> cursor(&map);
 	while (cursor.Next())
 		{
 		output << cursor.GetKey();
 		output << ' ' << *(cursor.GetValue()) << endl;
 		}
 }
+
+/******************************************************************************
+ WriteBinaryFile
+
+	Writes all the strings as a binary table.  Use this to build files
+	that load quickly.
+
+ *****************************************************************************/
+
+void
+JStringManager::WriteBinaryFile
+	(
+	ostream& output
+	)
+	const
+{
+	JStringPtrMap<JString> map(JPtrArrayT::kForgetAll);
+	GetAllStrings(&map);
+
+	output << (long) kBinaryFormat << '\n';
+	JStaticStringTable::Write(output, map);
+}
+
+#define JTemplateType JStaticStringTable
+#include <JPtrArray.tmpls>
+#undef JTemplateType
@@ -17,6 +17,7 @@
 class JError;
 class JString;
 class JSubstitute;
+class JStaticStringTable;
 
 class JStringManager : public JStringPtrMap<JString>
 {
@@ -24,7 +25,8 @@ public:
 
 	enum
 	{
-		kASCIIFormat = 0
+		kASCIIFormat  = 0,
+		kBinaryFormat = 1
 	};
 
 public:
@@ -33,12 +35,17 @@ public:
 
 	virtual ~JStringManager();
 
-	void		Register(const JCharacter* signature, const JCharacter** defaultData);
+	void		Register(const JCharacter* signature, const JCharacter** defaultData);
+	void		Register(const JCharacter* signature,
+						 const unsigned char* defaultTable, const JSize tableSize);
 	JBoolean	MergeFile(const JCharacter* fileName, const JBoolean debug = kJFalse);
 	void		MergeFile(istream& input, const JBoolean debug = kJFalse);
 	void		WriteFile(ostream& output) const;
+	void		WriteBinaryFile(ostream& output) const;
 
 	const JString&	Get(const JCharacter* id) const;
+	JBoolean		Contains(const JCharacter* id) const;
+	JBoolean		GetElement(const JCharacter* id, const JString** s) const;
 
 	JString			Get(const JCharacter* id, const JCharacter* map[],
 						const JSize size) const;
@@ -53,10 +60,16 @@ public:
 
 private:
 
-	JSubstitute*	itsReplaceEngine;
+	JSubstitute*					itsReplaceEngine;
+	JPtrArray<JStaticStringTable>*	itsTableList;	// later tables override earlier ones
 
 private:
 
+	void		MergeUserFiles(const JCharacter* signature);
+	void		MergeTable(JStaticStringTable* table);
+	JBoolean	GetTableString(const JCharacter* id, const JString** s) const;
+	void		GetAllStrings(JStringPtrMap<JString>* map) const;
+
 	// not allowed
 
 	JStringManager(const JStringManager& source);
@@ -56,6 +56,7 @@ public:
 	void     RemoveAll();
 
 	JBoolean KeysAreCopied() const { return itsCopyKeysFlag; };
+	JSize    GetKeyStorageSize() const;
 
 protected:
 
@@ -69,14 +70,32 @@ protected:
 						   const JPtrArrayT::SetElementAction action);
 	void     RemoveAll(const JPtrArrayT::SetElementAction action);
 
+private:
+
+	struct KeyBlock
+	{
+		KeyBlock*	next;
+		JSize		size;		// bytes of key storage after the header
+	};
+
 private:
 
 	const JBoolean itsCopyKeysFlag;
 
+	KeyBlock*	itsKeyBlocks;		// NULL if empty; first block is being filled
+	JSize		itsKeyBlockUsed;	// bytes used in first block
+	JSize		itsKeyBytes;		// bytes used by keys in the table
+	JSize		itsDeadKeyBytes;	// bytes used by keys that have been removed
+
 private:
 
 	void JStringMapX();
 
+	JCharacter*	CopyKey(const JCharacter* key);
+	void		ReleaseKey(const JCharacter* key);
+	void		CompactKeys();
+	void		DeleteKeys();
+
 	static JBoolean Compare(const JStrValue<V>& lhs, const JStrValue<V>& rhs);
 
 	static JHashValue Hash(const JStrValue<V>& value);
@@ -0,0 +1,109 @@
+/******************************************************************************
+ JStringView.h
+
+	A pointer and a length that refer to characters owned by somebody
+	else, usually a JString.  Use it instead of JString::GetSubstring()
+	when the substring is only compared, searched, hashed, or matched,
+	so no copy is made.
+
+	The view does not own the characters, so it becomes invalid as soon
+	as the owner is modified or deleted.  The characters do not need to
+	be terminated, and they may contain NULLs.
+
+ *****************************************************************************/
+
+#ifndef _H_JStringView
+#define _H_JStringView
+
+#if !defined _J_UNIX && !defined ACE_LACKS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <JIndexRange.h>
+#include <string.h>
+
+class JStringView
+{
+public:
+
+	JStringView()
+		:
+		itsChars(""),
+		itsLength(0)
+	{ };
+
+	explicit
+	JStringView
+		(
+		const JCharacter* str
+		)
+		:
+		itsChars(str),
+		itsLength(strlen(str))
+	{ };
+
+	JStringView
+		(
+		const JCharacter*	str,
+		const JSize			length
+		)
+		:
+		itsChars(length > 0 ? str : ""),	// allow NULL,0
+		itsLength(length)
+	{ };
+
+	JStringView
+		(
+		const JCharacter*	str,
+		const JIndexRange&	range		// allows empty range
+		)
+		:
+		itsChars(range.IsEmpty() ? "" : str + range.first-1),
+		itsLength(range.GetLength())
+	{ };
+
+	const JCharacter*
+	GetCharacters() const
+	{
+		return itsChars;
+	};
+
+	JSize
+	GetLength() const
+	{
+		return itsLength;
+	};
+
+	JBoolean
+	IsEmpty() const
+	{
+		return JI2B( itsLength == 0 );
+	};
+
+	JCharacter
+	GetCharacter
+		(
+		const JIndex index
+		)
+		const
+	{
+		return itsChars[ index-1 ];
+	};
+
+	JStringView
+	GetSubview
+		(
+		const JIndexRange& range		// allows empty range
+		)
+		const
+	{
+		return JStringView(itsChars, range);
+	};
+
+private:
+
+	const JCharacter*	itsChars;
+	JSize				itsLength;
+};
+
+#endif
@@ -56,6 +56,7 @@
 #include <JMinMax.h>
 #include <jStreamUtil.h>
 #include <JStopWatch.h>
+#include <JTrace.h>
 #include <strstream>
 #include <jAssert.h>
 
@@ -130,6 +131,8 @@ JTEStyler::UpdateStyles
 	JArray<TokenData>*				tokenStartList
 	)
 {
+	J_TRACE_ZONE("JTEStyler::UpdateStyles");
+
 	if (!itsActiveFlag)
 		{
 		tokenStartList->RemoveAll();
@@ -119,6 +119,23 @@
 #include <jASCIIConstants.h>
 #include <jAssert.h>
 
+// JTableData messages handled by Receive()
+
+enum
+{
+	kTableDataRectChanged = 1,
+	kTableDataRowsInserted,
+	kTableDataRowDuplicated,
+	kTableDataRowsRemoved,
+	kTableDataRowMoved,
+	kTableDataColsInserted,
+	kTableDataColDuplicated,
+	kTableDataColsRemoved,
+	kTableDataColMoved
+};
+
+static const JBroadcaster::MessageTable&	JTableGetDataMessageTable();
+
 /******************************************************************************
  Constructor
 
@@ -2507,123 +2524,165 @@ JTable::Receive
 	const Message&	message
 	)
 {
-	const JBoolean isAuxData = itsAuxDataList->Includes(sender);
+	const JBoolean isTableData = JI2B(sender == const_cast<JTableData*>(itsTableData));
+	const JBoolean isAuxData   = itsAuxDataList->Includes(sender);
 
 	// notify all JAuxTableData objects before updating the table
 
-	if (sender == const_cast<JTableData*>(itsTableData))
+	if (isTableData)
 		{
 		Broadcast(PrepareForTableDataMessage(message));
 		}
 
-	// element or aux data changed
+	JIndex type = 0;
+	if (isTableData)
+		{
+		type = JTableGetDataMessageTable().Lookup(message);
+		}
+	else if (isAuxData && message.Is(JTableData::kRectChanged))
+		{
+		type = kTableDataRectChanged;
+		}
 
-	if ((sender == const_cast<JTableData*>(itsTableData) || isAuxData) &&
-		message.Is(JTableData::kRectChanged))
+	switch (type)
 		{
-		const JTableData::RectChanged* info =
-			dynamic_cast(const JTableData::RectChanged*, &message);
-		assert( info != NULL );
-		const JRect& r = info->GetRect();
-		if (sender == const_cast<JTableData*>(itsTableData) &&
-			itsIsEditingFlag && r.Contains(itsEditCell))
+		// element or aux data changed
+
+		case kTableDataRectChanged:
 			{
-			CancelEditing();
+			const JTableData::RectChanged* info =
+				dynamic_cast(const JTableData::RectChanged*, &message);
+			assert( info != NULL );
+			const JRect& r = info->GetRect();
+			if (isTableData && itsIsEditingFlag && r.Contains(itsEditCell))
+				{
+				CancelEditing();
+				}
+			TableRefreshCellRect(r);
+			break;
 			}
-		TableRefreshCellRect(r);
-		}
 
-	// rows changed
+		// rows changed
 
-	else if (sender == const_cast<JTableData*>(itsTableData) &&
-			 message.Is(JTableData::kRowsInserted))
-		{
-		const JTableData::RowsInserted* info =
-			dynamic_cast(const JTableData::RowsInserted*, &message);
-		assert( info != NULL );
-		InsertRows(info->GetFirstIndex(), info->GetCount());
-		}
+		case kTableDataRowsInserted:
+			{
+			const JTableData::RowsInserted* info =
+				dynamic_cast(const JTableData::RowsInserted*, &message);
+			assert( info != NULL );
+			InsertRows(info->GetFirstIndex(), info->GetCount());
+			break;
+			}
 
-	else if (sender == const_cast<JTableData*>(itsTableData) &&
-			 message.Is(JTableData::kRowDuplicated))
-		{
-		const JTableData::RowDuplicated* info =
-			dynamic_cast(const JTableData::RowDuplicated*, &message);
-		assert( info != NULL );
-		InsertRows(info->GetNewIndex(), 1);
-		}
+		case kTableDataRowDuplicated:
+			{
+			const JTableData::RowDuplicated* info =
+				dynamic_cast(const JTableData::RowDuplicated*, &message);
+			assert( info != NULL );
+			InsertRows(info->GetNewIndex(), 1);
+			break;
+			}
 
-	else if (sender == const_cast<JTableData*>(itsTableData) &&
-			 message.Is(JTableData::kRowsRemoved))
-		{
-		const JTableData::RowsRemoved* info =
-			dynamic_cast(const JTableData::RowsRemoved*, &message);
-		assert( info != NULL );
-		RemoveNextRows(info->GetFirstIndex(), info->GetCount());
-		}
+		case kTableDataRowsRemoved:
+			{
+			const JTableData::RowsRemoved* info =
+				dynamic_cast(const JTableData::RowsRemoved*, &message);
+			assert( info != NULL );
+			RemoveNextRows(info->GetFirstIndex(), info->GetCount());
+			break;
+			}
 
-	else if (sender == const_cast<JTableData*>(itsTableData) &&
-			 message.Is(JTableData::kRowMoved))
-		{
-		const JTableData::RowMoved* info =
-			dynamic_cast(const JTableData::RowMoved*, &message);
-		assert( info != NULL );
-		MoveRow(info->GetOrigIndex(), info->GetNewIndex());
-		}
+		case kTableDataRowMoved:
+			{
+			const JTableData::RowMoved* info =
+				dynamic_cast(const JTableData::RowMoved*, &message);
+			assert( info != NULL );
+			MoveRow(info->GetOrigIndex(), info->GetNewIndex());
+			break;
+			}
 
-	// columns changed
+		// columns changed
 
-	else if (sender == const_cast<JTableData*>(itsTableData) &&
-			 message.Is(JTableData::kColsInserted))
-		{
-		const JTableData::ColsInserted* info =
-			dynamic_cast(const JTableData::ColsInserted*, &message);
-		assert( info != NULL );
-		InsertCols(info->GetFirstIndex(), info->GetCount());
-		}
+		case kTableDataColsInserted:
+			{
+			const JTableData::ColsInserted* info =
+				dynamic_cast(const JTableData::ColsInserted*, &message);
+			assert( info != NULL );
+			InsertCols(info->GetFirstIndex(), info->GetCount());
+			break;
+			}
 
-	else if (sender == const_cast<JTableData*>(itsTableData) &&
-			 message.Is(JTableData::kColDuplicated))
-		{
-		const JTableData::ColDuplicated* info =
-			dynamic_cast(const JTableData::ColDuplicated*, &message);
-		assert( info != NULL );
-		InsertCols(info->GetNewIndex(), 1);
-		}
+		case kTableDataColDuplicated:
+			{
+			const JTableData::ColDuplicated* info =
+				dynamic_cast(const JTableData::ColDuplicated*, &message);
+			assert( info != NULL );
+			InsertCols(info->GetNewIndex(), 1);
+			break;
+			}
 
-	else if (sender == const_cast<JTableData*>(itsTableData) &&
-			 message.Is(JTableData::kColsRemoved))
-		{
-		const JTableData::ColsRemoved* info =
-			dynamic_cast(const JTableData::ColsRemoved*, &message);
-		assert( info != NULL );
-		RemoveNextCols(info->GetFirstIndex(), info->GetCount());
-		}
+		case kTableDataColsRemoved:
+			{
+			const JTableData::ColsRemoved* info =
+				dynamic_cast(const JTableData::ColsRemoved*, &message);
+			assert( info != NULL );
+			RemoveNextCols(info->GetFirstIndex(), info->GetCount());
+			break;
+			}
 
-	else if (sender == const_cast<JTableData*>(itsTableData) &&
-			 message.Is(JTableData::kColMoved))
-		{
-		const JTableData::ColMoved* info =
-			dynamic_cast(const JTableData::ColMoved*, &message);
-		assert( info != NULL );
-		MoveCol(info->GetOrigIndex(), info->GetNewIndex());
-		}
+		case kTableDataColMoved:
+			{
+			const JTableData::ColMoved* info =
+				dynamic_cast(const JTableData::ColMoved*, &message);
+			assert( info != NULL );
+			MoveCol(info->GetOrigIndex(), info->GetNewIndex());
+			break;
+			}
 
-	// something else
+		// something else
 
-	else
-		{
-		JBroadcaster::Receive(sender, message);
+		default:
+			JBroadcaster::Receive(sender, message);
+			break;
 		}
 
 	// update all JAuxTableData objects after updating the table
 
-	if (sender == const_cast<JTableData*>(itsTableData))
+	if (isTableData)
 		{
 		Broadcast(message);
 		}
 }
 
+/******************************************************************************
+ JTableGetDataMessageTable (local)
+
+	Maps the JTableData messages to the cases in Receive().
+
+ ******************************************************************************/
+
+const JBroadcaster::MessageTable&
+JTableGetDataMessageTable()
+{
+	static JBroadcaster::MessageTable table;
+	static JBoolean init = kJFalse;
+
+	if (!init)
+		{
+		table.Add(JTableData::kRectChanged,   kTableDataRectChanged);
+		table.Add(JTableData::kRowsInserted,  kTableDataRowsInserted);
+		table.Add(JTableData::kRowDuplicated, kTableDataRowDuplicated);
+		table.Add(JTableData::kRowsRemoved,   kTableDataRowsRemoved);
+		table.Add(JTableData::kRowMoved,      kTableDataRowMoved);
+		table.Add(JTableData::kColsInserted,  kTableDataColsInserted);
+		table.Add(JTableData::kColDuplicated, kTableDataColDuplicated);
+		table.Add(JTableData::kColsRemoved,   kTableDataColsRemoved);
+		table.Add(JTableData::kColMoved,      kTableDataColMoved);
+		init = kJTrue;
+		}
+
+	return table;
+}
+
 /******************************************************************************
  JBroadcaster messages
 
@@ -196,3 +196,49 @@ JTableData::RowColMoved::AdjustIndex
 {
 	JAdjustIndexAfterMove(itsOrigIndex, itsNewIndex, index);
 }
+
+/******************************************************************************
+ Batching (virtual)
+
+	Rectangles are merged only if their union is a rectangle, so no extra
+	cells are reported.
+
+ ******************************************************************************/
+
+JBroadcaster::Message*
+JTableData::RectChanged::Copy()
+	const
+{
+	JBroadcaster::Message* m = new RectChanged(itsRect);
+	assert( m != NULL );
+	return m;
+}
+
+JBoolean
+JTableData::RectChanged::Merge
+	(
+	const JBroadcaster::Message& next
+	)
+{
+	if (!next.Is(kRectChanged))
+		{
+		return kJFalse;
+		}
+
+	const RectChanged* info = dynamic_cast(const RectChanged*, &next);
+	assert( info != NULL );
+	const JRect& r = info->itsRect;
+
+	const JRect cover = JCovering(itsRect, r);
+	if (cover == itsRect || cover == r ||
+		(r.left == itsRect.left && r.right == itsRect.right &&
+		 r.top <= itsRect.bottom && itsRect.top <= r.bottom) ||
+		(r.top == itsRect.top && r.bottom == itsRect.bottom &&
+		 r.left <= itsRect.right && itsRect.left <= r.right))
+		{
+		itsRect = cover;
+		return kJTrue;
+		}
+
+	return kJFalse;
+}
@@ -372,6 +372,9 @@ public:
 				return itsRect;
 			};
 
+			virtual JBroadcaster::Message*	Copy() const;
+			virtual JBoolean				Merge(const JBroadcaster::Message& next);
+
 		private:
 
 			JRect	itsRect;
@@ -159,6 +159,7 @@
 #include <JRegex.h>
 #include <JLatentPG.h>
 #include <JMinMax.h>
+#include <JTrace.h>
 #include <jASCIIConstants.h>
 #include <jFStreamUtil.h>
 #include <jStreamUtil.h>
@@ -10654,6 +10655,8 @@ JTextEditor::RecalcAll
 	const JBoolean needAdjustStyles
 	)
 {
+	J_TRACE_ZONE("JTextEditor::RecalcAll");
+
 	if (itsBreakCROnlyFlag)
 		{
 		itsWidth = 0;
@@ -10693,6 +10696,8 @@ JTextEditor::Recalc
 	const JBoolean			needAdjustStyles
 	)
 {
+	J_TRACE_ZONE("JTextEditor::Recalc");
+
 	JCoordinate maxLineWidth = 0;
 	if (itsBreakCROnlyFlag && GetLineCount() == 1)
 		{
@@ -10879,6 +10884,8 @@ JTextEditor::Recalc1
 	JIndex*					lastLineIndex
 	)
 {
+	J_TRACE_ZONE("JTextEditor::Recalc1");
+
 	JIndex lineIndex = caretLoc.lineIndex;
 	if (!itsBreakCROnlyFlag && lineIndex > 1 &&
 		caretLoc.charIndex <= bufLength &&
@@ -16,6 +16,11 @@
 	program relies heavily on signals, neither of which should happen in a
 	well-designed program, I think.  Let me know if you need more.
 
+	SIGCHLD is also recorded separately, so it is never lost, even when
+	many children finish at once.  Event loops can call
+	ChildProcessFinished() on every pass and then call
+	JProcess::CheckForFinishedChild() to reap all of them.
+
 	You can change which signals are caught by calling ShouldCatchSignal().
 
 	The signals that are caught by default are:
@@ -66,6 +71,9 @@
        SIGABRT   Abort signal from abort(3)  assert() calls abort()
                                              abort() generates infinite # of SIGABRT's
 
+	If JMM_PROFILE_SIGNAL is set, the corresponding signal is handled by
+	JMemoryManager, which writes a heap profile.  It is not broadcast.
+
 	Wishful thinking:  If one could do actual work inside a signal handler,
 	one could catch SIGINT, longjmp() back to JXApplication(), call
 	CleanUpBeforeSuddenDeath(), and then exit().
@@ -82,6 +90,7 @@
 #include <JString.h>
 #include <JMinMax.h>
 #include <JStdError.h>
+#include <JMemoryManager.h>
 #include <stdlib.h>
 #include <jErrno.h>
 #include <ace/OS.h>
@@ -136,6 +145,8 @@ volatile sig_atomic_t pendingSignalCount = 0;
 
 volatile sig_atomic_t signalList [ kSignalListSize ];
 
+volatile sig_atomic_t childFinishedFlag = 0;
+
 /******************************************************************************
  Instance (static)
 
@@ -340,7 +351,9 @@ JThisProcess::CheckForSignals()
 			{
 			// this is safe since extra signals are simply appended to the list
 
-			const JBoolean sigCaught = itsSelf->BroadcastSignal(signalList[i]);
+			const JBoolean sigCaught = JI2B(
+				JMemoryManager::HandleProfileSignal(signalList[i]) ||
+				itsSelf->BroadcastSignal(signalList[i]));
 			if (!sigCaught)
 				{
 				if (signalList[i] == SIGTERM ||
@@ -376,6 +389,29 @@ JThisProcess::CheckForSignals()
 	return requestQuit;
 }
 
+/******************************************************************************
+ ChildProcessFinished (static)
+
+	Returns kJTrue if SIGCHLD has been received since the last time this
+	was called.  The flag is cleared before returning, so a child that
+	finishes while the caller is reaping will be reported next time.
+
+ ******************************************************************************/
+
+JBoolean
+JThisProcess::ChildProcessFinished()
+{
+	if (childFinishedFlag)
+		{
+		childFinishedFlag = 0;
+		return kJTrue;
+		}
+	else
+		{
+		return kJFalse;
+		}
+}
+
 /******************************************************************************
  handle_signal (virtual protected)
 
@@ -392,6 +428,11 @@ JThisProcess::handle_signal
 	ucontext_t*
 	)
 {
+	if (signum == SIGCHLD)
+		{
+		childFinishedFlag = 1;
+		}
+
 	if (signum == SIGINT)
 		{
 		JThisProcess::Exit(1);
@@ -45,6 +45,7 @@ public:
 	// called by event loop
 
 	static JBoolean	CheckForSignals();
+	static JBoolean	ChildProcessFinished();
 
 	// called by JExecute() if exec() fails
 
@@ -0,0 +1,352 @@
+/******************************************************************************
+ JTrace.cpp
+
+	Lightweight timing zones for finding out where the event loop spends
+	its time.  Wrap the interesting part of a function with
+
+		J_TRACE_ZONE("JXWindow::Update");
+
+	Zones are compiled away unless _J_USE_TRACING is defined (J_USE_TRACING
+	in include/make/jx_constants), and even then nothing is recorded until
+	SetEnabled(kJTrue) is called.
+
+	Each thread records into its own ring buffer, so the only cost of a
+	zone is reading the clock twice and storing three words.  When a
+	buffer fills up, the oldest events are discarded.
+
+	WriteChromeTrace() produces the JSON format read by Chrome's
+	about:tracing and similar viewers.  It should be called while the
+	other threads are not recording, since it reads their buffers
+	without locking them.
+
+	BASE CLASS = none
+
+ ******************************************************************************/
+
+#include <JCoreStdInc.h>
+#include <JTrace.h>
+#include <ace/TSS_T.h>
+#include <ace/Synch_Traits.h>
+#include <ace/Guard_T.h>
+#include <ace/OS_NS_unistd.h>
+#include <time.h>
+#include <sys/time.h>
+#include <jFStreamUtil.h>
+#include <jAssert.h>
+
+const JSize kBufferSize = 1 << 16;		// events per thread
+
+JBoolean JTrace::theEnabledFlag = kJFalse;
+
+/******************************************************************************
+ JTrace::Buffer
+
+	Ring buffer of events recorded by one thread.  Buffers are never
+	deleted, so the events survive after the thread exits.
+
+ ******************************************************************************/
+
+class JTrace::Buffer
+{
+public:
+
+	Buffer(const JIndex threadIndex, Buffer* next)
+		:
+		itsThreadIndex(threadIndex),
+		itsNextEvent(0),
+		itsEventCount(0),
+		itsNextBuffer(next)
+	{
+		itsEvents = new Event [ kBufferSize ];
+		assert( itsEvents != NULL );
+	};
+
+	void
+	Add
+		(
+		const JCharacter*	name,
+		const JTraceTime	start,
+		const JTraceTime	end
+		)
+	{
+		Event* e = itsEvents + itsNextEvent;
+		e->name  = name;
+		e->start = start;
+		e->end   = end;
+
+		itsNextEvent = (itsNextEvent + 1) % kBufferSize;
+		if (itsEventCount < kBufferSize)
+			{
+			itsEventCount++;
+			}
+	};
+
+	void
+	Clear()
+	{
+		itsNextEvent  = 0;
+		itsEventCount = 0;
+	};
+
+	const Event&
+	GetEvent
+		(
+		const JIndex index		// 0 is the oldest
+		)
+		const
+	{
+		return itsEvents[ (itsNextEvent + kBufferSize - itsEventCount + index) % kBufferSize ];
+	};
+
+	JIndex	itsThreadIndex;
+	Event*	itsEvents;
+	JIndex	itsNextEvent;
+	JSize	itsEventCount;
+	Buffer*	itsNextBuffer;
+};
+
+// ACE_TSS deletes its object when the thread exits, so it only holds
+// a pointer to the buffer.  Without thread support, ACE_TSS simply
+// stores the object it is given, so we must always provide one.
+
+struct JTraceBufferPtr
+{
+	JTrace::Buffer* buffer;
+
+	JTraceBufferPtr()
+		:
+		buffer(NULL)
+	{ };
+};
+
+static ACE_TSS<JTraceBufferPtr>	theThreadBuffer(new JTraceBufferPtr);
+static ACE_SYNCH_MUTEX			theBufferListMutex;
+static JTrace::Buffer*			theBufferList  = NULL;
+static JSize					theBufferCount = 0;
+
+/******************************************************************************
+ GetTime (static)
+
+	Returns a monotonic time in nanoseconds.  The origin is arbitrary.
+
+ ******************************************************************************/
+
+JTraceTime
+JTrace::GetTime()
+{
+#ifdef CLOCK_MONOTONIC
+
+	timespec t;
+	if (clock_gettime(CLOCK_MONOTONIC, &t) == 0)
+		{
+		return JTraceTime(t.tv_sec) * 1000000000 + t.tv_nsec;
+		}
+
+#endif
+
+	timeval tv;
+	gettimeofday(&tv, NULL);
+	return JTraceTime(tv.tv_sec) * 1000000000 + JTraceTime(tv.tv_usec) * 1000;
+}
+
+/******************************************************************************
+ Record (static)
+
+	Stores an event in the calling thread's buffer.  The name must remain
+	valid until the trace is written, so it should be a string constant.
+
+ ******************************************************************************/
+
+void
+JTrace::Record
+	(
+	const JCharacter*	name,
+	const JTraceTime	start,
+	const JTraceTime	end
+	)
+{
+	Buffer* b;
+	if (theEnabledFlag && (b = GetBuffer()) != NULL)
+		{
+		b->Add(name, start, end);
+		}
+}
+
+/******************************************************************************
+ GetBuffer (static private)
+
+ ******************************************************************************/
+
+JTrace::Buffer*
+JTrace::GetBuffer()
+{
+	JTraceBufferPtr* p = theThreadBuffer;
+	if (p == NULL)
+		{
+		return NULL;
+		}
+	else if (p->buffer == NULL)
+		{
+		ACE_GUARD_RETURN(ACE_SYNCH_MUTEX, guard, theBufferListMutex, NULL);
+
+		theBufferCount++;
+		p->buffer = new Buffer(theBufferCount, theBufferList);
+		assert( p->buffer != NULL );
+		theBufferList = p->buffer;
+		}
+
+	return p->buffer;
+}
+
+/******************************************************************************
+ Clear (static)
+
+	Discards all recorded events.
+
+ ******************************************************************************/
+
+void
+JTrace::Clear()
+{
+	ACE_GUARD(ACE_SYNCH_MUTEX, guard, theBufferListMutex);
+
+	for (Buffer* b = theBufferList; b != NULL; b = b->itsNextBuffer)
+		{
+		b->Clear();
+		}
+}
+
+/******************************************************************************
+ WriteChromeTrace (static)
+
+	Writes all recorded events as complete ("X") events in the Chrome
+	trace event format.  Each thread's events are written in the order
+	in which the zones ended.
+
+ ******************************************************************************/
+
+JBoolean
+JTrace::WriteChromeTrace
+	(
+	const JCharacter* fileName
+	)
+{
+	ofstream output(fileName);
+	WriteChromeTrace(output);
+	return JI2B( output.good() );
+}
+
+static void	JTracePrintMicroseconds(ostream& output, const JTraceTime t);
+static void	JTracePrintString(ostream& output, const JCharacter* s);
+
+void
+JTrace::WriteChromeTrace
+	(
+	ostream& output
+	)
+{
+	ACE_GUARD(ACE_SYNCH_MUTEX, guard, theBufferListMutex);
+
+	// use the earliest event as the origin to keep the numbers small
+
+	JBoolean hasOrigin = kJFalse;
+	JTraceTime origin  = 0;
+	for (Buffer* b = theBufferList; b != NULL; b = b->itsNextBuffer)
+		{
+		if (b->itsEventCount > 0)
+			{
+			const JTraceTime t = (b->GetEvent(0)).start;
+			if (!hasOrigin || t < origin)
+				{
+				origin    = t;
+				hasOrigin = kJTrue;
+				}
+			}
+		}
+
+	const long pid = ACE_OS::getpid();
+
+	output << "{\"traceEvents\":[";
+
+	JBoolean first = kJTrue;
+	for (Buffer* b = theBufferList; b != NULL; b = b->itsNextBuffer)
+		{
+		for (JIndex i=0; i<b->itsEventCount; i++)
+			{
+			const Event& e = b->GetEvent(i);
+			const JTraceTime start = (e.start > origin ? e.start - origin : 0);
+
+			if (!first)
+				{
+				output << ',';
+				}
+			first = kJFalse;
+
+			output << "\n{\"name\":";
+			JTracePrintString(output, e.name);
+			output << ",\"ph\":\"X\",\"ts\":";
+			JTracePrintMicroseconds(output, start);
+			output << ",\"dur\":";
+			JTracePrintMicroseconds(output, e.end - e.start);
+			output << ",\"pid\":" << pid;
+			output << ",\"tid\":" << b->itsThreadIndex;
+			output << '}';
+			}
+		}
+
+	output << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+/******************************************************************************
+ JTracePrintMicroseconds (local)
+
+	Chrome expects microseconds, but we keep the nanoseconds as a fraction.
+	The microseconds do not fit in 32 bits after about 71 minutes, so they
+	are printed as JTraceTime.
+
+ ******************************************************************************/
+
+static void
+JTracePrintMicroseconds
+	(
+	ostream&			output,
+	const JTraceTime	t
+	)
+{
+	const JTraceTime us = t / 1000;
+	const JSize ns      = t % 1000;
+	output << us << '.'
+		   << (ns < 100 ? "0" : "") << (ns < 10 ? "0" : "") << ns;
+}
+
+/******************************************************************************
+ JTracePrintString (local)
+
+ ******************************************************************************/
+
+static void
+JTracePrintString
+	(
+	ostream&			output,
+	const JCharacter*	s
+	)
+{
+	output << '"';
+	for ( ; *s != '\0'; s++)
+		{
+		const unsigned char c = *s;
+		if (c == '"' || c == '\\')
+			{
+			output << '\\' << *s;
+			}
+		else if (c < 0x20)
+			{
+			output << ' ';
+			}
+		else
+			{
+			output << *s;
+			}
+		}
+	output << '"';
+}
@@ -0,0 +1,139 @@
+/******************************************************************************
+ JTrace.h
+
+	Interface for the JTrace class
+
+ ******************************************************************************/
+
+#ifndef _H_JTrace
+#define _H_JTrace
+
+#if !defined _J_UNIX && !defined ACE_LACKS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <jTypes.h>
+
+class JString;
+
+#ifdef JUInt64_EXISTS
+typedef JUInt64				JTraceTime;		// nanoseconds
+#else
+typedef unsigned long long	JTraceTime;
+#endif
+
+class JTrace
+{
+public:
+
+	struct Event
+	{
+		const JCharacter*	name;
+		JTraceTime			start;
+		JTraceTime			end;
+	};
+
+	class Buffer;
+
+public:
+
+	static JBoolean		IsEnabled();
+	static void			SetEnabled(const JBoolean enabled);
+
+	static JTraceTime	GetTime();
+	static void			Record(const JCharacter* name,
+							   const JTraceTime start, const JTraceTime end);
+	static void			Clear();
+
+	static JBoolean		WriteChromeTrace(const JCharacter* fileName);
+	static void			WriteChromeTrace(ostream& output);
+
+private:
+
+	static JBoolean	theEnabledFlag;
+
+private:
+
+	static Buffer*	GetBuffer();
+
+	// not allowed
+
+	JTrace();
+	JTrace(const JTrace& source);
+	const JTrace& operator=(const JTrace& source);
+};
+
+/******************************************************************************
+ JTraceZone
+
+	Records the time between construction and destruction as a single
+	event.  The name must be a string constant, since only the pointer
+	is stored.  Use J_TRACE_ZONE() so the zone compiles away unless
+	_J_USE_TRACING is defined.
+
+ ******************************************************************************/
+
+class JTraceZone
+{
+public:
+
+	JTraceZone(const JCharacter* name)
+		:
+		itsName(name),
+		itsStart(JTrace::IsEnabled() ? JTrace::GetTime() : 0)
+	{ };
+
+	~JTraceZone()
+	{
+		if (itsStart > 0)
+			{
+			JTrace::Record(itsName, itsStart, JTrace::GetTime());
+			}
+	};
+
+private:
+
+	const JCharacter*	itsName;
+	const JTraceTime	itsStart;
+
+private:
+
+	// not allowed
+
+	JTraceZone(const JTraceZone& source);
+	const JTraceZone& operator=(const JTraceZone& source);
+};
+
+#ifdef _J_USE_TRACING
+	#define J_TRACE_ZONE_VAR2(name,line)	JTraceZone jTraceZone##line(name)
+	#define J_TRACE_ZONE_VAR(name,line)		J_TRACE_ZONE_VAR2(name,line)
+	#define J_TRACE_ZONE(name)				J_TRACE_ZONE_VAR(name,__LINE__)
+#else
+	#define J_TRACE_ZONE(name)
+#endif
+
+
+/******************************************************************************
+ Enabled
+
+	Recording is off by default, so an instrumented build costs only one
+	test per zone until someone asks for a trace.
+
+ ******************************************************************************/
+
+inline JBoolean
+JTrace::IsEnabled()
+{
+	return theEnabledFlag;
+}
+
+inline void
+JTrace::SetEnabled
+	(
+	const JBoolean enabled
+	)
+{
+	theEnabledFlag = enabled;
+}
+
+#endif
@@ -0,0 +1,535 @@
+/******************************************************************************
+ JWorkerPool.cpp
+
+	Runs JWorkerTasks on a small set of background threads, so long
+	operations do not block the event loop.
+
+	Each worker has its own queue.  Add() distributes tasks round robin,
+	and a worker whose queue is empty steals from the others, so one slow
+	task does not hold up the ones queued behind it.  Workers are started
+	as tasks arrive, up to the maximum passed to the constructor.
+
+	The queues that are shared with the workers are TaskQueues rather
+	than JPtrArrays, because JBroadcasters must only be used on the main
+	thread.  All the Worker objects are created by the constructor, so
+	the list never changes while the workers are scanning it.
+
+	The event loop must call DeliverFinishedTasks() periodically.  It
+	broadcasts JWorkerTask::Finished on the main thread for each task that
+	has completed and then deletes the task.
+
+	If ACE was built without thread support, tasks are performed one at a
+	time by DeliverFinishedTasks(), so code using the pool does not need
+	a separate path for this case.
+
+	BASE CLASS = none
+
+ ******************************************************************************/
+
+#include <JCoreStdInc.h>
+#include <JWorkerPool.h>
+#include <JWorkerTask.h>
+#include <JMinMax.h>
+#include <ace/OS_NS_unistd.h>
+#include <jAssert.h>
+
+// JMemoryManager is not thread-safe.
+
+#if defined ACE_HAS_THREADS && ACE_MT_SAFE && ! defined _J_ARRAY_NEW_OVERRIDABLE
+#define J_WORKER_THREADS
+#include <ace/Thread.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Thread_Semaphore.h>
+#include <ace/Guard_T.h>
+#include <ace/OS_NS_signal.h>
+#endif
+
+const JSize kDefaultMaxWorkerCount = 8;
+
+/******************************************************************************
+ JWorkerPool::TaskQueue
+
+	Circular buffer of tasks that does not broadcast, so it can be used by
+	any thread.  The owner must provide the locking.
+
+ ******************************************************************************/
+
+struct JWorkerPool::TaskQueue
+{
+	JWorkerTask**	list;
+	JSize			size;
+	JIndex			first;		// zero-based
+	JSize			count;
+
+	TaskQueue()
+		:
+		list(NULL),
+		size(0),
+		first(0),
+		count(0)
+	{ };
+
+	~TaskQueue()
+	{
+		delete [] list;
+	};
+
+	JBoolean
+	IsEmpty() const
+	{
+		return JI2B( count == 0 );
+	};
+
+	void
+	Append
+		(
+		JWorkerTask* task
+		)
+	{
+		if (count == size)
+			{
+			const JSize newSize   = JMax((JSize) 16, 2 * size);
+			JWorkerTask** newList = new JWorkerTask* [ newSize ];
+			assert( newList != NULL );
+
+			for (JIndex i=0; i<count; i++)
+				{
+				newList[i] = list[ (first + i) % size ];
+				}
+
+			delete [] list;
+			list  = newList;
+			size  = newSize;
+			first = 0;
+			}
+
+		list[ (first + count) % size ] = task;
+		count++;
+	};
+
+	JWorkerTask*
+	RemoveFirst()
+	{
+		assert( count > 0 );
+		JWorkerTask* task = list[ first ];
+		first             = (first + 1) % size;
+		count--;
+		return task;
+	};
+
+	JWorkerTask*
+	RemoveLast()
+	{
+		assert( count > 0 );
+		count--;
+		return list[ (first + count) % size ];
+	};
+};
+
+/******************************************************************************
+ JWorkerPool::Worker
+
+ ******************************************************************************/
+
+struct JWorkerPool::Worker
+{
+	JWorkerPool*	pool;
+	JIndex			index;
+	TaskQueue		queue;			// protected by lock
+
+#ifdef J_WORKER_THREADS
+	ACE_Thread_Mutex		lock;
+	ACE_thread_t			threadID;
+
+	static ACE_THR_FUNC_RETURN	Main(void* data);
+#endif
+
+	Worker
+		(
+		JWorkerPool*	p,
+		const JIndex	i
+		)
+		:
+		pool(p),
+		index(i)
+	{ };
+};
+
+/******************************************************************************
+ Constructor
+
+	maxWorkerCount = 0 means one worker per processor, up to 8.
+
+ ******************************************************************************/
+
+JWorkerPool::JWorkerPool
+	(
+	const JSize maxWorkerCount
+	)
+	:
+	itsMaxWorkerCount(0),
+	itsWorkerList(NULL),
+	itsWorkerSlotCount(0),
+	itsWorkerCount(0),
+	itsNextWorkerIndex(1),
+	itsFinishedLock(NULL),
+	itsHasFinishedFlag(kJFalse),
+	itsTaskSemaphore(NULL),
+	itsQuitFlag(kJFalse)
+{
+	itsTaskList = new JPtrArray<JWorkerTask>(JPtrArrayT::kDeleteAll);
+	assert( itsTaskList != NULL );
+
+	itsPendingList = new JPtrArray<JWorkerTask>(JPtrArrayT::kForgetAll);
+	assert( itsPendingList != NULL );
+
+	itsFinishedList = new TaskQueue;
+	assert( itsFinishedList != NULL );
+
+#ifdef J_WORKER_THREADS
+
+	itsMaxWorkerCount = maxWorkerCount;
+	if (itsMaxWorkerCount == 0)
+		{
+		const long cpuCount = ACE_OS::num_processors_online();
+		itsMaxWorkerCount   = JMin(kDefaultMaxWorkerCount,
+								   (JSize) JMax(1L, cpuCount));
+		}
+
+	itsWorkerSlotCount = itsMaxWorkerCount;
+	itsWorkerList      = new Worker* [ itsWorkerSlotCount ];
+	assert( itsWorkerList != NULL );
+
+	for (JIndex i=1; i<=itsWorkerSlotCount; i++)
+		{
+		itsWorkerList[i-1] = new Worker(this, i);
+		assert( itsWorkerList[i-1] != NULL );
+		}
+
+	itsFinishedLock = new ACE_Thread_Mutex;
+	assert( itsFinishedLock != NULL );
+
+	itsTaskSemaphore = new ACE_Thread_Semaphore(0);
+	assert( itsTaskSemaphore != NULL );
+
+#endif
+}
+
+/******************************************************************************
+ Destructor
+
+	Cancels all tasks and waits for the workers to finish.  Tasks that
+	have not been delivered are deleted without broadcasting.
+
+ ******************************************************************************/
+
+JWorkerPool::~JWorkerPool()
+{
+	CancelAll();
+
+#ifdef J_WORKER_THREADS
+
+	itsQuitFlag = kJTrue;
+	for (JIndex i=1; i<=itsWorkerCount; i++)
+		{
+		itsTaskSemaphore->release();
+		}
+
+	for (JIndex i=1; i<=itsWorkerCount; i++)
+		{
+		ACE_thread_t departed;
+		ACE_THR_FUNC_RETURN status;
+		ACE_Thread::join(itsWorkerList[i-1]->threadID, &departed, &status);
+		}
+
+	for (JIndex i=1; i<=itsWorkerSlotCount; i++)
+		{
+		delete itsWorkerList[i-1];
+		}
+
+	delete [] itsWorkerList;
+	delete itsFinishedLock;
+	delete itsTaskSemaphore;
+
+#endif
+
+	delete itsFinishedList;
+	delete itsPendingList;
+	delete itsTaskList;
+}
+
+/******************************************************************************
+ IsMultithreaded (static)
+
+	Returns kJFalse if tasks are performed on the main thread.
+
+ ******************************************************************************/
+
+JBoolean
+JWorkerPool::IsMultithreaded()
+{
+#ifdef J_WORKER_THREADS
+	return kJTrue;
+#else
+	return kJFalse;
+#endif
+}
+
+/******************************************************************************
+ Add
+
+	We take ownership of the task.  This must only be called from the
+	main thread.
+
+ ******************************************************************************/
+
+void
+JWorkerPool::Add
+	(
+	JWorkerTask* task
+	)
+{
+	itsTaskList->Append(task);
+
+#ifdef J_WORKER_THREADS
+
+	if (itsWorkerCount < itsMaxWorkerCount &&
+		itsWorkerCount < itsTaskList->GetElementCount())
+		{
+		StartWorker();
+		}
+
+	if (itsWorkerCount > 0)
+		{
+		Worker* worker     = itsWorkerList[ itsNextWorkerIndex-1 ];
+		itsNextWorkerIndex = (itsNextWorkerIndex % itsWorkerCount) + 1;
+
+		{
+		ACE_Guard<ACE_Thread_Mutex> guard(worker->lock);
+		worker->queue.Append(task);
+		}
+
+		itsTaskSemaphore->release();
+		return;
+		}
+
+#endif
+
+	itsPendingList->Append(task);
+}
+
+/******************************************************************************
+ CancelAll
+
+	Cancels every task that has not been delivered.
+
+ ******************************************************************************/
+
+void
+JWorkerPool::CancelAll()
+{
+	const JSize count = itsTaskList->GetElementCount();
+	for (JIndex i=1; i<=count; i++)
+		{
+		(itsTaskList->NthElement(i))->Cancel();
+		}
+}
+
+/******************************************************************************
+ DeliverFinishedTasks
+
+	Broadcasts JWorkerTask::Finished for each task that has completed and
+	then deletes the task.  Returns kJTrue if any tasks were finished.
+
+	This must only be called from the main thread.
+
+ ******************************************************************************/
+
+JBoolean
+JWorkerPool::DeliverFinishedTasks()
+{
+	JPtrArray<JWorkerTask> list(JPtrArrayT::kForgetAll);
+
+#ifdef J_WORKER_THREADS
+
+	if (itsHasFinishedFlag)		// avoid locking on every pass through the event loop
+		{
+		ACE_Guard<ACE_Thread_Mutex> guard(*itsFinishedLock);
+		while (!itsFinishedList->IsEmpty())
+			{
+			list.Append(itsFinishedList->RemoveFirst());
+			}
+		itsHasFinishedFlag = kJFalse;
+		}
+
+#endif
+
+	// without workers, we perform one task each time, to avoid blocking
+	// the event loop
+
+	if (!itsPendingList->IsEmpty())
+		{
+		JWorkerTask* task = itsPendingList->FirstElement();
+		itsPendingList->RemoveElement(1);
+		if (!task->IsCancelled())
+			{
+			task->Perform();
+			}
+		list.Append(task);
+		}
+
+	const JSize count = list.GetElementCount();
+	for (JIndex i=1; i<=count; i++)
+		{
+		JWorkerTask* task = list.NthElement(i);
+		itsTaskList->Remove(task);
+
+		// a recipient may have cancelled the rest
+
+		if (!task->IsCancelled())
+			{
+			task->BroadcastFinished();
+			}
+		delete task;
+		}
+
+	return JI2B( count > 0 );
+}
+
+#ifdef J_WORKER_THREADS
+
+/******************************************************************************
+ StartWorker (private)
+
+	If the thread cannot be created, we stop trying to add workers.
+
+ ******************************************************************************/
+
+JBoolean
+JWorkerPool::StartWorker()
+{
+	Worker* worker = itsWorkerList[ itsWorkerCount ];
+	if (ACE_Thread::spawn(Worker::Main, worker, THR_NEW_LWP | THR_JOINABLE,
+						  &(worker->threadID)) == 0)
+		{
+		itsWorkerCount++;
+		return kJTrue;
+		}
+	else
+		{
+		itsMaxWorkerCount = itsWorkerCount;
+		return kJFalse;
+		}
+}
+
+/******************************************************************************
+ TakeTask (private)
+
+	Called by a worker after acquiring itsTaskSemaphore, so there is at
+	least one task waiting somewhere.  The worker takes the oldest task
+	in its own queue.  If it has none, it steals the newest task from
+	another queue, since that end is least likely to be contended.
+
+	Only itsWorkerList and itsWorkerSlotCount are read here, and they do
+	not change while the workers are running.  The queues of workers
+	that have not been started are always empty.
+
+ ******************************************************************************/
+
+JWorkerTask*
+JWorkerPool::TakeTask
+	(
+	const JIndex workerIndex
+	)
+{
+	Worker* self = itsWorkerList[ workerIndex-1 ];
+	while (1)
+		{
+		{
+		ACE_Guard<ACE_Thread_Mutex> guard(self->lock);
+		if (!self->queue.IsEmpty())
+			{
+			return self->queue.RemoveFirst();
+			}
+		}
+
+		const JSize count = itsWorkerSlotCount;
+		for (JIndex i=1; i<count; i++)
+			{
+			Worker* victim = itsWorkerList[ (workerIndex - 1 + i) % count ];
+
+			ACE_Guard<ACE_Thread_Mutex> guard(victim->lock);
+			if (!victim->queue.IsEmpty())
+				{
+				return victim->queue.RemoveLast();
+				}
+			}
+
+		ACE_OS::thr_yield();
+		}
+}
+
+/******************************************************************************
+ TaskFinished (private)
+
+	Called by a worker when it is done with a task.
+
+ ******************************************************************************/
+
+void
+JWorkerPool::TaskFinished
+	(
+	JWorkerTask* task
+	)
+{
+	ACE_Guard<ACE_Thread_Mutex> guard(*itsFinishedLock);
+	itsFinishedList->Append(task);
+	itsHasFinishedFlag = kJTrue;
+}
+
+/******************************************************************************
+ Worker::Main (static)
+
+	Thread function for each worker.
+
+ ******************************************************************************/
+
+ACE_THR_FUNC_RETURN
+JWorkerPool::Worker::Main
+	(
+	void* data
+	)
+{
+	Worker* self      = static_cast<Worker*>(data);
+	JWorkerPool* pool = self->pool;
+
+	// signals must be handled by the main thread
+
+	sigset_t mask;
+	ACE_OS::sigfillset(&mask);
+	ACE_OS::thr_sigsetmask(SIG_BLOCK, &mask, NULL);
+
+	while (1)
+		{
+		pool->itsTaskSemaphore->acquire();
+		if (pool->itsQuitFlag)
+			{
+			break;
+			}
+
+		JWorkerTask* task = pool->TakeTask(self->index);
+		if (!task->IsCancelled())
+			{
+			task->Perform();
+			}
+		pool->TaskFinished(task);
+		}
+
+	return 0;
+}
+
+#endif
+
+#define JTemplateType JWorkerTask
+#include <JPtrArray.tmpls>
+#undef JTemplateType
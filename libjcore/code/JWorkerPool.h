@@ -0,0 +1,122 @@
+/******************************************************************************
+ JWorkerPool.h
+
+	Interface for the JWorkerPool class
+
+ ******************************************************************************/
+
+#ifndef _H_JWorkerPool
+#define _H_JWorkerPool
+
+#if !defined _J_UNIX && !defined ACE_LACKS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <JPtrArray.h>
+
+class JWorkerTask;
+class ACE_Thread_Mutex;
+class ACE_Thread_Semaphore;
+
+class JWorkerPool
+{
+public:
+
+	JWorkerPool(const JSize maxWorkerCount = 0);
+
+	~JWorkerPool();
+
+	void		Add(JWorkerTask* task);
+	void		CancelAll();
+
+	JBoolean	IsBusy() const;
+	JSize		GetTaskCount() const;
+	JSize		GetWorkerCount() const;
+	JSize		GetMaxWorkerCount() const;
+
+	JBoolean	DeliverFinishedTasks();
+
+	static JBoolean	IsMultithreaded();
+
+public:
+
+	struct TaskQueue;
+	struct Worker;
+	friend struct Worker;
+
+private:
+
+	JSize		itsMaxWorkerCount;
+	Worker**	itsWorkerList;			// created by constructor, never changes
+	JSize		itsWorkerSlotCount;		// size of itsWorkerList
+	JSize		itsWorkerCount;			// number of threads started
+	JIndex		itsNextWorkerIndex;		// round robin for Add()
+
+	JPtrArray<JWorkerTask>*	itsTaskList;		// not yet delivered
+	JPtrArray<JWorkerTask>*	itsPendingList;		// no worker available
+	TaskQueue*				itsFinishedList;	// protected by itsFinishedLock
+	ACE_Thread_Mutex*		itsFinishedLock;
+	volatile JBoolean		itsHasFinishedFlag;
+
+	ACE_Thread_Semaphore*	itsTaskSemaphore;	// one post for each queued task
+	volatile JBoolean		itsQuitFlag;
+
+private:
+
+	JBoolean		StartWorker();
+	JWorkerTask*	TakeTask(const JIndex workerIndex);
+	void			TaskFinished(JWorkerTask* task);
+
+	// not allowed
+
+	JWorkerPool(const JWorkerPool& source);
+	const JWorkerPool& operator=(const JWorkerPool& source);
+};
+
+
+/******************************************************************************
+ IsBusy
+
+	Returns kJTrue if any task has not yet been delivered.
+
+ ******************************************************************************/
+
+inline JBoolean
+JWorkerPool::IsBusy()
+	const
+{
+	return !itsTaskList->IsEmpty();
+}
+
+/******************************************************************************
+ GetTaskCount
+
+ ******************************************************************************/
+
+inline JSize
+JWorkerPool::GetTaskCount()
+	const
+{
+	return itsTaskList->GetElementCount();
+}
+
+/******************************************************************************
+ Worker count
+
+ ******************************************************************************/
+
+inline JSize
+JWorkerPool::GetWorkerCount()
+	const
+{
+	return itsWorkerCount;
+}
+
+inline JSize
+JWorkerPool::GetMaxWorkerCount()
+	const
+{
+	return itsMaxWorkerCount;
+}
+
+#endif
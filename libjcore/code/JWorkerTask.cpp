@@ -0,0 +1,56 @@
+/******************************************************************************
+ JWorkerTask.cpp
+
+	Base class for work that is run by JWorkerPool on a background thread.
+
+	Perform() runs on a worker thread, so it must not touch any object
+	that the main thread might use at the same time, and it must not
+	broadcast.  Store the results in the task instead.  After Perform()
+	returns, JWorkerPool::DeliverFinishedTasks() broadcasts Finished on
+	the main thread, where the recipient can extract the results.  The
+	task is deleted immediately afterwards.
+
+	BASE CLASS = virtual JBroadcaster
+
+ ******************************************************************************/
+
+#include <JCoreStdInc.h>
+#include <JWorkerTask.h>
+#include <jAssert.h>
+
+// JBroadcaster message types
+
+const JCharacter* JWorkerTask::kFinished = "Finished::JWorkerTask";
+
+/******************************************************************************
+ Constructor
+
+ ******************************************************************************/
+
+JWorkerTask::JWorkerTask()
+	:
+	itsCancelledFlag(kJFalse)
+{
+}
+
+/******************************************************************************
+ Destructor
+
+ ******************************************************************************/
+
+JWorkerTask::~JWorkerTask()
+{
+}
+
+/******************************************************************************
+ BroadcastFinished (private)
+
+	Called by JWorkerPool on the main thread.
+
+ ******************************************************************************/
+
+void
+JWorkerTask::BroadcastFinished()
+{
+	Broadcast(Finished());
+}
@@ -0,0 +1,87 @@
+/******************************************************************************
+ JWorkerTask.h
+
+	Interface for the JWorkerTask class
+
+ ******************************************************************************/
+
+#ifndef _H_JWorkerTask
+#define _H_JWorkerTask
+
+#if !defined _J_UNIX && !defined ACE_LACKS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <JBroadcaster.h>
+
+class JWorkerTask : virtual public JBroadcaster
+{
+public:
+
+	JWorkerTask();
+
+	virtual ~JWorkerTask();
+
+	virtual void	Perform() = 0;
+
+	void		Cancel();
+	JBoolean	IsCancelled() const;
+
+private:
+
+	volatile JBoolean	itsCancelledFlag;
+
+private:
+
+	void	BroadcastFinished();
+
+	friend class JWorkerPool;
+
+	// not allowed
+
+	JWorkerTask(const JWorkerTask& source);
+	const JWorkerTask& operator=(const JWorkerTask& source);
+
+public:
+
+	// JBroadcaster messages
+
+	static const JCharacter* kFinished;
+
+	class Finished : public JBroadcaster::Message
+		{
+		public:
+
+			Finished()
+				:
+				JBroadcaster::Message(kFinished)
+				{ };
+		};
+};
+
+
+/******************************************************************************
+ Cancel
+
+	Perform() is not called if the task has not yet started.  Otherwise,
+	Perform() should check IsCancelled() periodically and return early.
+	Either way, Finished is not broadcast.
+
+	This can be called from any thread.
+
+ ******************************************************************************/
+
+inline void
+JWorkerTask::Cancel()
+{
+	itsCancelledFlag = kJTrue;
+}
+
+inline JBoolean
+JWorkerTask::IsCancelled()
+	const
+{
+	return itsCancelledFlag;
+}
+
+#endif
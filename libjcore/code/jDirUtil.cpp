@@ -10,7 +10,7 @@
 #include <JCoreStdInc.h>
 #include <jDirUtil.h>
 #include <jFileUtil.h>
-#include <JDirInfo.h>
+#include <JDirTreeSearch.h>
 #include <JLatentPG.h>
 #include <JString.h>
 #include <limits.h>
@@ -249,13 +249,11 @@ JGetClosestDirectory
 /******************************************************************************
  JSearchSubdirs
 
-	Recursively search for the given file or directory, starting from the
-	specified directory.  We do this in two passes:
-		1)  Search in the given directory
-		2)  Search in the sub-directories
-
-	This mirrors the user's search strategy and helps insure that the
-	expected file is found, if there are duplicates.
+	Search for the given file or directory, starting from the specified
+	directory.  The tree is searched breadth-first, so if there are
+	duplicates, the one closest to startPath is found.  This mirrors the
+	user's search strategy and helps insure that the expected file is
+	found.
 
 	caseSensitive is used only if name does not include a partial path,
 	because it is just too messy otherwise.
@@ -266,13 +264,10 @@ JGetClosestDirectory
 	A progress display is used if the search takes more than 3 seconds.
 	If you do not pass one in, JNewPG() will be used to create one.
 
- ******************************************************************************/
+	To search for several names in one pass, or to reuse the results in
+	later searches, use JDirTreeSearch directly.
 
-static JBoolean JSearchSubdirs_private(
-	const JCharacter* startPath, const JCharacter* name,
-	const JBoolean isFile, const JBoolean caseSensitive,
-	JString* path, JString* newName,
-	JProgressDisplay& pg, JBoolean* cancelled);
+ ******************************************************************************/
 
 JBoolean
 JSearchSubdirs
@@ -300,123 +295,16 @@ JSearchSubdirs
 	msg += "\"...";
 	pg.VariableLengthProcessBeginning(msg, kJTrue, kJFalse);
 
-	JBoolean cancelled = kJFalse;
-	const JBoolean found =
-		JSearchSubdirs_private(startPath, name, isFile, caseSensitive,
-							   path, newName, pg, &cancelled);
-	if (!found)
-		{
-		path->Clear();
-		if (newName != NULL)
-			{
-			newName->Clear();
-			}
-		}
-
-	pg.ProcessFinished();
-
-	if (userCancelled != NULL)
-		{
-		*userCancelled = cancelled;
-		}
-	return found;
-}
+	JDirTreeSearch::Target target;
+	target.name          = name;
+	target.isFile        = isFile;
+	target.caseSensitive = caseSensitive;
+	target.path          = path;
+	target.newName       = newName;
 
-JBoolean
-JSearchSubdirs_private
-	(
-	const JCharacter*	startPath,
-	const JCharacter*	name,
-	const JBoolean		isFile,
-	const JBoolean		caseSensitive,
-	JString*			path,
-	JString*			newName,
-	JProgressDisplay&	pg,
-	JBoolean*			cancelled
-	)
-{
-	// checking this way covers partial path cases like "X11/Xlib.h"
+	JDirTreeSearch search;
+	const JBoolean found = search.Search(startPath, 1, &target, &pg, userCancelled);
 
-	const JString fullName = JCombinePathAndName(startPath, name);
-	if (( isFile && JFileExists(fullName)) ||
-		(!isFile && JDirectoryExists(fullName)))
-		{
-		const JBoolean ok = JGetTrueName(startPath, path);
-		assert( ok );
-		if (newName != NULL)
-			{
-			*newName = name;
-			}
-		return kJTrue;
-		}
-
-	JDirInfo* info;
-	if (!JDirInfo::Create(startPath, &info))
-		{
-		return kJFalse;
-		}
-
-	JBoolean found    = kJFalse;
-	const JSize count = info->GetEntryCount();
-
-	// check each entry (if case sensitive, the initial check is enough)
-
-	if (!caseSensitive)
-		{
-		for (JIndex i=1; i<=count; i++)
-			{
-			const JDirEntry& entry = info->GetEntry(i);
-
-			if ((( isFile && entry.IsFile()) ||
-				 (!isFile && entry.IsDirectory())) &&
-				JStringCompare(name, entry.GetName(), caseSensitive) == 0)
-				{
-				const JBoolean ok = JGetTrueName(startPath, path);
-				assert( ok );
-				if (newName != NULL)
-					{
-					*newName = entry.GetName();
-					}
-				found = kJTrue;
-				break;
-				}
-
-			if (!pg.IncrementProgress())
-				{
-				*cancelled = kJTrue;
-				break;
-				}
-			}
-		}
-
-	// recurse on each directory
-
-	if (!found && !(*cancelled))
-		{
-		for (JIndex i=1; i<=count; i++)
-			{
-			const JDirEntry& entry = info->GetEntry(i);
-
-			if (entry.IsDirectory() && !entry.IsLink())
-				{
-				const JString& newPath = entry.GetFullName();
-				if (JSearchSubdirs_private(newPath, name, isFile,
-										   caseSensitive, path, newName,
-										   pg, cancelled))
-					{
-					found = kJTrue;
-					break;
-					}
-				}
-
-			if (*cancelled || (caseSensitive && !pg.IncrementProgress()))
-				{
-				*cancelled = kJTrue;
-				break;
-				}
-			}
-		}
-
-	delete info;
+	pg.ProcessFinished();
 	return found;
 }
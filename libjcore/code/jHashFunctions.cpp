@@ -16,6 +16,7 @@
 //Library Header
 #include <JCoreStdInc.h>
 #include <jHashFunctions.h>
+#include <string.h>
 
 #include <jAssert.h>
 
@@ -123,3 +124,80 @@ JHash8Bit
 
 	return JRandWord(hash); // Extra "randomness" as discussed above
 }
+
+/******************************************************************************
+ JHashString
+
+	A general purpose hash function for strings of any kind, much faster
+	than JHash7Bit and JHash8Bit on all but the shortest strings because it
+	consumes a whole word at a time.  This is MurmurHash2 (Austin Appleby,
+	public domain), using the 64-bit variant when JHashValue is 64 bits.
+	All bits of the result are significant.
+
+	The version that takes a length does not require the key to be
+	terminated, and it accepts embedded nulls.
+
+ *****************************************************************************/
+
+JHashValue
+JHashString
+	(
+	const JCharacter* const& key
+	)
+{
+	assert(key != NULL);
+	return JHashString(key, strlen(key));
+}
+
+JHashValue
+JHashString
+	(
+	const JCharacter*	key,
+	const JSize			length
+	)
+{
+#if JWORDSIZE == 8
+	const JHashValue m = 0xC6A4A7935BD1E995UL;
+	const int r        = 47;
+#else
+	const JHashValue m = 0x5BD1E995UL;
+	const int r        = 24;
+#endif
+
+	const unsigned char* data = (const unsigned char*) key;
+	const unsigned char* end  = data + (length / sizeof(JHashValue)) * sizeof(JHashValue);
+
+	JHashValue h = 0x9747B28CUL ^ (length * m);
+	while (data != end)
+		{
+		JHashValue k;
+		memcpy(&k, data, sizeof(JHashValue));	// alignment is unknown
+		data += sizeof(JHashValue);
+
+		k *= m;
+		k ^= k >> r;
+		k *= m;
+
+		h ^= k;
+		h *= m;
+		}
+
+	const JSize tail = length % sizeof(JHashValue);
+	if (tail > 0)
+		{
+		JHashValue k = 0;
+		for (JIndex i=0; i<tail; i++)
+			{
+			k |= ((JHashValue) data[i]) << (8*i);
+			}
+
+		h ^= k;
+		h *= m;
+		}
+
+	h ^= h >> r;
+	h *= m;
+	h ^= h >> r;
+
+	return h;
+}
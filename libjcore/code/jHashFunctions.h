@@ -18,12 +18,34 @@
 
 #include <jRand.h>
 #include <jTypes.h>
+#include <JStringView.h>
 
 	JHashValue JHash7Bit(const JCharacter* const& key);
 	JHashValue JHash8Bit(const JCharacter* const& key);
 
+	JHashValue JHashString(const JCharacter* const& key);
+	JHashValue JHashString(const JCharacter* key, const JSize length);
+	JHashValue JHashString(const JStringView& key);
 
 
+
+/******************************************************************************
+ JHashString
+
+	Hashes the characters of a view, so the key does not have to be copied.
+	Gives the same result as hashing a terminated copy.
+
+ *****************************************************************************/
+
+inline JHashValue
+JHashString
+	(
+	const JStringView& key
+	)
+{
+	return JHashString(key.GetCharacters(), key.GetLength());
+}
+
 /******************************************************************************
  JDualHash
 
@@ -119,6 +119,62 @@ operator delete[]
 	JMemoryManager::Instance()->Delete(memory, kJTrue);
 }
 
+/******************************************************************************
+ operator new (nothrow)
+
+	JMemoryManager::New() returns NULL if it fails.
+
+ *****************************************************************************/
+
+void*
+operator new
+	(
+	size_t					size,
+	const std::nothrow_t&
+	)
+	throw()
+{
+	return JMemoryManager::New(size, "<UNKNOWN>", 0, kJFalse);
+}
+
+void*
+operator new[]
+	(
+	size_t					size,
+	const std::nothrow_t&
+	)
+	throw()
+{
+	return JMemoryManager::New(size, "<UNKNOWN>", 0, kJTrue);
+}
+
+/******************************************************************************
+ operator delete (nothrow)
+
+ *****************************************************************************/
+
+void
+operator delete
+	(
+	void*					memory,
+	const std::nothrow_t&
+	)
+	throw()
+{
+	JMemoryManager::Instance()->Delete(memory, kJFalse);
+}
+
+void
+operator delete[]
+	(
+	void*					memory,
+	const std::nothrow_t&
+	)
+	throw()
+{
+	JMemoryManager::Instance()->Delete(memory, kJTrue);
+}
+
 /******************************************************************************
  JLocateDelete
 
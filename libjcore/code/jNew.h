@@ -25,6 +25,7 @@
 #endif
 
 #include <stdlib.h> // For size_t
+#include <new>		// For std::nothrow_t
 #include <jTypes.h>
 
 	#ifdef __KCC
@@ -46,6 +47,15 @@
 	void operator delete(void* memory);
 	void operator delete[](void* memory);
 
+	// Code that is not compiled with jNew.h can still call these, e.g., the
+	// C++ library.  They must use JMemoryManager, too, because its blocks
+	// can have a header.
+
+	void* operator new(size_t size, const std::nothrow_t&) throw();
+	void* operator new[](size_t size, const std::nothrow_t&) throw();
+	void  operator delete(void* memory, const std::nothrow_t&) throw();
+	void  operator delete[](void* memory, const std::nothrow_t&) throw();
+
 	void JLocateDelete(const JCharacter* file, const JUInt32 line);
 
 #endif
@@ -23,15 +23,29 @@
 #include <jSysUtil.h>
 #include <jErrno.h>
 #include <jMissingProto.h>
+#include <fcntl.h>
 #include <jAssert.h>
 
+#if defined _POSIX_SPAWN && _POSIX_SPAWN > 0
+	#define J_USE_POSIX_SPAWN
+	#include <spawn.h>
+	extern char** environ;
+#endif
+
 static JBoolean theIncludeCWDOnPathFlag = kJFalse;
+static JBoolean theUseSpawnFlag         = kJTrue;
 
 // Private functions
 
 void		JCleanArg(JString* arg);
 JBoolean	JProgramAvailable(const JCharacter* programName, JString* fixedName);
 
+static JError	JSpawnChild(const JCharacter* argv[], int fd[3][2], pid_t* pid,
+							const JExecuteAction toAction, const int* toFD,
+							const JExecuteAction fromAction, const int* fromFD,
+							const JExecuteAction errAction, const int* errFD);
+static void		JSetCloseOnExec(const int fd);
+
 /******************************************************************************
  JPrepArgForExec
 
@@ -361,6 +375,11 @@ JExecute
 
 	Can return JProgramNotAvailable, JNoProcessMemory, JNoKernelMemory.
 
+	Where posix_spawn() is available, it is used instead of fork().
+	fork() has to copy the page tables of the parent, so it is slow for
+	large programs.  The ends of the pipes that stay in the parent are
+	marked close-on-exec, so other children do not inherit them.
+
 	*** Security Note:
 		This function calls execvp(), which uses the current search path to
 		find the program to run.  In most cases, this is desirable because
@@ -449,8 +468,26 @@ JExecute
 			}
 		}
 
+	if (toAction == kJCreatePipe)
+		{
+		JSetCloseOnExec(fd[0][1]);
+		}
+	if (fromAction == kJCreatePipe)
+		{
+		JSetCloseOnExec(fd[1][0]);
+		}
+	if (errAction == kJCreatePipe)
+		{
+		JSetCloseOnExec(fd[2][0]);
+		}
+
+	const JBoolean spawn = JWillUseSpawn();
+
 	pid_t pid;
-	const JError err = JThisProcess::Fork(&pid);
+	const JError err =
+		spawn ? JSpawnChild(argv, fd, &pid, toAction, toFD,
+							fromAction, fromFD, errAction, errFD) :
+				JThisProcess::Fork(&pid);
 	if (!err.OK())
 		{
 		if (toAction == kJCreatePipe)
@@ -473,7 +510,7 @@ JExecute
 
 	// child
 
-	else if (pid == 0)
+	else if (!spawn && pid == 0)
 		{
 		const int stdinFD = fileno(stdin);
 		if (toAction == kJCreatePipe)
@@ -575,6 +612,157 @@ JExecute
 		}
 }
 
+/******************************************************************************
+ JSpawnChild (local)
+
+	Starts the child with posix_spawnp().  The file actions make the same
+	connections that JExecute() makes after fork(), and the child is put
+	in its own process group, as JThisProcess::Fork() does.
+
+ ******************************************************************************/
+
+static JError
+JSpawnChild
+	(
+	const JCharacter*		argv[],
+	int						fd[3][2],
+	pid_t*					pid,
+	const JExecuteAction	toAction,
+	const int*				toFD,
+	const JExecuteAction	fromAction,
+	const int*				fromFD,
+	const JExecuteAction	errAction,
+	const int*				errFD
+	)
+{
+#ifdef J_USE_POSIX_SPAWN
+
+	const int stdinFD  = fileno(stdin);
+	const int stdoutFD = fileno(stdout);
+	const int stderrFD = fileno(stderr);
+
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+
+	if (toAction == kJCreatePipe)
+		{
+		posix_spawn_file_actions_adddup2(&actions, fd[0][0], stdinFD);
+		if (fd[0][0] != stdinFD)
+			{
+			posix_spawn_file_actions_addclose(&actions, fd[0][0]);
+			}
+		}
+	else if (toAction == kJAttachToFD && *toFD != stdinFD)
+		{
+		posix_spawn_file_actions_adddup2(&actions, *toFD, stdinFD);
+		posix_spawn_file_actions_addclose(&actions, *toFD);
+		}
+
+	if (fromAction == kJCreatePipe)
+		{
+		posix_spawn_file_actions_adddup2(&actions, fd[1][1], stdoutFD);
+		if (fd[1][1] != stdoutFD)
+			{
+			posix_spawn_file_actions_addclose(&actions, fd[1][1]);
+			}
+		}
+	else if (fromAction == kJAttachToFD && *fromFD != stdoutFD)
+		{
+		posix_spawn_file_actions_adddup2(&actions, *fromFD, stdoutFD);
+		posix_spawn_file_actions_addclose(&actions, *fromFD);
+		}
+	else if (fromAction == kJTossOutput)
+		{
+		posix_spawn_file_actions_addopen(&actions, stdoutFD, "/dev/null",
+										 O_WRONLY | O_APPEND, 0);
+		}
+
+	if (errAction == kJCreatePipe)
+		{
+		posix_spawn_file_actions_adddup2(&actions, fd[2][1], stderrFD);
+		if (fd[2][1] != stderrFD)
+			{
+			posix_spawn_file_actions_addclose(&actions, fd[2][1]);
+			}
+		}
+	else if (errAction == kJAttachToFD && *errFD != stderrFD)
+		{
+		posix_spawn_file_actions_adddup2(&actions, *errFD, stderrFD);
+		posix_spawn_file_actions_addclose(&actions, *errFD);
+		}
+	else if (errAction == kJTossOutput)
+		{
+		posix_spawn_file_actions_addopen(&actions, stderrFD, "/dev/null",
+										 O_WRONLY | O_APPEND, 0);
+		}
+	else if (errAction == kJAttachToFromFD && fromAction != kJIgnoreConnection)
+		{
+		posix_spawn_file_actions_adddup2(&actions, stdoutFD, stderrFD);
+		}
+
+	posix_spawnattr_t attr;
+	posix_spawnattr_init(&attr);
+	posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+	posix_spawnattr_setpgroup(&attr, 0);	// required by JProcess
+
+	const int result =
+		posix_spawnp(pid, argv[0], &actions, &attr,
+					 const_cast<char* const*>(argv), environ);
+
+	posix_spawnattr_destroy(&attr);
+	posix_spawn_file_actions_destroy(&actions);
+
+	if (result == 0)
+		{
+		return JNoError();
+		}
+
+	*pid = 0;
+	if (result == EAGAIN)
+		{
+		return JNoProcessMemory();
+		}
+	else if (result == ENOMEM)
+		{
+		return JNoKernelMemory();
+		}
+	else if (result == ENOENT || result == EACCES || result == ENOEXEC)
+		{
+		return JProgramNotAvailable(argv[0]);
+		}
+	else
+		{
+		return JUnexpectedError(result);
+		}
+
+#else
+
+	assert( 0 /* posix_spawn() is not available */ );
+	return JNoError();
+
+#endif
+}
+
+/******************************************************************************
+ JSetCloseOnExec (local)
+
+ ******************************************************************************/
+
+static void
+JSetCloseOnExec
+	(
+	const int fd
+	)
+{
+#ifdef FD_CLOEXEC
+	const int flags = fcntl(fd, F_GETFD);
+	if (flags != -1)
+		{
+		fcntl(fd, F_SETFD, flags | FD_CLOEXEC);
+		}
+#endif
+}
+
 /******************************************************************************
  JWaitForChild
 
@@ -807,3 +995,30 @@ JShouldIncludeCWDOnPath
 {
 	theIncludeCWDOnPathFlag = includeCWD;
 }
+
+/******************************************************************************
+ Use spawn
+
+	Turn this option off to make JExecute() use fork() even when
+	posix_spawn() is available.
+
+ ******************************************************************************/
+
+JBoolean
+JWillUseSpawn()
+{
+#ifdef J_USE_POSIX_SPAWN
+	return theUseSpawnFlag;
+#else
+	return kJFalse;
+#endif
+}
+
+void
+JShouldUseSpawn
+	(
+	const JBoolean spawn
+	)
+{
+	theUseSpawnFlag = spawn;
+}
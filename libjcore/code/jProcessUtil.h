@@ -47,6 +47,9 @@ enum JChildExitReason
 JBoolean	JWillIncludeCWDOnPath();
 void		JShouldIncludeCWDOnPath(const JBoolean includeCWD);
 
+JBoolean	JWillUseSpawn();
+void		JShouldUseSpawn(const JBoolean spawn);
+
 JBoolean	JProgramAvailable(const JCharacter* programName);
 
 JError	JExecute(const JCharacter* cmd, pid_t* childPID,
@@ -162,6 +162,10 @@ SOURCE=.\code\JDirInfo.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\code\JDirTreeSearch.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\code\JDirInfo_UNIX.cpp
 
 !IF  "$(CFG)" == "libjcore - Win32 Release"
@@ -572,6 +576,10 @@ SOURCE=.\code\JStdError.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\code\JStaticStringTable.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\code\JStopWatch.cpp
 # End Source File
 # Begin Source File
@@ -713,6 +721,10 @@ SOURCE=.\code\jTime_Win32.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\code\JTrace.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\code\JTree.cpp
 # End Source File
 # Begin Source File
@@ -737,6 +749,14 @@ SOURCE=.\code\JVector.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\code\JWorkerPool.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\code\JWorkerTask.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=".\code\Templates-double.cpp"
 # SUBTRACT CPP /YX /Yc /Yu
 # End Source File
@@ -905,6 +925,10 @@ SOURCE=.\code\JDirInfo.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\code\JDirTreeSearch.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\code\jDirUtil.h
 # End Source File
 # Begin Source File
@@ -1289,6 +1313,10 @@ SOURCE=.\code\JStdError.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\code\JStaticStringTable.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\code\JStopWatch.h
 # End Source File
 # Begin Source File
@@ -1329,6 +1357,10 @@ SOURCE=.\code\JStringTableData.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\code\JStringView.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\code\JStrValue.h
 # End Source File
 # Begin Source File
@@ -1429,6 +1461,10 @@ SOURCE=.\code\jTime.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\code\JTrace.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\code\JTree.h
 # End Source File
 # Begin Source File
@@ -1461,6 +1497,14 @@ SOURCE=.\code\JVector.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\code\JWorkerPool.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\code\JWorkerTask.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\code\JXPM.h
 # End Source File
 # End Group
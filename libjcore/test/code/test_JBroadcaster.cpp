@@ -1,7 +1,10 @@
 /******************************************************************************
  test_JBroadcaster.cc
 
-	Program to test JBroadcaster class.
+	Program to test JBroadcaster class.  Also measures how long it takes
+	to create and destroy many connections to a single sender, checks
+	that StBatch merges messages, and compares a chain of Is() calls with
+	a MessageTable.
 
 	Written by John Lindal.
 
@@ -10,8 +13,11 @@
 #include <JBroadcaster.h>
 #include <JOrderedSet.h>
 #include <jCommandLine.h>
+#include <JTrace.h>
 #include <jAssert.h>
 
+const JSize kLinkCount = 100000;
+
 class Test : virtual public JBroadcaster
 {
 public:
@@ -35,8 +41,57 @@ protected:
 	virtual void	Receive(JBroadcaster* sender, const Message& message);
 };
 
+class Counter : virtual public JBroadcaster
+{
+public:
+
+	Counter()
+		:
+		itsCount(0),
+		itsInsertCount(0),
+		itsSender(NULL)
+	{ };
+
+	void
+	Listen(JBroadcaster* sender)
+	{
+		ListenTo(sender);
+		itsSender = sender;
+	};
+
+	JSize			itsCount;
+	JSize			itsInsertCount;		// total from ElementsInserted
+	JBroadcaster*	itsSender;
+
+protected:
+
+	virtual void
+	Receive(JBroadcaster* sender, const Message& message)
+	{
+		itsCount++;
+		if (message.Is(JOrderedSetT::kElementsInserted))
+			{
+			const JOrderedSetT::ElementsInserted* info =
+				dynamic_cast(const JOrderedSetT::ElementsInserted*, &message);
+			assert( info != NULL );
+			itsInsertCount += info->GetCount();
+			}
+	};
+
+	virtual void
+	ReceiveGoingAway(JBroadcaster* sender)
+	{
+		itsSender = NULL;
+	};
+};
+
 Test t1, t2, t3;
 
+void	Run(const JBoolean deleteSenderFirst);
+void	RunBatch();
+void	RunTypeID();
+void	PrintTime(const JCharacter* label, const JTraceTime start);
+
 void
 Test::Receive
 	(
@@ -57,5 +112,172 @@ main()
 	t2.Listen(&t3);
 	JOrderedSetT::Sorted msg;
 	t3.Bcast(msg);
+
+	Run(kJFalse);
+	Run(kJTrue);
+	RunBatch();
+	RunTypeID();
 	return 0;
 }
+
+void
+Run
+	(
+	const JBoolean deleteSenderFirst
+	)
+{
+	Test* sender = new Test;
+	assert( sender != NULL );
+
+	Counter* list = new Counter [ kLinkCount ];
+	assert( list != NULL );
+
+	JTraceTime start = JTrace::GetTime();
+	for (JIndex i=0; i<kLinkCount; i++)
+		{
+		list[i].Listen(sender);
+		}
+	PrintTime("connect:    ", start);
+
+	// each connection must only be made once
+
+	for (JIndex i=0; i<kLinkCount; i+=1000)
+		{
+		list[i].Listen(sender);
+		}
+	assert( sender->GetRecipientCount() == kLinkCount );
+
+	JOrderedSetT::Sorted msg;
+	sender->Bcast(msg);
+	for (JIndex i=0; i<kLinkCount; i++)
+		{
+		assert( list[i].itsCount == 1 );
+		}
+
+	start = JTrace::GetTime();
+	if (deleteSenderFirst)
+		{
+		delete sender;
+		PrintTime("del sender: ", start);
+
+		for (JIndex i=0; i<kLinkCount; i++)
+			{
+			assert( list[i].itsSender == NULL && !list[i].HasSenders() );
+			}
+		delete [] list;
+		}
+	else
+		{
+		delete [] list;
+		PrintTime("disconnect: ", start);
+
+		assert( !sender->HasRecipients() );
+		delete sender;
+		}
+}
+
+void
+RunBatch()
+{
+	Test sender;
+	Counter c;
+	c.Listen(&sender);
+
+	{
+	JBroadcaster::StBatch batch(&sender);
+	for (JIndex i=1; i<=1000; i++)
+		{
+		JOrderedSetT::ElementsInserted msg(i, 1);
+		sender.Bcast(msg);
+		}
+	assert( c.itsCount == 0 );
+
+	// cannot be merged, so the insertions are delivered first
+
+	JOrderedSetT::Sorted msg;
+	sender.Bcast(msg);
+	assert( c.itsCount == 2 && c.itsInsertCount == 1000 );
+
+	JOrderedSetT::ElementsInserted msg2(1, 1);
+	sender.Bcast(msg2);
+	}
+
+	assert( c.itsCount == 3 && c.itsInsertCount == 1001 );
+}
+
+void
+RunTypeID()
+{
+	// same characters, different address
+
+	const JCharacter sortedCopy[] = "Sorted::JOrderedSetT";
+
+	const JIndex sortedID = JRTTIBase::GetTypeID(JOrderedSetT::kSorted);
+	assert( sortedID > 0 );
+	assert( JRTTIBase::GetTypeID(sortedCopy) == sortedID );
+	assert( JRTTIBase::GetTypeID(JOrderedSetT::kCopied) != sortedID );
+
+	JOrderedSetT::Sorted msg;
+	assert( msg.GetTypeID() == sortedID );
+
+	JBroadcaster::MessageTable table;
+	table.Add(JOrderedSetT::kElementsInserted, 1);
+	table.Add(JOrderedSetT::kElementsRemoved,  2);
+	table.Add(JOrderedSetT::kElementMoved,     3);
+	table.Add(JOrderedSetT::kElementsSwapped,  4);
+	table.Add(JOrderedSetT::kElementChanged,   5);
+	table.Add(sortedCopy,                      6);
+	assert( table.Lookup(msg) == 6 );
+
+	const JOrderedSetT::Copied other;
+	assert( table.Lookup(other) == 0 );
+
+	// dispatch to the last type in the chain
+
+	const JSize kDispatchCount = 1000000;
+
+	JSize count = 0;
+	JTraceTime start = JTrace::GetTime();
+	for (JIndex i=1; i<=kDispatchCount; i++)
+		{
+		const JOrderedSetT::Sorted m;
+		if (m.Is(JOrderedSetT::kElementsInserted) ||
+			m.Is(JOrderedSetT::kElementsRemoved)  ||
+			m.Is(JOrderedSetT::kElementMoved)     ||
+			m.Is(JOrderedSetT::kElementsSwapped)  ||
+			m.Is(JOrderedSetT::kElementChanged))
+			{
+			count--;
+			}
+		else if (m.Is(sortedCopy))
+			{
+			count++;
+			}
+		}
+	PrintTime("Is() chain: ", start);
+
+	start = JTrace::GetTime();
+	for (JIndex i=1; i<=kDispatchCount; i++)
+		{
+		const JOrderedSetT::Sorted m;
+		switch (table.Lookup(m))
+			{
+			case 6:  count++; break;
+			default: count--; break;
+			}
+		}
+	PrintTime("table:      ", start);
+
+	assert( count == 2 * kDispatchCount );
+}
+
+void
+PrintTime
+	(
+	const JCharacter*	label,
+	const JTraceTime	start
+	)
+{
+	const JTraceTime end = JTrace::GetTime();
+	cout << label << (unsigned long) ((end - start) / 1000000) << " ms" << endl;
+}
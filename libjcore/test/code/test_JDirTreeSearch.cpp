@@ -0,0 +1,106 @@
+/******************************************************************************
+ test_JDirTreeSearch.cpp
+
+	Program to test JDirTreeSearch.  Searches for all the given names in
+	one pass, and then again using the index.
+
+ ******************************************************************************/
+
+#include <JDirTreeSearch.h>
+#include <JString.h>
+#include <JTrace.h>
+#include <jAssert.h>
+
+void	Search(JDirTreeSearch* search, const JCharacter* path,
+			   const JSize count, JDirTreeSearch::Target* list);
+
+int main
+	(
+	int argc,
+	char** argv
+	)
+{
+	if (argc < 3)
+		{
+		cerr << "usage:  " << argv[0] << " path name..." << endl;
+		return 1;
+		}
+
+	const JSize count = argc - 2;
+
+	JDirTreeSearch::Target* list = new JDirTreeSearch::Target [ count ];
+	assert( list != NULL );
+
+	JIndex i;
+	for (i=0; i<count; i++)
+		{
+		list[i].name          = argv[i+2];
+		list[i].isFile        = kJTrue;
+		list[i].caseSensitive = kJFalse;
+		list[i].path          = new JString;
+		list[i].newName       = new JString;
+		assert( list[i].path != NULL && list[i].newName != NULL );
+		}
+
+	JDirTreeSearch search;
+	search.ShouldIndex(kJTrue);
+	cout << "threads: " << search.GetMaxThreadCount() << endl;
+
+	Search(&search, argv[1], count, list);
+	cout << "indexed " << search.GetIndexedDirCount() << " directories" << endl;
+
+	// the index must not change the results
+
+	JString* firstPath = new JString [ count ];
+	assert( firstPath != NULL );
+	for (i=0; i<count; i++)
+		{
+		firstPath[i] = *(list[i].path);
+		}
+
+	Search(&search, argv[1], count, list);
+	for (i=0; i<count; i++)
+		{
+		assert( *(list[i].path) == firstPath[i] );
+		}
+
+	for (i=0; i<count; i++)
+		{
+		delete list[i].path;
+		delete list[i].newName;
+		}
+	delete [] list;
+	delete [] firstPath;
+
+	return 0;
+}
+
+void
+Search
+	(
+	JDirTreeSearch*			search,
+	const JCharacter*		path,
+	const JSize				count,
+	JDirTreeSearch::Target*	list
+	)
+{
+	const JTraceTime start = JTrace::GetTime();
+	search->Search(path, count, list);
+	const JTraceTime end   = JTrace::GetTime();
+
+	for (JIndex i=0; i<count; i++)
+		{
+		cout << list[i].name << ": ";
+		if (list[i].found)
+			{
+			cout << *(list[i].path) << ' ' << *(list[i].newName);
+			}
+		else
+			{
+			cout << "not found";
+			}
+		cout << endl;
+		}
+
+	cout << "time: " << (unsigned long) ((end - start) / 1000000) << " ms" << endl;
+}
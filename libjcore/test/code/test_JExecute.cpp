@@ -0,0 +1,86 @@
+/******************************************************************************
+ test_JExecute.cpp
+
+	Program to test JExecute.  Allocates a large heap and then measures
+	how many programs can be started per second with fork() and with
+	posix_spawn().
+
+ ******************************************************************************/
+
+#include <jProcessUtil.h>
+#include <JTrace.h>
+#include <JString.h>
+#include <jStreamUtil.h>
+#include <string.h>
+#include <stdlib.h>
+#include <jAssert.h>
+
+const JSize kLaunchCount = 200;
+
+void	Run(const JBoolean spawn);
+
+int
+main
+	(
+	int		argc,
+	char**	argv
+	)
+{
+	const JSize heapSize = (argc > 1 ? atoi(argv[1]) : 1024);	// MB
+
+	// touch every page so the kernel has to copy the page tables
+
+	JCharacter* heap = new JCharacter [ heapSize * 1024 * 1024 ];
+	assert( heap != NULL );
+	memset(heap, 1, heapSize * 1024 * 1024);
+	cout << "heap: " << heapSize << " MB" << endl;
+
+	// check that the output is connected
+
+	const JCharacter* echoArgv[] = { "echo", "hello", NULL };
+	pid_t pid;
+	int fromFD;
+	const JError err = JExecute(echoArgv, sizeof(echoArgv), &pid,
+								kJIgnoreConnection, NULL,
+								kJCreatePipe, &fromFD);
+	assert( err.OK() );
+
+	JString text;
+	JReadAll(fromFD, &text);
+	JWaitForChild(pid);
+	text.TrimWhitespace();
+	assert( text == "hello" );
+
+	Run(kJFalse);
+	if (JWillUseSpawn())
+		{
+		Run(kJTrue);
+		}
+
+	delete [] heap;
+	return 0;
+}
+
+void
+Run
+	(
+	const JBoolean spawn
+	)
+{
+	JShouldUseSpawn(spawn);
+
+	const JTraceTime start = JTrace::GetTime();
+
+	for (JIndex i=1; i<=kLaunchCount; i++)
+		{
+		const JCharacter* argv[] = { "true", NULL };
+		const JError err = JExecute(argv, sizeof(argv), NULL);
+		assert( err.OK() );
+		}
+
+	const JTraceTime end = JTrace::GetTime();
+
+	cout << (spawn ? "spawn: " : "fork:  ");
+	cout << (unsigned long) (kLaunchCount / ((end - start) / 1e9));
+	cout << " launches/sec" << endl;
+}
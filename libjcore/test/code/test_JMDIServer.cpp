@@ -0,0 +1,157 @@
+/******************************************************************************
+ test_JMDIServer.cpp
+
+	Program to test JMDIServer.  Starts a server in a child process and
+	measures how long each request takes to be accepted.  Then starts many
+	invocations at once, to check that they are all handled.  The server
+	only runs the reactor, so this also checks that requests are handled
+	without CheckForConnections().
+
+ ******************************************************************************/
+
+#include <JMDIServer.h>
+#include <JString.h>
+#include <JTrace.h>
+#include <jSysUtil.h>
+#include <jFileUtil.h>
+#include <jProcessUtil.h>
+#include <jTime.h>
+#include <ace/Reactor.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <jAssert.h>
+
+const JSize kRequestCount = 200;
+const JSize kBurstCount   = 20;		// invocations started at one time
+
+class TestServer : public JMDIServer
+{
+public:
+
+	TestServer
+		(
+		const JCharacter* signature
+		)
+		:
+		JMDIServer(signature),
+		itsRequestCount(0)
+	{ };
+
+	JSize	itsRequestCount;
+
+protected:
+
+	virtual JBoolean
+	CanAcceptMDIRequest()
+	{
+		return kJTrue;
+	};
+
+	virtual void
+	HandleMDIRequest
+		(
+		const JCharacter*			dir,
+		const JPtrArray<JString>&	argList
+		)
+	{
+		assert( JString(dir) == JGetCurrentDirectory() );
+		assert( argList.GetElementCount() == 3 );
+		assert( *(argList.NthElement(1)) == "test_JMDIServer" );
+		assert( argList.NthElement(2)->IsEmpty() );
+		assert( *(argList.NthElement(3)) == "file name" );
+		itsRequestCount++;
+	};
+};
+
+void	RunServer(const JCharacter* signature);
+void	SendRequest(const JCharacter* signature);
+
+int main()
+{
+	JString signature = "test_JMDIServer_";
+	signature        += JString(getpid(), JString::kBase10);
+
+	const pid_t serverPID = fork();
+	assert( serverPID != -1 );
+	if (serverPID == 0)
+		{
+		RunServer(signature);
+		exit(0);
+		}
+
+	// wait for the server to start:  the first request that succeeds
+	// is not timed
+
+	char* argv[] = { (char*) "test_JMDIServer", (char*) "", (char*) "file name", NULL };
+	while (JMDIServer::WillBeMDIServer(signature, 3, argv))
+		{
+		JWait(0.01);
+		}
+
+	const JTraceTime start = JTrace::GetTime();
+
+	for (JIndex i=1; i<kRequestCount; i++)
+		{
+		SendRequest(signature);
+		}
+
+	const JTraceTime end = JTrace::GetTime();
+
+	cout << "sequential: " << (unsigned long) ((end - start) / 1000 / (kRequestCount-1));
+	cout << " us per request" << endl;
+
+	// many invocations at once
+
+	pid_t pid[ kBurstCount ];
+	for (JIndex i=0; i<kBurstCount; i++)
+		{
+		pid[i] = fork();
+		assert( pid[i] != -1 );
+		if (pid[i] == 0)
+			{
+			SendRequest(signature);
+			exit(0);
+			}
+		}
+
+	for (JIndex i=0; i<kBurstCount; i++)
+		{
+		ACE_exitcode status;
+		JWaitForChild(pid[i], &status);
+		assert( status == 0 );
+		}
+
+	ACE_exitcode status;
+	JWaitForChild(serverPID, &status);
+	assert( status == 0 );
+
+	cout << "burst: " << kBurstCount << " requests handled" << endl;
+	return 0;
+}
+
+void
+RunServer
+	(
+	const JCharacter* signature
+	)
+{
+	TestServer server(signature);
+
+	const JSize count = kRequestCount + kBurstCount;
+	while (server.itsRequestCount < count)
+		{
+		(ACE_Reactor::instance())->handle_events();
+		}
+}
+
+void
+SendRequest
+	(
+	const JCharacter* signature
+	)
+{
+	char* argv[] = { (char*) "test_JMDIServer", (char*) "", (char*) "file name", NULL };
+	const JBoolean server = JMDIServer::WillBeMDIServer(signature, 3, argv);
+	assert( !server );
+}
@@ -0,0 +1,297 @@
+/******************************************************************************
+ test_JMessageProtocol.cpp
+
+	Program to test JMessageProtocol.  Sends messages through a socket
+	pair and measures how fast they are parsed, first with separators
+	and then with the binary protocol.  Then measures how many system
+	calls are needed to send messages asynchronously.
+
+ ******************************************************************************/
+
+#include <JMessageProtocol.h>
+#include <JTrace.h>
+#include <ace/LSOCK_Stream.h>
+#include <ace/OS_NS_signal.h>
+#include <ace/OS_NS_sys_socket.h>
+#include <ace/OS_NS_unistd.h>
+#include <jAssert.h>
+
+typedef JMessageProtocol<ACE_LSOCK_STREAM>	Link;
+
+const JSize kMessageLength  = 40;
+const JSize kChunkCount     = 1000;		// messages written at one time
+const JSize kRoundCount     = 500;
+
+class Listener : virtual public JBroadcaster
+{
+public:
+
+	Listener
+		(
+		Link*				link,
+		const JCharacter*	expected
+		)
+		:
+		itsMessageCount(0),
+		itsDisconnectFlag(kJFalse),
+		itsHighCount(0),
+		itsLowCount(0),
+		itsLink(link),
+		itsExpected(expected)
+	{
+		ListenTo(link);
+	};
+
+	void
+	Watch
+		(
+		Link* sender
+		)
+	{
+		ListenTo(sender);
+	};
+
+	JSize		itsMessageCount;
+	JBoolean	itsDisconnectFlag;
+	JSize		itsHighCount;
+	JSize		itsLowCount;
+
+protected:
+
+	virtual void
+	Receive
+		(
+		JBroadcaster*	sender,
+		const Message&	message
+		)
+	{
+		if (sender == itsLink && message.Is(JMessageProtocolT::kMessageReady))
+			{
+			const JMessageProtocolT::MessageReady* info =
+				dynamic_cast(const JMessageProtocolT::MessageReady*, &message);
+			assert( info != NULL );
+			assert( info->GetLength() == kMessageLength &&
+					memcmp(info->GetData(), itsExpected, kMessageLength) == 0 );
+
+			JString msg;
+			const JBoolean ok = itsLink->GetNextMessage(&msg);
+			assert( ok && msg.GetLength() == kMessageLength );
+			itsMessageCount++;
+			}
+		else if (sender == itsLink && message.Is(JMessageProtocolT::kReceivedDisconnect))
+			{
+			itsDisconnectFlag = kJTrue;
+			}
+		else if (message.Is(JNetworkProtocolBaseT::kHighWatermark))
+			{
+			itsHighCount++;
+			}
+		else if (message.Is(JNetworkProtocolBaseT::kLowWatermark))
+			{
+			itsLowCount++;
+			}
+		else
+			{
+			JBroadcaster::Receive(sender, message);
+			}
+	};
+
+private:
+
+	Link*				itsLink;
+	const JCharacter*	itsExpected;
+};
+
+void	Run(const JBoolean binary);
+void	RunAsynch();
+void	WriteAll(const ACE_HANDLE fd, const JString& data);
+
+int main()
+{
+	ACE_OS::signal(SIGPIPE, SIG_IGN);
+
+	Run(kJFalse);
+	Run(kJTrue);
+	RunAsynch();
+	return 0;
+}
+
+void
+Run
+	(
+	const JBoolean binary
+	)
+{
+	ACE_HANDLE fd[2];
+	const int result = ACE_OS::socketpair(AF_UNIX, SOCK_STREAM, 0, fd);
+	assert( result == 0 );
+
+	Link* link = new Link(fd[0]);
+	assert( link != NULL );
+
+	// the binary payload contains both the separator and the disconnect sequence
+
+	JCharacter payload[ kMessageLength ];
+	for (JIndex i=0; i<kMessageLength; i++)
+		{
+		payload[i] = (binary ? (JCharacter) (i * 37) : (JCharacter) ('a' + i % 26));
+		}
+
+	JString chunk;
+	for (JIndex i=0; i<kChunkCount; i++)
+		{
+		if (binary)
+			{
+			const JCharacter header[] = { 0, 0, 0, kMessageLength };
+			chunk.Append(header, sizeof(header));
+			chunk.Append(payload, kMessageLength);
+			}
+		else
+			{
+			chunk.Append(payload, kMessageLength);
+			chunk.Append(JMessageProtocolT::kUNIXSeparatorStr,
+						 JMessageProtocolT::kUNIXSeparatorLength);
+			}
+		}
+
+	if (binary)
+		{
+		link->UseBinaryProtocol();
+		}
+
+	Listener listener(link, payload);
+
+	const JTraceTime start = JTrace::GetTime();
+
+	for (JIndex i=1; i<=kRoundCount; i++)
+		{
+		WriteAll(fd[1], chunk);
+		while (listener.itsMessageCount < i * kChunkCount)
+			{
+			link->handle_input(fd[0]);
+			}
+		}
+
+	const JTraceTime end = JTrace::GetTime();
+
+	// a message split across writes, followed by the disconnect
+
+	JString last(payload, kMessageLength);
+	if (binary)
+		{
+		const JCharacter header[] = { 0, 0, 0, kMessageLength };
+		last.Prepend(header, sizeof(header));
+		}
+
+	WriteAll(fd[1], last.GetSubstring(1, 10));
+	link->handle_input(fd[0]);
+
+	JString partial;
+	const JBoolean hasPartial = link->PeekPartialMessage(&partial);
+	assert( hasPartial && partial.GetLength() == (binary ? 6 : 10) );
+
+	last.RemoveSubstring(1, 10);
+	if (binary)
+		{
+		last.Append("\xFF\xFF\xFF\xFF", 4);
+		}
+	else
+		{
+		last.Append(JMessageProtocolT::kStdDisconnectStr,
+					JMessageProtocolT::kStdDisconnectLength);
+		}
+
+	WriteAll(fd[1], last);
+	while (!listener.itsDisconnectFlag)
+		{
+		link->handle_input(fd[0]);
+		}
+	assert( listener.itsMessageCount == kRoundCount * kChunkCount + 1 );
+	assert( !link->HasMessages() );
+
+	const double seconds = (end - start) / 1e9;
+	const double count   = kRoundCount * kChunkCount;
+	cout << (binary ? "binary: " : "text:   ");
+	cout << (unsigned long) (count / seconds) << " messages/sec, ";
+	cout << (count * chunk.GetLength() / kChunkCount) / seconds / (1024*1024) << " MB/s" << endl;
+
+	delete link;
+	ACE_OS::close(fd[1]);
+}
+
+void
+RunAsynch()
+{
+	ACE_HANDLE fd[2];
+	const int result = ACE_OS::socketpair(AF_UNIX, SOCK_STREAM, 0, fd);
+	assert( result == 0 );
+
+	Link* receiver = new Link(fd[0]);
+	assert( receiver != NULL );
+
+	Link* sender = new Link(fd[1]);
+	assert( sender != NULL );
+	sender->SetWatermarks(1000, 100000);
+
+	JCharacter payload[ kMessageLength ];
+	for (JIndex i=0; i<kMessageLength; i++)
+		{
+		payload[i] = 'a' + i % 26;
+		}
+
+	Listener listener(receiver, payload);
+	listener.Watch(sender);
+
+	// queue everything first, to check the watermarks
+
+	const JSize count = kRoundCount * kChunkCount / 10;
+	for (JIndex i=1; i<=count; i++)
+		{
+		sender->SendMessage(payload, kMessageLength);
+		}
+	assert( sender->IsAboveHighWatermark() && listener.itsHighCount == 1 );
+
+	while (listener.itsMessageCount < count)
+		{
+		if (sender->DataPending())
+			{
+			sender->handle_output(fd[1]);
+			}
+		receiver->handle_input(fd[0]);
+		}
+
+	assert( !sender->DataPending() );
+	assert( !sender->IsAboveHighWatermark() && listener.itsLowCount == 1 );
+
+	cout << "asynch: " << sender->GetSendCount() << " messages, ";
+	cout << sender->GetSystemCallCount() << " system calls" << endl;
+
+	// the destructor must not broadcast, even when it discards the queue
+
+	for (JIndex i=1; i<=3000; i++)
+		{
+		sender->SendMessage(payload, kMessageLength);
+		}
+	assert( sender->IsAboveHighWatermark() && listener.itsHighCount == 2 );
+
+	delete receiver;
+	delete sender;
+	assert( listener.itsLowCount == 1 );
+}
+
+void
+WriteAll
+	(
+	const ACE_HANDLE	fd,
+	const JString&		data
+	)
+{
+	JSize offset = 0;
+	while (offset < data.GetLength())
+		{
+		const ssize_t n = ACE_OS::write(fd, data.GetCString() + offset,
+										data.GetLength() - offset);
+		assert( n > 0 );
+		offset += n;
+		}
+}
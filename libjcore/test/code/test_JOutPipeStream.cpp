@@ -0,0 +1,114 @@
+/******************************************************************************
+ test_JOutPipeStream.cpp
+
+	Program to test JOutPipeStream.  Sends fields to "wc -c" and measures
+	how fast they are written without a buffer, with a buffer, and with
+	a buffer and a non-blocking pipe.  Then checks that the destructor
+	gives up if nobody reads the pipe.
+
+ ******************************************************************************/
+
+#include <JOutPipeStream.h>
+#include <jProcessUtil.h>
+#include <JTrace.h>
+#include <JString.h>
+#include <jStreamUtil.h>
+#include <jTime.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <jAssert.h>
+
+const JCharacter* kField  = "0123456789abcdef";
+const JSize kFieldLength  = 16;
+const JSize kFieldCount   = 200000;
+
+void	Run(const JCharacter* name, const JSize bufferSize, const JBoolean block);
+void	RunStalled();
+
+int main()
+{
+	Run("unbuffered:  ", 0, kJTrue);
+	Run("buffered:    ", JOutPipeStreambuf<char>::kDefaultBufferSize, kJTrue);
+	Run("nonblocking: ", JOutPipeStreambuf<char>::kDefaultBufferSize, kJFalse);
+	RunStalled();
+	return 0;
+}
+
+void
+Run
+	(
+	const JCharacter*	name,
+	const JSize			bufferSize,
+	const JBoolean		block
+	)
+{
+	const JCharacter* argv[] = { "wc", "-c", NULL };
+	pid_t pid;
+	int toFD, fromFD;
+	const JError err = JExecute(argv, sizeof(argv), &pid,
+								kJCreatePipe, &toFD,
+								kJCreatePipe, &fromFD);
+	assert( err.OK() );
+
+	const JTraceTime start = JTrace::GetTime();
+
+	{
+	JOutPipeStream output(toFD, kJTrue, bufferSize);
+	output.ShouldBlock(block);
+
+	for (JIndex i=1; i<=kFieldCount; i++)
+		{
+		output << kField << ' ';
+		if (i % 1000 == 0)
+			{
+			output.flush();
+			}
+		}
+	assert( output.good() );
+
+	while (!output.FlushPendingOutput())
+		{
+		JWait(0.001);
+		}
+	}
+
+	const JTraceTime end = JTrace::GetTime();
+
+	// check that everything arrived
+
+	JString text;
+	JReadAll(fromFD, &text);
+	JWaitForChild(pid);
+	text.TrimWhitespace();
+	assert( atol(text) == (long) (kFieldCount * (kFieldLength + 1)) );
+
+	const double seconds = (end - start) / 1e9;
+	cout << name << (unsigned long) (kFieldCount / seconds) << " fields/sec" << endl;
+}
+
+void
+RunStalled()
+{
+	int fd[2];
+	const int result = pipe(fd);
+	assert( result == 0 );
+
+	const JTraceTime start = JTrace::GetTime();
+
+	{
+	JOutPipeStream output(fd[1], kJTrue, JOutPipeStreambuf<char>::kDefaultBufferSize);
+	output.ShouldBlock(kJFalse);
+
+	for (JIndex i=1; i<=kFieldCount; i++)
+		{
+		output << kField << ' ';
+		}
+	assert( output.good() );
+	assert( !output.FlushPendingOutput() );
+	}
+
+	const JTraceTime end = JTrace::GetTime();
+	close(fd[0]);
+
+	cout << "stalled:     gave up after " << (unsigned long) ((end - start) / 1000000) << " ms" << endl;
+}
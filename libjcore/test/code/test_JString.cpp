@@ -13,10 +13,18 @@
 #include <jMath.h>
 #include <jCommandLine.h>
 #include <jFStreamUtil.h>
+#include <jHashFunctions.h>
+#include <JRegex.h>
+#include <JTrace.h>
 #include <limits.h>
+#include <stdlib.h>
+#include <new>
+#include <jAssert.h>
 
 void TestCopyMaxN();
 void TestLeak();
+void TestSetView();
+void TestAllocations();
 
 int main
 	(
@@ -351,6 +359,9 @@ JString s28(9.995, 2);
 	cout << endl << "Compare memory usage with recorded value";
 	JWaitForReturn();
 
+	TestSetView();
+	TestAllocations();
+
 	cout << endl;
 	cout << "System clock started on " << JConvertToTimeStamp(0) << endl;
 	cout << "System clock ends on " << JConvertToTimeStamp(J_TIME_T_MAX) << endl;
@@ -438,3 +449,214 @@ GetString2()
 
 	return stem;
 }
+
+/******************************************************************************
+ Allocation counting
+
+	Every heap allocation in this program goes through here, so we can
+	check how many of them the string workloads need.
+
+ ******************************************************************************/
+
+static JSize theAllocCount = 0;
+
+void*
+operator new
+	(
+	size_t size
+	)
+	throw (std::bad_alloc)
+{
+	theAllocCount++;
+
+	void* p = malloc(size > 0 ? size : 1);
+	if (p == NULL)
+		{
+		throw std::bad_alloc();
+		}
+	return p;
+}
+
+void*
+operator new[]
+	(
+	size_t size
+	)
+	throw (std::bad_alloc)
+{
+	return operator new(size);
+}
+
+void
+operator delete
+	(
+	void* p
+	)
+	throw ()
+{
+	free(p);
+}
+
+void
+operator delete[]
+	(
+	void* p
+	)
+	throw ()
+{
+	free(p);
+}
+
+/******************************************************************************
+ TestAllocations
+
+	Reports the number of allocations and the time per iteration for some
+	typical workloads: short temporaries, splitting a line into words with
+	GetSubstring() and with GetView(), and matching and hashing each word.
+
+ ******************************************************************************/
+
+const JSize kAllocRoundCount = 100000;
+
+const JCharacter* kSentence =
+	"the quick brown fox jumps over the lazy dog while the cat sleeps";
+
+void	PrintAllocations(const JCharacter* name, const JSize allocCount,
+						 const JTraceTime start, const JTraceTime end);
+
+void
+TestAllocations()
+{
+	const JString line = kSentence;
+	const JRegex wordRegex("^[a-z]+");
+	JIndexRange r;
+
+	JSize allocCount = theAllocCount;
+	JTraceTime start = JTrace::GetTime();
+
+	for (JIndex i=1; i<=kAllocRoundCount; i++)
+		{
+		TestLeak();
+		}
+
+	PrintAllocations("temporaries:", theAllocCount - allocCount, start, JTrace::GetTime());
+
+	// copy each word
+
+	JSize copyCount = 0;
+	JHashValue copyHash = 0;
+
+	allocCount = theAllocCount;
+	start      = JTrace::GetTime();
+
+	for (JIndex i=1; i<=kAllocRoundCount; i++)
+		{
+		JIndex first = 1, last;
+		while (first <= line.GetLength())
+			{
+			last = first;
+			while (last < line.GetLength() && line.GetCharacter(last+1) != ' ')
+				{
+				last++;
+				}
+
+			const JString word = line.GetSubstring(first, last);
+			if (word == "the" && wordRegex.Match(word, &r))
+				{
+				copyCount++;
+				}
+			copyHash ^= JHashString(word, word.GetLength());
+
+			first = last + 2;
+			}
+		}
+
+	PrintAllocations("substring:  ", theAllocCount - allocCount, start, JTrace::GetTime());
+
+	// view each word
+
+	JSize viewCount = 0;
+	JHashValue viewHash = 0;
+
+	allocCount = theAllocCount;
+	start      = JTrace::GetTime();
+
+	for (JIndex i=1; i<=kAllocRoundCount; i++)
+		{
+		JIndex first = 1, last;
+		while (first <= line.GetLength())
+			{
+			last = first;
+			while (last < line.GetLength() && line.GetCharacter(last+1) != ' ')
+				{
+				last++;
+				}
+
+			const JStringView word = line.GetView(JIndexRange(first, last));
+			if (word == "the" && wordRegex.Match(word, &r))
+				{
+				viewCount++;
+				}
+			viewHash ^= JHashString(word);
+
+			first = last + 2;
+			}
+		}
+
+	PrintAllocations("view:       ", theAllocCount - allocCount, start, JTrace::GetTime());
+
+	assert( viewCount == copyCount && viewCount == 3 * kAllocRoundCount );
+	assert( viewHash == copyHash );
+
+	// $ matches at the end of a view that ends the string
+
+	const JRegex endRegex("[a-z]+$");
+	assert( endRegex.Match(line.GetView(JIndexRange(line.GetLength()-5, line.GetLength()))) );
+}
+
+void
+PrintAllocations
+	(
+	const JCharacter*	name,
+	const JSize			allocCount,
+	const JTraceTime	start,
+	const JTraceTime	end
+	)
+{
+	cout << name << ' ';
+	cout << allocCount / (double) kAllocRoundCount << " allocations, ";
+	cout << (end - start) / (double) kAllocRoundCount << " ns per round" << endl;
+}
+
+/******************************************************************************
+ TestSetView
+
+	Set() must copy a view into the string itself, even when the view
+	starts at the first character.
+
+ ******************************************************************************/
+
+void
+TestSetView()
+{
+	JString s = "abcdef";
+	s.Set(s.GetView(JIndexRange(1, s.GetLength())));
+	assert( s == "abcdef" );
+
+	s.Set(s.GetView(JIndexRange(1,3)));
+	assert( s == "abc" && s.GetLength() == 3 );
+
+	s = "abcdef";
+	s.Set(s.GetView(JIndexRange(2,5)));
+	assert( s == "bcde" && s.GetLength() == 4 );
+
+	s = kSentence;
+	s.Set(s.GetView(JIndexRange(5,9)));
+	assert( s == "quick" );
+
+	s = kSentence;
+	s.Set(s.GetView(JIndexRange(1,3)));
+	assert( s == "the" );
+
+	cout << endl << "Set(view) test passed" << endl;
+}
@@ -0,0 +1,192 @@
+/******************************************************************************
+ test_JStringManager.cpp
+
+	Program to test JStringManager and compare the time required to load
+	text and binary string databases.
+
+ ******************************************************************************/
+
+#include <JStringManager.h>
+#include <JStaticStringTable.h>
+#include <JStopWatch.h>
+#include <JString.h>
+#include <jFileUtil.h>
+#include <fstream>
+#include <sstream>
+#include <stdio.h>
+#include <jAssert.h>
+
+const JSize kStringCount = 20000;
+
+void	OverrideTest();
+void	BuildID(const JIndex i, JString* id, JString* value);
+JFloat	TimeLoad(const JCharacter* fileName);
+
+int main()
+{
+	cout << "Beginning JStringManager test.  No news is good news." << endl;
+
+	OverrideTest();
+
+	// build the databases
+
+	JStringManager mgr;
+	{
+	std::ostringstream data;
+	data << (long) JStringManager::kASCIIFormat << endl;
+
+	JString id, value;
+	for (JIndex i=1; i<=kStringCount; i++)
+		{
+		BuildID(i, &id, &value);
+		id.Print(data);
+		data << ' ' << value << endl;
+		}
+
+	std::istringstream input(data.str());
+	mgr.MergeFile(input);
+	}
+
+	JString textFileName, binaryFileName;
+	assert_ok( JCreateTempFile(&textFileName) );
+	assert_ok( JCreateTempFile(&binaryFileName) );
+	{
+	std::ofstream textOutput(textFileName);
+	mgr.WriteFile(textOutput);
+
+	std::ofstream binaryOutput(binaryFileName);
+	mgr.WriteBinaryFile(binaryOutput);
+	}
+
+	// compare the startup cost
+
+	const JFloat textTime   = TimeLoad(textFileName);
+	const JFloat binaryTime = TimeLoad(binaryFileName);
+
+	cout << kStringCount << " strings" << endl;
+	cout << "text:   " << textTime   << " sec" << endl;
+	cout << "binary: " << binaryTime << " sec" << endl;
+
+	JRemoveFile(textFileName);
+	JRemoveFile(binaryFileName);
+	return 0;
+}
+
+/******************************************************************************
+ TimeLoad
+
+	Measures the time required to load the file and then look up 1% of
+	the strings, which is typical of program startup.
+
+ ******************************************************************************/
+
+JFloat
+TimeLoad
+	(
+	const JCharacter* fileName
+	)
+{
+	JStopWatch timer;
+	timer.StartTimer();
+
+	JStringManager mgr;
+	assert( mgr.MergeFile(fileName) );
+
+	JString id, value;
+	for (JIndex i=1; i<=kStringCount; i+=100)
+		{
+		BuildID(i, &id, &value);
+		assert( mgr.Get(id) == value );
+		}
+
+	timer.StopTimer();
+	return timer.GetCPUTimeInterval();
+}
+
+/******************************************************************************
+ OverrideTest
+
+	Later files override earlier ones, except for the strings that cannot
+	be overridden.
+
+ ******************************************************************************/
+
+void
+OverrideTest()
+{
+	std::istringstream text1("0\nVERSION \"1\"\na \"text1\"\nb \"text1\"\n");
+	std::istringstream text2("0\nVERSION \"2\"\nb \"text2\"\n");
+
+	JStringManager m1;
+	m1.MergeFile(text1);
+	std::ostringstream binary1;
+	m1.WriteBinaryFile(binary1);
+
+	JStringManager mgr;
+	std::istringstream input1(binary1.str());
+	mgr.MergeFile(input1);
+	assert( mgr.Get("a") == "text1" );
+	assert( mgr.Get("b") == "text1" );
+
+	mgr.MergeFile(text2);
+	assert( mgr.Get("VERSION") == "1" );
+	assert( mgr.Get("b") == "text2" );
+
+	JStringManager m2;
+	std::istringstream text3("0\nVERSION \"3\"\nb \"binary2\"\nc \"binary2\"\n");
+	m2.MergeFile(text3);
+	std::ostringstream binary2;
+	m2.WriteBinaryFile(binary2);
+
+	std::istringstream input2(binary2.str());
+	mgr.MergeFile(input2);
+	assert( mgr.Get("VERSION") == "1" );
+	assert( mgr.Get("a") == "text1" );
+	assert( mgr.Get("b") == "binary2" );
+	assert( mgr.Get("c") == "binary2" );
+
+	// table strings are visible without being copied into the map
+
+	const JSize count = mgr.GetElementCount();
+	const JString* s1;
+	assert( mgr.Contains("a") && mgr.Contains("c") && !mgr.Contains("d") );
+	assert( mgr.GetElement("c", &s1) && *s1 == "binary2" );
+	assert( mgr.GetElementCount() == count );
+
+	std::ostringstream binary3;
+	mgr.WriteBinaryFile(binary3);
+
+	JStringManager m3;
+	std::istringstream input3(binary3.str());
+	m3.MergeFile(input3);
+	assert( m3.Get("VERSION") == "1" );
+	assert( m3.Get("a") == "text1" );
+	assert( m3.Get("b") == "binary2" );
+	assert( m3.Get("c") == "binary2" );
+
+	const JCharacter* s;
+	JSize length;
+	JStaticStringTable table((const unsigned char*) "JSTB", 4);
+	assert( !table.IsValid() && !table.GetElement("a", &s, &length) );
+}
+
+/******************************************************************************
+ BuildID
+
+ ******************************************************************************/
+
+void
+BuildID
+	(
+	const JIndex	i,
+	JString*		id,
+	JString*		value
+	)
+{
+	*id = "String";
+	*id += JString(i, JString::kBase10);
+	*id += "::JStringManagerTest";
+
+	*value = "This is string #";
+	*value += JString(i, JString::kBase10);
+}
@@ -0,0 +1,145 @@
+/******************************************************************************
+ test_JWorkerPool.cpp
+
+	Program to test JWorkerPool.
+
+ ******************************************************************************/
+
+#include <JWorkerPool.h>
+#include <JWorkerTask.h>
+#include <jTime.h>
+#include <jAssert.h>
+
+const JSize kTaskCount = 200;
+
+class SumTask : public JWorkerTask
+{
+public:
+
+	SumTask(const JSize n)
+		:
+		itsCount(n),
+		itsSum(0)
+	{ };
+
+	virtual void
+	Perform()
+	{
+		for (JIndex i=1; i<=itsCount && !IsCancelled(); i++)
+			{
+			itsSum += i;
+			}
+	};
+
+	JBoolean
+	IsCorrect() const
+	{
+		return JI2B( itsSum == itsCount * (itsCount+1) / 2 );
+	};
+
+private:
+
+	const JSize	itsCount;
+	JSize		itsSum;
+};
+
+class Listener : virtual public JBroadcaster
+{
+public:
+
+	Listener()
+		:
+		itsFinishedCount(0)
+	{ };
+
+	void
+	Watch
+		(
+		JWorkerTask* task
+		)
+	{
+		ListenTo(task);
+	};
+
+	JSize	itsFinishedCount;
+
+protected:
+
+	virtual void
+	Receive
+		(
+		JBroadcaster*	sender,
+		const Message&	message
+		)
+	{
+		if (message.Is(JWorkerTask::kFinished))
+			{
+			SumTask* task = dynamic_cast(SumTask*, sender);
+			assert( task != NULL && task->IsCorrect() );
+			itsFinishedCount++;
+			}
+	};
+};
+
+void	WaitForTasks(JWorkerPool* pool);
+
+int main()
+{
+	cout << "Beginning JWorkerPool test.  No news is good news." << endl;
+
+	JWorkerPool pool(4);
+	Listener listener;
+
+	JIndex i;
+	for (i=1; i<=kTaskCount; i++)
+		{
+		SumTask* task = new SumTask(1000 * i);
+		assert( task != NULL );
+		listener.Watch(task);
+		pool.Add(task);
+		}
+	assert( pool.GetTaskCount() == kTaskCount );
+	assert( pool.GetWorkerCount() <= pool.GetMaxWorkerCount() );
+
+	WaitForTasks(&pool);
+	assert( listener.itsFinishedCount == kTaskCount );
+
+	// cancelled tasks do not broadcast
+
+	listener.itsFinishedCount = 0;
+	for (i=1; i<=10; i++)
+		{
+		SumTask* task = new SumTask(100000000);
+		assert( task != NULL );
+		listener.Watch(task);
+		pool.Add(task);
+		}
+
+	pool.CancelAll();
+	WaitForTasks(&pool);
+	assert( listener.itsFinishedCount == 0 );
+
+	// the destructor must clean up tasks that are still running
+
+	for (i=1; i<=10; i++)
+		{
+		pool.Add(new SumTask(100000000));
+		}
+
+	return 0;
+}
+
+void
+WaitForTasks
+	(
+	JWorkerPool* pool
+	)
+{
+	while (pool->IsBusy())
+		{
+		if (!pool->DeliverFinishedTasks())
+			{
+			JWait(0.001);
+			}
+		}
+}
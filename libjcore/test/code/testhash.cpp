@@ -10,7 +10,9 @@
  *****************************************************************************/
 
 #include <jHashFunctions.h>
+#include <JStopWatch.h>
 #include <iomanip>
+#include <string.h>
 #include <jAssert.h>
 
 	JHashValue DualHashArg[] =
@@ -141,6 +143,9 @@
 		0xe0993db5
 		};
 
+	JFloat	TimeHash(JHashValue (*hash)(const JCharacter* const&),
+					 const JCharacter* key);
+
 /******************************************************************************
  main
 
@@ -193,7 +198,78 @@ main()
 		i++;
 		}
 
+// Test JHashString
+	i=0;
+	while (HashStringArg[i] != NULL)
+		{
+		const JHashValue result = JHashString(HashStringArg[i]);
+		if (JHashString(HashStringArg[i], strlen(HashStringArg[i])) != result)
+			{
+			cout << "   JHashString(\"" << HashStringArg[i]
+				 << "\") depends on whether the length is given" << endl;
+			}
+
+		for (JIndex j=0; j<i; j++)
+			{
+			if (JHashString(HashStringArg[j]) == result)
+				{
+				cout << "   JHashString(\"" << HashStringArg[i]
+					 << "\") collides with JHashString(\"" << HashStringArg[j]
+					 << "\")" << endl;
+				}
+			}
+		i++;
+		}
+
 	cout << "Finished hash function test.  If nothing printed out, it passed" << endl;
 
+// Compare speed
+
+	const JCharacter* shortKey = HashStringArg[7];
+	const JCharacter* longKey  = HashStringArg[13];
+
+	cout << std::setbase(10);
+	cout << endl;
+	cout << "Time to hash " << strlen(shortKey) << " characters:" << endl;
+	cout << "JHash7Bit:   " << TimeHash(JHash7Bit, shortKey) << " ns" << endl;
+	cout << "JHashString: " << TimeHash(JHashString, shortKey) << " ns" << endl;
+	cout << "Time to hash " << strlen(longKey) << " characters:" << endl;
+	cout << "JHash7Bit:   " << TimeHash(JHash7Bit, longKey) << " ns" << endl;
+	cout << "JHashString: " << TimeHash(JHashString, longKey) << " ns" << endl;
+
 	return 0;
 }
+
+/******************************************************************************
+ TimeHash
+
+	Returns the average time in nanoseconds required to hash the key.
+
+ *****************************************************************************/
+
+JFloat
+TimeHash
+	(
+	JHashValue			(*hash)(const JCharacter* const&),
+	const JCharacter*	key
+	)
+{
+	const JSize count = 1000000;
+
+	JStopWatch timer;
+	timer.StartTimer();
+
+	JHashValue sum = 0;
+	for (JIndex i=0; i<count; i++)
+		{
+		sum += hash(key);
+		}
+
+	timer.StopTimer();
+	if (sum == 0)
+		{
+		cout << "";		// keep the optimizer from discarding the loop
+		}
+
+	return timer.GetCPUTimeInterval() * 1e9 / count;
+}
@@ -11,13 +11,16 @@
 
 #include <JStringMap.h>
 #include <JStringMapCursor.h>
+#include <JStopWatch.h>
 #include <string.h>
+#include <stdio.h>
 
 //#include <JMemoryManager.h>
 
 #include <jAssert.h>
 
 	void PrintError(long line);
+	void Benchmark(const JBoolean copyKeys);
 
 	const JSize gNumStrings = 16;
 
@@ -446,6 +449,11 @@ cout << "   Map still contains " << map.GetElementCount() << " keys!" << endl;
 
 	cout << "Finished JStringMap test.  If nothing printed out, it passed." << endl;
 
+	cout << endl << "Copying keys:" << endl;
+	Benchmark(kJTrue);
+	cout << endl << "Not copying keys:" << endl;
+	Benchmark(kJFalse);
+
 //	JMemoryManager::Instance()->SetPrintExitStats(kJTrue);
 
 	return 0;
@@ -463,4 +471,87 @@ PrintError
 	)
 {
 	cout << "*** testmap error at line " << line << endl;
-}
\ No newline at end of file
+}
+
+/******************************************************************************
+ Benchmark
+
+	Prints the average time for each operation and the memory used per
+	element, for a table of symbol-like keys.
+
+ *****************************************************************************/
+
+void
+Benchmark
+	(
+	const JBoolean copyKeys
+	)
+{
+	const JSize count = 200000;
+
+	JCharacter** keys = new JCharacter* [ 2*count ];
+	assert( keys != NULL );
+	for (JIndex i=0; i<2*count; i++)
+		{
+		JCharacter s[32];
+		sprintf(s, "symbol_%lu", (unsigned long) (i * 2654435761UL) % 100000000);
+		keys[i] = new JCharacter [ strlen(s)+1 ];
+		assert( keys[i] != NULL );
+		strcpy(keys[i], s);
+		}
+
+	JStringMap<int> map((JSize) kJDefaultLgMinTableSize, copyKeys);
+	JStopWatch timer;
+	int v, found = 0;
+
+	timer.StartTimer();
+	for (JIndex i=0; i<count; i++)
+		{
+		map.SetElement(keys[i], i);
+		}
+	timer.StopTimer();
+	cout << "insert:      " << timer.GetCPUTimeInterval() * 1e9 / count << " ns" << endl;
+
+	timer.StartTimer();
+	for (JIndex i=0; i<count; i++)
+		{
+		found += map.GetElement(keys[i], &v);
+		}
+	timer.StopTimer();
+	cout << "lookup hit:  " << timer.GetCPUTimeInterval() * 1e9 / count << " ns" << endl;
+
+	timer.StartTimer();
+	for (JIndex i=count; i<2*count; i++)
+		{
+		found += map.GetElement(keys[i], &v);
+		}
+	timer.StopTimer();
+	cout << "lookup miss: " << timer.GetCPUTimeInterval() * 1e9 / count << " ns" << endl;
+
+	timer.StartTimer();
+	for (JIndex i=0; i<count; i++)
+		{
+		map.RemoveElement(keys[i]);
+		map.SetElement(keys[count+i], i);
+		}
+	timer.StopTimer();
+	cout << "replace:     " << timer.GetCPUTimeInterval() * 1e9 / count << " ns" << endl;
+
+	if (found != (int) count || map.GetElementCount() != count)
+		{
+		PrintError(__LINE__);
+		}
+
+	const JSize tableSize = map.GetTableSize() * (sizeof(JHashRecord< JStrValue<int> >) + 1);
+	cout << "memory:      " << (tableSize + map.GetKeyStorageSize()) / (JFloat) count
+		 << " bytes/element (" << map.GetKeyStorageSize() / (JFloat) count
+		 << " for keys)" << endl;
+	cout << "load factor: " << map.GetLoadFactor() << endl;
+
+	map.RemoveAll();
+	for (JIndex i=0; i<2*count; i++)
+		{
+		delete [] keys[i];
+		}
+	delete [] keys;
+}
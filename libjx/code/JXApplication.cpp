@@ -32,6 +32,8 @@
 #include <jXKeysym.h>
 
 #include <JThisProcess.h>
+#include <JWorkerPool.h>
+#include <JTrace.h>
 #include <ace/Reactor.h>
 #include <ace/Service_Config.h>
 #include <sys/time.h>
@@ -50,6 +52,7 @@ const time_t kTimerStart = J_TIME_T_MAX/1000U;	// milliseconds before rollover
 const Time kMaxSleepTime = 50;					// 0.05 seconds (in milliseconds)
 
 const JSize kWaitForChildCount = 10;
+const Time kWorkerPollTime    = 10;				// 0.01 seconds (in milliseconds)
 
 /******************************************************************************
  Constructor
@@ -95,10 +98,23 @@ JXApplication::JXApplication
 	itsUrgentTasks = new JPtrArray<JXUrgentTask>(JPtrArrayT::kDeleteAll);
 	assert( itsUrgentTasks != NULL );
 
+	itsWorkerPool = NULL;
+
 	itsHasBlockingWindowFlag = kJFalse;
 	itsHadBlockingWindowFlag = kJFalse;
 	itsRequestQuitFlag       = kJFalse;
 
+#ifdef _J_USE_TRACING
+
+	// record timing zones if a trace file was requested
+
+	if (!JStringEmpty(getenv("JX_TRACE_FILE")))
+		{
+		JTrace::SetEnabled(kJTrue);
+		}
+
+#endif
+
 	// if no path info specified, assume it's on exec path
 
 	if (JIsRelativePath(itsRestartCmd) &&
@@ -161,6 +177,18 @@ JXApplication::JXApplication
 
 JXApplication::~JXApplication()
 {
+#ifdef _J_USE_TRACING
+
+	const JCharacter* traceFile = getenv("JX_TRACE_FILE");
+	if (!JStringEmpty(traceFile) && !JTrace::WriteChromeTrace(traceFile))
+		{
+		cerr << "Unable to write trace to " << traceFile << endl;
+		}
+
+#endif
+
+	delete itsWorkerPool;		// stop the workers before anything else goes away
+
 	JXCloseDirectors();
 
 	itsIgnoreDisplayDeletedFlag = kJTrue;
@@ -478,6 +506,8 @@ JXApplication::UpdateCurrentTime()
 void
 JXApplication::HandleOneEvent()
 {
+	J_TRACE_ZONE("JXApplication::HandleOneEvent");
+
 	itsHadBlockingWindowFlag = kJFalse;
 
 	UpdateCurrentTime();
@@ -510,6 +540,7 @@ JXApplication::HandleOneEvent()
 			// dispatch the event
 
 			display->HandleEvent(xEvent, itsCurrentTime);
+			display->UpdateIfFrameDue(itsCurrentTime, kJTrue);
 			}
 		else
 			{
@@ -530,7 +561,7 @@ JXApplication::HandleOneEvent()
 		PerformUrgentTasks();
 		if (allowSleep)
 			{
-			JWait(itsMaxSleepTime / 1000.0);
+			JWait(GetSleepTime() / 1000.0);
 			}
 		}
 	else if (hasEvents &&
@@ -677,6 +708,7 @@ JXApplication::HandleOneEventForWindow
 					itsLastIdleTime = itsCurrentTime;
 					}
 				display->HandleEvent(xEvent, itsCurrentTime);
+				display->UpdateIfFrameDue(itsCurrentTime, kJTrue);
 				}
 #if 0
 			// cd: background event check is now done as part of window event check
@@ -694,7 +726,7 @@ JXApplication::HandleOneEventForWindow
 				}
 			else
 				{
-				display->Update();
+				display->UpdateIfFrameDue(itsCurrentTime, kJFalse);
 				}
 
 			// discard mouse and keyboard events
@@ -716,7 +748,7 @@ JXApplication::HandleOneEventForWindow
 			}
 		else
 			{
-			display->Update();
+			display->UpdateIfFrameDue(itsCurrentTime, kJFalse);
 			}
 		}
 
@@ -732,7 +764,7 @@ JXApplication::HandleOneEventForWindow
 			PerformUrgentTasks();
 			if (allowSleep)
 				{
-				JWait(itsMaxSleepTime / 1000.0);
+				JWait(GetSleepTime() / 1000.0);
 				}
 			}
 		else if (windowHasEvents &&
@@ -1109,6 +1141,8 @@ JXApplication::PopAllIdleTaskStack()
 void
 JXApplication::PerformIdleTasks()
 {
+	J_TRACE_ZONE("JXApplication::PerformIdleTasks");
+
 	itsMaxSleepTime = kMaxSleepTime;
 
 	if (!itsIdleTasks->IsEmpty())		// avoid constructing iterator
@@ -1119,6 +1153,7 @@ JXApplication::PerformIdleTasks()
 		while (iter.Next(&task))
 			{
 			Time maxSleepTime = itsMaxSleepTime;
+			J_TRACE_ZONE("JXIdleTask::Perform");
 			task->Perform(deltaTime, &maxSleepTime);
 			if (maxSleepTime < itsMaxSleepTime)
 				{
@@ -1133,13 +1168,17 @@ JXApplication::PerformIdleTasks()
 
 		CheckACEReactor();
 
-		// let processes broadcast -- not necessary to check each time
+		// let processes broadcast -- PerformUrgentTasks() does this when
+		// SIGCHLD is caught, and otherwise not necessary to check each time
 
-		itsWaitForChildCounter++;
-		if (itsWaitForChildCounter >= kWaitForChildCount)
+		if (!JThisProcess::WillCatchSignal(SIGCHLD))
 			{
-			JProcess::CheckForFinishedChild(kJFalse);
-			itsWaitForChildCounter = 0;
+			itsWaitForChildCounter++;
+			if (itsWaitForChildCounter >= kWaitForChildCount)
+				{
+				JProcess::CheckForFinishedChild(kJFalse);
+				itsWaitForChildCounter = 0;
+				}
 			}
 		}
 
@@ -1154,6 +1193,34 @@ JXApplication::PerformIdleTasks()
 	itsLastIdleTaskTime = itsCurrentTime;
 }
 
+/******************************************************************************
+ GetSleepTime (private)
+
+	Returns itsMaxSleepTime, shortened so we wake up in time to draw the
+	next frame on any display that has been damaged.
+
+ ******************************************************************************/
+
+Time
+JXApplication::GetSleepTime()
+	const
+{
+	Time sleepTime = itsMaxSleepTime;
+
+	const JSize count = itsDisplayList->GetElementCount();
+	for (JIndex i=1; i<=count; i++)
+		{
+		Time delay;
+		if ((itsDisplayList->NthElement(i))->GetTimeUntilFrame(itsCurrentTime, &delay) &&
+			delay < sleepTime)
+			{
+			sleepTime = delay;
+			}
+		}
+
+	return sleepTime;
+}
+
 /******************************************************************************
  PerformPermanentTasks (private)
 
@@ -1162,6 +1229,8 @@ JXApplication::PerformIdleTasks()
 void
 JXApplication::PerformPermanentTasks()
 {
+	J_TRACE_ZONE("JXApplication::PerformPermanentTasks");
+
 	itsMaxSleepTime = kMaxSleepTime;
 
 	if (!itsPermanentTasks->IsEmpty())		// avoid constructing iterator
@@ -1172,6 +1241,7 @@ JXApplication::PerformPermanentTasks()
 		while (iter.Next(&task))
 			{
 			Time maxSleepTime = itsMaxSleepTime;
+			J_TRACE_ZONE("JXIdleTask::Perform");
 			task->Perform(deltaTime, &maxSleepTime);
 			if (maxSleepTime < itsMaxSleepTime)
 				{
@@ -1246,6 +1316,27 @@ JXApplication::RemoveUrgentTask
 		}
 }
 
+/******************************************************************************
+ GetWorkerPool
+
+	Returns the pool of background threads shared by the entire program.
+	The pool is created the first time it is requested.  Finished tasks
+	are delivered along with the urgent tasks.
+
+ ******************************************************************************/
+
+JWorkerPool*
+JXApplication::GetWorkerPool()
+{
+	if (itsWorkerPool == NULL)
+		{
+		itsWorkerPool = new JWorkerPool;
+		assert( itsWorkerPool != NULL );
+		}
+
+	return itsWorkerPool;
+}
+
 /******************************************************************************
  PerformUrgentTasks (private)
 
@@ -1254,6 +1345,23 @@ JXApplication::RemoveUrgentTask
 void
 JXApplication::PerformUrgentTasks()
 {
+	J_TRACE_ZONE("JXApplication::PerformUrgentTasks");
+
+	// finished background tasks broadcast before the urgent tasks run,
+	// since the recipients usually update the display
+
+	if (itsWorkerPool != NULL)
+		{
+		itsWorkerPool->DeliverFinishedTasks();
+
+		// don't sleep too long while tasks are running
+
+		if (itsWorkerPool->IsBusy() && itsMaxSleepTime > kWorkerPollTime)
+			{
+			itsMaxSleepTime = kWorkerPollTime;
+			}
+		}
+
 	if (!itsUrgentTasks->IsEmpty())
 		{
 		// clear out itsUrgentTasks so new ones can safely be added
@@ -1272,6 +1380,14 @@ JXApplication::PerformUrgentTasks()
 
 	JXDisplay::CheckForXErrors();
 
+	// SIGCHLD interrupts JWait(), so finished processes broadcast
+	// during the next pass through the event loop.
+
+	if (!itsHasBlockingWindowFlag && JThisProcess::ChildProcessFinished())
+		{
+		JProcess::CheckForFinishedChild(kJFalse);
+		}
+
 	// We check in this order so CheckForSignals() can broadcast even
 	// if the app is suspended.
 
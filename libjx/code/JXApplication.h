@@ -24,6 +24,7 @@
 #include <X11/Xutil.h>
 
 class JXWindow;
+class JWorkerPool;
 
 class JXApplication : public JXDirector
 {
@@ -58,6 +59,8 @@ public:
 	void	InstallUrgentTask(JXUrgentTask* newTask);
 	void	RemoveUrgentTask(JXUrgentTask* task);
 
+	JWorkerPool*	GetWorkerPool();
+
 	JXDisplay*	GetCurrentDisplay() const;
 	void		SetCurrentDisplay(const JIndex index);
 	void		SetCurrentDisplay(JXDisplay* display);
@@ -145,6 +148,7 @@ private:
 	IdleTaskStack*			itsIdleTaskStack;
 
 	JPtrArray<JXUrgentTask>*	itsUrgentTasks;
+	JWorkerPool*				itsWorkerPool;		// NULL until first requested
 	JBoolean					itsHasBlockingWindowFlag;
 	JBoolean					itsHadBlockingWindowFlag;
 
@@ -158,6 +162,7 @@ private:
 	void	PerformIdleTasks();
 	void	PerformPermanentTasks();
 	void	PerformUrgentTasks();
+	Time	GetSleepTime() const;
 
 	void	PushIdleTaskStack();
 	void	PopIdleTaskStack();
@@ -40,7 +40,9 @@
 #include <JXStdInc.h>
 #include <JXColormap.h>
 #include <JXDisplay.h>
+#include <JMinMax.h>
 #include <stdlib.h>
+#include <string.h>
 #include <jAssert.h>
 
 const JSize kBitsPerColorComp   = 16;			// X uses 16 bits for each of r,g,b
@@ -49,6 +51,12 @@ const JSize kColorListBlockSize = 30;
 const JCoordinate kDefColorBoxHW    = 40000;	// recommended by XPM docs
 const JCoordinate kDefPreColorBoxHW = 4000;
 
+const JSize kMinColorHashSize = 256;
+const JSize kColorGridBits    = 4;				// bits of each component used for grid
+const JSize kColorGridShift   = kBitsPerColorComp - kColorGridBits;
+const JSize kColorGridWidth   = 1 << kColorGridBits;
+const JSize kColorGridSize    = kColorGridWidth * kColorGridWidth * kColorGridWidth;
+
 // JBroadcaster message types
 
 const JCharacter* JXColormap::kNewColormap = "NewColormap::JXColormap";
@@ -242,6 +250,10 @@ JXColormap::JXColormap
 	itsXColorListUseCount    = 0;
 	itsXColorListInitFlag    = kJFalse;
 	itsXColorList            = NULL;
+	itsColorHash             = NULL;
+	itsColorHashSize         = 0;
+	itsColorIndexLoad        = 0;
+	itsColorGrid             = NULL;
 
 #ifdef USE_DYNAMIC_SELECTION
 	itsSelectionColor        = kDefaultSelectionColor;
@@ -313,6 +325,7 @@ JXColormap::~JXColormap()
 			}
 		}
 
+	DeleteColorIndex();
 	delete itsColorList;
 	delete [] itsXColorList;
 }
@@ -342,6 +355,7 @@ JXColormap::AllocateDefaultColors()
 		itsColorList = new JArray<ColorInfo>(kColorListBlockSize);
 		assert( itsColorList != NULL );
 
+		RebuildColorIndex();
 		AllocateXColorList();
 
 		for (JIndex i=1; i<=kDefColorCount; i++)
@@ -795,42 +809,23 @@ JXColormap::AllocateStaticColor
 
 	if (!itsSwitchingCmapFlag)
 		{
-		const JSize colorCount = itsColorList->GetElementCount();
-		JFloat minDistance     = 0.0;
-		for (JIndex i=1; i<=colorCount; i++)
+		JColorIndex i;
+		if (FindExactColor(red, green, blue, &i))
 			{
 			ColorInfo info = itsColorList->GetElement(i);
-			if (info.useCount > 0 && !info.dynamic && !info.preemptive)
-				{
-				if (info.color.red   == red &&
-					info.color.green == green &&
-					info.color.blue  == blue)
-					{
-					(info.useCount)++;
-					itsColorList->SetElement(i, info);
+			(info.useCount)++;
+			itsColorList->SetElement(i, info);
 
-					*colorIndex = i;
-					if (exactMatch != NULL)
-						{
-						*exactMatch = info.exactMatch;
-						}
-					return kJTrue;
-					}
-				else if (itsAllowApproxColorsFlag && itsPreApproxColorsFlag &&
-						 IsInsideColorBox(red, green, blue,
-						 				  info.color.red, info.color.green, info.color.blue,
-						 				  itsPreColorBoxHW))
-					{
-					const JFloat d =
-						itsColorDistanceFn(red, green, blue,
-										   info.color.red, info.color.green, info.color.blue);
-					if (d < minDistance || closestColorIndex == 0)
-						{
-						minDistance       = d;
-						closestColorIndex = i;
-						}
-					}
+			*colorIndex = i;
+			if (exactMatch != NULL)
+				{
+				*exactMatch = info.exactMatch;
 				}
+			return kJTrue;
+			}
+		else if (itsAllowApproxColorsFlag && itsPreApproxColorsFlag)
+			{
+			FindClosestColor(red, green, blue, itsPreColorBoxHW, &closestColorIndex);
 			}
 		}
 
@@ -1013,27 +1008,34 @@ JIndex i;
 			XQueryColors(*itsDisplay, itsXColormap, xColor, colorCount);
 			}
 
-		// sort the list of colors by closeness
+		// sort the acceptable colors by closeness -- the rest can be
+		// discarded first, since this is much cheaper than sorting them
 
+		const JBoolean isGray = JI2B(IsGray(red, green, blue));
+
+		JSize candidateCount = 0;
 		for (i=0; i<colorCount; i++)
 			{
-			info[i].xPixel = i;
-			info[i].d =
-				itsColorDistanceFn(red, green, blue,
-								   xColor[i].red, xColor[i].green, xColor[i].blue);
+			XColor* c = xColor + i;
+			if (IsInsideColorBox(red, green, blue,
+								 c->red, c->green, c->blue, itsColorBoxHW) &&
+				(!isGray || IsGray(c->red, c->green, c->blue)))
+				{
+				info[ candidateCount ].xPixel = i;
+				info[ candidateCount ].d      =
+					itsColorDistanceFn(red, green, blue, c->red, c->green, c->blue);
+				candidateCount++;
+				}
 			}
-		qsort(info, colorCount, sizeof(CloseColorInfo), CompareCloseColorInfo);
+		qsort(info, candidateCount, sizeof(CloseColorInfo), CompareCloseColorInfo);
 
 		// find the closest usable color (colormap may change or pixel may be read/write)
 
 		const JBoolean forceMatch = kJFalse;
-		for (i=0; i<colorCount; i++)
+		for (i=0; i<candidateCount; i++)
 			{
 			XColor* c = xColor + info[i].xPixel;
-			if (IsInsideColorBox(red, green, blue,
-								 c->red, c->green, c->blue, itsColorBoxHW) &&
-				(!IsGray(red, green, blue) || IsGray(c->red, c->green, c->blue)) &&
-				PrivateAllocateStaticColor(c->red, c->green, c->blue,
+			if (PrivateAllocateStaticColor(c->red, c->green, c->blue,
 										   colorIndex, exactMatch, &forceMatch))
 				{
 				if (serverGrabbed)
@@ -1509,14 +1511,269 @@ JXColormap::StoreNewColor
 		if (info.useCount == 0)
 			{
 			itsColorList->SetElement(i, newInfo);
+			IndexColor(i);
 			return i;
 			}
 		}
 
 	itsColorList->AppendElement(newInfo);
+	IndexColor(colorCount + 1);
 	return colorCount + 1;
 }
 
+/******************************************************************************
+ Color index (private)
+
+	itsColorHash finds exact matches, and itsColorGrid groups similar
+	colors so approximate matches only need to check the nearby cells.
+
+	Since slots in itsColorList are reused, entries are never removed.
+	Instead, every candidate is checked against itsColorList, and both
+	indexes are rebuilt when the hash table gets too full.
+
+ ******************************************************************************/
+
+inline JIndex
+JXColormapHash
+	(
+	const JSize red,
+	const JSize green,
+	const JSize blue
+	)
+{
+	return (red * 73856093UL) ^ (green * 19349663UL) ^ (blue * 83492791UL);
+}
+
+inline JIndex
+JXColormapGridCell
+	(
+	const JSize red,
+	const JSize green,
+	const JSize blue
+	)
+{
+	return (((red   >> kColorGridShift)  * kColorGridWidth +
+			 (green >> kColorGridShift)) * kColorGridWidth +
+			 (blue  >> kColorGridShift));
+}
+
+JBoolean
+JXColormap::IsIndexedColor
+	(
+	const JColorIndex colorIndex
+	)
+	const
+{
+	if (colorIndex > itsColorList->GetElementCount())
+		{
+		return kJFalse;
+		}
+
+	const ColorInfo info = itsColorList->GetElement(colorIndex);
+	return JI2B(info.useCount > 0 && !info.dynamic && !info.preemptive);
+}
+
+JBoolean
+JXColormap::FindExactColor
+	(
+	const JSize		red,
+	const JSize		green,
+	const JSize		blue,
+	JColorIndex*	colorIndex
+	)
+	const
+{
+	const JSize mask = itsColorHashSize - 1;
+	for (JIndex h = JXColormapHash(red, green, blue) & mask;
+		 itsColorHash[h] != 0; h = (h+1) & mask)
+		{
+		const JColorIndex i = itsColorHash[h];
+		if (IsIndexedColor(i))
+			{
+			const JRGB c = (itsColorList->GetElement(i)).color;
+			if (c.red == red && c.green == green && c.blue == blue)
+				{
+				*colorIndex = i;
+				return kJTrue;
+				}
+			}
+		}
+
+	*colorIndex = 0;
+	return kJFalse;
+}
+
+JBoolean
+JXColormap::FindClosestColor
+	(
+	const JSize		red,
+	const JSize		green,
+	const JSize		blue,
+	const long		hw,
+	JColorIndex*	colorIndex
+	)
+	const
+{
+	const JSize rgb[3] = { red, green, blue };
+	JIndex minCell[3], maxCell[3];
+	for (JIndex i=0; i<3; i++)
+		{
+		minCell[i] = (rgb[i] > (JSize) hw ? (rgb[i] - hw) >> kColorGridShift : 0);
+		maxCell[i] = JMin((rgb[i] + hw) >> kColorGridShift, kColorGridWidth-1);
+		}
+
+	*colorIndex       = 0;
+	long minDistance  = 0;
+	for (JIndex r=minCell[0]; r<=maxCell[0]; r++)
+		{
+		for (JIndex g=minCell[1]; g<=maxCell[1]; g++)
+			{
+			for (JIndex b=minCell[2]; b<=maxCell[2]; b++)
+				{
+				const JArray<JColorIndex>* cell =
+					itsColorGrid[ (r * kColorGridWidth + g) * kColorGridWidth + b ];
+				if (cell == NULL)
+					{
+					continue;
+					}
+
+				const JSize count = cell->GetElementCount();
+				for (JIndex j=1; j<=count; j++)
+					{
+					const JColorIndex i = cell->GetElement(j);
+					if (!IsIndexedColor(i))
+						{
+						continue;
+						}
+
+					const JRGB c = (itsColorList->GetElement(i)).color;
+					if (IsInsideColorBox(red, green, blue, c.red, c.green, c.blue, hw))
+						{
+						const long d =
+							itsColorDistanceFn(red, green, blue, c.red, c.green, c.blue);
+						if (*colorIndex == 0 || d < minDistance ||
+							(d == minDistance && i < *colorIndex))
+							{
+							minDistance = d;
+							*colorIndex = i;
+							}
+						}
+					}
+				}
+			}
+		}
+
+	return JI2B( *colorIndex > 0 );
+}
+
+void
+JXColormap::IndexColor
+	(
+	const JColorIndex colorIndex
+	)
+{
+	if (!IsIndexedColor(colorIndex))
+		{
+		return;
+		}
+
+	itsColorIndexLoad++;
+	if (2 * itsColorIndexLoad > itsColorHashSize)
+		{
+		RebuildColorIndex();	// includes the new color
+		return;
+		}
+
+	const JRGB c = (itsColorList->GetElement(colorIndex)).color;
+
+	const JSize mask = itsColorHashSize - 1;
+	JIndex h         = JXColormapHash(c.red, c.green, c.blue) & mask;
+	while (itsColorHash[h] != 0)
+		{
+		h = (h+1) & mask;
+		}
+	itsColorHash[h] = colorIndex;
+
+	JArray<JColorIndex>** cell = itsColorGrid + JXColormapGridCell(c.red, c.green, c.blue);
+	if (*cell == NULL)
+		{
+		*cell = new JArray<JColorIndex>;
+		assert( *cell != NULL );
+		}
+	(**cell).AppendElement(colorIndex);
+}
+
+void
+JXColormap::RebuildColorIndex()
+{
+	JSize liveCount = 0;
+
+	const JSize colorCount = itsColorList->GetElementCount();
+	for (JIndex i=1; i<=colorCount; i++)
+		{
+		if (IsIndexedColor(i))
+			{
+			liveCount++;
+			}
+		}
+
+	JSize size = kMinColorHashSize;
+	while (size < 4 * liveCount)
+		{
+		size *= 2;
+		}
+
+	if (size != itsColorHashSize)
+		{
+		delete [] itsColorHash;
+		itsColorHash = new JColorIndex [ size ];
+		assert( itsColorHash != NULL );
+		itsColorHashSize = size;
+		}
+	memset(itsColorHash, 0, itsColorHashSize * sizeof(JColorIndex));
+
+	if (itsColorGrid == NULL)
+		{
+		itsColorGrid = new JArray<JColorIndex>* [ kColorGridSize ];
+		assert( itsColorGrid != NULL );
+		memset(itsColorGrid, 0, kColorGridSize * sizeof(JArray<JColorIndex>*));
+		}
+	else
+		{
+		for (JIndex i=0; i<kColorGridSize; i++)
+			{
+			if (itsColorGrid[i] != NULL)
+				{
+				itsColorGrid[i]->RemoveAll();
+				}
+			}
+		}
+
+	itsColorIndexLoad = 0;
+	for (JIndex i=1; i<=colorCount; i++)
+		{
+		IndexColor(i);
+		}
+}
+
+void
+JXColormap::DeleteColorIndex()
+{
+	delete [] itsColorHash;
+	itsColorHash     = NULL;
+	itsColorHashSize = 0;
+
+	if (itsColorGrid != NULL)
+		{
+		for (JIndex i=0; i<kColorGridSize; i++)
+			{
+			delete itsColorGrid[i];
+			}
+		delete [] itsColorGrid;
+		itsColorGrid = NULL;
+		}
+}
+
 /******************************************************************************
  CreateEmptyColormap (private)
 
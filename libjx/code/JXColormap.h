@@ -223,6 +223,14 @@ private:
 	JBoolean	itsXColorListInitFlag;			// kJTrue => itsXColorList contains colormap
 	XColor*		itsXColorList;					// NULL unless approximating many colors
 
+	// indexes into itsColorList for fast lookup of static colors
+	// (entries are never removed, so they must be checked before use)
+
+	JColorIndex*			itsColorHash;		// exact match; 0 => empty slot
+	JSize					itsColorHashSize;	// power of 2
+	JSize					itsColorIndexLoad;	// # of entries added since last rebuild
+	JArray<JColorIndex>**	itsColorGrid;		// buckets of similar colors; NULL if empty
+
 private:
 
 	JXColormap(JXDisplay* display, Visual* visual, Colormap xColormap,
@@ -249,6 +257,15 @@ private:
 								 const long r2, const long g2, const long b2,
 								 const long hw) const;
 
+	JBoolean	FindExactColor(const JSize red, const JSize green, const JSize blue,
+							   JColorIndex* colorIndex) const;
+	JBoolean	FindClosestColor(const JSize red, const JSize green, const JSize blue,
+								 const long hw, JColorIndex* colorIndex) const;
+	JBoolean	IsIndexedColor(const JColorIndex colorIndex) const;
+	void		IndexColor(const JColorIndex colorIndex);
+	void		RebuildColorIndex();
+	void		DeleteColorIndex();
+
 	// called by JXDisplay
 
 	static JXColormap*	Create(JXDisplay* display);
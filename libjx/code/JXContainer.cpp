@@ -33,6 +33,11 @@
 	This is why all the DND functions other than BeginDND() are defined
 	by JXContainer.
 
+	Containers with many enclosed objects build a JXContainerIndex so
+	hit-testing and redrawing only have to check the objects near the
+	point or the damaged rectangle.  Derived classes must call
+	FrameChanged() whenever their frame changes.
+
 	BASE CLASS = virtual JBroadcaster
 
 	Copyright  1996 by John Lindal. All rights reserved.
@@ -41,6 +46,7 @@
 
 #include <JXStdInc.h>
 #include <JXContainer.h>
+#include <JXContainerIndex.h>
 #include <JXDisplay.h>
 #include <JXWindow.h>
 #include <JXWindowPainter.h>
@@ -97,6 +103,10 @@ JXContainer::JXContainerX
 	itsEnclosure       = enclosure;
 	itsEnclosedObjs    = NULL;
 	itsIgnoreEnclosedObjs = kJFalse;
+	itsEnclosedIndex   = NULL;
+	itsNextStackOrder  = 0;
+	itsStackOrder      = 0;
+	itsIndexedFlag     = kJFalse;
 	itsActiveFlag      = kJFalse;
 	itsWasActiveFlag   = kJTrue;
 	itsVisibleFlag     = kJFalse;
@@ -260,13 +270,24 @@ JXContainer::DrawAll
 		XRectangle xClipRect = JXJToXRect(apClipRectG);
 		visRegion            = JXRectangleRegion(&xClipRect);
 
+		// only objects that intersect the rectangle need to be drawn
+
+		JPtrArray<JXContainer>* objList = itsEnclosedObjs;
+
+		JPtrArray<JXContainer> damagedObjs(JPtrArrayT::kForgetAll);
+		JXContainerIndex* index;
+		if (GetEnclosedIndex(&index) && index->FindObjects(apClipRectG, &damagedObjs))
+			{
+			objList = &damagedObjs;
+			}
+
 		// draw visible objects in reverse order so all the
 		// other routines can check them in the normal order
 
-		const JSize objCount = itsEnclosedObjs->GetElementCount();
+		const JSize objCount = objList->GetElementCount();
 		for (JIndex i=objCount; i>=1; i--)
 			{
-			JXContainer* obj = itsEnclosedObjs->NthElement(i);
+			JXContainer* obj = objList->NthElement(i);
 			if (obj->IsVisible())
 				{
 				obj->DrawAll(p, apClipRectG);
@@ -415,17 +436,11 @@ JXContainer::FindContainer
 
 	// check if enclosed object contains it
 
-	if (itsEnclosedObjs != NULL)
+	JXContainer* obj;
+	if (FindEnclosedObject(ptG, kJTrue, &obj) &&
+		obj->FindContainer(ptG, container))
 		{
-		const JSize objCount = itsEnclosedObjs->GetElementCount();
-		for (JIndex i=1; i<=objCount; i++)
-			{
-			JXContainer* obj = itsEnclosedObjs->NthElement(i);
-			if (obj->FindContainer(ptG, container))
-				{
-				return kJTrue;
-				}
-			}
+		return kJTrue;
 		}
 
 	// we contain it
@@ -455,19 +470,12 @@ JXContainer::DispatchNewMouseEvent
 
 	// check if enclosed object wants it
 
-	if (IsActive() && !itsIgnoreEnclosedObjs && itsEnclosedObjs != NULL)
+	JXContainer* obj;
+	if (IsActive() && !itsIgnoreEnclosedObjs &&
+		FindEnclosedObject(ptG, kJFalse, &obj))
 		{
-		const JSize objCount = itsEnclosedObjs->GetElementCount();
-		for (JIndex i=1; i<=objCount; i++)
-			{
-			JXContainer* obj = itsEnclosedObjs->NthElement(i);
-			if (obj->IsVisible() &&
-				(obj->GetFrameGlobal()).Contains(ptG))
-				{
-				obj->DispatchNewMouseEvent(eventType, ptG, button, state);
-				return;
-				}
-			}
+		obj->DispatchNewMouseEvent(eventType, ptG, button, state);
+		return;
 		}
 
 	// handle it ourselves
@@ -1335,18 +1343,11 @@ JXContainer::DispatchCursor
 {
 	// check if cursor is in enclosed object
 
-	if (IsActive() && itsEnclosedObjs != NULL)
+	JXContainer* obj;
+	if (IsActive() && FindEnclosedObject(ptG, kJFalse, &obj))
 		{
-		const JSize objCount = itsEnclosedObjs->GetElementCount();
-		for (JIndex i=1; i<=objCount; i++)
-			{
-			JXContainer* obj = itsEnclosedObjs->NthElement(i);
-			if (obj->IsVisible() && (obj->GetFrameGlobal()).Contains(ptG))
-				{
-				obj->DispatchCursor(ptG, modifiers);
-				return;
-				}
-			}
+		obj->DispatchCursor(ptG, modifiers);
+		return;
 		}
 
 	// if not, display our own cursor
@@ -1705,6 +1706,25 @@ JXContainer::NotifyBoundsResized
 		}
 }
 
+/******************************************************************************
+ FrameChanged (protected)
+
+	Derived classes must call this after changing the frame, so our
+	enclosure can update its index.  Moving the frame because the
+	enclosure scrolled is harmless, since the index is in the enclosure's
+	local coordinates.
+
+ ******************************************************************************/
+
+void
+JXContainer::FrameChanged()
+{
+	if (itsEnclosure != NULL && itsEnclosure->itsEnclosedIndex != NULL)
+		{
+		itsEnclosure->itsEnclosedIndex->FrameChanged(this);
+		}
+}
+
 /******************************************************************************
  DeleteEnclosedObjects (protected)
 
@@ -1720,6 +1740,9 @@ JXContainer::DeleteEnclosedObjects()
 		itsGoingAwayFlag = kJFalse;
 		delete itsEnclosedObjs;
 		itsEnclosedObjs = NULL;
+
+		delete itsEnclosedIndex;
+		itsEnclosedIndex = NULL;
 		}
 }
 
@@ -1746,6 +1769,13 @@ JXContainer::AddEnclosedObject
 	if (!itsEnclosedObjs->Includes(theObject))
 		{
 		itsEnclosedObjs->Prepend(theObject);
+
+		itsNextStackOrder--;
+		theObject->itsStackOrder = itsNextStackOrder;
+		if (itsEnclosedIndex != NULL)
+			{
+			itsEnclosedIndex->Add(theObject);
+			}
 		}
 }
 
@@ -1764,15 +1794,96 @@ JXContainer::RemoveEnclosedObject
 {
 	if (itsEnclosedObjs != NULL && !itsGoingAwayFlag)
 		{
+		if (itsEnclosedIndex != NULL)
+			{
+			itsEnclosedIndex->Remove(theObject);
+			}
+
 		itsEnclosedObjs->Remove(theObject);
 		if (itsEnclosedObjs->IsEmpty())
 			{
 			delete itsEnclosedObjs;
 			itsEnclosedObjs = NULL;
+
+			delete itsEnclosedIndex;
+			itsEnclosedIndex = NULL;
 			}
 		}
 }
 
+/******************************************************************************
+ GetEnclosedIndex (private)
+
+	Returns kJTrue if there are enough enclosed objects to make the index
+	worthwhile.  It is built the first time it is needed.
+
+ ******************************************************************************/
+
+JBoolean
+JXContainer::GetEnclosedIndex
+	(
+	JXContainerIndex** index
+	)
+	const
+{
+	if (itsEnclosedObjs == NULL ||
+		itsEnclosedObjs->GetElementCount() < JXContainerIndex::kMinObjectCount)
+		{
+		*index = NULL;
+		return kJFalse;
+		}
+
+	if (itsEnclosedIndex == NULL)
+		{
+		JXContainer* me        = const_cast<JXContainer*>(this);
+		me->itsEnclosedIndex   = new JXContainerIndex(me);
+		assert( itsEnclosedIndex != NULL );
+		}
+
+	*index = itsEnclosedIndex;
+	return kJTrue;
+}
+
+/******************************************************************************
+ FindEnclosedObject (private)
+
+	Returns the first visible enclosed object whose frame contains the
+	given point.  This is the object that is drawn on top.
+
+ ******************************************************************************/
+
+JBoolean
+JXContainer::FindEnclosedObject
+	(
+	const JPoint&	ptG,
+	const JBoolean	requireActive,
+	JXContainer**	obj
+	)
+	const
+{
+	JXContainerIndex* index;
+	if (GetEnclosedIndex(&index))
+		{
+		return index->FindObject(ptG, requireActive, obj);
+		}
+	else if (itsEnclosedObjs != NULL)
+		{
+		const JSize objCount = itsEnclosedObjs->GetElementCount();
+		for (JIndex i=1; i<=objCount; i++)
+			{
+			*obj = itsEnclosedObjs->NthElement(i);
+			if ((**obj).IsVisible() && (!requireActive || (**obj).IsActive()) &&
+				((**obj).GetFrameGlobal()).Contains(ptG))
+				{
+				return kJTrue;
+				}
+			}
+		}
+
+	*obj = NULL;
+	return kJFalse;
+}
+
 /******************************************************************************
  Receive (virtual protected)
 
@@ -36,11 +36,13 @@ class JXSelectionManager;
 class JXDNDManager;
 class JXMenuManager;
 class JXHintManager;
+class JXContainerIndex;
 
 class JXContainer : virtual public JBroadcaster
 {
 	friend class JXWindow;
 	friend class JXDNDManager;
+	friend class JXContainerIndex;
 
 public:
 
@@ -179,6 +181,8 @@ protected:
 	virtual void	BoundsResized(const JCoordinate dw, const JCoordinate dh) = 0;
 	virtual void	EnclosingBoundsResized(const JCoordinate dw, const JCoordinate dh) = 0;
 
+	void			FrameChanged();
+
 	void			DeleteEnclosedObjects();
 
 	virtual void	Receive(JBroadcaster* sender, const Message& message);
@@ -212,6 +216,14 @@ private:
 	JBoolean				itsIgnoreEnclosedObjs;
 	JBoolean				itsGoingAwayFlag;
 
+	// spatial index of enclosed objects
+
+	JXContainerIndex*	itsEnclosedIndex;	// NULL until there are enough objects
+	long				itsNextStackOrder;
+	long				itsStackOrder;		// smaller => nearer the front
+	JRect				itsIndexFrame;		// enclosure's local coords
+	JBoolean			itsIndexedFlag;
+
 	JBoolean	itsActiveFlag;
 	JBoolean	itsWasActiveFlag;	// kJTrue => activate when enclosure is activated
 	JBoolean	itsVisibleFlag;
@@ -247,6 +259,10 @@ private:
 	void	AddEnclosedObject(JXContainer* theObject);
 	void	RemoveEnclosedObject(JXContainer* theObject);
 
+	JBoolean	GetEnclosedIndex(JXContainerIndex** index) const;
+	JBoolean	FindEnclosedObject(const JPoint& ptG, const JBoolean requireActive,
+								   JXContainer** obj) const;
+
 	// called by JXWindow
 
 	void	DispatchNewMouseEvent(const int eventType, const JPoint& ptG,
@@ -0,0 +1,542 @@
+/******************************************************************************
+ JXContainerIndex.cpp
+
+	Spatial index of the objects enclosed by a JXContainer, so hit-testing
+	and redrawing do not have to check every object when a container holds
+	hundreds of them.
+
+	The objects are stored in a hashed grid of square cells, in the local
+	coordinates of the enclosure.  Each object is stored in every cell that
+	its frame overlaps.  Objects that overlap too many cells are kept in a
+	separate list that is always checked.  Since scrolling moves all the
+	enclosed objects together, their local frames do not change, so only
+	Place() and SetSize() require updates.
+
+	The index does not store visibility.  Show() and Hide() do not move an
+	object, so the queries simply skip invisible objects.
+
+	Objects are added before their frame is known, so they are kept in a
+	pending list until the next query.
+
+	The results are always the same as scanning the list of enclosed
+	objects, because each object remembers its position in that list.
+
+	BASE CLASS = none
+
+ ******************************************************************************/
+
+#include <JXStdInc.h>
+#include <JXContainerIndex.h>
+#include <JXContainer.h>
+#include <JMinMax.h>
+#include <string.h>
+#include <jAssert.h>
+
+const JSize kMinBucketCount     = 16;
+const JSize kMaxCellsPerObject  = 16;
+const JCoordinate kMinCellSize  = 16;
+const JCoordinate kMaxCellSize  = 1024;
+
+/******************************************************************************
+ Constructor
+
+ ******************************************************************************/
+
+JXContainerIndex::JXContainerIndex
+	(
+	JXContainer* owner
+	)
+	:
+	itsOwner(owner),
+	itsCellSize(kMinCellSize),
+	itsBucketCount(0),
+	itsBuckets(NULL),
+	itsLargeLimit(0)
+{
+	itsLargeObjs = new JPtrArray<JXContainer>(JPtrArrayT::kForgetAll);
+	assert( itsLargeObjs != NULL );
+
+	itsPendingObjs = new JPtrArray<JXContainer>(JPtrArrayT::kForgetAll);
+	assert( itsPendingObjs != NULL );
+
+	Rebuild();
+}
+
+/******************************************************************************
+ Destructor
+
+ ******************************************************************************/
+
+JXContainerIndex::~JXContainerIndex()
+{
+	for (JIndex i=0; i<itsBucketCount; i++)
+		{
+		delete itsBuckets[i];
+		}
+	delete [] itsBuckets;
+
+	delete itsLargeObjs;
+	delete itsPendingObjs;
+}
+
+/******************************************************************************
+ Add
+
+	The object's frame is not yet valid, because JXContainer adds it
+	before the derived class constructor runs.
+
+ ******************************************************************************/
+
+void
+JXContainerIndex::Add
+	(
+	JXContainer* obj
+	)
+{
+	obj->itsIndexedFlag = kJFalse;
+	itsPendingObjs->Append(obj);
+}
+
+/******************************************************************************
+ Remove
+
+ ******************************************************************************/
+
+void
+JXContainerIndex::Remove
+	(
+	JXContainer* obj
+	)
+{
+	if (obj->itsIndexedFlag)
+		{
+		Extract(obj);
+		}
+	else
+		{
+		itsPendingObjs->Remove(obj);
+		}
+}
+
+/******************************************************************************
+ FrameChanged
+
+	Moves the object to the cells covered by its new frame.
+
+ ******************************************************************************/
+
+void
+JXContainerIndex::FrameChanged
+	(
+	JXContainer* obj
+	)
+{
+	if (obj->itsIndexedFlag && GetLocalFrame(obj) != obj->itsIndexFrame)
+		{
+		Extract(obj);
+		Insert(obj);
+		}
+}
+
+/******************************************************************************
+ FindObject
+
+	Returns the first visible object in the enclosure's list whose frame
+	contains the given point.
+
+ ******************************************************************************/
+
+JBoolean
+JXContainerIndex::FindObject
+	(
+	const JPoint&	ptG,
+	const JBoolean	requireActive,
+	JXContainer**	obj
+	)
+{
+	Flush();
+
+	const JPoint pt = itsOwner->GlobalToLocal(ptG);
+
+	JPtrArray<JXContainer>* list[2];
+	list[0] = *(GetBucket(GetCell(pt.x), GetCell(pt.y)));
+	list[1] = itsLargeObjs;
+
+	*obj = NULL;
+	for (JIndex i=0; i<2; i++)
+		{
+		if (list[i] == NULL)
+			{
+			continue;
+			}
+
+		const JSize count = list[i]->GetElementCount();
+		for (JIndex j=1; j<=count; j++)
+			{
+			JXContainer* o = list[i]->NthElement(j);
+			if ((*obj == NULL || o->itsStackOrder < (**obj).itsStackOrder) &&
+				o->IsVisible() && (!requireActive || o->IsActive()) &&
+				(o->GetFrameGlobal()).Contains(ptG))
+				{
+				*obj = o;
+				}
+			}
+		}
+
+	return JI2B( *obj != NULL );
+}
+
+/******************************************************************************
+ FindObjects
+
+	Fills in the visible objects whose frames intersect the given
+	rectangle, in the same order as the enclosure's list.  Returns kJFalse
+	if the rectangle covers so much of the enclosure that it would be
+	faster to check every object.
+
+ ******************************************************************************/
+
+JBoolean
+JXContainerIndex::FindObjects
+	(
+	const JRect&			rectG,
+	JPtrArray<JXContainer>*	list
+	)
+{
+	Flush();
+
+	list->RemoveAll();
+
+	JCoordinate x1, y1, x2, y2, ax1, ay1, ax2, ay2;
+	if (!GetCellRange(itsOwner->GlobalToLocal(rectG), &x1, &y1, &x2, &y2))
+		{
+		return kJTrue;
+		}
+	else if (GetCellRange(itsOwner->GetAperture(), &ax1, &ay1, &ax2, &ay2) &&
+			 2 * (x2-x1+1) * (y2-y1+1) > (ax2-ax1+1) * (ay2-ay1+1))
+		{
+		return kJFalse;
+		}
+
+	JRect r;
+	for (JCoordinate y=y1; y<=y2; y++)
+		{
+		for (JCoordinate x=x1; x<=x2; x++)
+			{
+			JPtrArray<JXContainer>* bucket = *(GetBucket(x,y));
+			if (bucket == NULL)
+				{
+				continue;
+				}
+
+			const JSize count = bucket->GetElementCount();
+			for (JIndex i=1; i<=count; i++)
+				{
+				JXContainer* o = bucket->NthElement(i);
+				if (o->IsVisible() && JIntersection(o->GetFrameGlobal(), rectG, &r))
+					{
+					list->Append(o);
+					}
+				}
+			}
+		}
+
+	const JSize count = itsLargeObjs->GetElementCount();
+	for (JIndex i=1; i<=count; i++)
+		{
+		JXContainer* o = itsLargeObjs->NthElement(i);
+		if (o->IsVisible() && JIntersection(o->GetFrameGlobal(), rectG, &r))
+			{
+			list->Append(o);
+			}
+		}
+
+	// an object can be found in several cells
+
+	list->SetCompareFunction(CompareStackOrder);
+	list->Sort();
+
+	for (JIndex i=list->GetElementCount(); i>=2; i--)
+		{
+		if (list->NthElement(i) == list->NthElement(i-1))
+			{
+			list->RemoveElement(i);
+			}
+		}
+
+	return kJTrue;
+}
+
+/******************************************************************************
+ Rebuild (private)
+
+	Chooses the cell size based on the average size of the enclosed
+	objects and the number of buckets based on the number of objects.
+
+ ******************************************************************************/
+
+void
+JXContainerIndex::Rebuild()
+{
+	for (JIndex i=0; i<itsBucketCount; i++)
+		{
+		delete itsBuckets[i];
+		}
+	delete [] itsBuckets;
+
+	itsLargeObjs->RemoveAll();
+	itsPendingObjs->RemoveAll();
+
+	JPtrArray<JXContainer>* objList = itsOwner->itsEnclosedObjs;
+	const JSize objCount = (objList != NULL ? objList->GetElementCount() : 0);
+
+	JSize total = 0;
+	for (JIndex i=1; i<=objCount; i++)
+		{
+		const JRect r = (objList->NthElement(i))->GetFrameGlobal();
+		total += JMax(r.width(), r.height());
+		}
+
+	itsCellSize = kMinCellSize;
+	while (itsCellSize < kMaxCellSize && itsCellSize * objCount < total)
+		{
+		itsCellSize *= 2;
+		}
+
+	itsBucketCount = kMinBucketCount;
+	while (itsBucketCount < objCount)
+		{
+		itsBucketCount *= 2;
+		}
+
+	itsBuckets = new JPtrArray<JXContainer>* [ itsBucketCount ];
+	assert( itsBuckets != NULL );
+	memset(itsBuckets, 0, itsBucketCount * sizeof(JPtrArray<JXContainer>*));
+
+	for (JIndex i=1; i<=objCount; i++)
+		{
+		Insert(objList->NthElement(i));
+		}
+
+	// if a larger cell size did not help, don't try again right away
+
+	itsLargeLimit = JMax(2 * itsLargeObjs->GetElementCount(),
+						 JMax((JSize) kMinObjectCount / 2, objCount / 4));
+}
+
+/******************************************************************************
+ Flush (private)
+
+	Inserts the pending objects.  If the enclosure has grown too much or
+	too many objects have become larger than the cells, it is faster to
+	start over.
+
+ ******************************************************************************/
+
+void
+JXContainerIndex::Flush()
+{
+	JPtrArray<JXContainer>* objList = itsOwner->itsEnclosedObjs;
+	const JSize objCount = (objList != NULL ? objList->GetElementCount() : 0);
+
+	if (objCount > 2 * itsBucketCount ||
+		itsLargeObjs->GetElementCount() > itsLargeLimit)
+		{
+		Rebuild();
+		}
+	else if (!itsPendingObjs->IsEmpty())
+		{
+		const JSize count = itsPendingObjs->GetElementCount();
+		for (JIndex i=1; i<=count; i++)
+			{
+			Insert(itsPendingObjs->NthElement(i));
+			}
+		itsPendingObjs->RemoveAll();
+		}
+}
+
+/******************************************************************************
+ Insert (private)
+
+ ******************************************************************************/
+
+void
+JXContainerIndex::Insert
+	(
+	JXContainer* obj
+	)
+{
+	obj->itsIndexFrame  = GetLocalFrame(obj);
+	obj->itsIndexedFlag = kJTrue;
+
+	JCoordinate x1, y1, x2, y2;
+	if (!GetCellRange(obj->itsIndexFrame, &x1, &y1, &x2, &y2))
+		{
+		return;		// empty frame is never hit
+		}
+	else if ((JSize) ((x2-x1+1) * (y2-y1+1)) > kMaxCellsPerObject)
+		{
+		itsLargeObjs->Append(obj);
+		return;
+		}
+
+	for (JCoordinate y=y1; y<=y2; y++)
+		{
+		for (JCoordinate x=x1; x<=x2; x++)
+			{
+			JPtrArray<JXContainer>** bucket = GetBucket(x,y);
+			if (*bucket == NULL)
+				{
+				*bucket = new JPtrArray<JXContainer>(JPtrArrayT::kForgetAll, 4);
+				assert( *bucket != NULL );
+				}
+			(**bucket).Append(obj);
+			}
+		}
+}
+
+/******************************************************************************
+ Extract (private)
+
+	Must undo exactly what Insert() did, so it uses the stored frame.
+	If two cells share a bucket, the object was appended twice, so it is
+	also removed twice.
+
+ ******************************************************************************/
+
+void
+JXContainerIndex::Extract
+	(
+	JXContainer* obj
+	)
+{
+	obj->itsIndexedFlag = kJFalse;
+
+	JCoordinate x1, y1, x2, y2;
+	if (!GetCellRange(obj->itsIndexFrame, &x1, &y1, &x2, &y2))
+		{
+		return;
+		}
+	else if ((JSize) ((x2-x1+1) * (y2-y1+1)) > kMaxCellsPerObject)
+		{
+		itsLargeObjs->Remove(obj);
+		return;
+		}
+
+	for (JCoordinate y=y1; y<=y2; y++)
+		{
+		for (JCoordinate x=x1; x<=x2; x++)
+			{
+			JPtrArray<JXContainer>* bucket = *(GetBucket(x,y));
+			assert( bucket != NULL );
+			bucket->Remove(obj);
+			}
+		}
+}
+
+/******************************************************************************
+ GetLocalFrame (private)
+
+ ******************************************************************************/
+
+JRect
+JXContainerIndex::GetLocalFrame
+	(
+	const JXContainer* obj
+	)
+	const
+{
+	return itsOwner->GlobalToLocal(obj->GetFrameGlobal());
+}
+
+/******************************************************************************
+ GetCellRange (private)
+
+	Returns kJFalse if the rectangle is empty.
+
+ ******************************************************************************/
+
+JBoolean
+JXContainerIndex::GetCellRange
+	(
+	const JRect&	r,
+	JCoordinate*	x1,
+	JCoordinate*	y1,
+	JCoordinate*	x2,
+	JCoordinate*	y2
+	)
+	const
+{
+	if (r.IsEmpty())
+		{
+		return kJFalse;
+		}
+
+	*x1 = GetCell(r.left);
+	*y1 = GetCell(r.top);
+	*x2 = GetCell(r.right - 1);
+	*y2 = GetCell(r.bottom - 1);
+	return kJTrue;
+}
+
+/******************************************************************************
+ GetCell (private)
+
+	Rounds toward negative infinity, since objects can be scrolled to
+	negative coordinates.
+
+ ******************************************************************************/
+
+JCoordinate
+JXContainerIndex::GetCell
+	(
+	const JCoordinate v
+	)
+	const
+{
+	return (v >= 0 ? v / itsCellSize : -((-v - 1) / itsCellSize) - 1);
+}
+
+/******************************************************************************
+ GetBucket (private)
+
+ ******************************************************************************/
+
+JPtrArray<JXContainer>**
+JXContainerIndex::GetBucket
+	(
+	const JCoordinate cx,
+	const JCoordinate cy
+	)
+	const
+{
+	const unsigned long h = ((unsigned long) cx * 73856093UL) ^
+							((unsigned long) cy * 19349663UL);
+	return itsBuckets + (h & (itsBucketCount - 1));
+}
+
+/******************************************************************************
+ CompareStackOrder (static private)
+
+ ******************************************************************************/
+
+JOrderedSetT::CompareResult
+JXContainerIndex::CompareStackOrder
+	(
+	JXContainer* const & o1,
+	JXContainer* const & o2
+	)
+{
+	if (o1->itsStackOrder < o2->itsStackOrder)
+		{
+		return JOrderedSetT::kFirstLessSecond;
+		}
+	else if (o1->itsStackOrder == o2->itsStackOrder)
+		{
+		return JOrderedSetT::kFirstEqualSecond;
+		}
+	else
+		{
+		return JOrderedSetT::kFirstGreaterSecond;
+		}
+}
@@ -0,0 +1,77 @@
+/******************************************************************************
+ JXContainerIndex.h
+
+	Interface for the JXContainerIndex class
+
+ ******************************************************************************/
+
+#ifndef _H_JXContainerIndex
+#define _H_JXContainerIndex
+
+#if !defined _J_UNIX && !defined ACE_LACKS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <JPtrArray.h>
+#include <JRect.h>
+
+class JXContainer;
+
+class JXContainerIndex
+{
+public:
+
+	enum
+	{
+		kMinObjectCount = 32	// smaller containers are faster to scan
+	};
+
+public:
+
+	JXContainerIndex(JXContainer* owner);
+
+	~JXContainerIndex();
+
+	void	Add(JXContainer* obj);
+	void	Remove(JXContainer* obj);
+	void	FrameChanged(JXContainer* obj);
+
+	JBoolean	FindObject(const JPoint& ptG, const JBoolean requireActive,
+						   JXContainer** obj);
+	JBoolean	FindObjects(const JRect& rectG, JPtrArray<JXContainer>* list);
+
+private:
+
+	JXContainer*			itsOwner;
+	JCoordinate				itsCellSize;
+	JSize					itsBucketCount;		// power of 2
+	JPtrArray<JXContainer>**	itsBuckets;		// NULL if empty
+	JPtrArray<JXContainer>*	itsLargeObjs;		// span too many cells
+	JPtrArray<JXContainer>*	itsPendingObjs;		// frame not yet known
+	JSize					itsLargeLimit;		// rebuild if more large objects
+
+private:
+
+	void	Rebuild();
+	void	Flush();
+
+	JRect		GetLocalFrame(const JXContainer* obj) const;
+	JBoolean	GetCellRange(const JRect& r, JCoordinate* x1, JCoordinate* y1,
+							 JCoordinate* x2, JCoordinate* y2) const;
+	JCoordinate	GetCell(const JCoordinate v) const;
+
+	JPtrArray<JXContainer>**	GetBucket(const JCoordinate cx, const JCoordinate cy) const;
+
+	void	Insert(JXContainer* obj);
+	void	Extract(JXContainer* obj);
+
+	static JOrderedSetT::CompareResult
+		CompareStackOrder(JXContainer* const & o1, JXContainer* const & o2);
+
+	// not allowed
+
+	JXContainerIndex(const JXContainerIndex& source);
+	const JXContainerIndex& operator=(const JXContainerIndex& source);
+};
+
+#endif
@@ -178,30 +178,35 @@ JXDNDManager::JXDNDManager
 
 	// create required X atoms
 
-	itsDNDSelectionName = itsDisplay->RegisterXAtom(kDNDSelectionXAtomName);
-
-	itsDNDProxyXAtom    = itsDisplay->RegisterXAtom(kDNDProxyXAtomName);
-	itsDNDAwareXAtom    = itsDisplay->RegisterXAtom(kDNDAwareXAtomName);
-	itsDNDTypeListXAtom = itsDisplay->RegisterXAtom(kDNDTypeListXAtomName);
-
-	itsDNDEnterXAtom    = itsDisplay->RegisterXAtom(kDNDEnterXAtomName);
-	itsDNDHereXAtom     = itsDisplay->RegisterXAtom(kDNDHereXAtomName);
-	itsDNDStatusXAtom   = itsDisplay->RegisterXAtom(kDNDStatusXAtomName);
-	itsDNDLeaveXAtom    = itsDisplay->RegisterXAtom(kDNDLeaveXAtomName);
-	itsDNDDropXAtom     = itsDisplay->RegisterXAtom(kDNDDropXAtomName);
-	itsDNDFinishedXAtom = itsDisplay->RegisterXAtom(kDNDFinishedXAtomName);
-
-	itsDNDActionCopyXAtom       = itsDisplay->RegisterXAtom(kDNDActionCopyXAtomName);
-	itsDNDActionMoveXAtom       = itsDisplay->RegisterXAtom(kDNDActionMoveXAtomName);
-	itsDNDActionLinkXAtom       = itsDisplay->RegisterXAtom(kDNDActionLinkXAtomName);
-	itsDNDActionAskXAtom        = itsDisplay->RegisterXAtom(kDNDActionAskXAtomName);
-	itsDNDActionPrivateXAtom    = itsDisplay->RegisterXAtom(kDNDActionPrivateXAtomName);
-	itsDNDActionDirectSaveXAtom = itsDisplay->RegisterXAtom(kDNDActionDirectSaveXAtomName);
-
-	itsDNDActionListXAtom        = itsDisplay->RegisterXAtom(kDNDActionListXAtomName);
-	itsDNDActionDescriptionXAtom = itsDisplay->RegisterXAtom(kDNDActionDescriptionXAtomName);
-
-	itsDNDDirectSave0XAtom = itsDisplay->RegisterXAtom(kDNDDirectSave0XAtomName);
+	const JXDisplay::XAtomInfo atomInfo[] =
+		{
+		{ kDNDSelectionXAtomName,         &itsDNDSelectionName          },
+
+		{ kDNDProxyXAtomName,             &itsDNDProxyXAtom             },
+		{ kDNDAwareXAtomName,             &itsDNDAwareXAtom             },
+		{ kDNDTypeListXAtomName,          &itsDNDTypeListXAtom          },
+
+		{ kDNDEnterXAtomName,             &itsDNDEnterXAtom             },
+		{ kDNDHereXAtomName,              &itsDNDHereXAtom              },
+		{ kDNDStatusXAtomName,            &itsDNDStatusXAtom            },
+		{ kDNDLeaveXAtomName,             &itsDNDLeaveXAtom             },
+		{ kDNDDropXAtomName,              &itsDNDDropXAtom              },
+		{ kDNDFinishedXAtomName,          &itsDNDFinishedXAtom          },
+
+		{ kDNDActionCopyXAtomName,        &itsDNDActionCopyXAtom        },
+		{ kDNDActionMoveXAtomName,        &itsDNDActionMoveXAtom        },
+		{ kDNDActionLinkXAtomName,        &itsDNDActionLinkXAtom        },
+		{ kDNDActionAskXAtomName,         &itsDNDActionAskXAtom         },
+		{ kDNDActionPrivateXAtomName,     &itsDNDActionPrivateXAtom     },
+		{ kDNDActionDirectSaveXAtomName,  &itsDNDActionDirectSaveXAtom  },
+
+		{ kDNDActionListXAtomName,        &itsDNDActionListXAtom        },
+		{ kDNDActionDescriptionXAtomName, &itsDNDActionDescriptionXAtom },
+
+		{ kDNDDirectSave0XAtomName,       &itsDNDDirectSave0XAtom       }
+		};
+
+	itsDisplay->RegisterXAtoms(sizeof(atomInfo)/sizeof(JXDisplay::XAtomInfo), atomInfo);
 }
 
 /******************************************************************************
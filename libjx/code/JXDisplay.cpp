@@ -54,18 +54,23 @@
 #include <JXMenuManager.h>
 #include <JXWDManager.h>
 #include <JXCursor.h>
+#include <JTrace.h>
 #include <jXGlobals.h>
 #include <jXKeysym.h>
 #include <X11/Xutil.h>
 #include <X11/cursorfont.h>
 #include <X11/Xproto.h>		// for error request codes
 #include <JString.h>
+#include <JMinMax.h>
 #include <jMath.h>
 #include <stdlib.h>
 #include <jAssert.h>
 
 const JSize kMaxSleepTime = 50;		// 0.05 seconds (in milliseconds)
 
+const JSize kDefaultFrameRate = 60;	// frames per second
+const JSize kMaxFrameDelay    = 4;	// frames that input can postpone redrawing
+
 static const JCharacter* kWMStateXAtomName      = "WM_STATE";
 static const JCharacter* kWMProtocolsXAtomName  = "WM_PROTOCOLS";
 static const JCharacter* kDeleteWindowXAtomName = "WM_DELETE_WINDOW";
@@ -136,6 +141,14 @@ JXDisplay::JXDisplay
 	itsLastIdleTime         = 0;
 	itsLastMotionNotifyTime = 0;
 
+	itsHasLatestPointerFlag = kJFalse;
+	itsLatestPointerWindow  = None;
+
+	itsRoundTripCount          = 0;
+	itsRoundTripRate           = 0;
+	itsRoundTripRateStartCount = 0;
+	itsRoundTripRateStartTime  = 0;
+
 	itsModifierKeymap = NULL;
 	UpdateModifierMapping();
 
@@ -154,13 +167,27 @@ JXDisplay::JXDisplay
 
 	itsNeedsUpdateFlag = kJFalse;
 	itsMouseContainer  = NULL;
+
+	itsLastFrameTime     = 0;
+	itsHasDamageTimeFlag = kJFalse;
+	itsDamageTime        = 0;
+	itsDamagedArea       = 0;
+	SetTargetFrameRate(kDefaultFrameRate);
 	itsMouseGrabber    = NULL;
 	itsKeyboardGrabber = NULL;
 
-	itsWMStateXAtom      = RegisterXAtom(kWMStateXAtomName);
-	itsWMProtocolsXAtom  = RegisterXAtom(kWMProtocolsXAtomName);
-	itsDeleteWindowXAtom = RegisterXAtom(kDeleteWindowXAtomName);
-	itsSaveYourselfXAtom = RegisterXAtom(kSaveYourselfXAtomName);
+	itsAtomMap = new JStringMap<Atom>;
+	assert( itsAtomMap != NULL );
+
+	const XAtomInfo atomInfo[] =
+		{
+		{ kWMStateXAtomName,      &itsWMStateXAtom      },
+		{ kWMProtocolsXAtomName,  &itsWMProtocolsXAtom  },
+		{ kDeleteWindowXAtomName, &itsDeleteWindowXAtom },
+		{ kSaveYourselfXAtomName, &itsSaveYourselfXAtom }
+		};
+
+	RegisterXAtoms(sizeof(atomInfo)/sizeof(XAtomInfo), atomInfo);
 
 	CreateBuiltInCursor("XC_left_ptr", XC_left_ptr);
 	CreateBuiltInCursor("XC_xterm",    XC_xterm);
@@ -208,6 +235,7 @@ JXDisplay::~JXDisplay()
 	delete itsDefaultGC;
 	delete itsColormap;
 	delete itsName;
+	delete itsAtomMap;
 
 	const JSize count = itsCursorList->GetElementCount();
 	for (JIndex i=1; i<=count; i++)
@@ -518,6 +546,7 @@ JXDisplay::GetCurrentButtonKeyState
 	Window root, child;
 	int root_x, root_y, win_x, win_y;
 	unsigned int state;
+	CountRoundTrip();
 	XQueryPointer(itsXDisplay, GetRootWindow(), &root, &child, &root_x, &root_y,
 				  &win_x, &win_y, &state);
 
@@ -532,6 +561,112 @@ JXDisplay::GetCurrentButtonKeyState
 		}
 }
 
+/******************************************************************************
+ RegisterXAtom
+
+	Atoms are cached, so only the first request for each name requires
+	a round trip to the server.
+
+ ******************************************************************************/
+
+Atom
+JXDisplay::RegisterXAtom
+	(
+	const JCharacter* name
+	)
+{
+	Atom atom;
+	if (!itsAtomMap->GetElement(name, &atom))
+		{
+		CountRoundTrip();
+		atom = XInternAtom(itsXDisplay, const_cast<JCharacter*>(name), False);
+		itsAtomMap->SetElement(name, atom);
+		}
+
+	return atom;
+}
+
+/******************************************************************************
+ RegisterXAtoms
+
+	Stores the atom for each name in the location specified by the
+	corresponding XAtomInfo.  All the atoms that are not already cached
+	are obtained from the server in a single round trip, so each
+	subsystem should register all its atoms at once.
+
+ ******************************************************************************/
+
+void
+JXDisplay::RegisterXAtoms
+	(
+	const JSize			count,
+	const XAtomInfo*	list
+	)
+{
+	JCharacter** name = new JCharacter* [ count ];
+	assert( name != NULL );
+
+	JIndex* index = new JIndex [ count ];
+	assert( index != NULL );
+
+	JSize newCount = 0;
+	for (JIndex i=0; i<count; i++)
+		{
+		if (!itsAtomMap->GetElement(list[i].name, list[i].atom))
+			{
+			name[ newCount ]  = const_cast<JCharacter*>(list[i].name);
+			index[ newCount ] = i;
+			newCount++;
+			}
+		}
+
+	if (newCount > 0)
+		{
+		Atom* atom = new Atom [ newCount ];
+		assert( atom != NULL );
+
+		CountRoundTrip();
+		XInternAtoms(itsXDisplay, name, newCount, False, atom);
+
+		for (JIndex i=0; i<newCount; i++)
+			{
+			*(list[ index[i] ].atom) = atom[i];
+			itsAtomMap->SetElement(name[i], atom[i]);
+			}
+
+		delete [] atom;
+		}
+
+	delete [] name;
+	delete [] index;
+}
+
+/******************************************************************************
+ GetLatestPointerPosition
+
+	Returns kJFalse if no event has reported the pointer position yet.
+	Otherwise, pt is relative to xWindow and ptR is relative to the root
+	window.  Since we select PointerMotionMask on all our windows, this
+	is current as long as the pointer is inside one of them, so it can
+	be used instead of XQueryPointer().
+
+ ******************************************************************************/
+
+JBoolean
+JXDisplay::GetLatestPointerPosition
+	(
+	Window*	xWindow,
+	JPoint*	pt,
+	JPoint*	ptR
+	)
+	const
+{
+	*xWindow = itsLatestPointerWindow;
+	*pt      = itsLatestPointerPt;
+	*ptR     = itsLatestPointerPtR;
+	return itsHasLatestPointerFlag;
+}
+
 /******************************************************************************
  UpdateModifierMapping (private)
 
@@ -872,6 +1007,8 @@ JXDisplay::HandleEvent
 	const Time		currentTime
 	)
 {
+	J_TRACE_ZONE("JXDisplay::HandleEvent");
+
 	// update event time (mainly for JXSelectionManager::BecomeOwner)
 
 	Time time;
@@ -883,6 +1020,17 @@ JXDisplay::HandleEvent
 	if (xEvent.type == MotionNotify)
 		{
 		itsLastMotionNotifyTime = currentTime;
+
+		// Only the latest position matters, so skip any motion events for
+		// the same window that immediately follow this one.  We do not
+		// look further ahead, because that would reorder the events.
+
+		XEvent latestEvent;
+		if (CompressMotion(xEvent, &latestEvent))
+			{
+			HandleEvent(latestEvent, currentTime);
+			return;
+			}
 		}
 //	else if (xEvent.type == Expose)
 //		{
@@ -898,6 +1046,27 @@ JXDisplay::HandleEvent
 		itsLatestKeyModifiers.SetState(this, state);
 		}
 
+	// save pointer position so nobody needs to ask the server
+
+	if (xEvent.type == MotionNotify)
+		{
+		SaveLatestPointerPosition(xEvent.xmotion.window, xEvent.xmotion.x,
+								  xEvent.xmotion.y, xEvent.xmotion.x_root,
+								  xEvent.xmotion.y_root);
+		}
+	else if (xEvent.type == ButtonPress || xEvent.type == ButtonRelease)
+		{
+		SaveLatestPointerPosition(xEvent.xbutton.window, xEvent.xbutton.x,
+								  xEvent.xbutton.y, xEvent.xbutton.x_root,
+								  xEvent.xbutton.y_root);
+		}
+	else if (xEvent.type == EnterNotify || xEvent.type == LeaveNotify)
+		{
+		SaveLatestPointerPosition(xEvent.xcrossing.window, xEvent.xcrossing.x,
+								  xEvent.xcrossing.y, xEvent.xcrossing.x_root,
+								  xEvent.xcrossing.y_root);
+		}
+
 	// handle event
 
 	if (xEvent.type == MappingNotify)
@@ -923,7 +1092,12 @@ JXDisplay::HandleEvent
 		}
 	else if (xEvent.type == SelectionNotify)
 		{
-		// JXSelectionManager catches these events
+		itsSelectionManager->HandleSelectionNotify(xEvent.xselection);
+		}
+	else if ((xEvent.type == PropertyNotify || xEvent.type == DestroyNotify) &&
+			 itsSelectionManager->HandleTransferEvent(xEvent))
+		{
+		// JXSelectionManager handled it if it returns kJTrue
 		}
 
 	else if (xEvent.type == ClientMessage &&
@@ -955,10 +1129,18 @@ JXDisplay::HandleEvent
 		}
 	else if (xEvent.type == MotionNotify && itsMouseGrabber != NULL)
 		{
-		// calls XQueryPointer() for itsXWindow so we don't care which window
-		// it is reported relative to
-
-		itsMouseGrabber->HandleEvent(xEvent);
+		XEvent fixedEvent         = xEvent;
+		XMotionEvent& motionEvent = fixedEvent.xmotion;
+		if (motionEvent.window != itsMouseGrabber->GetXWindow())
+			{
+			const JPoint ptG =
+				itsMouseGrabber->RootToGlobal(motionEvent.x_root, motionEvent.y_root);
+			motionEvent.window    = itsMouseGrabber->GetXWindow();
+			motionEvent.subwindow = None;
+			motionEvent.x         = ptG.x;
+			motionEvent.y         = ptG.y;
+			}
+		itsMouseGrabber->HandleEvent(fixedEvent);
 		}
 	else if ((xEvent.type == KeyPress || xEvent.type == KeyRelease) &&
 			 itsKeyboardGrabber != NULL)
@@ -984,10 +1166,71 @@ JXDisplay::HandleEvent
 		}
 }
 
+/******************************************************************************
+ CompressMotion (private)
+
+	Returns kJTrue if one or more MotionNotify events for the same window
+	immediately follow the given one in the queue.  In this case, they are
+	removed from the queue, and the last one is returned in latestEvent.
+
+	XEventsQueued() only reads what has already arrived, so this never
+	waits for the server.
+
+ ******************************************************************************/
+
+JBoolean
+JXDisplay::CompressMotion
+	(
+	const XEvent&	xEvent,
+	XEvent*			latestEvent
+	)
+{
+	JBoolean found = kJFalse;
+
+	XEvent nextEvent;
+	while (XEventsQueued(itsXDisplay, QueuedAfterReading) > 0)
+		{
+		XPeekEvent(itsXDisplay, &nextEvent);
+		if (nextEvent.type                 != MotionNotify ||
+			nextEvent.xmotion.window       != xEvent.xmotion.window ||
+			nextEvent.xmotion.state        != xEvent.xmotion.state ||
+			nextEvent.xmotion.same_screen  != xEvent.xmotion.same_screen)
+			{
+			break;
+			}
+
+		XNextEvent(itsXDisplay, latestEvent);
+		found = kJTrue;
+		}
+
+	return found;
+}
+
+/******************************************************************************
+ SaveLatestPointerPosition (private)
+
+ ******************************************************************************/
+
+void
+JXDisplay::SaveLatestPointerPosition
+	(
+	const Window	xWindow,
+	const int		x,
+	const int		y,
+	const int		xRoot,
+	const int		yRoot
+	)
+{
+	itsHasLatestPointerFlag = kJTrue;
+	itsLatestPointerWindow  = xWindow;
+	itsLatestPointerPt.Set(x, y);
+	itsLatestPointerPtR.Set(xRoot, yRoot);
+}
+
 /******************************************************************************
  Idle
 
-	Redraw our windows and send a fake motion event.
+	Redraw our windows, if a frame is due, and send a fake motion event.
 
 	If the mouse is not pressed, we send idle events relatively slowly so
 	that we don't hog CPU time.
@@ -1003,10 +1246,11 @@ JXDisplay::Idle
 	const Time currentTime
 	)
 {
+	UpdateIfFrameDue(currentTime, kJFalse);
+
 	if (currentTime - itsLastIdleTime > kMaxSleepTime ||
 		!itsLatestButtonStates.AllOff())
 		{
-		Update();
 		itsLastIdleTime = currentTime;
 
 		if (currentTime - itsLastMotionNotifyTime > kMaxSleepTime)
@@ -1015,6 +1259,16 @@ JXDisplay::Idle
 			itsLastMotionNotifyTime = currentTime;
 			}
 		}
+
+	if (currentTime - itsRoundTripRateStartTime >= 1000)
+		{
+		itsRoundTripRate =
+			((itsRoundTripCount - itsRoundTripRateStartCount) * 1000) /
+			(currentTime - itsRoundTripRateStartTime);
+
+		itsRoundTripRateStartCount = itsRoundTripCount;
+		itsRoundTripRateStartTime  = currentTime;
+		}
 }
 
 /******************************************************************************
@@ -1024,6 +1278,9 @@ JXDisplay::Idle
 	an idle task, we use a single flag to make sure that it doesn't do
 	more work than it has to.
 
+	This ignores the frame rate, so JXApplication calls UpdateIfFrameDue()
+	instead.
+
  ******************************************************************************/
 
 void
@@ -1031,7 +1288,12 @@ JXDisplay::Update()
 {
 	if (itsNeedsUpdateFlag)
 		{
-		itsNeedsUpdateFlag = kJFalse;	// clear first, in case redraw triggers update
+		J_TRACE_ZONE("JXDisplay::Update");
+
+		itsNeedsUpdateFlag   = kJFalse;	// clear first, in case redraw triggers update
+		itsHasDamageTimeFlag = kJFalse;
+
+		const JTraceTime startTime = JTrace::GetTime();
 
 		const JSize count = itsWindowList->GetElementCount();
 		for (JIndex i=1; i<=count; i++)
@@ -1039,9 +1301,114 @@ JXDisplay::Update()
 			const WindowInfo info = itsWindowList->GetElement(i);
 			(info.window)->Update();
 			}
+
+		const JSize drawTime = (JTrace::GetTime() - startTime) / 1000;
+
+		itsFrameStats.frameCount++;
+		itsFrameStats.lastDrawTime     = drawTime;
+		itsFrameStats.maxDrawTime      = JMax(itsFrameStats.maxDrawTime, drawTime);
+		itsFrameStats.totalDrawTime   += drawTime;
+		itsFrameStats.lastDamagedArea  = itsDamagedArea;
+		itsFrameStats.totalDamagedArea += itsDamagedArea;
+
+		itsDamagedArea = 0;
 		}
 }
 
+/******************************************************************************
+ UpdateIfFrameDue
+
+	Redraws our windows if the next frame is due.  If input is pending,
+	we let it be processed first, unless we have already postponed the
+	frame for too long.
+
+	The first time we notice that a window needs to be redrawn is taken
+	as the time the damage occurred.  Since we are called every time
+	through the event loop, this is accurate enough.
+
+ ******************************************************************************/
+
+void
+JXDisplay::UpdateIfFrameDue
+	(
+	const Time		currentTime,
+	const JBoolean	inputPending
+	)
+{
+	if (!itsNeedsUpdateFlag)
+		{
+		return;
+		}
+	else if (!itsHasDamageTimeFlag)
+		{
+		itsHasDamageTimeFlag = kJTrue;
+		itsDamageTime        = currentTime;
+		}
+
+	const Time elapsed = currentTime - itsLastFrameTime;
+	if (elapsed < (inputPending ? kMaxFrameDelay : 1) * itsFrameInterval)
+		{
+		return;
+		}
+
+	// count the frames that should have been drawn since the damage
+	// occurred -- both times are no later than currentTime
+
+	if (itsFrameInterval > 0)
+		{
+		const Time dueTime = JMax(itsDamageTime, itsLastFrameTime + itsFrameInterval);
+		itsFrameStats.droppedFrameCount += (currentTime - dueTime) / itsFrameInterval;
+		}
+
+	itsLastFrameTime = currentTime;
+	Update();
+}
+
+/******************************************************************************
+ GetTimeUntilFrame
+
+	Returns kJFalse if no window needs to be redrawn.  Otherwise, *delay
+	is the number of milliseconds until the next frame is due.
+	JXApplication uses this to avoid sleeping through a frame.
+
+ ******************************************************************************/
+
+JBoolean
+JXDisplay::GetTimeUntilFrame
+	(
+	const Time	currentTime,
+	Time*		delay
+	)
+	const
+{
+	if (!itsNeedsUpdateFlag)
+		{
+		*delay = 0;
+		return kJFalse;
+		}
+
+	const Time elapsed = currentTime - itsLastFrameTime;
+	*delay = (elapsed < itsFrameInterval ? itsFrameInterval - elapsed : 0);
+	return kJTrue;
+}
+
+/******************************************************************************
+ SetTargetFrameRate
+
+	0 means that windows are redrawn every time through the event loop.
+
+ ******************************************************************************/
+
+void
+JXDisplay::SetTargetFrameRate
+	(
+	const JSize framesPerSecond
+	)
+{
+	itsTargetFrameRate = framesPerSecond;
+	itsFrameInterval   = (framesPerSecond > 0 ? 1000 / framesPerSecond : 0);
+}
+
 /******************************************************************************
  DispatchMouse
 
@@ -1095,6 +1462,7 @@ JXDisplay::FindMouseContainer
 	Window rootWindow, childWindow;
 	int root_x, root_y, x,y;
 	unsigned int state;
+	CountRoundTrip();
 	if (XQueryPointer(itsXDisplay, GetRootWindow(), &rootWindow, &childWindow,
 					  &root_x, &root_y, &x, &y, &state) &&
 		childWindow != None)
@@ -1141,6 +1509,7 @@ JXDisplay::FindMouseContainer
 	const Window rootWindow = GetRootWindow();
 	Window childWindow;
 	int x,y;
+	CountRoundTrip();
 	if (XTranslateCoordinates(itsXDisplay, startWindow, rootWindow,
 							  ptG.x, ptG.y, &x, &y, &childWindow) &&
 		childWindow != None)
@@ -1189,10 +1558,12 @@ JXDisplay::FindMouseContainer
 	Window window2 = origChildWindow;
 	Window childWindow;
 	int x1 = xRoot, y1 = yRoot, x2,y2;
+	CountRoundTrip();
 	while (XTranslateCoordinates(itsXDisplay, window1, window2,
 								 x1, y1, &x2, &y2, &childWindow) &&
 		   childWindow != None)
 		{
+		CountRoundTrip();
 		window1 = window2;
 		window2 = childWindow;
 		x1      = x2;
@@ -18,6 +18,7 @@
 #include <JRect.h>
 #include <JXCursor.h>
 #include <JArray.h>
+#include <JStringMap.h>
 #include <jXEventUtil.h>
 #include <JXKeyModifiers.h>	// need defn of kJXKeyModifierMapCount
 
@@ -86,6 +87,42 @@ public:
 
 	const JXButtonStates&	GetLatestButtonStates() const;
 	const JXKeyModifiers&	GetLatestKeyModifiers() const;
+	JBoolean				GetLatestPointerPosition(Window* xWindow, JPoint* pt,
+													 JPoint* ptR) const;
+
+	// Synchronous requests stall until the X server replies, which is
+	// expensive on remote displays.  Code that makes them should call
+	// CountRoundTrip() so the rate can be monitored.
+
+	void	CountRoundTrip() const;
+	JSize	GetRoundTripCount() const;
+	JSize	GetRoundTripRate() const;
+
+	// Windows are redrawn at most once per frame.  While input is waiting,
+	// redrawing is postponed, but never by more than a few frames.
+
+	struct FrameStats
+	{
+		JSize	frameCount;
+		JSize	droppedFrameCount;	// frames missed because we were late
+		JSize	lastDrawTime;		// microseconds
+		JSize	maxDrawTime;		// microseconds
+		JFloat	totalDrawTime;		// microseconds
+		JSize	lastDamagedArea;	// pixels
+		JFloat	totalDamagedArea;	// pixels
+
+		FrameStats()
+			:
+			frameCount(0), droppedFrameCount(0),
+			lastDrawTime(0), maxDrawTime(0), totalDrawTime(0.0),
+			lastDamagedArea(0), totalDamagedArea(0.0)
+		{ };
+	};
+
+	JSize				GetTargetFrameRate() const;
+	void				SetTargetFrameRate(const JSize framesPerSecond);
+	const FrameStats&	GetFrameStats() const;
+	void				ResetFrameStats();
 
 	JBoolean	KeysymToModifier(const KeySym keysym, JIndex* modifierIndex) const;
 	JBoolean	KeycodeToModifier(const KeyCode keycode, JIndex* modifierIndex) const;
@@ -108,9 +145,11 @@ public:
 
 	// called by JXApplication
 
-	void	HandleEvent(const XEvent& xEvent, const Time currentTime);
-	void	Idle(const Time currentTime);
-	void	Update();
+	void		HandleEvent(const XEvent& xEvent, const Time currentTime);
+	void		Idle(const Time currentTime);
+	void		Update();
+	void		UpdateIfFrameDue(const Time currentTime, const JBoolean inputPending);
+	JBoolean	GetTimeUntilFrame(const Time currentTime, Time* delay) const;
 	void	DispatchMouse();
 	void	DispatchCursor();
 
@@ -119,6 +158,7 @@ public:
 	void	WindowCreated(JXWindow* window, const Window xWindow);
 	void	WindowDeleted(JXWindow* window);
 	void	WindowNeedsUpdate(JXWindow* window);
+	void	CountDamage(const JRect& rectG);
 
 	JBoolean	GetMouseContainer(JXWindow** window) const;
 	void		SetMouseContainer(JXWindow* window);
@@ -168,7 +208,14 @@ public:
 
 	Time	GetLastEventTime() const;
 
+	struct XAtomInfo
+	{
+		const JCharacter*	name;
+		Atom*				atom;
+	};
+
 	Atom	RegisterXAtom(const JCharacter* name);
+	void	RegisterXAtoms(const JSize count, const XAtomInfo* list);
 
 	JBoolean	FindXWindow(const Window xWindow, JXWindow** window) const;
 
@@ -233,6 +280,15 @@ private:
 
 	JXButtonStates		itsLatestButtonStates;
 	JXKeyModifiers		itsLatestKeyModifiers;
+	JBoolean			itsHasLatestPointerFlag;
+	Window				itsLatestPointerWindow;
+	JPoint				itsLatestPointerPt;		// relative to itsLatestPointerWindow
+	JPoint				itsLatestPointerPtR;	// relative to root window
+
+	JSize	itsRoundTripCount;
+	JSize	itsRoundTripRate;				// per second
+	JSize	itsRoundTripRateStartCount;
+	Time	itsRoundTripRateStartTime;
 	XModifierKeymap*	itsModifierKeymap;
 	int					itsJXKeyModifierMapping [ 1+kJXKeyModifierMapCount ];
 
@@ -241,6 +297,14 @@ private:
 
 	JArray<WindowInfo>*	itsWindowList;
 	JBoolean			itsNeedsUpdateFlag;
+
+	JSize		itsTargetFrameRate;			// 0 => no limit
+	Time		itsFrameInterval;			// milliseconds
+	Time		itsLastFrameTime;
+	JBoolean	itsHasDamageTimeFlag;
+	Time		itsDamageTime;				// when we first noticed itsNeedsUpdateFlag
+	JSize		itsDamagedArea;				// since the last frame
+	FrameStats	itsFrameStats;
 	JXWindow*			itsMouseContainer;		// can be NULL
 	JXWindow*			itsMouseGrabber;		// usually NULL
 	JXWindow*			itsKeyboardGrabber;		// usually NULL
@@ -258,6 +322,8 @@ private:
 	Atom	itsSaveYourselfXAtom;
 	Atom	itsWMStateXAtom;
 
+	JStringMap<Atom>*	itsAtomMap;		// name -> atom, so lookups are local
+
 private:
 
 	JBoolean	FindMouseContainer(const Window rootWindow,
@@ -269,6 +335,11 @@ private:
 	Cursor	CreateCustomXCursor(const JXCursor& cursor) const;
 	void	UpdateModifierMapping();
 
+	JBoolean	CompressMotion(const XEvent& xEvent, XEvent* latestEvent);
+	void		SaveLatestPointerPosition(const Window xWindow,
+										  const int x, const int y,
+										  const int xRoot, const int yRoot);
+
 	// not allowed
 
 	JXDisplay(const JXDisplay& source);
@@ -438,6 +509,7 @@ inline void
 JXDisplay::Synchronize()
 	const
 {
+	CountRoundTrip();
 	XSync(itsXDisplay, False);
 }
 
@@ -568,44 +640,96 @@ JXDisplay::GetLatestKeyModifiers()
 }
 
 /******************************************************************************
- GetJXKeyModifierMapping
+ Round trips
+
+	GetRoundTripRate() returns the number of round trips during the most
+	recent interval of about one second.
 
  ******************************************************************************/
 
-inline const int*
-JXDisplay::GetJXKeyModifierMapping()
+inline void
+JXDisplay::CountRoundTrip()
 	const
 {
-	return itsJXKeyModifierMapping;
+	(const_cast<JXDisplay*>(this))->itsRoundTripCount++;
+}
+
+inline JSize
+JXDisplay::GetRoundTripCount()
+	const
+{
+	return itsRoundTripCount;
+}
+
+inline JSize
+JXDisplay::GetRoundTripRate()
+	const
+{
+	return itsRoundTripRate;
 }
 
 /******************************************************************************
- GetXCursorID
+ Frame statistics
+
+	The damaged area includes windows that were redrawn immediately via
+	Redraw() since the last frame.
 
  ******************************************************************************/
 
-inline Cursor
-JXDisplay::GetXCursorID
+inline JSize
+JXDisplay::GetTargetFrameRate()
+	const
+{
+	return itsTargetFrameRate;
+}
+
+inline const JXDisplay::FrameStats&
+JXDisplay::GetFrameStats()
+	const
+{
+	return itsFrameStats;
+}
+
+inline void
+JXDisplay::ResetFrameStats()
+{
+	itsFrameStats = FrameStats();
+}
+
+inline void
+JXDisplay::CountDamage
 	(
-	const JCursorIndex index
+	const JRect& rectG
 	)
+{
+	itsDamagedArea += rectG.area();
+}
+
+/******************************************************************************
+ GetJXKeyModifierMapping
+
+ ******************************************************************************/
+
+inline const int*
+JXDisplay::GetJXKeyModifierMapping()
 	const
 {
-	return (itsCursorList->GetElement(index)).xid;
+	return itsJXKeyModifierMapping;
 }
 
 /******************************************************************************
- RegisterXAtom
+ GetXCursorID
 
  ******************************************************************************/
 
-inline Atom
-JXDisplay::RegisterXAtom
+inline Cursor
+JXDisplay::GetXCursorID
 	(
-	const JCharacter* name
+	const JCursorIndex index
 	)
+	const
 {
-	return XInternAtom(itsXDisplay, name, False);
+	return (itsCursorList->GetElement(index)).xid;
 }
 
 /******************************************************************************
@@ -63,8 +63,13 @@ JXDockManager::JXDockManager
 	itsWindowTypeMap = new JStringMap<JIndex>;
 	assert( itsWindowTypeMap != NULL );
 
-	itsDNDMinSizeAtom = display->RegisterXAtom(kDNDMinSizeAtomName);
-	itsDNDWindowAtom  = display->RegisterXAtom(kDNDWindowAtomName);
+	const JXDisplay::XAtomInfo atomInfo[] =
+		{
+		{ kDNDMinSizeAtomName, &itsDNDMinSizeAtom },
+		{ kDNDWindowAtomName,  &itsDNDWindowAtom  }
+		};
+
+	display->RegisterXAtoms(sizeof(atomInfo)/sizeof(JXDisplay::XAtomInfo), atomInfo);
 
 	JXSetDockManager(this);
 }
@@ -5,6 +5,13 @@
 	returned by GetFullNameDataList() and keep an array of extra data in
 	sync with our information.
 
+	Changing the filter checks the files on several threads and sorts the
+	visible list once.  If the new pattern only adds literal characters
+	to the old one, only the files that are already visible are checked.
+	For very large lists, ShouldUseFilterIndex() builds a trigram index
+	of the file names, so only files containing the literal parts of the
+	pattern are checked.
+
 	BASE CLASS = JXTable
 
 	Copyright  1998-99 by John Lindal.  All rights reserved.
@@ -35,8 +42,21 @@
 #include <jFileUtil.h>
 #include <jMouseUtil.h>
 #include <jASCIIConstants.h>
+#include <ace/OS_NS_unistd.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
 #include <jAssert.h>
 
+// JMemoryManager is not thread-safe.
+
+#if defined ACE_HAS_THREADS && ACE_MT_SAFE && ! defined _J_ARRAY_NEW_OVERRIDABLE
+#define JX_FILE_LIST_THREADS
+#include <ace/Thread.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Guard_T.h>
+#endif
+
 #include <jx_plain_file_small.xpm>
 
 const JCoordinate kIconWidth    = 20;
@@ -46,12 +66,84 @@ const JCoordinate kVMarginWidth = 1;
 
 const JCharacter kInactiveChar = ' ';	// file names starting with this are gray
 
+const JSize kMaxThreadCount    = 8;
+const JSize kMinFilesPerThread = 10000;
+const JSize kFilterChunkSize   = 1024;		// files claimed by a thread at one time
+
 static const JCharacter* kSelectionDataID = "JXFileListTable";
 
 // JBroadcaster messages
 
 const JCharacter* JXFileListTable::kProcessSelection = "ProcessSelection::JXFileListTable";
 
+/******************************************************************************
+ JXFileListTable::FilterPass
+
+	Shared by all the threads that filter the file list.  Each file's
+	entry in nameIndexList is set to the index of its name, or zero if it
+	does not match.
+
+ ******************************************************************************/
+
+struct JXFileListTable::FilterPass
+{
+	const JPtrArray<JString>*	fileList;
+	const JRegex*				regex;				// can be NULL
+	const JIndex*				candidateList;		// NULL => all files
+	JSize						count;
+	JIndex*						nameIndexList;		// count elements
+
+	JIndex	nextIndex;		// protected by lock
+
+#ifdef JX_FILE_LIST_THREADS
+	ACE_Thread_Mutex	lock;
+
+	static ACE_THR_FUNC_RETURN	Main(void* data);
+#endif
+
+	void	Perform();
+	void	FilterFiles();
+};
+
+/******************************************************************************
+ JXFileListTable::FilterIndex
+
+	Maps each trigram of the lowercased file names to the files that
+	contain it.  The lists are stored end to end in one array, since
+	separate arrays would take far more memory for large projects.
+
+ ******************************************************************************/
+
+class JXFileListTable::FilterIndex
+{
+public:
+
+	FilterIndex(const JPtrArray<JString>& fileList);
+
+	~FilterIndex();
+
+	JBoolean	GetCandidates(const JCharacter* pattern, JArray<JIndex>* list) const;
+
+private:
+
+	JSize		itsKeyCount;
+	JUInt32*	itsKeyList;			// sorted
+	JIndex*		itsOffsetList;		// itsKeyCount+1 offsets into itsFileList
+	JUInt32*	itsFileList;		// file indexes, ascending for each key
+
+private:
+
+	JBoolean	GetFiles(const JUInt32 key, const JUInt32** list, JSize* count) const;
+
+	// not allowed
+
+	FilterIndex(const FilterIndex& source);
+	const FilterIndex& operator=(const FilterIndex& source);
+};
+
+static JBoolean	JXFileListTableGetTrigrams(const JCharacter* pattern,
+										   JArray<JIndex>* keyList);
+
 /******************************************************************************
  Constructor
 
@@ -72,6 +164,8 @@ JXFileListTable::JXFileListTable
 	JXTable(10, 10, scrollbarSet, enclosure, hSizing,vSizing, x,y, w,h)
 {
 	itsRegex              = NULL;
+	itsUseFilterIndexFlag = kJFalse;
+	itsFilterIndex        = NULL;
 	itsAcceptFileDropFlag = kJFalse;
 	itsBSRemoveSelFlag    = kJFalse;
 	itsDragType           = kInvalidDrag;
@@ -118,6 +212,7 @@ JXFileListTable::~JXFileListTable()
 	delete itsVisibleList;
 
 	delete itsRegex;
+	delete itsFilterIndex;
 	delete itsFileIcon;
 }
 
@@ -195,6 +290,115 @@ JXFileListTable::AddFile
 		}
 }
 
+/******************************************************************************
+ AddFiles
+
+	Adds all the files in the list that exist or are relative paths.  This
+	is much faster than calling AddFile() for each one, because the table
+	is only rebuilt once.
+
+ ******************************************************************************/
+
+static int	JXFileListTableCompareNames(const void* p1, const void* p2);
+
+void
+JXFileListTable::AddFiles
+	(
+	const JPtrArray<JString>& fileList
+	)
+{
+	const JSize count = fileList.GetElementCount();
+
+	JString** newList = new JString* [ count+1 ];
+	assert( newList != NULL );
+
+	JSize newCount = 0;
+	for (JIndex i=1; i<=count; i++)
+		{
+		const JString* fullName = fileList.NthElement(i);
+		if (!fullName->IsEmpty() &&
+			(JIsRelativePath(*fullName) || JFileExists(*fullName)))
+			{
+			newList[ newCount ] = new JString(*fullName);
+			assert( newList[ newCount ] != NULL );
+			newCount++;
+			}
+		}
+
+	if (newCount == 0)
+		{
+		delete [] newList;
+		return;
+		}
+
+	ClearSelection();
+
+	// The table will be rebuilt, so it is pointless to keep it up to date.
+
+	itsVisibleList->RemoveAll();
+	RemoveAllRows();
+
+	// Inserting in order means that files beyond the end of the list
+	// (e.g. when loading a project) are simply appended.
+
+	qsort(newList, newCount, sizeof(JString*), JXFileListTableCompareNames);
+
+	const JSize origBlockSize = itsFileList->GetBlockSize();
+	itsFileList->SetBlockSize(JMax(origBlockSize, newCount));
+
+	for (JIndex i=0; i<newCount; i++)
+		{
+		JString* s = newList[i];
+
+		const JSize fileCount = itsFileList->GetElementCount();
+		if (fileCount == 0 ||
+			JCompareStringsCaseSensitive(s, itsFileList->NthElement(fileCount)) ==
+				JOrderedSetT::kFirstGreaterSecond)
+			{
+			itsFileList->Append(s);
+			continue;
+			}
+
+		JBoolean found;
+		const JIndex index = itsFileList->SearchSorted1(s, JOrderedSetT::kAnyMatch, &found);
+		if (found)
+			{
+			delete s;
+			}
+		else
+			{
+			itsFileList->InsertAtIndex(index, s);
+			}
+		}
+
+	itsFileList->SetBlockSize(origBlockSize);
+	delete [] newList;
+
+	RebuildTable();
+}
+
+/******************************************************************************
+ JXFileListTableCompareNames (local)
+
+	qsort() version of JCompareStringsCaseSensitive().
+
+ ******************************************************************************/
+
+static int
+JXFileListTableCompareNames
+	(
+	const void* p1,
+	const void* p2
+	)
+{
+	JString* s1 = *(JString* const*) p1;
+	JString* s2 = *(JString* const*) p2;
+
+	const JOrderedSetT::CompareResult r = JCompareStringsCaseSensitive(s1, s2);
+	return (r == JOrderedSetT::kFirstLessSecond    ? -1 :
+			r == JOrderedSetT::kFirstGreaterSecond ? +1 : 0);
+}
+
 /******************************************************************************
  RemoveFile
 
@@ -343,7 +547,7 @@ JXFileListTable::SetFilterRegex
 			const JError err = itsRegex->SetPattern(regexStr);
 			if (err.OK())
 				{
-				RebuildTable();
+				RebuildTable(kJFalse, IsRefinement(origRegexStr, regexStr));
 				}
 			else
 				{
@@ -372,28 +576,208 @@ JXFileListTable::ClearFilterRegex()
 		}
 }
 
+/******************************************************************************
+ IsRefinement (static private)
+
+	Returns kJTrue if every file matching newPattern must also match
+	origPattern.  This is true when only literal characters were added,
+	unless they could extend an escape sequence like \x4 or \1.
+
+ ******************************************************************************/
+
+JBoolean
+JXFileListTable::IsRefinement
+	(
+	const JString&		origPattern,
+	const JCharacter*	newPattern
+	)
+{
+	const JSize origLength = origPattern.GetLength();
+	if (strncmp(newPattern, origPattern, origLength) != 0 ||
+		strpbrk(newPattern + origLength, "\\^$.|?*+()[]{}") != NULL)
+		{
+		return kJFalse;
+		}
+
+	JIndex i = origLength;
+	while (i > 0 && origLength - i < 3 &&
+		   isalnum((unsigned char) origPattern.GetCharacter(i)))
+		{
+		i--;
+		}
+
+	JSize slashCount = 0;
+	while (i > 0 && origPattern.GetCharacter(i) == '\\')
+		{
+		slashCount++;
+		i--;
+		}
+
+	return JI2B( slashCount % 2 == 0 );
+}
+
+/******************************************************************************
+ ShouldUseFilterIndex
+
+ ******************************************************************************/
+
+void
+JXFileListTable::ShouldUseFilterIndex
+	(
+	const JBoolean use
+	)
+{
+	itsUseFilterIndexFlag = use;
+	if (!use)
+		{
+		delete itsFilterIndex;
+		itsFilterIndex = NULL;
+		}
+}
+
 /******************************************************************************
  RebuildTable (private)
 
+	If refine is kJTrue, only the visible files are checked.
+
  ******************************************************************************/
 
+struct JXFileListTableSortInfo
+{
+	const JCharacter*	name;
+	JIndex				fileIndex;
+	JIndex				nameIndex;
+};
+
+static int	JXFileListTableCompareSortInfo(const void* p1, const void* p2);
+
 void
 JXFileListTable::RebuildTable
 	(
-	const JBoolean maintainScroll
+	const JBoolean maintainScroll,
+	const JBoolean refine
 	)
 {
 	const JPoint scrollPt = (GetAperture()).topLeft();
 
+	// decide which files need to be checked
+
+	JArray<JIndex> candidateList(1000);
+	JBoolean useCandidates = kJFalse;
+	if (refine)
+		{
+		const JSize visCount = itsVisibleList->GetElementCount();
+		candidateList.SetBlockSize(JMax(visCount, (JSize) 1));
+		for (JIndex i=1; i<=visCount; i++)
+			{
+			candidateList.AppendElement(RowIndexToFileIndex(i));
+			}
+		useCandidates = kJTrue;
+		}
+	else if (itsRegex != NULL && itsUseFilterIndexFlag)
+		{
+		if (itsFilterIndex == NULL)
+			{
+			itsFilterIndex = new FilterIndex(*itsFileList);
+			assert( itsFilterIndex != NULL );
+			}
+		useCandidates = itsFilterIndex->GetCandidates(itsRegex->GetPattern(),
+													  &candidateList);
+		}
+
 	itsVisibleList->RemoveAll();
 	RemoveAllRows();
 	ClearIncrementalSearchBuffer();
 	itsMaxStringWidth = 0;
 
-	const JSize count = itsFileList->GetElementCount();
-	for (JIndex i=1; i<=count; i++)
+	// check the files
+
+	FilterPass pass;
+	pass.fileList      = itsFileList;
+	pass.regex         = itsRegex;
+	pass.candidateList = (useCandidates ? candidateList.GetCArray() : NULL);
+	pass.count         = (useCandidates ? candidateList.GetElementCount() :
+										  itsFileList->GetElementCount());
+
+	pass.nameIndexList = new JIndex [ pass.count+1 ];
+	assert( pass.nameIndexList != NULL );
+
+	pass.Perform();
+
+	// sort the matches once, instead of inserting them one at a time
+
+	JXFileListTableSortInfo* sortList = new JXFileListTableSortInfo [ pass.count+1 ];
+	assert( sortList != NULL );
+
+	JSize visCount = 0;
+	for (JIndex i=0; i<pass.count; i++)
+		{
+		if (pass.nameIndexList[i] > 0)
+			{
+			JXFileListTableSortInfo* info = sortList + visCount;
+			info->fileIndex = (useCandidates ? pass.candidateList[i] : i+1);
+			info->nameIndex = pass.nameIndexList[i];
+			info->name      = (itsFileList->NthElement(info->fileIndex))->GetCString() +
+							  info->nameIndex-1;
+			visCount++;
+			}
+		}
+
+	delete [] pass.nameIndexList;
+
+	qsort(sortList, visCount, sizeof(JXFileListTableSortInfo),
+		  JXFileListTableCompareSortInfo);
+
+	const JSize origBlockSize = itsVisibleList->GetBlockSize();
+	itsVisibleList->SetBlockSize(JMax(origBlockSize, visCount));
+
+	for (JIndex i=0; i<visCount; i++)
+		{
+		VisInfo info;
+		info.fileIndex = sortList[i].fileIndex;
+		info.nameIndex = sortList[i].nameIndex;
+		info.drawIndex = info.nameIndex;
+		itsVisibleList->AppendElement(info);
+		}
+
+	itsVisibleList->SetBlockSize(origBlockSize);
+
+	if (visCount > 0)
+		{
+		InsertRows(1, visCount);
+		}
+
+	// files with the same name show as much of the path as needed to
+	// tell them apart
+
+	JIndex rowIndex = 1;
+	while (rowIndex < visCount)
+		{
+		if (JStringCompare(sortList[rowIndex-1].name, sortList[rowIndex].name, kJFalse) == 0)
+			{
+			rowIndex = UpdateDrawIndex(rowIndex, sortList[rowIndex-1].name) + 1;
+			}
+		else
+			{
+			rowIndex++;
+			}
+		}
+
+	delete [] sortList;
+
+	// check width of all rows
+
+	for (JIndex i=1; i<=visCount; i++)
 		{
-		FilterFile(i);
+		const VisInfo info = itsVisibleList->GetElement(i);
+		const JCharacter* drawStr =
+			(itsFileList->NthElement(info.fileIndex))->GetCString() + info.drawIndex-1;
+		const JSize w = (GetFontManager())->GetStringWidth(
+			JGetDefaultFontName(), kJXDefaultFontSize, JFontStyle(), drawStr);
+		if (w > itsMaxStringWidth)
+			{
+			itsMaxStringWidth = w;
+			}
 		}
 
 	AdjustColWidths();
@@ -404,6 +788,551 @@ JXFileListTable::RebuildTable
 		}
 }
 
+/******************************************************************************
+ JXFileListTableCompareSortInfo (local)
+
+	Files with the same name are ordered the same way as by FilterFile().
+
+ ******************************************************************************/
+
+static int
+JXFileListTableCompareSortInfo
+	(
+	const void* p1,
+	const void* p2
+	)
+{
+	const JXFileListTableSortInfo* i1 = (const JXFileListTableSortInfo*) p1;
+	const JXFileListTableSortInfo* i2 = (const JXFileListTableSortInfo*) p2;
+
+	const int r = JStringCompare(i1->name, i2->name, kJFalse);
+	if (r != 0)
+		{
+		return r;
+		}
+	else if (i1->fileIndex > i2->fileIndex)
+		{
+		return -1;
+		}
+	else if (i1->fileIndex < i2->fileIndex)
+		{
+		return +1;
+		}
+	else
+		{
+		return 0;
+		}
+}
+
+/******************************************************************************
+ FilterPass::Perform
+
+	The main thread also checks files, because it has to wait anyway.
+
+ ******************************************************************************/
+
+void
+JXFileListTable::FilterPass::Perform()
+{
+	nextIndex = 0;
+
+	// compile the pattern now, so the threads only read it
+
+	if (regex != NULL)
+		{
+		regex->Match("");
+		}
+
+#ifdef JX_FILE_LIST_THREADS
+
+	const long cpuCount     = ACE_OS::num_processors_online();
+	const JSize threadCount = JMin(JMin(kMaxThreadCount, (JSize) JMax(1L, cpuCount)),
+								   count / kMinFilesPerThread + 1) - 1;
+
+	ACE_thread_t* threadList = NULL;
+	JSize startCount         = 0;
+	if (threadCount > 0)
+		{
+		threadList = new ACE_thread_t [ threadCount ];
+		assert( threadList != NULL );
+
+		while (startCount < threadCount &&
+			   ACE_Thread::spawn(Main, this, THR_NEW_LWP | THR_JOINABLE,
+								 threadList + startCount) == 0)
+			{
+			startCount++;
+			}
+		}
+
+	FilterFiles();
+
+	for (JIndex i=0; i<startCount; i++)
+		{
+		ACE_thread_t departed;
+		ACE_THR_FUNC_RETURN status;
+		ACE_Thread::join(threadList[i], &departed, &status);
+		}
+
+	delete [] threadList;
+
+#else
+
+	FilterFiles();
+
+#endif
+}
+
+#ifdef JX_FILE_LIST_THREADS
+
+ACE_THR_FUNC_RETURN
+JXFileListTable::FilterPass::Main
+	(
+	void* data
+	)
+{
+	static_cast<FilterPass*>(data)->FilterFiles();
+	return 0;
+}
+
+#endif
+
+/******************************************************************************
+ FilterPass::FilterFiles
+
+	Checks chunks of files until there are none left.  This is called from
+	several threads at once, so it must not modify anything shared except
+	its own part of nameIndexList.
+
+ ******************************************************************************/
+
+void
+JXFileListTable::FilterPass::FilterFiles()
+{
+	while (1)
+		{
+		JIndex first;
+		{
+#ifdef JX_FILE_LIST_THREADS
+		ACE_Guard<ACE_Thread_Mutex> guard(lock);
+#endif
+		first      = nextIndex;
+		nextIndex += kFilterChunkSize;
+		}
+
+		if (first >= count)
+			{
+			break;
+			}
+
+		const JIndex last = JMin(first + kFilterChunkSize, count);
+		for (JIndex i=first; i<last; i++)
+			{
+			const JIndex fileIndex     = (candidateList != NULL ? candidateList[i] : i+1);
+			const JCharacter* fullName = (fileList->NthElement(fileIndex))->GetCString();
+
+			const JCharacter* name = strrchr(fullName, ACE_DIRECTORY_SEPARATOR_CHAR);
+			name = (name != NULL ? name+1 : fullName);
+
+			nameIndexList[i] =
+				(regex == NULL || regex->Match(name) ? name - fullName + 1 : 0);
+			}
+		}
+}
+
+/******************************************************************************
+ FilterIndex
+
+	Trigrams are collected in file order and then sorted by a stable radix
+	sort, so the files for each trigram come out in order, too.
+
+ ******************************************************************************/
+
+struct JXFileListTableTrigram
+{
+	JUInt32	key;
+	JUInt32	fileIndex;
+};
+
+inline JUInt32
+JXFileListTableGetTrigram
+	(
+	const JCharacter* s
+	)
+{
+	return ((JUInt32) tolower((unsigned char) s[0]) << 16) |
+		   ((JUInt32) tolower((unsigned char) s[1]) <<  8) |
+		   ((JUInt32) tolower((unsigned char) s[2]));
+}
+
+JXFileListTable::FilterIndex::FilterIndex
+	(
+	const JPtrArray<JString>& fileList
+	)
+{
+	const JSize fileCount = fileList.GetElementCount();
+
+	JSize total = 0;
+	for (JIndex i=1; i<=fileCount; i++)
+		{
+		const JString* fullName = fileList.NthElement(i);
+		const JCharacter* name  = strrchr(*fullName, ACE_DIRECTORY_SEPARATOR_CHAR);
+		const JSize length      = (name != NULL ? strlen(name+1) : fullName->GetLength());
+		if (length >= 3)
+			{
+			total += length - 2;
+			}
+		}
+
+	JXFileListTableTrigram* list1 = new JXFileListTableTrigram [ total+1 ];
+	JXFileListTableTrigram* list2 = new JXFileListTableTrigram [ total+1 ];
+	assert( list1 != NULL && list2 != NULL );
+
+	JSize n = 0;
+	for (JIndex i=1; i<=fileCount; i++)
+		{
+		const JCharacter* fullName = (fileList.NthElement(i))->GetCString();
+		const JCharacter* name     = strrchr(fullName, ACE_DIRECTORY_SEPARATOR_CHAR);
+		name = (name != NULL ? name+1 : fullName);
+
+		for (const JCharacter* s = name; s[0] != '\0' && s[1] != '\0' && s[2] != '\0'; s++)
+			{
+			list1[n].key       = JXFileListTableGetTrigram(s);
+			list1[n].fileIndex = i;
+			n++;
+			}
+		}
+	assert( n == total );
+
+	for (JIndex shift=0; shift<24; shift+=8)
+		{
+		JIndex start[257];
+		memset(start, 0, sizeof(start));
+		for (JIndex i=0; i<total; i++)
+			{
+			start[ ((list1[i].key >> shift) & 0xFF) + 1 ]++;
+			}
+		for (JIndex i=1; i<=256; i++)
+			{
+			start[i] += start[i-1];
+			}
+		for (JIndex i=0; i<total; i++)
+			{
+			list2[ start[ (list1[i].key >> shift) & 0xFF ]++ ] = list1[i];
+			}
+
+		JXFileListTableTrigram* tmp = list1;
+		list1 = list2;
+		list2 = tmp;
+		}
+
+	delete [] list2;
+
+	// a file counts only once for each trigram
+
+	itsKeyCount    = 0;
+	JSize keepCount = 0;
+	for (JIndex i=0; i<total; i++)
+		{
+		if (i == 0 || list1[i].key != list1[i-1].key)
+			{
+			itsKeyCount++;
+			keepCount++;
+			}
+		else if (list1[i].fileIndex != list1[i-1].fileIndex)
+			{
+			keepCount++;
+			}
+		}
+
+	itsKeyList    = new JUInt32 [ itsKeyCount+1 ];
+	itsOffsetList = new JIndex [ itsKeyCount+1 ];
+	itsFileList   = new JUInt32 [ keepCount+1 ];
+	assert( itsKeyList != NULL && itsOffsetList != NULL && itsFileList != NULL );
+
+	JIndex k = 0, f = 0;
+	for (JIndex i=0; i<total; i++)
+		{
+		if (i == 0 || list1[i].key != list1[i-1].key)
+			{
+			itsKeyList[k]    = list1[i].key;
+			itsOffsetList[k] = f;
+			k++;
+			itsFileList[f++] = list1[i].fileIndex;
+			}
+		else if (list1[i].fileIndex != list1[i-1].fileIndex)
+			{
+			itsFileList[f++] = list1[i].fileIndex;
+			}
+		}
+	itsOffsetList[ itsKeyCount ] = f;
+
+	delete [] list1;
+}
+
+JXFileListTable::FilterIndex::~FilterIndex()
+{
+	delete [] itsKeyList;
+	delete [] itsOffsetList;
+	delete [] itsFileList;
+}
+
+/******************************************************************************
+ FilterIndex::GetCandidates
+
+	Returns kJFalse if the index cannot help, i.e., every file has to be
+	checked.  Otherwise, *list contains the files that contain all the
+	trigrams required by the pattern.
+
+ ******************************************************************************/
+
+JBoolean
+JXFileListTable::FilterIndex::GetCandidates
+	(
+	const JCharacter*	pattern,
+	JArray<JIndex>*		list
+	)
+	const
+{
+	list->RemoveAll();
+
+	JArray<JIndex> keyList;
+	if (!JXFileListTableGetTrigrams(pattern, &keyList))
+		{
+		return kJFalse;
+		}
+
+	// start with the shortest list
+
+	const JSize keyCount = keyList.GetElementCount();
+	const JUInt32** fileList = new const JUInt32* [ keyCount ];
+	JSize* countList         = new JSize [ keyCount ];
+	assert( fileList != NULL && countList != NULL );
+
+	JIndex shortest = 0;
+	for (JIndex i=0; i<keyCount; i++)
+		{
+		if (!GetFiles(keyList.GetElement(i+1), fileList + i, countList + i))
+			{
+			delete [] fileList;
+			delete [] countList;
+			return kJTrue;
+			}
+
+		if (countList[i] < countList[shortest])
+			{
+			shortest = i;
+			}
+		}
+
+	list->SetBlockSize(JMax(countList[shortest], (JSize) 1));
+
+	for (JIndex i=0; i<countList[shortest]; i++)
+		{
+		const JUInt32 fileIndex = fileList[shortest][i];
+
+		JBoolean found = kJTrue;
+		for (JIndex j=0; j<keyCount && found; j++)
+			{
+			if (j != shortest)
+				{
+				const JUInt32* end = fileList[j] + countList[j];
+				const JUInt32* p   = fileList[j];
+				JSize n            = countList[j];
+				while (n > 0)			// lower bound
+					{
+					const JSize half = n/2;
+					if (p[half] < fileIndex)
+						{
+						p += half+1;
+						n -= half+1;
+						}
+					else
+						{
+						n = half;
+						}
+					}
+				found = JI2B( p < end && *p == fileIndex );
+				}
+			}
+
+		if (found)
+			{
+			list->AppendElement(fileIndex);
+			}
+		}
+
+	delete [] fileList;
+	delete [] countList;
+	return kJTrue;
+}
+
+/******************************************************************************
+ FilterIndex::GetFiles (private)
+
+ ******************************************************************************/
+
+JBoolean
+JXFileListTable::FilterIndex::GetFiles
+	(
+	const JUInt32		key,
+	const JUInt32**		list,
+	JSize*				count
+	)
+	const
+{
+	JIndex lo = 0, hi = itsKeyCount;
+	while (lo < hi)
+		{
+		const JIndex mid = (lo + hi)/2;
+		if (itsKeyList[mid] < key)
+			{
+			lo = mid+1;
+			}
+		else
+			{
+			hi = mid;
+			}
+		}
+
+	if (lo < itsKeyCount && itsKeyList[lo] == key)
+		{
+		*list  = itsFileList + itsOffsetList[lo];
+		*count = itsOffsetList[lo+1] - itsOffsetList[lo];
+		return kJTrue;
+		}
+	else
+		{
+		*list  = NULL;
+		*count = 0;
+		return kJFalse;
+		}
+}
+
+/******************************************************************************
+ JXFileListTableGetTrigrams (local)
+
+	Collects the trigrams of the literal text that every match of the
+	pattern must contain.  Returns kJFalse if there are none, or if the
+	pattern is too complicated to analyze, e.g., alternation or groups.
+
+ ******************************************************************************/
+
+static void	JXFileListTableAddTrigrams(const JString& run, JArray<JIndex>* keyList);
+
+static JBoolean
+JXFileListTableGetTrigrams
+	(
+	const JCharacter*	pattern,
+	JArray<JIndex>*		keyList
+	)
+{
+	keyList->RemoveAll();
+
+	if (strpbrk(pattern, "|()") != NULL)
+		{
+		return kJFalse;
+		}
+
+	JString run;
+	for (const JCharacter* p = pattern; *p != '\0'; p++)
+		{
+		const JCharacter c = *p;
+		if (c == '?' || c == '*' || c == '{')
+			{
+			// the previous character is optional
+
+			if (!run.IsEmpty())
+				{
+				run.RemoveSubstring(run.GetLength(), run.GetLength());
+				}
+			JXFileListTableAddTrigrams(run, keyList);
+			run.Clear();
+
+			if (c == '{')
+				{
+				while (*p != '\0' && *p != '}')
+					{
+					p++;
+					}
+				if (*p == '\0')
+					{
+					break;
+					}
+				}
+			}
+		else if (c == '+' || c == '.' || c == '^' || c == '$')
+			{
+			JXFileListTableAddTrigrams(run, keyList);
+			run.Clear();
+			}
+		else if (c == '[')
+			{
+			JXFileListTableAddTrigrams(run, keyList);
+			run.Clear();
+
+			p++;
+			if (*p == '^')
+				{
+				p++;
+				}
+			if (*p == ']')
+				{
+				p++;
+				}
+			while (*p != '\0' && *p != ']')
+				{
+				if (*p == '\\' && p[1] != '\0')
+					{
+					p++;
+					}
+				p++;
+				}
+			if (*p == '\0')
+				{
+				break;
+				}
+			}
+		else if (c == '\\')
+			{
+			p++;
+			if (*p == '\0')
+				{
+				break;
+				}
+			else if (isalnum((unsigned char) *p))
+				{
+				JXFileListTableAddTrigrams(run, keyList);	// \d, \w, etc.
+				run.Clear();
+				}
+			else
+				{
+				run.AppendCharacter(*p);
+				}
+			}
+		else
+			{
+			run.AppendCharacter(c);
+			}
+		}
+
+	JXFileListTableAddTrigrams(run, keyList);
+	return !keyList->IsEmpty();
+}
+
+static void
+JXFileListTableAddTrigrams
+	(
+	const JString&	run,
+	JArray<JIndex>*	keyList
+	)
+{
+	const JSize length = run.GetLength();
+	for (JIndex i=0; i+3<=length; i++)
+		{
+		keyList->AppendElement(JXFileListTableGetTrigram(run.GetCString() + i));
+		}
+}
+
 /******************************************************************************
  FilterFile (private)
 
@@ -447,7 +1376,7 @@ JXFileListTable::FilterFile
 		JIndex endRowIndex = rowIndex;
 		if (found)
 			{
-			endRowIndex = UpdateDrawIndex(rowIndex, *fileName);
+			endRowIndex = UpdateDrawIndex(rowIndex, fileName);
 			}
 
 		// check width of all rows that were affected
@@ -1204,6 +2133,12 @@ JXFileListTable::Receive
 	const Message&	message
 	)
 {
+	if (sender == itsFileList)
+		{
+		delete itsFilterIndex;		// file indexes may have changed
+		itsFilterIndex = NULL;
+		}
+
 	if (sender == itsFileList && message.Is(JOrderedSetT::kElementsInserted))
 		{
 		const JOrderedSetT::ElementsInserted* m =
@@ -35,6 +35,7 @@ public:
 	virtual ~JXFileListTable();
 
 	JBoolean	AddFile(const JCharacter* fullName, JIndex* fullNameIndex = NULL);
+	void		AddFiles(const JPtrArray<JString>& fileList);
 	void		RemoveFile(const JCharacter* fullName);
 	void		RemoveFiles(const JPtrArray<JString>& fileList);
 	void		RemoveSelectedFiles();
@@ -49,6 +50,9 @@ public:
 	JError		SetFilterRegex(const JCharacter* regexStr);
 	void		ClearFilterRegex();
 
+	JBoolean	WillUseFilterIndex() const;
+	void		ShouldUseFilterIndex(const JBoolean use = kJTrue);
+
 	JBoolean	HasSelection() const;
 	JBoolean	GetSelection(JPtrArray<JString>* fileList) const;
 	void		SelectSingleEntry(const JIndex index, const JBoolean scroll = kJTrue);
@@ -122,11 +126,16 @@ private:
 		JIndex drawIndex;		// index of first character to draw
 	};
 
+	class FilterIndex;
+	struct FilterPass;
+
 private:
 
 	JPtrArray<JString>*	itsFileList;			// full name of each file
 	JArray<VisInfo>*	itsVisibleList;			// info about each visible item
 	JRegex*				itsRegex;				// can be NULL
+	JBoolean			itsUseFilterIndexFlag;
+	FilterIndex*		itsFilterIndex;			// NULL until needed; deleted when files change
 
 	JBoolean			itsAcceptFileDropFlag;	// kJTrue => accept drop of url/url
 	JBoolean			itsBSRemoveSelFlag;		// kJTrue => backspace removes selected files
@@ -146,10 +155,13 @@ private:
 
 private:
 
-	void	RebuildTable(const JBoolean maintainScroll = kJFalse);
+	void	RebuildTable(const JBoolean maintainScroll = kJFalse,
+						 const JBoolean refine = kJFalse);
 	void	FilterFile(const JIndex fileIndex);
 	void	AdjustColWidths();
 
+	static JBoolean	IsRefinement(const JString& origPattern, const JCharacter* newPattern);
+
 	JBoolean	ClosestMatch(const JString& prefixStr, JIndex* index) const;
 //	JBoolean	FileNameToFileIndex(const JString& name, JIndex* index) const;
 	JBoolean	MainResolveFullName(const JIndex rowIndex, const JIndex fileIndex,
@@ -220,6 +232,22 @@ JXFileListTable::ShouldAcceptFileDrop
 	itsAcceptFileDropFlag = accept;
 }
 
+/******************************************************************************
+ Filter index
+
+	The index speeds up filtering large lists by only checking files that
+	contain the literal parts of the pattern.  It takes memory, so it is
+	off by default.
+
+ ******************************************************************************/
+
+inline JBoolean
+JXFileListTable::WillUseFilterIndex()
+	const
+{
+	return itsUseFilterIndexFlag;
+}
+
 /******************************************************************************
  Backspace action
 
@@ -0,0 +1,617 @@
+/******************************************************************************
+ JXFontCatalog.cpp
+
+	The fonts available on one display, listed once and indexed by family.
+	Asking the server for its fonts can take a long time when it has
+	thousands of them, so JXFontManager answers all its questions about
+	names, sizes, and styles from here.
+
+	When Xft is not used, the list of X font names can be saved in a cache
+	file.  The cache is keyed on the server and its font path, including
+	the modification time of each directory in the path, so adding fonts
+	with mkfontdir invalidates it.
+
+	BASE CLASS = none
+
+ ******************************************************************************/
+
+#include <JXStdInc.h>
+#include <JXFontCatalog.h>
+#include <JXDisplay.h>
+#include <jDirUtil.h>
+#include <jFileUtil.h>
+#include <jStreamUtil.h>
+#include <jFStreamUtil.h>
+#include <X11/Xlib.h>
+#ifdef _J_USE_XFT
+#include <X11/Xft/Xft.h>
+#endif
+#include <jMath.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include <jAssert.h>
+
+JBoolean JXFontCatalog::theUseCacheFileFlag = kJTrue;
+
+static const JCharacter* kCacheFileName = "~/.jx/font_cache";
+
+const JFileVersion kCurrentCacheVersion = 0;
+
+// XLFD fields
+
+enum
+{
+	kFoundryField = 0,
+	kFamilyField,
+	kWeightField,
+	kSlantField,
+	kSetWidthField,
+	kAddStyleField,
+	kPixelSizeField,
+	kPointSizeField,
+	kXResField,
+	kYResField,
+	kSpacingField,
+	kAvgWidthField,
+	kRegistryField,
+	kEncodingField,
+
+	kXLFDFieldCount
+};
+
+static JBoolean	JXFontCatalogSplitXLFD(const JCharacter* name,
+									   const JCharacter* field[], JSize length[]);
+static JSize	JXFontCatalogParseNumber(const JCharacter* s, const JSize length);
+
+/******************************************************************************
+ Constructor
+
+ ******************************************************************************/
+
+JXFontCatalog::JXFontCatalog
+	(
+	JXDisplay* display
+	)
+	:
+	itsDisplay(display),
+	itsMonoFontNames(NULL)
+{
+	itsFontList = new JArray<Font>(1000);
+	assert( itsFontList != NULL );
+
+	itsFamilyList = new JPtrArray<JString>(JPtrArrayT::kDeleteAll);
+	assert( itsFamilyList != NULL );
+
+	itsFamilyFirstFont = new JArray<JIndex>;
+	assert( itsFamilyFirstFont != NULL );
+
+	itsFamilyIndex = new JStringMap<JIndex>;
+	assert( itsFamilyIndex != NULL );
+
+	itsCharSetList = new JPtrArray<JString>(JPtrArrayT::kDeleteAll);
+	assert( itsCharSetList != NULL );
+	itsCharSetList->Append(JString());
+
+	itsXFontNames = new JPtrArray<JString>(JPtrArrayT::kDeleteAll, 1000);
+	assert( itsXFontNames != NULL );
+
+#ifdef _J_USE_XFT
+
+	BuildFromXft();
+
+#else
+
+	if (theUseCacheFileFlag)
+		{
+		itsCacheKey = GetCacheKey();
+		}
+
+	if (itsCacheKey.IsEmpty() || !ReadCacheFile())
+		{
+		int nameCount;
+		char** nameList = XListFonts(*itsDisplay, "*", INT_MAX, &nameCount);
+		if (nameList != NULL)
+			{
+			for (int i=0; i<nameCount; i++)
+				{
+				itsXFontNames->Append(nameList[i]);
+				}
+			XFreeFontNames(nameList);
+			}
+
+		WriteCacheFile();
+		}
+
+	BuildFromXFontNames();
+
+#endif
+}
+
+/******************************************************************************
+ Destructor
+
+ ******************************************************************************/
+
+JXFontCatalog::~JXFontCatalog()
+{
+	delete itsFontList;
+	delete itsFamilyList;
+	delete itsFamilyFirstFont;
+	delete itsFamilyIndex;
+	delete itsCharSetList;
+	delete itsXFontNames;
+	delete itsMonoFontNames;
+}
+
+/******************************************************************************
+ GetFirstFont
+
+	Family names are not case sensitive.  Returns kJFalse if there are no
+	fonts in the family.
+
+ ******************************************************************************/
+
+JBoolean
+JXFontCatalog::GetFirstFont
+	(
+	const JCharacter*	family,
+	const Font**		font
+	)
+	const
+{
+	JString key = family;
+	key.ToLower();
+
+	JIndex index;
+	if (itsFamilyIndex->GetElement(key, &index))
+		{
+		*font = &(GetFirstFont(index));
+		return kJTrue;
+		}
+	else
+		{
+		*font = NULL;
+		return kJFalse;
+		}
+}
+
+/******************************************************************************
+ SetMonospaceFontNames
+
+ ******************************************************************************/
+
+void
+JXFontCatalog::SetMonospaceFontNames
+	(
+	const JPtrArray<JString>& list
+	)
+{
+	if (itsMonoFontNames == NULL)
+		{
+		itsMonoFontNames = new JPtrArray<JString>(list, JPtrArrayT::kDeleteAll, kJTrue);
+		assert( itsMonoFontNames != NULL );
+		}
+	else
+		{
+		itsMonoFontNames->CopyObjects(list, JPtrArrayT::kDeleteAll, kJFalse);
+		}
+
+	WriteCacheFile();
+}
+
+/******************************************************************************
+ BuildFromXFontNames (private)
+
+	Names that are not in XLFD format, like "fixed", are aliases, so they
+	are only returned by GetXFontNames().
+
+ ******************************************************************************/
+
+void
+JXFontCatalog::BuildFromXFontNames()
+{
+	JStringMap<JIndex> charSetIndex;
+
+	const JCharacter* field[ kXLFDFieldCount ];
+	JSize length[ kXLFDFieldCount ];
+
+	JString family, charSet;
+
+	const JSize count = itsXFontNames->GetElementCount();
+	for (JIndex i=1; i<=count; i++)
+		{
+		const JString* name = itsXFontNames->NthElement(i);
+		if (!JXFontCatalogSplitXLFD(*name, field, length))
+			{
+			continue;
+			}
+
+		family.Set(field[ kFamilyField ], length[ kFamilyField ]);
+		if (family.IsEmpty() || family == "nil")
+			{
+			continue;
+			}
+
+		Font font;
+		font.xName = i;
+		font.size  = JXFontCatalogParseNumber(field[ kPointSizeField ], length[ kPointSizeField ]);
+		font.xRes  = JXFontCatalogParseNumber(field[ kXResField ], length[ kXResField ]);
+		font.yRes  = JXFontCatalogParseNumber(field[ kYResField ], length[ kYResField ]);
+
+		font.scalable = JI2B( font.size == 0 );
+
+		font.bold = JI2B( length[ kWeightField ] == 4 &&
+						  strncmp(field[ kWeightField ], "bold", 4) == 0 );
+
+		const JCharacter slant = field[ kSlantField ][0];
+		font.italic = JI2B( length[ kSlantField ] == 1 && (slant == 'i' || slant == 'o') );
+
+		const JCharacter spacing = field[ kSpacingField ][0];
+		font.mono = JI2B( length[ kSpacingField ] == 1 && (spacing == 'm' || spacing == 'c') );
+
+		// the char set is everything after the average width
+
+		charSet.Set(field[ kRegistryField ],
+					length[ kRegistryField ] + 1 + length[ kEncodingField ]);
+		if (!charSetIndex.GetElement(charSet, &(font.charSet)))
+			{
+			itsCharSetList->Append(charSet);
+			font.charSet = itsCharSetList->GetElementCount();
+			charSetIndex.SetElement(charSet, font.charSet);
+			}
+
+		AddFont(family, &font);
+		}
+}
+
+/******************************************************************************
+ BuildFromXft (private)
+
+ ******************************************************************************/
+
+#ifdef _J_USE_XFT
+
+void
+JXFontCatalog::BuildFromXft()
+{
+	XftFontSet* fs = XftListFonts(*itsDisplay, DefaultScreen((Display*) *itsDisplay), NULL,
+								  XFT_FAMILY, XFT_SIZE, XFT_SLANT, XFT_WEIGHT,
+								  XFT_SPACING, XFT_SCALABLE, NULL);
+	if (fs == NULL)
+		{
+		return;
+		}
+
+	for (int i=0; i<fs->nfont; i++)
+		{
+		char* family;
+		if (XftPatternGetString(fs->fonts[i], XFT_FAMILY, 0, &family) != XftResultMatch)
+			{
+			continue;
+			}
+
+		Font font;
+		font.xName   = 0;
+		font.charSet = 1;
+		font.size    = 0;
+		font.xRes    = 0;
+		font.yRes    = 0;
+
+		double size;
+		if (XftPatternGetDouble(fs->fonts[i], XFT_SIZE, 0, &size) == XftResultMatch)
+			{
+			font.size = JRound(10 * size);
+			}
+
+		int value;
+		font.italic = JI2B(
+			XftPatternGetInteger(fs->fonts[i], XFT_SLANT, 0, &value) == XftResultMatch &&
+			value == XFT_SLANT_ITALIC);
+		font.bold = JI2B(
+			XftPatternGetInteger(fs->fonts[i], XFT_WEIGHT, 0, &value) == XftResultMatch &&
+			value == XFT_WEIGHT_BOLD);
+		font.mono = JI2B(
+			XftPatternGetInteger(fs->fonts[i], XFT_SPACING, 0, &value) == XftResultMatch &&
+			value == XFT_MONO);
+
+		FcBool scalable;
+		font.scalable = JI2B(
+			XftPatternGetBool(fs->fonts[i], XFT_SCALABLE, 0, &scalable) == XftResultMatch &&
+			scalable);
+
+		AddFont(family, &font);
+		}
+
+	XftFontSetDestroy(fs);
+}
+
+#endif
+
+/******************************************************************************
+ AddFont (private)
+
+	Each new font is inserted at the front of its family's list.
+
+ ******************************************************************************/
+
+void
+JXFontCatalog::AddFont
+	(
+	const JCharacter*	family,
+	Font*				font
+	)
+{
+	JString key = family;
+	key.ToLower();
+
+	itsFontList->AppendElement(*font);
+	const JIndex fontIndex = itsFontList->GetElementCount();
+
+	JIndex familyIndex;
+	if (itsFamilyIndex->GetElement(key, &familyIndex))
+		{
+		font->next = itsFamilyFirstFont->GetElement(familyIndex);
+		itsFamilyFirstFont->SetElement(familyIndex, fontIndex);
+		}
+	else
+		{
+		itsFamilyList->Append(family);
+		familyIndex = itsFamilyList->GetElementCount();
+		itsFamilyFirstFont->AppendElement(fontIndex);
+		itsFamilyIndex->SetElement(key, familyIndex);
+		font->next = 0;
+		}
+
+	font->family = familyIndex;
+	itsFontList->SetElement(fontIndex, *font);
+}
+
+/******************************************************************************
+ GetCacheKey (private)
+
+	Returns an empty string if the font path cannot be obtained.
+
+ ******************************************************************************/
+
+JString
+JXFontCatalog::GetCacheKey()
+	const
+{
+	Display* display = *itsDisplay;
+
+	int pathCount;
+	char** pathList = XGetFontPath(display, &pathCount);
+	if (pathList == NULL)
+		{
+		return JString();
+		}
+
+	JString key = ServerVendor(display);
+	key += " ";
+	key += JString(VendorRelease(display), 0);
+
+	for (int i=0; i<pathCount; i++)
+		{
+		key += "\n";
+		key += pathList[i];
+
+		// elements can look like "catalogue:/etc/X11/fontpath.d" or
+		// "/usr/share/fonts/X11/misc:unscaled"
+
+		const JCharacter* start = pathList[i];
+		while (start != NULL)
+			{
+			const JCharacter* end = strchr(start, ':');
+			const JString dir(start, end != NULL ? end - start : strlen(start));
+
+			time_t t;
+			if (dir.BeginsWith("/") && JGetModificationTime(dir, &t) == kJNoError)
+				{
+				key += " ";
+				key += JString(t, 0);
+				}
+
+			start = (end != NULL ? end+1 : NULL);
+			}
+		}
+
+	XFreeFontPath(pathList);
+	return key;
+}
+
+/******************************************************************************
+ GetCacheFileName (private)
+
+ ******************************************************************************/
+
+JBoolean
+JXFontCatalog::GetCacheFileName
+	(
+	JString* fileName
+	)
+	const
+{
+	return JExpandHomeDirShortcut(kCacheFileName, fileName);
+}
+
+/******************************************************************************
+ ReadCacheFile (private)
+
+	Returns kJFalse if the file does not exist or belongs to a different
+	server or font path.
+
+ ******************************************************************************/
+
+JBoolean
+JXFontCatalog::ReadCacheFile()
+{
+	JString fileName;
+	if (!GetCacheFileName(&fileName) || !JFileReadable(fileName))
+		{
+		return kJFalse;
+		}
+
+	ifstream input(fileName);
+
+	JFileVersion vers;
+	input >> vers;
+	if (input.fail() || vers != kCurrentCacheVersion)
+		{
+		return kJFalse;
+		}
+
+	JString key;
+	input >> key;
+	if (input.fail() || key != itsCacheKey)
+		{
+		return kJFalse;
+		}
+
+	input >> *itsXFontNames;
+
+	JBoolean hasMonoFontNames;
+	input >> hasMonoFontNames;
+	if (!input.fail() && hasMonoFontNames)
+		{
+		JPtrArray<JString> list(JPtrArrayT::kDeleteAll);
+		input >> list;
+		if (!input.fail())
+			{
+			itsMonoFontNames = new JPtrArray<JString>(list, JPtrArrayT::kDeleteAll, kJTrue);
+			assert( itsMonoFontNames != NULL );
+			}
+		}
+
+	if (input.fail())
+		{
+		itsXFontNames->CleanOut();
+		delete itsMonoFontNames;
+		itsMonoFontNames = NULL;
+		return kJFalse;
+		}
+
+	return kJTrue;
+}
+
+/******************************************************************************
+ WriteCacheFile (private)
+
+	The file is written under a temporary name and then renamed, so other
+	programs never see a partial file.  We call rename() directly because
+	JRenameFile() refuses to replace an existing file, and the cache must
+	be replaced atomically whenever the font path or the monospace list
+	changes.
+
+ ******************************************************************************/
+
+void
+JXFontCatalog::WriteCacheFile()
+	const
+{
+	JString fileName, path, name, tempName;
+	if (itsCacheKey.IsEmpty() || !GetCacheFileName(&fileName))
+		{
+		return;
+		}
+
+	JSplitPathAndName(fileName, &path, &name);
+	if (JCreateDirectory(path, 0700) != kJNoError ||
+		JCreateTempFile(path, name, &tempName) != kJNoError)
+		{
+		return;
+		}
+
+	ofstream output(tempName);
+	output << kCurrentCacheVersion;
+	output << ' ' << itsCacheKey;
+	output << ' ' << *itsXFontNames;
+	output << ' ' << JI2B( itsMonoFontNames != NULL );
+	if (itsMonoFontNames != NULL)
+		{
+		output << ' ' << *itsMonoFontNames;
+		}
+	output.close();
+
+	if (output.fail() || rename(tempName, fileName) != 0)
+		{
+		JRemoveFile(tempName);
+		}
+}
+
+/******************************************************************************
+ JXFontCatalogSplitXLFD (local)
+
+	Returns kJFalse if name does not have all the XLFD fields.
+
+ ******************************************************************************/
+
+static JBoolean
+JXFontCatalogSplitXLFD
+	(
+	const JCharacter*	name,
+	const JCharacter*	field[],
+	JSize				length[]
+	)
+{
+	if (name[0] != '-')
+		{
+		return kJFalse;
+		}
+
+	JIndex i = 0;
+	const JCharacter* start = name+1;
+	for (const JCharacter* p = start; ; p++)
+		{
+		if (*p == '-' || *p == '\0')
+			{
+			if (i >= kXLFDFieldCount)
+				{
+				return kJFalse;
+				}
+
+			field[i]  = start;
+			length[i] = p - start;
+			i++;
+
+			if (*p == '\0')
+				{
+				break;
+				}
+			start = p+1;
+			}
+		}
+
+	return JI2B( i == kXLFDFieldCount );
+}
+
+/******************************************************************************
+ JXFontCatalogParseNumber (local)
+
+	Returns 0 if the field is not a number.
+
+ ******************************************************************************/
+
+static JSize
+JXFontCatalogParseNumber
+	(
+	const JCharacter*	s,
+	const JSize			length
+	)
+{
+	JSize n = 0;
+	for (JIndex i=0; i<length; i++)
+		{
+		if (!isdigit(s[i]))
+			{
+			return 0;
+			}
+		n = 10*n + (s[i] - '0');
+		}
+	return n;
+}
+
+#define JTemplateType JXFontCatalog::Font
+#include <JArray.tmpls>
+#undef JTemplateType
@@ -0,0 +1,283 @@
+/******************************************************************************
+ JXFontCatalog.h
+
+	Interface for the JXFontCatalog class
+
+ ******************************************************************************/
+
+#ifndef _H_JXFontCatalog
+#define _H_JXFontCatalog
+
+#if !defined _J_UNIX && !defined ACE_LACKS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <JPtrArray-JString.h>
+#include <JStringMap.h>
+
+class JXDisplay;
+
+class JXFontCatalog
+{
+public:
+
+	struct Font
+	{
+		JIndex		family;		// index into family list
+		JIndex		next;		// next font in the same family, 0 if last
+		JIndex		xName;		// index into X font name list, 0 if none
+		JIndex		charSet;	// index into char set list
+		JSize		size;		// 10 * points, 0 if scalable
+		JSize		xRes;		// 0 if scalable
+		JSize		yRes;		// 0 if scalable
+		JBoolean	bold;
+		JBoolean	italic;
+		JBoolean	mono;		// declared monospace
+		JBoolean	scalable;
+	};
+
+public:
+
+	JXFontCatalog(JXDisplay* display);
+
+	~JXFontCatalog();
+
+	JSize			GetFontCount() const;
+	const Font&		GetFont(const JIndex index) const;
+	JBoolean		GetNextFont(const Font& font, const Font** next) const;
+
+	JSize			GetFamilyCount() const;
+	const JString&	GetFamilyName(const JIndex index) const;
+	const Font&		GetFirstFont(const JIndex family) const;
+	JBoolean		GetFirstFont(const JCharacter* family, const Font** font) const;
+	const JString&	GetCharSet(const Font& font) const;
+	JBoolean		MatchesResolution(const Font& font, const JSize res) const;
+
+	const JPtrArray<JString>&	GetXFontNames() const;
+	const JString&				GetXFontName(const Font& font) const;
+
+	JBoolean	GetMonospaceFontNames(const JPtrArray<JString>** list) const;
+	void		SetMonospaceFontNames(const JPtrArray<JString>& list);
+
+	static JBoolean	WillUseCacheFile();
+	static void		ShouldUseCacheFile(const JBoolean use);
+
+private:
+
+	JXDisplay*			itsDisplay;
+	JArray<Font>*		itsFontList;
+	JPtrArray<JString>*	itsFamilyList;
+	JArray<JIndex>*		itsFamilyFirstFont;
+	JStringMap<JIndex>*	itsFamilyIndex;		// lower case name -> index in itsFamilyList
+	JPtrArray<JString>*	itsCharSetList;		// first one is empty
+	JPtrArray<JString>*	itsXFontNames;
+	JPtrArray<JString>*	itsMonoFontNames;	// NULL until computed
+	JString				itsCacheKey;		// empty if not cached
+
+	static JBoolean	theUseCacheFileFlag;
+
+private:
+
+	void	BuildFromXFontNames();
+	void	AddFont(const JCharacter* family, Font* font);
+
+#ifdef _J_USE_XFT
+	void	BuildFromXft();
+#endif
+
+	JString		GetCacheKey() const;
+	JBoolean	GetCacheFileName(JString* fileName) const;
+	JBoolean	ReadCacheFile();
+	void		WriteCacheFile() const;
+
+	// not allowed
+
+	JXFontCatalog(const JXFontCatalog& source);
+	const JXFontCatalog& operator=(const JXFontCatalog& source);
+};
+
+
+/******************************************************************************
+ Fonts
+
+	Fonts are indexed from 1, in the order listed by the server.
+
+ ******************************************************************************/
+
+inline JSize
+JXFontCatalog::GetFontCount()
+	const
+{
+	return itsFontList->GetElementCount();
+}
+
+inline const JXFontCatalog::Font&
+JXFontCatalog::GetFont
+	(
+	const JIndex index
+	)
+	const
+{
+	return (itsFontList->GetCArray())[ index-1 ];
+}
+
+inline JBoolean
+JXFontCatalog::GetNextFont
+	(
+	const Font&		font,
+	const Font**	next
+	)
+	const
+{
+	if (font.next > 0)
+		{
+		*next = itsFontList->GetCArray() + font.next-1;
+		return kJTrue;
+		}
+	else
+		{
+		*next = NULL;
+		return kJFalse;
+		}
+}
+
+/******************************************************************************
+ Families
+
+	Each family is listed once, with the capitalization used by the first
+	font in the family.
+
+ ******************************************************************************/
+
+inline JSize
+JXFontCatalog::GetFamilyCount()
+	const
+{
+	return itsFamilyList->GetElementCount();
+}
+
+inline const JString&
+JXFontCatalog::GetFamilyName
+	(
+	const JIndex index
+	)
+	const
+{
+	return *(itsFamilyList->NthElement(index));
+}
+
+inline const JXFontCatalog::Font&
+JXFontCatalog::GetFirstFont
+	(
+	const JIndex family
+	)
+	const
+{
+	return GetFont(itsFamilyFirstFont->GetElement(family));
+}
+
+/******************************************************************************
+ GetCharSet
+
+	Returns an empty string if the font does not specify a char set.
+
+ ******************************************************************************/
+
+inline const JString&
+JXFontCatalog::GetCharSet
+	(
+	const Font& font
+	)
+	const
+{
+	return *(itsCharSetList->NthElement(font.charSet));
+}
+
+/******************************************************************************
+ MatchesResolution
+
+	Scalable fonts can be rendered at any resolution.
+
+ ******************************************************************************/
+
+inline JBoolean
+JXFontCatalog::MatchesResolution
+	(
+	const Font&	font,
+	const JSize	res
+	)
+	const
+{
+	return JI2B((font.xRes == res && font.yRes == res) ||
+				(font.xRes == 0   && font.yRes == 0));
+}
+
+/******************************************************************************
+ X font names
+
+	The raw output of XListFonts("*"), which includes aliases.  This is
+	empty when Xft is used.
+
+ ******************************************************************************/
+
+inline const JPtrArray<JString>&
+JXFontCatalog::GetXFontNames()
+	const
+{
+	return *itsXFontNames;
+}
+
+inline const JString&
+JXFontCatalog::GetXFontName
+	(
+	const Font& font
+	)
+	const
+{
+	return *(itsXFontNames->NthElement(font.xName));
+}
+
+/******************************************************************************
+ Monospace font names
+
+	Deciding which fonts are really monospace requires loading them, so
+	JXFontManager stores the result here to be saved in the cache file.
+
+ ******************************************************************************/
+
+inline JBoolean
+JXFontCatalog::GetMonospaceFontNames
+	(
+	const JPtrArray<JString>** list
+	)
+	const
+{
+	*list = itsMonoFontNames;
+	return JI2B( itsMonoFontNames != NULL );
+}
+
+/******************************************************************************
+ Cache file (static)
+
+	When this is turned on, the list of X fonts is saved in ~/.jx, so the
+	next program that connects to a server with the same font path does
+	not have to ask for it.
+
+ ******************************************************************************/
+
+inline JBoolean
+JXFontCatalog::WillUseCacheFile()
+{
+	return theUseCacheFileFlag;
+}
+
+inline void
+JXFontCatalog::ShouldUseCacheFile
+	(
+	const JBoolean use
+	)
+{
+	theUseCacheFileFlag = use;
+}
+
+#endif
@@ -9,6 +9,7 @@
 
 #include <JXStdInc.h>
 #include <JXFontManager.h>
+#include <JXFontCatalog.h>
 #include <JXDisplay.h>
 #include <JXColormap.h>
 #include <jXGlobals.h>
@@ -16,10 +17,8 @@
 #include <JOrderedSetUtil.h>
 #include <JMinMax.h>
 #include <JString16.h>
-#include <jStreamUtil.h>
 #include <jMath.h>
 #include <JRegex.h>
-#include <sstream>
 #include <string.h>
 #include <ctype.h>
 #include <jAssert.h>
@@ -51,6 +50,7 @@ JXFontManager::JXFontManager
 
 	itsAllFontNames  = NULL;
 	itsMonoFontNames = NULL;
+	itsCatalog       = NULL;
 
 	JFontStyle::SetDefaultColorIndex(colormap->GetBlackColor());
 }
@@ -77,8 +77,13 @@ JXFontManager::~JXFontManager()
 
 	delete itsAllFontNames;
 	delete itsMonoFontNames;
+	delete itsCatalog;
 }
 
+static JBoolean	JXFontManagerMatchesCharSet(const JXFontCatalog& catalog,
+											const JXFontCatalog::Font& font,
+											const JString& charSet);
+
 /******************************************************************************
  GetFontNames (virtual)
 
@@ -106,81 +111,50 @@ JXFontManager::GetFontNames
 		fontNames->SetCompareFunction(JCompareStringsCaseInsensitive);
 		fontNames->SetSortOrder(JOrderedSetT::kSortAscending);
 
-#ifdef _J_USE_XFT
-		FcBool scalable = 1;
-		XftFontSet* fs = XftListFonts(*itsDisplay, DefaultScreen((Display*)*itsDisplay), XFT_SCALABLE, XftTypeBool, scalable, 0, XFT_FAMILY, 0);
+		const JXFontCatalog* catalog = GetCatalog();
 
-		for (int i=0; i<fs->nfont; i++)
-		{
-			char* raw_name;
-			if (XftPatternGetString(fs->fonts[i], XFT_FAMILY, 0, &raw_name) == XftResultMatch)
+		const JSize familyCount = catalog->GetFamilyCount();
+		for (JIndex i=1; i<=familyCount; i++)
 			{
-				JString name(raw_name);
-				JBoolean isDuplicate;
-				const JIndex index = fontNames->GetInsertionSortIndex(&name, &isDuplicate);
-				if (!isDuplicate)
-				{
-					fontNames->InsertAtIndex(index, name);
-				}
-			}
-		}
-		
-		XftFontSetDestroy(fs);		
-#else
-		int nameCount;
-		char** nameList = XListFonts(*itsDisplay, "-*-*-*-*-*-*-*-*-75-75-*-*-*-*",
-									 INT_MAX, &nameCount);
-		if (nameList == NULL)
-			{
-			return;
-			}
-
-		JString name, charSet;
-		for (int i=0; i<nameCount; i++)
-			{
-			const std::string s(nameList[i], strlen(nameList[i]));
-			std::istringstream input(s);
-			input.ignore();						// initial dash
-			JIgnoreUntil(input, '-');			// foundry name
-			name = JReadUntil(input, '-');		// font name
-			JIgnoreUntil(input, "-75-75-");		// ignore specs
-			JIgnoreUntil(input, '-');
-			JIgnoreUntil(input, '-');
-			JReadAll(input, &charSet);			// char set
-
-			if (name.IsEmpty() || name == "nil")
-				{
-				continue;
-				}
+			JString name = catalog->GetFamilyName(i);
 
+#ifndef _J_USE_XFT
 			ConvertToPSFontName(&name);
 
 			// Until JPSPrinter can embed fonts in a Postscript file, we are limited
 			// to only the standard Postscript fonts.
 
-			if (name == JXGetCourierFontName()   ||
-				name == JXGetHelveticaFontName() ||
-				name == JXGetSymbolFontName()    ||
-				name == JXGetTimesFontName())
+			if (name != JXGetCourierFontName()   &&
+				name != JXGetHelveticaFontName() &&
+				name != JXGetSymbolFontName()    &&
+				name != JXGetTimesFontName())
 				{
-//				if (name != JXGetSymbolFontName())
-//					{
-//					name = CombineNameAndCharacterSet(name, charSet);
-//					}
+				continue;
+				}
+#endif
 
-				JBoolean isDuplicate;
-				const JIndex index =
-					fontNames->GetInsertionSortIndex(&name, &isDuplicate);
-				if (!isDuplicate)
+			const JXFontCatalog::Font* font = &(catalog->GetFirstFont(i));
+			do
+				{
+#ifdef _J_USE_XFT
+				if (font->scalable)
+#else
+				if (catalog->MatchesResolution(*font, 75))
+#endif
 					{
-					fontNames->InsertAtIndex(index, name);
+					JBoolean isDuplicate;
+					const JIndex index =
+						fontNames->GetInsertionSortIndex(&name, &isDuplicate);
+					if (!isDuplicate)
+						{
+						fontNames->InsertAtIndex(index, name);
+						}
+					break;
 					}
 				}
+				while (catalog->GetNextFont(*font, &font));
 			}
 
-		XFreeFontNames(nameList);
-#endif
-
 		// save names for next time
 
 		JXFontManager* me = const_cast<JXFontManager*>(this);
@@ -197,16 +171,10 @@ JXFontManager::GetFontNames
 	By performing an insertion sort, we can automatically eliminate
 	duplicate names.
 
- ******************************************************************************/
-
-static const JCharacter* kMonospaceFontPattern[] =
-{
-	"-*-*-*-*-*-*-*-*-72-72-*-*-*-*",
-	"-*-*-*-*-*-*-*-*-75-75-*-*-iso*-*",
-};
+	Checking X fonts requires loading them, so the result is stored in
+	the font catalog's cache file.
 
-const int kMonospaceFontPatternCount =
-	sizeof(kMonospaceFontPattern) / sizeof(JCharacter*);
+ ******************************************************************************/
 
 void
 JXFontManager::GetMonospaceFontNames
@@ -215,8 +183,19 @@ JXFontManager::GetMonospaceFontNames
 	)
 	const
 {
+	const JPtrArray<JString>* cachedNames;
 	if (itsMonoFontNames != NULL)
 		{
+		fontNames->CopyObjects(*itsMonoFontNames, fontNames->GetCleanUpAction(), kJFalse);
+		}
+	else if (GetCatalog()->GetMonospaceFontNames(&cachedNames))
+		{
+		JXFontManager* me = const_cast<JXFontManager*>(this);
+
+		me->itsMonoFontNames =
+			new JPtrArray<JString>(*cachedNames, JPtrArrayT::kDeleteAll, kJTrue);
+		assert( me->itsMonoFontNames != NULL );
+
 		fontNames->CopyObjects(*itsMonoFontNames, fontNames->GetCleanUpAction(), kJFalse);
 		}
 	else
@@ -227,58 +206,45 @@ JXFontManager::GetMonospaceFontNames
 		fontNames->SetCompareFunction(JCompareStringsCaseInsensitive);
 		fontNames->SetSortOrder(JOrderedSetT::kSortAscending);
 
-#ifdef _J_USE_XFT
-		FcBool scalable = 1;
-		XftFontSet* fs = XftListFonts(*itsDisplay, DefaultScreen((Display*)*itsDisplay), XFT_SPACING, XftTypeInteger, XFT_MONO,
-																			XFT_SCALABLE, XftTypeBool, scalable, 0, XFT_FAMILY, 0);
+		JXFontCatalog* catalog = GetCatalog();
+		const JSize fontCount  = catalog->GetFontCount();
 
-		for (int i=0; i<fs->nfont; i++)
-		{
-			char* raw_name;
-			if (XftPatternGetString(fs->fonts[i], XFT_FAMILY, 0, &raw_name) == XftResultMatch)
+#ifdef _J_USE_XFT
+		for (JIndex i=1; i<=fontCount; i++)
 			{
-				JString name(raw_name);
+			const JXFontCatalog::Font& font = catalog->GetFont(i);
+			if (font.mono && font.scalable)
+				{
+				JString name = catalog->GetFamilyName(font.family);
 				JBoolean isDuplicate;
 				const JIndex index = fontNames->GetInsertionSortIndex(&name, &isDuplicate);
 				if (!isDuplicate)
-				{
+					{
 					fontNames->InsertAtIndex(index, name);
+					}
 				}
 			}
-		}
-		
-		XftFontSetDestroy(fs);		
 #else
 		JPtrArray<JString> allFontNames(JPtrArrayT::kDeleteAll);
 		allFontNames.SetCompareFunction(JCompareStringsCaseInsensitive);
 		allFontNames.SetSortOrder(JOrderedSetT::kSortAscending);
 
-		for (int j=0; j<kMonospaceFontPatternCount; j++)
-			{
-			int nameCount;
-			char** nameList = XListFonts(*itsDisplay, kMonospaceFontPattern[j],
-										 INT_MAX, &nameCount);
-			if (nameList == NULL)
-				{
-				return;
-				}
+		// check 72 dpi fonts first, then 75 dpi iso fonts
 
-			JString name, charSet;
-			for (int i=0; i<nameCount; i++)
+		JString name;
+		for (int j=0; j<2; j++)
+			{
+			for (JIndex i=1; i<=fontCount; i++)
 				{
-				const std::string s(nameList[i], strlen(nameList[i]));
-				std::istringstream input(s);
-				input.ignore();						// initial dash
-				JIgnoreUntil(input, '-');			// foundry name
-				name = JReadUntil(input, '-');		// font name
-				JIgnoreUntil(input, "-iso");		// ignore specs
-				JReadAll(input, &charSet);			// char set
-
-				if (name.IsEmpty() || name == "nil")
+				const JXFontCatalog::Font& font = catalog->GetFont(i);
+				if (j == 0 ? !catalog->MatchesResolution(font, 72) :
+							 (!catalog->MatchesResolution(font, 75) ||
+							  !(catalog->GetCharSet(font)).BeginsWith("iso", kJFalse)))
 					{
 					continue;
 					}
 
+				name = catalog->GetFamilyName(font.family);
 				ConvertToPSFontName(&name);
 
 #if ! QUERY_FOR_MONOSPACE
@@ -288,9 +254,6 @@ JXFontManager::GetMonospaceFontNames
 					{
 #endif
 
-//				charSet.Prepend("iso");
-//				name = CombineNameAndCharacterSet(name, charSet);
-
 				JBoolean isDuplicate;
 				const JIndex index =
 					allFontNames.GetInsertionSortIndex(&name, &isDuplicate);
@@ -298,9 +261,8 @@ JXFontManager::GetMonospaceFontNames
 					{
 					allFontNames.InsertAtIndex(index, name);
 
-//					cout << nameList[i] << endl;
-
-					XFontStruct* xfont = XLoadQueryFont(*itsDisplay, nameList[i]);
+					XFontStruct* xfont =
+						XLoadQueryFont(*itsDisplay, catalog->GetXFontName(font));
 					if (xfont != NULL)
 						{
 						if (IsMonospace(*xfont))
@@ -317,8 +279,6 @@ JXFontManager::GetMonospaceFontNames
 					}
 #endif
 				}
-
-			XFreeFontNames(nameList);
 			}
 #endif
 
@@ -329,6 +289,8 @@ JXFontManager::GetMonospaceFontNames
 		me->itsMonoFontNames =
 			new JPtrArray<JString>(*fontNames, JPtrArrayT::kDeleteAll, kJTrue);
 		assert( me->itsMonoFontNames != NULL );
+
+		catalog->SetMonospaceFontNames(*fontNames);
 		}
 }
 
@@ -358,31 +320,25 @@ JXFontManager::GetXFontNames
 
 #ifdef _J_USE_XFT
 #else
-	int nameCount;
-	char** nameList = XListFonts(*itsDisplay, "*", INT_MAX, &nameCount);
-	if (nameList == NULL)
-		{
-		return;
-		}
+	const JPtrArray<JString>& nameList = GetCatalog()->GetXFontNames();
 
-	for (int i=0; i<nameCount; i++)
+	const JSize nameCount = nameList.GetElementCount();
+	for (JIndex i=1; i<=nameCount; i++)
 		{
-		if (regex.Match(nameList[i]) && strcmp(nameList[i], "nil") != 0)
+		const JString* name = nameList.NthElement(i);
+		if (regex.Match(*name) && *name != "nil")
 			{
-			JString name = nameList[i];
 			JBoolean isDuplicate;
 			const JIndex index =
-				fontNames->GetInsertionSortIndex(&name, &isDuplicate);
+				fontNames->GetInsertionSortIndex(const_cast<JString*>(name), &isDuplicate);
 			if (!isDuplicate)
 				{
-				JString* n = new JString(name);
+				JString* n = new JString(*name);
 				assert( n != NULL );
 				fontNames->InsertAtIndex(index, n);
 				}
 			}
 		}
-
-	XFreeFontNames(nameList);
 #endif
 }
 
@@ -411,109 +367,46 @@ JXFontManager::GetFontSizes
 	sizeList->SetCompareFunction(JCompareSizes);
 	sizeList->SetSortOrder(JOrderedSetT::kSortAscending);
 
-#ifdef _J_USE_XFT
-	XftFontSet* fs = XftListFonts(*itsDisplay, DefaultScreen((Display*)*itsDisplay), XFT_FAMILY, XftTypeString, name, 0, XFT_SIZE, 0);
+	const JXFontCatalog* catalog = GetCatalog();
 
-	if (fs->nfont == 0)
-	{
-		*minSize = 8;
-		*maxSize = 24;
-		XftFontSetDestroy(fs);		
-		return kJTrue;
-	}
-
-	for (int i=0; i<fs->nfont; i++)
-	{
-		double raw_size;
-		if (XftPatternGetDouble(fs->fonts[i], XFT_SIZE, 0, &raw_size) == XftResultMatch)
-		{
-			JSize fontSize = static_cast<JSize>(raw_size);
-			if (sizeList->IsEmpty())
-			{
-				*minSize = *maxSize = fontSize;
-			}
-
-			JBoolean isDuplicate;
-			const JIndex index =
-				sizeList->GetInsertionSortIndex(fontSize, &isDuplicate);
-			if (!isDuplicate)
-			{
-				sizeList->InsertElementAtIndex(index, fontSize);
-
-				if (fontSize < *minSize)
-				{
-					*minSize = fontSize;
-				}
-				else if (fontSize > *maxSize)
-				{
-					*maxSize = fontSize;
-				}
-			}
-		}
-	}
-	
-	// Look for scalable
-	if ((*minSize == 0) && (*maxSize == 0))
-	{
-		*minSize = 8;
-		*maxSize = 24;
-		XftFontSetDestroy(fs);		
-		return kJTrue;
-	}
-	
-	XftFontSetDestroy(fs);		
-#else
 	JString xFontName, charSet;
-	if (!ConvertToXFontName(name, &xFontName, &charSet))
-		{
-		charSet = "*-*";
-		}
-
-	// check for rescalable font
-
-	JString regexStr = "-*-" + xFontName + "-*-*-*-*-*-0-75-75-*-*-" + charSet;
+	ConvertToXFontName(name, &xFontName, &charSet);
 
-	int nameCount;
-	char** nameList = XListFonts(*itsDisplay, regexStr, INT_MAX, &nameCount);
-	if (nameList != NULL)
+	const JXFontCatalog::Font* font;
+	if (!catalog->GetFirstFont(xFontName, &font))
 		{
+#ifdef _J_USE_XFT
 		*minSize = 8;
 		*maxSize = 24;
-		XFreeFontNames(nameList);
 		return kJTrue;
-		}
-
-	// get list of available sizes
-
-	regexStr = "-*-" + xFontName + "-*-*-*-*-*-*-75-75-*-*-" + charSet;
-
-	nameList = XListFonts(*itsDisplay, regexStr, INT_MAX, &nameCount);
-	if (nameList == NULL)
-		{
+#else
 		return kJFalse;
+#endif
 		}
 
-	JSize fontSize;
-	for (int i=0; i<nameCount; i++)
+	do
 		{
-		const std::string s(nameList[i], strlen(nameList[i]));
-		std::istringstream input(s);
-		input.ignore();							// initial dash
-		JIgnoreUntil(input, '-');				// foundry name
-		JIgnoreUntil(input, '-');				// font name
-		JIgnoreUntil(input, '-');				// medium/bold
-		JIgnoreUntil(input, '-');				// roman/oblique/italic
-		JIgnoreUntil(input, '-');				// character spacing
-		input.ignore();							// extra dash
-		JIgnoreUntil(input, '-');				// pixel height
-		input >> fontSize;						// 10*(point size)
-
-		if (fontSize < 10)
+#ifndef _J_USE_XFT
+		if (!catalog->MatchesResolution(*font, 75) ||
+			!JXFontManagerMatchesCharSet(*catalog, *font, charSet))
 			{
-			continue;		// we already checked for rescalable version
+			continue;
 			}
+		else if (font->scalable)
+			{
+			*minSize = 8;
+			*maxSize = 24;
+			sizeList->RemoveAll();
+			return kJTrue;
+			}
+#endif
 
-		fontSize /= 10;
+		if (font->size < 10)
+			{
+			continue;		// rescalable
+			}
+
+		const JSize fontSize = font->size / 10;
 		if (sizeList->IsEmpty())
 			{
 			*minSize = *maxSize = fontSize;
@@ -536,8 +429,15 @@ JXFontManager::GetFontSizes
 				}
 			}
 		}
+		while (catalog->GetNextFont(*font, &font));
 
-	XFreeFontNames(nameList);
+#ifdef _J_USE_XFT
+	if (sizeList->IsEmpty())
+		{
+		*minSize = 8;
+		*maxSize = 24;
+		return kJTrue;
+		}
 #endif
 
 	return JNegate( sizeList->IsEmpty() );
@@ -561,75 +461,40 @@ JXFontManager::GetFontStyles
 {
 	JFontStyle style(kJFalse, kJFalse, 0, kJTrue);
 
-#ifdef _J_USE_XFT
-	double raw_size = size;
-	XftFontSet* fs = XftListFonts(*itsDisplay, DefaultScreen((Display*)*itsDisplay), XFT_FAMILY, XftTypeString, name, XFT_SIZE, XftTypeDouble, raw_size, 0, XFT_SLANT, XFT_WEIGHT, 0);
-
-	if (fs->nfont == 0)
-	{
-		return style;
-	}
+	const JXFontCatalog* catalog = GetCatalog();
 
-	for (int i=0; i<fs->nfont; i++)
-	{
-		int raw_slant;
-		if (XftPatternGetInteger(fs->fonts[i], XFT_SLANT, 0, &raw_slant) == XftResultMatch)
-		{
-			if (raw_slant == XFT_SLANT_ITALIC)
-				style.italic = kJTrue;
-		}
-
-		int raw_weight;
-		if (XftPatternGetInteger(fs->fonts[i], XFT_WEIGHT, 0, &raw_weight) == XftResultMatch)
-		{
-			if (raw_weight == XFT_WEIGHT_BOLD)
-				style.bold = kJTrue;
-		}
-	}
-	
-	XftFontSetDestroy(fs);		
-#else
 	JString xFontName, charSet;
-	if (!ConvertToXFontName(name, &xFontName, &charSet))
-		{
-		charSet = "*-*";
-		}
-
-	const JString regexStr =
-		"-*-" + xFontName + "-*-*-*-*-*-" +
-		JString(10*size, 0, JString::kForceNoExponent) +
-		"-75-75-*-*-" + charSet;
+	ConvertToXFontName(name, &xFontName, &charSet);
 
-	int nameCount;
-	char** nameList = XListFonts(*itsDisplay, regexStr, INT_MAX, &nameCount);
-	if (nameList == NULL)
+	const JXFontCatalog::Font* font;
+	if (!catalog->GetFirstFont(xFontName, &font))
 		{
 		return style;
 		}
 
-	JString weight, slant;
-	for (int i=0; i<nameCount; i++)
+	do
 		{
-		const std::string s(nameList[i], strlen(nameList[i]));
-		std::istringstream input(s);
-		input.ignore();							// initial dash
-		JIgnoreUntil(input, '-');				// foundry name
-		JIgnoreUntil(input, '-');				// font name
-		weight = JReadUntil(input, '-');		// medium/bold
-		slant  = JReadUntil(input, '-');		// roman/oblique/italic
-
-		if (weight == "bold")
+#ifndef _J_USE_XFT
+		if (!catalog->MatchesResolution(*font, 75) ||
+			!JXFontManagerMatchesCharSet(*catalog, *font, charSet))
 			{
-			style.bold = kJTrue;
+			continue;
 			}
-		if (slant == "o" || slant == "i")
+#endif
+
+		if (font->scalable || font->size == 10*size)
 			{
-			style.italic = kJTrue;
+			if (font->bold)
+				{
+				style.bold = kJTrue;
+				}
+			if (font->italic)
+				{
+				style.italic = kJTrue;
+				}
 			}
 		}
-
-	XFreeFontNames(nameList);
-#endif
+		while (catalog->GetNextFont(*font, &font));
 
 	return style;
 }
@@ -654,55 +519,83 @@ JXFontManager::GetFontCharSets
 	charSetList->SetCompareFunction(JCompareStringsCaseInsensitive);
 	charSetList->SetSortOrder(JOrderedSetT::kSortAscending);
 
+	const JXFontCatalog* catalog = GetCatalog();
+
 	JString xFontName, charSet;
 	ConvertToXFontName(name, &xFontName, &charSet);		// strip charSet
 
-	const JString regexStr =
-		"-*-" + xFontName + "-*-*-*-*-*-" +
-		JString(10*size, 0, JString::kForceNoExponent) +
-		"-75-75-*-*-*-*";
-
-	int nameCount;
-	char** nameList = XListFonts(*itsDisplay, regexStr, INT_MAX, &nameCount);
-	if (nameList == NULL)
+	const JXFontCatalog::Font* font;
+	if (!catalog->GetFirstFont(xFontName, &font))
 		{
 		return kJFalse;
 		}
 
-	for (int i=0; i<nameCount; i++)
+	do
 		{
-		const std::string s(nameList[i], strlen(nameList[i]));
-		std::istringstream input(s);
-		input.ignore();							// initial dash
-		JIgnoreUntil(input, '-');				// foundry name
-		JIgnoreUntil(input, '-');				// font name
-		JIgnoreUntil(input, '-');				// medium/bold
-		JIgnoreUntil(input, '-');				// roman/oblique/italic
-		JIgnoreUntil(input, '-');				// character spacing
-		input.ignore();							// extra dash
-		JIgnoreUntil(input, '-');				// pixel height
-		JIgnoreUntil(input, '-');				// 10*(point size)
-		JIgnoreUntil(input, '-');				// x resolution
-		JIgnoreUntil(input, '-');				// y resolution
-		JIgnoreUntil(input, '-');				// ?
-		JIgnoreUntil(input, '-');				// ?
-		JReadAll(input, &charSet);
+		const JString& s = catalog->GetCharSet(*font);
+		if (s.IsEmpty() || !catalog->MatchesResolution(*font, 75) ||
+			(!font->scalable && font->size != 10*size))
+			{
+			continue;
+			}
 
 		JBoolean isDuplicate;
 		const JIndex index =
-			charSetList->GetInsertionSortIndex(&charSet, &isDuplicate);
+			charSetList->GetInsertionSortIndex(const_cast<JString*>(&s), &isDuplicate);
 		if (!isDuplicate)
 			{
-			JString* s = new JString(charSet);
-			assert( s != NULL );
-			charSetList->InsertElementAtIndex(index, s);
+			JString* s1 = new JString(s);
+			assert( s1 != NULL );
+			charSetList->InsertElementAtIndex(index, s1);
 			}
 		}
+		while (catalog->GetNextFont(*font, &font));
 
-	XFreeFontNames(nameList);
 	return JNegate( charSetList->IsEmpty() );
 }
 
+/******************************************************************************
+ JXFontManagerMatchesCharSet (local)
+
+	An empty charSet matches every font.
+
+ ******************************************************************************/
+
+static JBoolean
+JXFontManagerMatchesCharSet
+	(
+	const JXFontCatalog&		catalog,
+	const JXFontCatalog::Font&	font,
+	const JString&				charSet
+	)
+{
+	return JI2B(charSet.IsEmpty() ||
+				JStringCompare(catalog.GetCharSet(font), charSet, kJFalse) == 0);
+}
+
+/******************************************************************************
+ GetCatalog (private)
+
+	The catalog is created the first time it is needed, since most
+	programs never ask what fonts are available.
+
+ ******************************************************************************/
+
+JXFontCatalog*
+JXFontManager::GetCatalog()
+	const
+{
+	if (itsCatalog == NULL)
+		{
+		JXFontManager* me = const_cast<JXFontManager*>(this);
+
+		me->itsCatalog = new JXFontCatalog(itsDisplay);
+		assert( me->itsCatalog != NULL );
+		}
+
+	return itsCatalog;
+}
+
 /******************************************************************************
  GetFontID (virtual)
 
@@ -25,6 +25,7 @@ class JString;
 class JRegex;
 class JXDisplay;
 class JXColormap;
+class JXFontCatalog;
 
 typedef JOrderedSetT::CompareResult
 	(*JSortXFontNamesFn)(JString * const &, JString * const &);
@@ -100,6 +101,7 @@ private:
 
 	JPtrArray<JString>*	itsAllFontNames;	// can be NULL
 	JPtrArray<JString>*	itsMonoFontNames;	// can be NULL
+	JXFontCatalog*		itsCatalog;			// NULL until needed
 
 private:
 
@@ -119,6 +121,8 @@ private:
 									const JSize size, const JFontStyle& style) const;
 #endif
 
+	JXFontCatalog*	GetCatalog() const;
+
 	JBoolean	ConvertToXFontName(const JCharacter* origName,
 								   JString* fontName, JString* charSet) const;
 	void		ConvertToPSFontName(JString* name) const;
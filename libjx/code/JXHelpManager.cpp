@@ -208,7 +208,7 @@ JXHelpManager::ShowSection
 		if (itsSections->SearchSorted(target, JOrderedSetT::kAnyMatch, &i))
 			{
 			target = itsSections->GetElement(i);
-			JString* text;
+			const JString* text;
 			if (target.dir != NULL)
 				{
 				found = kJTrue;
@@ -256,7 +256,7 @@ JXHelpManager::SearchAllSections()
 		SectionInfo info = itsSections->GetElement(i);
 		JBoolean hadDir  = kJTrue;
 
-		JString* text;
+		const JString* text;
 		if (info.dir == NULL &&
 			(JGetStringManager())->GetElement(info.name, &text))
 			{
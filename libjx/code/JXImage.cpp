@@ -1124,6 +1124,55 @@ JXImage::SetColor
 	XPutPixel(itsImage, x,y, xPixel);
 }
 
+/******************************************************************************
+ SetColorRow (virtual)
+
+	Converts an entire row in one pass.  When all colors are preallocated,
+	the JColorIndex is the X pixel value, so if the XImage stores 32 bits
+	per pixel in our byte order, we write directly into its data.
+
+ ******************************************************************************/
+
+void
+JXImage::SetColorRow
+	(
+	const JCoordinate	y,
+	const JColorIndex*	colorRow
+	)
+{
+	ConvertToImage();
+
+	const JCoordinate w = GetWidth();
+
+	const JUInt32 one   = 1;
+	const int hostOrder = (*((const unsigned char*) &one) == 1 ? LSBFirst : MSBFirst);
+
+	if (itsDepth == 1)
+		{
+		for (JCoordinate x=0; x<w; x++)
+			{
+			XPutPixel(itsImage, x,y, JXImageMask::ColorToBit(colorRow[x]));
+			}
+		}
+	else if (itsColormap->AllColorsPreallocated() &&
+			 itsImage->bits_per_pixel == 32 &&
+			 itsImage->byte_order == hostOrder)
+		{
+		JUInt32* data = (JUInt32*) (itsImage->data + y * itsImage->bytes_per_line);
+		for (JCoordinate x=0; x<w; x++)
+			{
+			data[x] = colorRow[x];
+			}
+		}
+	else
+		{
+		for (JCoordinate x=0; x<w; x++)
+			{
+			XPutPixel(itsImage, x,y, itsColormap->GetXPixel(colorRow[x]));
+			}
+		}
+}
+
 /******************************************************************************
  RegisterColor (private)
 
@@ -103,6 +103,7 @@ public:
 	virtual JColorIndex	GetColor(const JCoordinate x, const JCoordinate y) const;
 	virtual void		SetColor(const JCoordinate x, const JCoordinate y,
 								 const JColorIndex color);
+	virtual void		SetColorRow(const JCoordinate y, const JColorIndex* colorRow);
 
 	State	GetDefaultState() const;
 	void	SetDefaultState(const State state);
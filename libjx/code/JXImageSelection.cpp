@@ -288,11 +288,17 @@ JXImageSelection::GetImage
 	const JBoolean		allowApproxColors
 	)
 {
-	JXDisplay* display   = colormap->GetDisplay();
-	const Atom xpmXAtom  = display->RegisterXAtom(kXPMXAtomName);
-	const Atom gifXAtom  = display->RegisterXAtom(kGIFXAtomName);
-	const Atom pngXAtom  = display->RegisterXAtom(kPNGXAtomName);
-	const Atom jpegXAtom = display->RegisterXAtom(kJPEGXAtomName);
+	Atom xpmXAtom, gifXAtom, pngXAtom, jpegXAtom;
+	const JXDisplay::XAtomInfo atomInfo[] =
+		{
+		{ kXPMXAtomName,  &xpmXAtom  },
+		{ kGIFXAtomName,  &gifXAtom  },
+		{ kPNGXAtomName,  &pngXAtom  },
+		{ kJPEGXAtomName, &jpegXAtom }
+		};
+
+	JXDisplay* display = colormap->GetDisplay();
+	display->RegisterXAtoms(sizeof(atomInfo)/sizeof(JXDisplay::XAtomInfo), atomInfo);
 
 	JArray<Atom> typeList;
 	if (selMgr->GetAvailableTypes(selectionName, time, &typeList))
@@ -20,6 +20,74 @@
 
 static const char* kCurrentJXLibVersionStr = "2.5.0";
 
+// version 2.6.0:
+//	JXImage:
+//		Overrides SetColorRow() to write directly into the XImage when
+//			possible.
+//	JXApplication, JXDisplay, JXWindow:
+//		Instrumented event handling, idle tasks, and updates with trace
+//			zones.  If JX_TRACE_FILE is set, tracing is turned on and the
+//			trace is written to that file when the program exits.
+//	JXApplication:
+//		Added GetWorkerPool().  Finished JWorkerTasks are delivered along
+//			with the urgent tasks.
+//	JXDisplay:
+//		Compresses consecutive MotionNotify events and remembers the latest
+//			pointer position, so JXWindow no longer calls XQueryPointer()
+//			for every motion event or during idle time.
+//		Added GetLatestPointerPosition().
+//		Added CountRoundTrip(), GetRoundTripCount(), and GetRoundTripRate()
+//			to monitor synchronous requests.
+//		RegisterXAtom() caches the result, so only the first call for each
+//			name contacts the server.
+//		Added RegisterXAtoms() to obtain a list of atoms in one round trip.
+//			JXDisplay, JXSelectionManager, JXDNDManager, and JXDockManager
+//			use it, so opening a display needs 3 round trips instead of 36.
+//	JXColormap:
+//		AllocateStaticColor() uses a hash table to find existing colors and
+//			a grid to find approximate matches, instead of searching the
+//			entire list.
+//	JXContainer:
+//		Containers with many enclosed objects use a JXContainerIndex to
+//			find the object under the mouse and to skip objects outside
+//			the area being redrawn.
+//		*** Derived classes that change their frame must call FrameChanged().
+//			JXWidget already does this.
+//	JXDisplay:
+//		Windows are redrawn at most once per frame.  Added
+//			SetTargetFrameRate() (default 60 per second) and
+//			GetFrameStats().  Redrawing is postponed while input is pending,
+//			but never by more than 4 frames.
+//	JXApplication:
+//		Wakes up in time to draw the next frame instead of sleeping for the
+//			full idle interval.
+//	Created JXFontCatalog to list the fonts on a display once, indexed by
+//		family.  The X font list is saved in ~/.jx/font_cache and reused
+//		until the server's font path changes.
+//	JXFontManager:
+//		All queries about font names, sizes, styles, and char sets are
+//			answered from the display's JXFontCatalog instead of calling
+//			XListFonts() or XftListFonts() each time.
+//		GetMonospaceFontNames() saves its result in the font cache.
+//	JXSelectionManager:
+//		Sends large selections incrementally from the event loop instead of
+//			blocking until the requestor has received everything.
+//		Chunk size is based on XExtendedMaxRequestSize().
+//		Added StartTransfer() to receive a selection without blocking.  The
+//			returned JXSelectionTransfer broadcasts each chunk as it arrives.
+//		GetData() sleeps while waiting for the selection owner instead of
+//			spinning.
+//	JXFileListTable:
+//		Added AddFiles() to insert many files with a single rebuild.
+//		RebuildTable() checks large lists in several threads and sorts the
+//			results once.  Adding literal text to the filter only checks
+//			the files that are already visible.
+//		Added ShouldUseFilterIndex() to skip files that cannot match the
+//			filter, using an index of the trigrams in each file name.
+//	JXApplication:
+//		Finished child processes broadcast during the next pass through the
+//			event loop, instead of being polled every 10 idle passes.
+
 // version 2.5.0:
 //	*** All egcs thunks hacks have been removed.
 //	JXWindow:
@@ -1132,10 +1132,15 @@ JXSearchTextDialog::InitXSearch()
 	JXDisplay* display      = GetDisplay();
 	const Window rootWindow = display->GetRootWindow();
 
-	itsXSearchSelectionName = display->RegisterXAtom(kXSearchSelectionXAtomName);
-	itsXSearchWindowsXAtom  = display->RegisterXAtom(kXSearchWindowsXAtomName);
-	itsXSearchVersionXAtom  = display->RegisterXAtom(kXSearchVersionXAtomName);
-	itsXSearchDataXAtom[0]  = display->RegisterXAtom(kXSearchDataV1XAtomName);
+	const JXDisplay::XAtomInfo atomInfo[] =
+		{
+		{ kXSearchSelectionXAtomName, &itsXSearchSelectionName },
+		{ kXSearchWindowsXAtomName,   &itsXSearchWindowsXAtom  },
+		{ kXSearchVersionXAtomName,   &itsXSearchVersionXAtom  },
+		{ kXSearchDataV1XAtomName,    itsXSearchDataXAtom      }
+		};
+
+	display->RegisterXAtoms(sizeof(atomInfo)/sizeof(JXDisplay::XAtomInfo), atomInfo);
 
 	itsVersionWindow = None;
 	itsDataWindow    = None;
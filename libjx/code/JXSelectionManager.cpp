@@ -10,6 +10,12 @@
 		We remove the unconverted types from JArray<Atom> and
 			fill in the JArray<char*> with the converted data
 
+	Large selections are sent incrementally (INCR) without blocking:  each
+	chunk is written when the requestor deletes the previous one, via
+	HandleTransferEvent().  StartTransfer() receives the same way, passing
+	each chunk to the caller as it arrives.  GetData() still blocks, for
+	code that needs the result immediately.
+
 	BASE CLASS = virtual JBroadcaster
 
 	Copyright  1996-99 by John Lindal. All rights reserved.
@@ -18,15 +24,21 @@
 
 #include <JXStdInc.h>
 #include <JXSelectionManager.h>
+#include <JXSelectionTransfer.h>
 #include <JXDNDManager.h>
 #include <JXDisplay.h>
 #include <JXWindow.h>
 #include <JXWidget.h>
+#include <JXTimerTask.h>
 #include <jXGlobals.h>
+#include <JTrace.h>
 #include <jTime.h>
 #include <string.h>
 #include <stdlib.h>
 #include <limits.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
 #include <X11/Xlib.h>
 #include <jAssert.h>
 
@@ -36,10 +48,18 @@
 
 const Time kHistoryInterval = 60000;	// 1 minute (milliseconds)
 
-const clock_t kWaitForSelectionTime = 5 * CLOCKS_PER_SEC;
-const clock_t kUserBoredWaitingTime = 1 * CLOCKS_PER_SEC;
+const Time kWaitForSelectionTime  = 5000;	// 5 seconds (milliseconds)
+const Time kUserBoredWaitingTime  = 1000;	// 1 second (milliseconds)
+const Time kTransferCheckInterval = 1000;	// 1 second (milliseconds)
+
+// XChangeProperty() must fit in one request, including its 6 word header.
+// Larger chunks would only make the server allocate more at once.
+
+const JSize kChangePropertyHeaderSize = 6;			// 4-byte blocks
+const JSize kMaxChunkSize             = 1 << 18;	// 4-byte blocks (1 MB)
 
 static const JCharacter* kSWPXAtomName             = "JXSelectionWindowProperty";
+static const JCharacter* kTransferXAtomNamePrefix  = "JXSelectionTransfer";
 static const JCharacter* kIncrementalXAtomName     = "INCR";
 static const JCharacter* kTargetsXAtomName         = "TARGETS";
 static const JCharacter* kTimeStampXAtomName       = "TIMESTAMP";
@@ -68,7 +88,26 @@ JXSelectionManager::JXSelectionManager
 	itsDataList = new JPtrArray<JXSelectionData>(JPtrArrayT::kDeleteAll);
 	assert( itsDataList != NULL );
 
-	itsMaxDataChunkSize = XMaxRequestSize(*display) * 4/5;
+	itsSendList = new JArray<SendInfo>;
+	assert( itsSendList != NULL );
+
+	itsTransferList = new JPtrArray<JXSelectionTransfer>(JPtrArrayT::kForgetAll);
+	assert( itsTransferList != NULL );
+
+	itsTransferPropertyList = new JArray<Atom>;
+	assert( itsTransferPropertyList != NULL );
+
+	itsTransferTimer = NULL;
+
+	// BIG-REQUESTS lets XChangeProperty() send much more at once
+
+	long maxRequestSize = XExtendedMaxRequestSize(*display);
+	if (maxRequestSize <= 0)
+		{
+		maxRequestSize = XMaxRequestSize(*display);
+		}
+	itsMaxDataChunkSize =
+		JMin((JSize) maxRequestSize, kMaxChunkSize) - kChangePropertyHeaderSize;
 
 	itsReceivedAllocErrorFlag  = kJFalse;
 	itsTargetWindow            = None;
@@ -96,22 +135,27 @@ JXSelectionManager::JXSelectionManager
 		mimePlainTextXAtomName += JString(charSetIndex, 0);
 		}
 
-	itsSelectionWindPropXAtom = itsDisplay->RegisterXAtom(kSWPXAtomName);
-	itsIncrementalSendXAtom   = itsDisplay->RegisterXAtom(kIncrementalXAtomName);
+	const JXDisplay::XAtomInfo atomInfo[] =
+		{
+		{ kSWPXAtomName,             &itsSelectionWindPropXAtom },
+		{ kIncrementalXAtomName,     &itsIncrementalSendXAtom   },
+
+		{ kTargetsXAtomName,         &itsTargetsXAtom           },
+		{ kTimeStampXAtomName,       &itsTimeStampXAtom         },
+		{ kTextXAtomName,            &itsTextXAtom              },
+		{ kCompoundTextXAtomName,    &itsCompoundTextXAtom      },
+		{ kUTF8StringXAtomName,      &itsUTF8StringXAtom        },
+		{ kMultipleXAtomName,        &itsMultipleXAtom          },
+		{ mimePlainTextXAtomName,    &itsMimePlainTextXAtom     },
+		{ kURLXAtomName,             &itsURLXAtom               },
 
-	itsTargetsXAtom           = itsDisplay->RegisterXAtom(kTargetsXAtomName);
-	itsTimeStampXAtom         = itsDisplay->RegisterXAtom(kTimeStampXAtomName);
-	itsTextXAtom              = itsDisplay->RegisterXAtom(kTextXAtomName);
-	itsCompoundTextXAtom      = itsDisplay->RegisterXAtom(kCompoundTextXAtomName);
-	itsUTF8StringXAtom        = itsDisplay->RegisterXAtom(kUTF8StringXAtomName);
-	itsMultipleXAtom          = itsDisplay->RegisterXAtom(kMultipleXAtomName);
-	itsMimePlainTextXAtom     = itsDisplay->RegisterXAtom(mimePlainTextXAtomName);
-	itsURLXAtom               = itsDisplay->RegisterXAtom(kURLXAtomName);
+		{ kDeleteSelectionXAtomName, &itsDeleteSelectionXAtom   },
+		{ kNULLXAtomName,            &itsNULLXAtom              },
 
-	itsDeleteSelectionXAtom   = itsDisplay->RegisterXAtom(kDeleteSelectionXAtomName);
-	itsNULLXAtom              = itsDisplay->RegisterXAtom(kNULLXAtomName);
+		{ kGnomeClipboardXAtomName,  &itsGnomeClipboardName     }
+		};
 
-	itsGnomeClipboardName     = itsDisplay->RegisterXAtom(kGnomeClipboardXAtomName);
+	itsDisplay->RegisterXAtoms(sizeof(atomInfo)/sizeof(JXDisplay::XAtomInfo), atomInfo);
 }
 
 /******************************************************************************
@@ -123,6 +167,18 @@ JXSelectionManager::~JXSelectionManager()
 {
 	delete itsDataList;
 
+	const JSize sendCount = itsSendList->GetElementCount();
+	for (JIndex i=1; i<=sendCount; i++)
+		{
+		delete [] (itsSendList->GetElement(i)).data;
+		}
+	delete itsSendList;
+
+	itsTransferList->DeleteAll();
+	delete itsTransferList;
+	delete itsTransferPropertyList;
+	delete itsTransferTimer;
+
 	XDestroyWindow(*itsDisplay, itsDataWindow);
 }
 
@@ -269,7 +325,7 @@ JXSelectionManager::GetData
 		// before initiating the incremental transfer.
 		{
 		XEvent xEvent;
-		XID checkIfEventData[] = { itsDataWindow, itsSelectionWindPropXAtom };
+		XID checkIfEventData[] = { itsDataWindow, itsSelectionWindPropXAtom, None };
 		while (XCheckIfEvent(*itsDisplay, &xEvent, GetNextNewPropertyEvent,
 							 reinterpret_cast<char*>(checkIfEventData)))
 			{
@@ -371,9 +427,394 @@ JXSelectionManager::SendDeleteRequest
 	DeleteData(&data, delMethod);
 }
 
+/******************************************************************************
+ StartTransfer
+
+	Asks the owner of the selection to convert it to requestType, without
+	waiting for the result.  Listen to the returned object to receive the
+	data.  It is deleted after it broadcasts Finished.
+
+	Returns kJFalse if nobody owns the selection.  time can be CurrentTime.
+
+ ******************************************************************************/
+
+JBoolean
+JXSelectionManager::StartTransfer
+	(
+	const Atom				selectionName,
+	const Time				origTime,
+	const Atom				requestType,
+	JXSelectionTransfer**	transfer
+	)
+{
+	assert( requestType != None );
+
+	*transfer = NULL;
+	if (XGetSelectionOwner(*itsDisplay, selectionName) == None)
+		{
+		return kJFalse;
+		}
+
+	Time time = origTime;
+	if (time == CurrentTime)
+		{
+		time = itsDisplay->GetLastEventTime();
+		}
+
+	// Each transfer gets its own property, so several can run at once.
+	// This also works when we own the selection, because sending does
+	// not block.
+
+	const Atom property = GetTransferProperty();
+
+	*transfer = new JXSelectionTransfer(selectionName, requestType, property,
+										(JXGetApplication())->GetCurrentTime());
+	assert( *transfer != NULL );
+	itsTransferList->Append(*transfer);
+	StartTransferTimer();
+
+	XConvertSelection(*itsDisplay, selectionName, requestType,
+					  property, itsDataWindow, time);
+	return kJTrue;
+}
+
+/******************************************************************************
+ GetTransferProperty (private)
+
+	Returns a property on itsDataWindow that is not used by any transfer.
+
+ ******************************************************************************/
+
+Atom
+JXSelectionManager::GetTransferProperty()
+{
+	const JSize count     = itsTransferPropertyList->GetElementCount();
+	const JSize sendCount = itsSendList->GetElementCount();
+	for (JIndex i=1; i<=count; i++)
+		{
+		const Atom property = itsTransferPropertyList->GetElement(i);
+
+		JXSelectionTransfer* transfer;
+		JBoolean inUse = FindTransfer(property, &transfer);
+		for (JIndex j=1; j<=sendCount && !inUse; j++)
+			{
+			const SendInfo info = itsSendList->GetElement(j);
+			inUse = JI2B(info.requestor == itsDataWindow && info.property == property);
+			}
+
+		if (!inUse)
+			{
+			return property;
+			}
+		}
+
+	JString name = kTransferXAtomNamePrefix;
+	name += JString(count+1, 0);
+
+	const Atom property = itsDisplay->RegisterXAtom(name);
+	itsTransferPropertyList->AppendElement(property);
+	return property;
+}
+
+/******************************************************************************
+ FindTransfer (private)
+
+ ******************************************************************************/
+
+JBoolean
+JXSelectionManager::FindTransfer
+	(
+	const Atom				property,
+	JXSelectionTransfer**	transfer
+	)
+	const
+{
+	const JSize count = itsTransferList->GetElementCount();
+	for (JIndex i=1; i<=count; i++)
+		{
+		*transfer = itsTransferList->NthElement(i);
+		if ((**transfer).itsProperty == property)
+			{
+			return kJTrue;
+			}
+		}
+
+	*transfer = NULL;
+	return kJFalse;
+}
+
+/******************************************************************************
+ HandleSelectionNotify
+
+	Called by JXDisplay with the response to StartTransfer().
+
+ ******************************************************************************/
+
+void
+JXSelectionManager::HandleSelectionNotify
+	(
+	const XSelectionEvent& selEvent
+	)
+{
+	if (selEvent.requestor != itsDataWindow)
+		{
+		return;
+		}
+
+	// If the conversion was refused, we have to find the transfer
+	// by what it asked for.
+
+	JXSelectionTransfer* transfer = NULL;
+	if (selEvent.property != None)
+		{
+		FindTransfer(selEvent.property, &transfer);
+		}
+	else
+		{
+		const JSize count = itsTransferList->GetElementCount();
+		for (JIndex i=1; i<=count; i++)
+			{
+			JXSelectionTransfer* t = itsTransferList->NthElement(i);
+			if (t->itsOwner         == None &&
+				t->itsSelectionName == selEvent.selection &&
+				t->itsRequestType   == selEvent.target)
+				{
+				transfer = t;
+				break;
+				}
+			}
+		}
+
+	if (transfer == NULL || transfer->itsOwner != None)
+		{
+		return;		// probably a response that GetData() gave up on
+		}
+	else if (selEvent.property == None)
+		{
+		FinishTransfer(transfer, kJFalse);
+		return;
+		}
+
+	Atom actualType;
+	int actualFormat;
+	unsigned long itemCount, remainingBytes;
+	unsigned char* data = NULL;
+	XGetWindowProperty(*itsDisplay, itsDataWindow, transfer->itsProperty,
+					   0, LONG_MAX, True, AnyPropertyType,
+					   &actualType, &actualFormat,
+					   &itemCount, &remainingBytes, &data);
+
+	const Time currTime = (JXGetApplication())->GetCurrentTime();
+	if (actualType == itsIncrementalSendXAtom)
+		{
+		XFree(data);
+
+		// Deleting the property started the transfer.  We need to hear
+		// when the sender crashes.
+
+		const Window owner = XGetSelectionOwner(*itsDisplay, transfer->itsSelectionName);
+		if (owner == None)
+			{
+			FinishTransfer(transfer, kJFalse);
+			}
+		else
+			{
+			#if JXSEL_DEBUG_MSGS && ! JXSEL_DEBUG_ONLY_RESULT
+			cout << "Initiating incremental receive" << endl;
+			#endif
+
+			transfer->itsOwner            = owner;
+			transfer->itsLastActivityTime = currTime;
+			UpdateEventMask(owner);
+			}
+		}
+	else if (actualType != None && remainingBytes == 0)
+		{
+		transfer->ChunkReceived(actualType, data, itemCount * actualFormat/8,
+								actualFormat, currTime);
+		XFree(data);
+		FinishTransfer(transfer, kJTrue);
+		}
+	else
+		{
+		XFree(data);
+		FinishTransfer(transfer, kJFalse);
+		}
+}
+
+/******************************************************************************
+ HandleTransferEvent
+
+	Called by JXDisplay to move incremental transfers along.  DestroyNotify
+	is never swallowed, since other objects may be watching the window.
+
+ ******************************************************************************/
+
+JBoolean
+JXSelectionManager::HandleTransferEvent
+	(
+	const XEvent& xEvent
+	)
+{
+	if (xEvent.type == PropertyNotify)
+		{
+		const XPropertyEvent& propEvent = xEvent.xproperty;
+
+		JXSelectionTransfer* transfer;
+		if (propEvent.state  == PropertyNewValue &&
+			propEvent.window == itsDataWindow &&
+			FindTransfer(propEvent.atom, &transfer) &&
+			transfer->itsOwner != None)
+			{
+			ReceiveChunk(transfer);
+			return kJTrue;
+			}
+		else if (propEvent.state == PropertyDelete)
+			{
+			const JSize count = itsSendList->GetElementCount();
+			for (JIndex i=1; i<=count; i++)
+				{
+				const SendInfo info = itsSendList->GetElement(i);
+				if (info.requestor == propEvent.window &&
+					info.property  == propEvent.atom)
+					{
+					SendNextChunk(i);
+					return kJTrue;
+					}
+				}
+			}
+		}
+
+	else if (xEvent.type == DestroyNotify)
+		{
+		const Window xWindow = xEvent.xdestroywindow.window;
+
+		for (JIndex i=itsSendList->GetElementCount(); i>=1; i--)
+			{
+			if ((itsSendList->GetElement(i)).requestor == xWindow)
+				{
+				#if JXSEL_DEBUG_MSGS
+				cout << "Requestor crashed" << endl;
+				#endif
+
+				FinishSend(i, kJFalse);
+				}
+			}
+
+		for (JIndex j=itsTransferList->GetElementCount(); j>=1; j--)
+			{
+			JXSelectionTransfer* transfer = itsTransferList->NthElement(j);
+			if (transfer->itsOwner == xWindow)
+				{
+				#if JXSEL_DEBUG_MSGS
+				cout << "Selection owner crashed" << endl;
+				#endif
+
+				FinishTransfer(transfer, kJFalse, kJFalse);
+				}
+			}
+		}
+
+	return kJFalse;
+}
+
+/******************************************************************************
+ ReceiveChunk (private)
+
+	Retrieves and deletes the next chunk of an incremental transfer.  An
+	empty property means that we are done.
+
+ ******************************************************************************/
+
+void
+JXSelectionManager::ReceiveChunk
+	(
+	JXSelectionTransfer* transfer
+	)
+{
+	Atom actualType;
+	int actualFormat;
+	unsigned long itemCount, remainingBytes;
+	unsigned char* chunk = NULL;
+	XGetWindowProperty(*itsDisplay, itsDataWindow, transfer->itsProperty,
+					   0, LONG_MAX, True, AnyPropertyType,
+					   &actualType, &actualFormat,
+					   &itemCount, &remainingBytes, &chunk);
+
+	if (actualType == None)
+		{
+		#if JXSEL_DEBUG_MSGS
+		cout << "Received data of type None" << endl;
+		#endif
+
+		XFree(chunk);
+		FinishTransfer(transfer, kJFalse);
+		}
+	else if (itemCount == 0)
+		{
+		XFree(chunk);
+		FinishTransfer(transfer, kJTrue);
+		}
+	else
+		{
+		assert( remainingBytes == 0 );
+
+		// pass Xlib's buffer straight through -- the listener copies
+		// only what it needs
+
+		const JSize chunkSize = itemCount * actualFormat/8;
+		transfer->ChunkReceived(actualType, chunk, chunkSize, actualFormat,
+								(JXGetApplication())->GetCurrentTime());
+		XFree(chunk);
+
+		#if JXSEL_DEBUG_MSGS && ! JXSEL_DEBUG_ONLY_RESULT
+		cout << "Received " << chunkSize << " bytes" << endl;
+		#endif
+		}
+}
+
+/******************************************************************************
+ FinishTransfer (private)
+
+	Removes the transfer, notifies the listeners, and deletes it.  If the
+	owner's window has been destroyed, we must not touch it.
+
+ ******************************************************************************/
+
+void
+JXSelectionManager::FinishTransfer
+	(
+	JXSelectionTransfer*	transfer,
+	const JBoolean			success,
+	const JBoolean			ownerExists
+	)
+{
+	itsTransferList->Remove(transfer);
+
+	if (!success)
+		{
+		XDeleteProperty(*itsDisplay, itsDataWindow, transfer->itsProperty);
+		}
+
+	if (transfer->itsOwner != None && ownerExists)
+		{
+		UpdateEventMask(transfer->itsOwner);
+		}
+
+	#if JXSEL_DEBUG_MSGS
+	cout << "Transfer " << (success ? "successful" : "failed") << endl;
+	#endif
+
+	transfer->TransferFinished(success);
+	delete transfer;
+}
+
 /******************************************************************************
  RequestData (private)
 
+	Used by GetData() and GetAvailableTypes(), which must block until the
+	data arrives.
+
  ******************************************************************************/
 
 JBoolean
@@ -387,8 +828,6 @@ JXSelectionManager::RequestData
 {
 	assert( type != None );
 
-	JXDNDManager* dndMgr = itsDisplay->GetDNDManager();
-
 	Time time = origTime;
 	if (time == CurrentTime)
 		{
@@ -398,36 +837,103 @@ JXSelectionManager::RequestData
 	XConvertSelection(*itsDisplay, selectionName, type,
 					  itsSelectionWindPropXAtom, itsDataWindow, time);
 
-	Bool receivedEvent = False;
+	// only take our own response, since transfers may be in progress
+
 	XEvent xEvent;
-	const clock_t startTime = clock();
-	const clock_t endTime   = startTime + kWaitForSelectionTime;
-	JBoolean userBored      = kJFalse;
-	while (!receivedEvent && clock() < endTime)
+	XID checkIfEventData[] =
+		{ itsDataWindow, selectionName, type, itsSelectionWindPropXAtom };
+	if (WaitForEvent(GetNextSelectionNotifyEvent, checkIfEventData, &xEvent))
+		{
+		*selEvent = xEvent.xselection;
+		return JI2B( selEvent->property == itsSelectionWindPropXAtom );
+		}
+	else
+		{
+		return kJFalse;
+		}
+}
+
+// static
+
+Bool
+JXSelectionManager::GetNextSelectionNotifyEvent
+	(
+	Display*	display,
+	XEvent*		event,
+	char*		arg
+	)
+{
+	XID* data = reinterpret_cast<XID*>(arg);
+
+	if (event->type                 == SelectionNotify &&
+		event->xselection.requestor == data[0] &&
+		event->xselection.selection == data[1] &&
+		event->xselection.target    == data[2] &&
+		(event->xselection.property == data[3] ||
+		 event->xselection.property == None))
+		{
+		return True;
+		}
+	else
 		{
-		receivedEvent =
-			XCheckTypedWindowEvent(*itsDisplay, itsDataWindow,
-								   SelectionNotify, &xEvent);
+		return False;
+		}
+}
+
+/******************************************************************************
+ WaitForEvent (private)
+
+	Sleeps until an event matching the predicate arrives, instead of
+	spinning.  Returns kJFalse if we time out.
+
+ ******************************************************************************/
+
+JBoolean
+JXSelectionManager::WaitForEvent
+	(
+	Bool	(*predicate)(Display*, XEvent*, char*),
+	XID*	arg,
+	XEvent*	xEvent
+	)
+{
+	const int fd = ConnectionNumber((Display*) *itsDisplay);
+
+	const JTraceTime startTime = JTrace::GetTime();
+	JBoolean userBored         = kJFalse;
+	while (1)
+		{
+		// XCheckIfEvent() flushes the output buffer and reads whatever
+		// the server has sent.
+
+		if (XCheckIfEvent(*itsDisplay, xEvent, predicate,
+						  reinterpret_cast<char*>(arg)))
+			{
+			return kJTrue;
+			}
 
-		if (!userBored && clock() > startTime + kUserBoredWaitingTime)
+		const Time elapsed = (JTrace::GetTime() - startTime) / 1000000;
+		if (elapsed >= kWaitForSelectionTime)
+			{
+			return kJFalse;
+			}
+		else if (!userBored && elapsed >= kUserBoredWaitingTime)
 			{
 			userBored = kJTrue;
 			(JXGetApplication())->DisplayBusyCursor();
 			}
-		}
 
-	if (receivedEvent)
-		{
-		assert( xEvent.type == SelectionNotify );
-		*selEvent = xEvent.xselection;
-		return JI2B(selEvent->requestor == itsDataWindow &&
-					selEvent->selection == selectionName &&
-					selEvent->target    == type &&
-					selEvent->property  == itsSelectionWindPropXAtom );
-		}
-	else
-		{
-		return kJFalse;
+		const Time wait =
+			(userBored ? kWaitForSelectionTime : kUserBoredWaitingTime) - elapsed;
+
+		fd_set readSet;
+		FD_ZERO(&readSet);
+		FD_SET(fd, &readSet);
+
+		timeval timeout;
+		timeout.tv_sec  = wait / 1000;
+		timeout.tv_usec = (wait % 1000) * 1000;
+
+		select(fd+1, &readSet, NULL, NULL, &timeout);
 		}
 }
 
@@ -489,22 +995,8 @@ JXSelectionManager::HandleSelectionRequest
 			cout << ", time=" << selReqEvent.time << endl;
 			#endif
 
-			#if JXSEL_MICRO_TRANSFER
-			const JSize savedMaxSize = itsMaxDataChunkSize;
-			if (selReqEvent.target != itsTargetsXAtom)
-				{
-				itsMaxDataChunkSize = 1;
-				}
-			#endif
-
 			SendData(selReqEvent.requestor, returnEvent.property, returnType,
 					 data, dataLength, bitsPerBlock, &xEvent);
-			delete [] data;
-
-			#if JXSEL_MICRO_TRANSFER
-			itsMaxDataChunkSize = savedMaxSize;
-			#endif
-
 			return;
 			}
 		else
@@ -532,7 +1024,12 @@ JXSelectionManager::HandleSelectionRequest
 /******************************************************************************
  SendData (private)
 
-	Sends the given data either as one chunk or incrementally.
+	Sends the given data either as one chunk or incrementally.  We take
+	ownership of the data.
+
+	An incremental transfer only starts here.  Each time the requestor
+	deletes the property, HandleTransferEvent() sends the next chunk, so
+	the event loop keeps running.
 
  ******************************************************************************/
 
@@ -550,6 +1047,13 @@ JXSelectionManager::SendData
 {
 	JSize chunkSize = 4*itsMaxDataChunkSize;
 
+	#if JXSEL_MICRO_TRANSFER
+	if (type != XA_ATOM)
+		{
+		chunkSize = 4;
+		}
+	#endif
+
 	// if small enough, send it one chunk
 
 	#if JXSEL_DEBUG_MSGS && ! JXSEL_DEBUG_ONLY_RESULT
@@ -568,13 +1072,34 @@ JXSelectionManager::SendData
 		cout << "Transfer complete" << endl;
 		#endif
 
+		delete [] data;
 		itsDisplay->SendXEvent(requestor, returnEvent);
 		return;
 		}
+	else if (dataLength <= chunkSize && itsTargetWindowDeletedFlag)
+		{
+		delete [] data;
+		return;
+		}
+
+	// remember what to send
+
+	SendInfo info;
+	info.requestor        = requestor;
+	info.property         = property;
+	info.type             = type;
+	info.data             = data;
+	info.dataLength       = dataLength;
+	info.bitsPerBlock     = bitsPerBlock;
+	info.chunkSize        = chunkSize;
+	info.offset           = 0;
+	info.lastActivityTime = (JXGetApplication())->GetCurrentTime();
+	itsSendList->AppendElement(info);
 
 	// we need to hear when the property or the window is deleted
 
-	XSelectInput(*itsDisplay, requestor, PropertyChangeMask | StructureNotifyMask);
+	UpdateEventMask(requestor);
+	StartTransferTimer();
 
 	// initiate transfer by sending INCR
 
@@ -582,102 +1107,207 @@ JXSelectionManager::SendData
 	cout << "Initiating incremental transfer" << endl;
 	#endif
 
-	(JXGetApplication())->DisplayBusyCursor();
-
 	XID remainingLength = dataLength;		// must be 32 bits
 	XChangeProperty(*itsDisplay, requestor, property, itsIncrementalSendXAtom,
 					32, PropModeReplace,
 					reinterpret_cast<unsigned char*>(&remainingLength), 1);
 	itsDisplay->SendXEvent(requestor, returnEvent);
-	if (!WaitForPropertyDeleted(requestor, property))
-		{
-		#if JXSEL_DEBUG_MSGS
-		cout << "No response from requestor (data length)" << endl;
-		#endif
+}
 
-		return;
-		}
+/******************************************************************************
+ SendNextChunk (private)
 
-	// send a chunk and wait for it to be deleted
+	The requestor deleted the property, so it is ready for more.  After
+	the last chunk, we send an empty property to signal that we are done.
 
-	#if JXSEL_DEBUG_MSGS
-	JIndex chunkIndex = 0;
-	#endif
+ ******************************************************************************/
+
+void
+JXSelectionManager::SendNextChunk
+	(
+	const JIndex index
+	)
+{
+	SendInfo info         = itsSendList->GetElement(index);
+	info.lastActivityTime = (JXGetApplication())->GetCurrentTime();
 
-	while (remainingLength > 0)
+	const JSize remainingLength = info.dataLength - info.offset;
+	if (remainingLength == 0)
 		{
+		SendData1(info.requestor, info.property, info.type, info.data, 0, 8);
+		FinishSend(index, JNegate(itsTargetWindowDeletedFlag));
+
 		#if JXSEL_DEBUG_MSGS
-		chunkIndex++;
+		cout << "Transfer complete" << endl;
 		#endif
 
-		unsigned char* dataStart = data + dataLength - remainingLength;
-		if (chunkSize > remainingLength)
-			{
-			chunkSize = remainingLength;
-			}
+		return;
+		}
+
+	while (1)
+		{
+		const JSize chunkSize = JMin(info.chunkSize, remainingLength);
 
 		#if JXSEL_DEBUG_MSGS && ! JXSEL_DEBUG_ONLY_RESULT
 		cout << "Sending " << chunkSize << " bytes" << endl;
 		#endif
 
-		SendData1(requestor, property, type,
-				  dataStart, chunkSize, bitsPerBlock);
-		if (itsTargetWindowDeletedFlag)
+		if (SendData1(info.requestor, info.property, info.type,
+					  info.data + info.offset, chunkSize, info.bitsPerBlock))
+			{
+			info.offset += chunkSize;
+			itsSendList->SetElement(index, info);
+			return;
+			}
+		else if (itsTargetWindowDeletedFlag)
 			{
 			#if JXSEL_DEBUG_MSGS
-			cout << "Requestor crashed on iteration ";
-			cout << chunkIndex << endl;
+			cout << "Requestor crashed after " << info.offset << " bytes" << endl;
 			#endif
+
+			FinishSend(index, kJFalse);
 			return;
 			}
-		else if (itsReceivedAllocErrorFlag && itsMaxDataChunkSize > 1)
+		else if (info.chunkSize > 4)
 			{
-			itsMaxDataChunkSize /= 2;
-			chunkSize            = 4*itsMaxDataChunkSize;
+			info.chunkSize      = 4*(info.chunkSize/8);
+			itsMaxDataChunkSize = JMin(itsMaxDataChunkSize, info.chunkSize/4);
 
 			#if JXSEL_DEBUG_MSGS && ! JXSEL_DEBUG_ONLY_RESULT
-			cout << "Reducing chunk size to " << chunkSize << " bytes" << endl;
+			cout << "Reducing chunk size to " << info.chunkSize << " bytes" << endl;
 			#endif
 			}
-		else if (itsReceivedAllocErrorFlag)
+		else
 			{
 			#if JXSEL_DEBUG_MSGS
 			cout << "X server is out of memory!" << endl;
 			#endif
 
-			XSelectInput(*itsDisplay, requestor, NoEventMask);
+			FinishSend(index, kJTrue);
 			return;
 			}
+		}
+}
+
+/******************************************************************************
+ FinishSend (private)
+
+	If the requestor's window has been destroyed, we must not touch it.
+
+ ******************************************************************************/
+
+void
+JXSelectionManager::FinishSend
+	(
+	const JIndex	index,
+	const JBoolean	requestorExists
+	)
+{
+	const SendInfo info = itsSendList->GetElement(index);
+	itsSendList->RemoveElement(index);
+	delete [] info.data;
+
+	if (requestorExists)
+		{
+		UpdateEventMask(info.requestor);
+		}
+}
+
+/******************************************************************************
+ UpdateEventMask (private)
+
+	Selects the events that we need from another client's window,
+	based on the transfers that involve it.
+
+ ******************************************************************************/
+
+void
+JXSelectionManager::UpdateEventMask
+	(
+	const Window xWindow
+	)
+{
+	if (xWindow == itsDataWindow)
+		{
+		return;		// always listening for PropertyNotify
+		}
 
-		if (!WaitForPropertyDeleted(requestor, property))
+	long mask = NoEventMask;
+
+	const JSize sendCount = itsSendList->GetElementCount();
+	for (JIndex i=1; i<=sendCount; i++)
+		{
+		if ((itsSendList->GetElement(i)).requestor == xWindow)
 			{
-			#if JXSEL_DEBUG_MSGS
-			cout << "No response from requestor on iteration ";
-			cout << chunkIndex << ", " << dataLength - remainingLength;
-			cout << " bytes sent, " << remainingLength;
-			cout << " bytes remaining, chunk size " << chunkSize << endl;
-			#endif
+			mask |= PropertyChangeMask | StructureNotifyMask;
+			}
+		}
 
-			return;
+	const JSize transferCount = itsTransferList->GetElementCount();
+	for (JIndex j=1; j<=transferCount; j++)
+		{
+		if ((itsTransferList->NthElement(j))->itsOwner == xWindow)
+			{
+			mask |= StructureNotifyMask;
 			}
+		}
+
+	XSelectInput(*itsDisplay, xWindow, mask);
+}
+
+/******************************************************************************
+ StartTransferTimer (private)
+
+ ******************************************************************************/
 
-		remainingLength -= chunkSize;
+void
+JXSelectionManager::StartTransferTimer()
+{
+	if (itsTransferTimer == NULL)
+		{
+		itsTransferTimer = new JXTimerTask(kTransferCheckInterval);
+		assert( itsTransferTimer != NULL );
+		(JXGetApplication())->InstallIdleTask(itsTransferTimer);
+		ListenTo(itsTransferTimer);
 		}
+}
 
-	// send zero-length property to signal that we are done
+/******************************************************************************
+ CheckTransferTimeouts (private)
+
+	Abandons transfers when the other side stops responding.
 
-	SendData1(requestor, property, type, data, 0, 8);
+ ******************************************************************************/
 
-	// we are done interacting with the requestor
+void
+JXSelectionManager::CheckTransferTimeouts()
+{
+	const Time currTime = (JXGetApplication())->GetCurrentTime();
 
-	if (!itsTargetWindowDeletedFlag)
+	for (JIndex i=itsSendList->GetElementCount(); i>=1; i--)
 		{
-		XSelectInput(*itsDisplay, requestor, NoEventMask);
+		if (currTime - (itsSendList->GetElement(i)).lastActivityTime > kWaitForSelectionTime)
+			{
+			#if JXSEL_DEBUG_MSGS
+			cout << "No response from requestor" << endl;
+			#endif
+
+			FinishSend(i, kJTrue);
+			}
 		}
 
-	#if JXSEL_DEBUG_MSGS
-	cout << "Transfer complete" << endl;
-	#endif
+	for (JIndex j=itsTransferList->GetElementCount(); j>=1; j--)
+		{
+		JXSelectionTransfer* transfer = itsTransferList->NthElement(j);
+		if (currTime - transfer->itsLastActivityTime > kWaitForSelectionTime)
+			{
+			#if JXSEL_DEBUG_MSGS
+			cout << "No response from selection owner" << endl;
+			#endif
+
+			FinishTransfer(transfer, kJFalse);
+			}
+		}
 }
 
 /******************************************************************************
@@ -718,104 +1348,12 @@ JXSelectionManager::SendData1
 	return JNegate(itsReceivedAllocErrorFlag || itsTargetWindowDeletedFlag);
 }
 
-/******************************************************************************
- WaitForPropertyDeleted (private)
-
-	Wait for the receiver to delete the window property.
-	Returns kJFalse if we time out or the window is deleted (receiver crash).
-
- ******************************************************************************/
-
-JBoolean
-JXSelectionManager::WaitForPropertyDeleted
-	(
-	const Window	xWindow,
-	const Atom		property
-	)
-{
-	itsDisplay->Synchronize();
-
-	XEvent xEvent;
-	XID checkIfEventData[] = { xWindow, property };
-	const clock_t endTime = clock() + kWaitForSelectionTime;
-	while (clock() < endTime)
-		{
-		const Bool receivedEvent =
-			XCheckIfEvent(*itsDisplay, &xEvent, GetNextPropDeletedEvent,
-						  reinterpret_cast<char*>(&checkIfEventData));
-
-		if (receivedEvent && xEvent.type == PropertyNotify)
-			{
-			return kJTrue;
-			}
-		else if (receivedEvent && xEvent.type == DestroyNotify)
-			{
-			return kJFalse;
-			}
-		}
-
-	#if JXSEL_DEBUG_MSGS
-
-	Atom actualType;
-	int actualFormat;
-	unsigned long itemCount, remainingBytes;
-	unsigned char* data;
-	XGetWindowProperty(*itsDisplay, xWindow, property,
-					   0, LONG_MAX, False, AnyPropertyType,
-					   &actualType, &actualFormat,
-					   &itemCount, &remainingBytes, &data);
-
-	if (actualType == None && actualFormat == 0 && remainingBytes == 0)
-		{
-		cout << "Window property was deleted, but source was not notified!" << endl;
-		}
-	else
-		{
-		cout << "Window property not deleted, type " << XGetAtomName(*itsDisplay, actualType);
-		cout << ", " << itemCount * actualFormat/8 << " bytes" << endl;
-		}
-	XFree(data);
-
-	#endif
-
-	XSelectInput(*itsDisplay, xWindow, NoEventMask);
-	return kJFalse;
-}
-
-// static
-
-Bool
-JXSelectionManager::GetNextPropDeletedEvent
-	(
-	Display*	display,
-	XEvent*		event,
-	char*		arg
-	)
-{
-	XID* data = reinterpret_cast<XID*>(arg);
-
-	if (event->type             == PropertyNotify &&
-		event->xproperty.window == data[0] &&
-		event->xproperty.atom   == data[1] &&
-		event->xproperty.state  == PropertyDelete)
-		{
-		return True;
-		}
-	else if (event->type                  == DestroyNotify &&
-			 event->xdestroywindow.window == data[0])
-		{
-		return True;
-		}
-	else
-		{
-		return False;
-		}
-}
-
 /******************************************************************************
  ReceiveDataIncr (private)
 
-	Receives the current selection data incrementally.
+	Receives the current selection data incrementally, for GetData().
+	The buffer grows geometrically, so large selections are not copied
+	once per chunk.
 
  ******************************************************************************/
 
@@ -858,14 +1396,19 @@ JXSelectionManager::ReceiveDataIncr
 	JIndex chunkIndex = 0;
 	#endif
 
-	JBoolean ok = kJTrue;
+	XID checkIfEventData[] = { itsDataWindow, itsSelectionWindPropXAtom, sender };
+
+	JSize bufferSize = 0;
+	JBoolean ok      = kJTrue;
 	while (1)
 		{
 		#if JXSEL_DEBUG_MSGS
 		chunkIndex++;
 		#endif
 
-		if (!WaitForPropertyCreated(itsDataWindow, itsSelectionWindPropXAtom, sender))
+		XEvent xEvent;
+		if (!WaitForEvent(GetNextNewPropertyEvent, checkIfEventData, &xEvent) ||
+			xEvent.type == DestroyNotify)
 			{
 			#if JXSEL_DEBUG_MSGS
 			cout << "No response from selection owner on iteration ";
@@ -925,20 +1468,19 @@ JXSelectionManager::ReceiveDataIncr
 				// the first chunk determines the format
 				*returnType = actualType;
 
-				*data = static_cast<unsigned char*>(malloc(chunkSize));
-				assert( *data != NULL );
-				memcpy(*data, chunk, chunkSize);
-
 				#if JXSEL_DEBUG_MSGS && ! JXSEL_DEBUG_ONLY_RESULT
 				cout << "Data format: " << XGetAtomName(*itsDisplay, actualType) << endl;
 				#endif
 				}
-			else
+
+			if (*dataLength + chunkSize > bufferSize)
 				{
-				*data = static_cast<unsigned char*>(realloc(*data, *dataLength + chunkSize));
-				memcpy(*data + *dataLength, chunk, chunkSize);
+				bufferSize = JMax(2 * bufferSize, *dataLength + chunkSize);
+				*data = static_cast<unsigned char*>(realloc(*data, bufferSize));
+				assert( *data != NULL );
 				}
 
+			memcpy(*data + *dataLength, chunk, chunkSize);
 			*dataLength += chunkSize;
 			XFree(chunk);
 
@@ -976,44 +1518,6 @@ JXSelectionManager::ReceiveDataIncr
 	return ok;
 }
 
-/******************************************************************************
- WaitForPropertyCreated (private)
-
-	Wait for the receiver to create the window property.
-	Returns kJFalse if we time out or the sender crashes.
-
- ******************************************************************************/
-
-JBoolean
-JXSelectionManager::WaitForPropertyCreated
-	(
-	const Window	xWindow,
-	const Atom		property,
-	const Window	sender
-	)
-{
-	itsDisplay->Synchronize();
-
-	XEvent xEvent;
-	XID checkIfEventData[] = { xWindow, property };
-	const clock_t endTime = clock() + kWaitForSelectionTime;
-	while (clock() < endTime)
-		{
-		if (XCheckTypedWindowEvent(*itsDisplay, sender, DestroyNotify, &xEvent))
-			{
-			return kJFalse;
-			}
-
-		if (XCheckIfEvent(*itsDisplay, &xEvent, GetNextNewPropertyEvent,
-						  reinterpret_cast<char*>(checkIfEventData)))
-			{
-			return kJTrue;
-			}
-		}
-
-	return kJFalse;
-}
-
 // static
 
 Bool
@@ -1033,12 +1537,40 @@ JXSelectionManager::GetNextNewPropertyEvent
 		{
 		return True;
 		}
+	else if (event->type                  == DestroyNotify &&
+			 event->xdestroywindow.window == data[2])
+		{
+		return True;		// sender crashed
+		}
 	else
 		{
 		return False;
 		}
 }
 
+/******************************************************************************
+ Receive (virtual protected)
+
+ ******************************************************************************/
+
+void
+JXSelectionManager::Receive
+	(
+	JBroadcaster*	sender,
+	const Message&	message
+	)
+{
+	if (sender == itsTransferTimer && message.Is(JXTimerTask::kTimerWentOff))
+		{
+		CheckTransferTimeouts();
+		}
+
+	else
+		{
+		JBroadcaster::Receive(sender, message);
+		}
+}
+
 /******************************************************************************
  ReceiveWithFeedback (virtual protected)
 
@@ -1260,3 +1792,7 @@ JXSelectionManager::DeleteOutdatedData()
 			}
 		}
 }
+
+#define JTemplateType JXSelectionManager::SendInfo
+#include <JArray.tmpls>
+#undef JTemplateType
@@ -16,6 +16,9 @@
 
 const Atom kJXClipboardName = XA_PRIMARY;
 
+class JXSelectionTransfer;
+class JXTimerTask;
+
 class JXSelectionManager : virtual public JBroadcaster
 {
 	friend class JXDNDManager;
@@ -43,6 +46,10 @@ public:
 						DeleteMethod* delMethod);
 	void		DeleteData(unsigned char** data, const DeleteMethod delMethod);
 
+	JBoolean	StartTransfer(const Atom selectionName, const Time time,
+							  const Atom requestType,
+							  JXSelectionTransfer** transfer);
+
 	void	SendDeleteRequest(const Atom selectionName, const Time time);
 
 	JBoolean	OwnedSelection(const Atom selectionName, const Time time);
@@ -66,18 +73,41 @@ public:
 
 	// called by JXDisplay
 
-	void	HandleSelectionRequest(const XSelectionRequestEvent& selReqEvent);
+	void		HandleSelectionRequest(const XSelectionRequestEvent& selReqEvent);
+	void		HandleSelectionNotify(const XSelectionEvent& selEvent);
+	JBoolean	HandleTransferEvent(const XEvent& xEvent);
 
 protected:
 
+	virtual void	Receive(JBroadcaster* sender, const Message& message);
 	virtual void	ReceiveWithFeedback(JBroadcaster* sender, Message* message);
 
+private:
+
+	struct SendInfo
+	{
+		Window			requestor;
+		Atom			property;
+		Atom			type;
+		unsigned char*	data;			// we own it
+		JSize			dataLength;
+		JSize			bitsPerBlock;
+		JSize			chunkSize;		// bytes
+		JIndex			offset;			// bytes already sent
+		Time			lastActivityTime;
+	};
+
 private:
 
 	JXDisplay*					itsDisplay;		// owns us
 	Window						itsDataWindow;
 	JPtrArray<JXSelectionData>*	itsDataList;	// current + recent
 
+	JArray<SendInfo>*				itsSendList;				// incremental sends in progress
+	JPtrArray<JXSelectionTransfer>*	itsTransferList;			// asynchronous receives in progress
+	JArray<Atom>*					itsTransferPropertyList;	// one per active transfer
+	JXTimerTask*					itsTransferTimer;			// NULL until first transfer
+
 	JSize		itsMaxDataChunkSize;	// max # of 4-byte blocks that we can send
 	JBoolean	itsReceivedAllocErrorFlag;
 	Window		itsTargetWindow;
@@ -102,6 +132,7 @@ private:
 
 	JBoolean	RequestData(const Atom selectionName, const Time time,
 							const Atom type, XSelectionEvent* selEvent);
+	static Bool	GetNextSelectionNotifyEvent(Display* display, XEvent* event, char* arg);
 
 	void		SendData(const Window requestor, const Atom property,
 						 const Atom type, unsigned char* data,
@@ -110,15 +141,24 @@ private:
 	JBoolean	SendData1(const Window requestor, const Atom property,
 						  const Atom type, unsigned char* data,
 						  const JSize dataLength, const JSize bitsPerBlock);
-	JBoolean	WaitForPropertyDeleted(const Window xWindow, const Atom property);
-	static Bool	GetNextPropDeletedEvent(Display* display, XEvent* event, char* arg);
+	void		SendNextChunk(const JIndex index);
+	void		FinishSend(const JIndex index, const JBoolean requestorExists);
 
 	JBoolean	ReceiveDataIncr(const Atom selectionName,
 								Atom* returnType, unsigned char** data,
 								JSize* dataLength, DeleteMethod* delMethod);
-	JBoolean	WaitForPropertyCreated(const Window xWindow, const Atom property,
-									   const Window sender);
 	static Bool	GetNextNewPropertyEvent(Display* display, XEvent* event, char* arg);
+	JBoolean	WaitForEvent(Bool (*predicate)(Display*, XEvent*, char*),
+							 XID* arg, XEvent* xEvent);
+
+	Atom		GetTransferProperty();
+	JBoolean	FindTransfer(const Atom property, JXSelectionTransfer** transfer) const;
+	void		ReceiveChunk(JXSelectionTransfer* transfer);
+	void		FinishTransfer(JXSelectionTransfer* transfer, const JBoolean success,
+							   const JBoolean ownerExists = kJTrue);
+	void		UpdateEventMask(const Window xWindow);
+	void		StartTransferTimer();
+	void		CheckTransferTimeouts();
 
 	JBoolean	GetData(const Atom selectionName, const Time time,
 						JXSelectionData** data, JIndex* index = NULL);
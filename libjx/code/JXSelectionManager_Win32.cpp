@@ -145,6 +145,66 @@ JXSelectionManager::HandleSelectionRequest
 {
 }
 
+/******************************************************************************
+ StartTransfer
+
+ ******************************************************************************/
+
+JBoolean
+JXSelectionManager::StartTransfer
+	(
+	const Atom				selectionName,
+	const Time				time,
+	const Atom				requestType,
+	JXSelectionTransfer**	transfer
+	)
+{
+	*transfer = NULL;
+	return kJFalse;
+}
+
+/******************************************************************************
+ HandleSelectionNotify
+
+ ******************************************************************************/
+
+void
+JXSelectionManager::HandleSelectionNotify
+	(
+	const XSelectionEvent& selEvent
+	)
+{
+}
+
+/******************************************************************************
+ HandleTransferEvent
+
+ ******************************************************************************/
+
+JBoolean
+JXSelectionManager::HandleTransferEvent
+	(
+	const XEvent& xEvent
+	)
+{
+	return kJFalse;
+}
+
+/******************************************************************************
+ Receive (virtual protected)
+
+ ******************************************************************************/
+
+void
+JXSelectionManager::Receive
+	(
+	JBroadcaster*	sender,
+	const Message&	message
+	)
+{
+	JBroadcaster::Receive(sender, message);
+}
+
 /******************************************************************************
  ReceiveWithFeedback (virtual protected)
 
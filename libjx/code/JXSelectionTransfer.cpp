@@ -0,0 +1,115 @@
+/******************************************************************************
+ JXSelectionTransfer.cpp
+
+	Represents one asynchronous request for selection data.  Created by
+	JXSelectionManager::StartTransfer().
+
+	The data is broadcast as it arrives, one DataReceived message per
+	chunk, followed by exactly one Finished message.  For incremental
+	(INCR) transfers, each chunk is passed on directly from Xlib, so
+	nothing is accumulated unless the listener chooses to do so.
+
+	JXSelectionManager owns the object and deletes it after broadcasting
+	Finished.  Call Cancel() to stop receiving messages.
+
+	BASE CLASS = virtual JBroadcaster
+
+ ******************************************************************************/
+
+#include <JXStdInc.h>
+#include <JXSelectionTransfer.h>
+#include <jAssert.h>
+
+// JBroadcaster message types
+
+const JCharacter* JXSelectionTransfer::kDataReceived = "DataReceived::JXSelectionTransfer";
+const JCharacter* JXSelectionTransfer::kFinished     = "Finished::JXSelectionTransfer";
+
+/******************************************************************************
+ Constructor (private)
+
+ ******************************************************************************/
+
+JXSelectionTransfer::JXSelectionTransfer
+	(
+	const Atom	selectionName,
+	const Atom	requestType,
+	const Atom	property,
+	const Time	currentTime
+	)
+	:
+	itsSelectionName(selectionName),
+	itsRequestType(requestType),
+	itsProperty(property),
+	itsOwner(None),
+	itsDataType(None),
+	itsByteCount(0),
+	itsLastActivityTime(currentTime),
+	itsCancelledFlag(kJFalse)
+{
+}
+
+/******************************************************************************
+ Destructor
+
+ ******************************************************************************/
+
+JXSelectionTransfer::~JXSelectionTransfer()
+{
+}
+
+/******************************************************************************
+ ChunkReceived (private)
+
+	Called by JXSelectionManager.  The first chunk determines the type.
+
+ ******************************************************************************/
+
+void
+JXSelectionTransfer::ChunkReceived
+	(
+	const Atom				type,
+	const unsigned char*	data,
+	const JSize				length,
+	const JSize				bitsPerBlock,
+	const Time				currentTime
+	)
+{
+	itsLastActivityTime = currentTime;
+	if (itsCancelledFlag)
+		{
+		return;
+		}
+
+	if (itsDataType == None)
+		{
+		itsDataType = type;
+		}
+
+	itsByteCount += length;
+	Broadcast(DataReceived(type, data, length, bitsPerBlock));
+}
+
+/******************************************************************************
+ TransferFinished (private)
+
+	Called by JXSelectionManager.  A transfer that received nothing is
+	never successful.
+
+ ******************************************************************************/
+
+void
+JXSelectionTransfer::TransferFinished
+	(
+	const JBoolean success
+	)
+{
+	if (!itsCancelledFlag)
+		{
+		Broadcast(Finished(JI2B(success && itsDataType != None)));
+		}
+}
+
+#define JTemplateType JXSelectionTransfer
+#include <JPtrArray.tmpls>
+#undef JTemplateType
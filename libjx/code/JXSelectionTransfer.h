@@ -0,0 +1,202 @@
+/******************************************************************************
+ JXSelectionTransfer.h
+
+	Interface for the JXSelectionTransfer class
+
+ ******************************************************************************/
+
+#ifndef _H_JXSelectionTransfer
+#define _H_JXSelectionTransfer
+
+#if !defined _J_UNIX && !defined ACE_LACKS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <JBroadcaster.h>
+#include <X11/Xlib.h>
+
+class JXSelectionTransfer : virtual public JBroadcaster
+{
+	friend class JXSelectionManager;
+
+public:
+
+	virtual ~JXSelectionTransfer();		// only JXSelectionManager may delete us
+
+	Atom		GetSelectionName() const;
+	Atom		GetRequestType() const;
+	Atom		GetDataType() const;
+	JSize		GetReceivedByteCount() const;
+	JBoolean	IsIncremental() const;
+
+	void		Cancel();
+	JBoolean	IsCancelled() const;
+
+private:
+
+	const Atom	itsSelectionName;
+	const Atom	itsRequestType;
+	const Atom	itsProperty;		// on JXSelectionManager's data window
+
+	Window		itsOwner;			// None unless transfer is incremental
+	Atom		itsDataType;		// None until first chunk arrives
+	JSize		itsByteCount;
+	Time		itsLastActivityTime;
+	JBoolean	itsCancelledFlag;
+
+private:
+
+	JXSelectionTransfer(const Atom selectionName, const Atom requestType,
+						const Atom property, const Time currentTime);
+
+	void	ChunkReceived(const Atom type, const unsigned char* data,
+						  const JSize length, const JSize bitsPerBlock,
+						  const Time currentTime);
+	void	TransferFinished(const JBoolean success);
+
+	// not allowed
+
+	JXSelectionTransfer(const JXSelectionTransfer& source);
+	const JXSelectionTransfer& operator=(const JXSelectionTransfer& source);
+
+public:
+
+	// JBroadcaster messages
+
+	static const JCharacter* kDataReceived;
+	static const JCharacter* kFinished;
+
+	class DataReceived : public JBroadcaster::Message
+		{
+		public:
+
+			DataReceived(const Atom type, const unsigned char* data,
+						 const JSize length, const JSize bitsPerBlock)
+				:
+				JBroadcaster::Message(kDataReceived),
+				itsType(type),
+				itsData(data),
+				itsLength(length),
+				itsBitsPerBlock(bitsPerBlock)
+				{ };
+
+			Atom
+			GetType() const
+			{
+				return itsType;
+			};
+
+			// only valid while the message is being processed
+
+			const unsigned char*
+			GetData() const
+			{
+				return itsData;
+			};
+
+			JSize
+			GetDataLength() const
+			{
+				return itsLength;
+			};
+
+			JSize
+			GetBitsPerBlock() const
+			{
+				return itsBitsPerBlock;
+			};
+
+		private:
+
+			const Atom				itsType;
+			const unsigned char*	itsData;
+			const JSize				itsLength;
+			const JSize				itsBitsPerBlock;
+		};
+
+	class Finished : public JBroadcaster::Message
+		{
+		public:
+
+			Finished(const JBoolean success)
+				:
+				JBroadcaster::Message(kFinished),
+				itsSuccessFlag(success)
+				{ };
+
+			JBoolean
+			Successful() const
+			{
+				return itsSuccessFlag;
+			};
+
+		private:
+
+			const JBoolean	itsSuccessFlag;
+		};
+};
+
+
+/******************************************************************************
+ Transfer info
+
+ ******************************************************************************/
+
+inline Atom
+JXSelectionTransfer::GetSelectionName()
+	const
+{
+	return itsSelectionName;
+}
+
+inline Atom
+JXSelectionTransfer::GetRequestType()
+	const
+{
+	return itsRequestType;
+}
+
+inline Atom
+JXSelectionTransfer::GetDataType()
+	const
+{
+	return itsDataType;
+}
+
+inline JSize
+JXSelectionTransfer::GetReceivedByteCount()
+	const
+{
+	return itsByteCount;
+}
+
+inline JBoolean
+JXSelectionTransfer::IsIncremental()
+	const
+{
+	return JI2B( itsOwner != None );
+}
+
+/******************************************************************************
+ Cancel
+
+	No more messages will be broadcast.  JXSelectionManager will clean up
+	the next time it looks at the transfer, so the object must not be used
+	after this.
+
+ ******************************************************************************/
+
+inline void
+JXSelectionTransfer::Cancel()
+{
+	itsCancelledFlag = kJTrue;
+}
+
+inline JBoolean
+JXSelectionTransfer::IsCancelled()
+	const
+{
+	return itsCancelledFlag;
+}
+
+#endif
@@ -506,6 +506,7 @@ JXWidget::Move
 
 		itsBoundsG.Shift(dx,dy);
 		itsFrameG.Shift(dx,dy);
+		FrameChanged();
 		NotifyBoundsMoved(dx,dy);
 
 		Refresh();		// refresh new location
@@ -547,6 +548,7 @@ JXWidget::AdjustSize
 
 		itsFrameG.bottom += dh;
 		itsFrameG.right  += dw;
+		FrameChanged();
 		ApertureResized(dw,dh);
 
 		Refresh();		// refresh new size
@@ -46,6 +46,7 @@
 #include <JString16.h>
 #include <jASCIIConstants.h>
 #include <JMinMax.h>
+#include <JTrace.h>
 #include <jStreamUtil.h>
 #include <jDirUtil.h>
 #include <jMath.h>
@@ -457,31 +458,32 @@ JXWindow::ColormapChanged
 /******************************************************************************
  DispatchMouse
 
+	Called during idle time, so the widget under the mouse can react to
+	changes in its contents, e.g., while scrolling during a drag.
+
  ******************************************************************************/
 
 void
 JXWindow::DispatchMouse()
 {
-	Window rootWindow, childWindow;
-	int root_x, root_y, x,y;
+	JPoint pt, ptR;
 	unsigned int state;
 	JXWindow* window;
 	if (IsVisible() &&
-		XQueryPointer(*itsDisplay, itsXWindow, &rootWindow, &childWindow,
-					  &root_x, &root_y, &x, &y, &state) &&
 		itsDisplay->GetMouseContainer(&window) &&
-		window == this)
+		window == this &&
+		GetPointerPosition(&pt, &ptR, &state))
 		{
 		XMotionEvent xEvent;
 		xEvent.type      = MotionNotify;
 		xEvent.display   = *itsDisplay;
 		xEvent.window    = itsXWindow;
-		xEvent.root      = rootWindow;
+		xEvent.root      = itsDisplay->GetRootWindow();
 		xEvent.subwindow = None;
-		xEvent.x         = x;
-		xEvent.y         = y;
-		xEvent.x_root    = root_x;
-		xEvent.y_root    = root_y;
+		xEvent.x         = pt.x;
+		xEvent.y         = pt.y;
+		xEvent.x_root    = ptR.x;
+		xEvent.y_root    = ptR.y;
 		xEvent.state     = state;
 
 		HandleMotionNotify(xEvent);
@@ -496,18 +498,63 @@ JXWindow::DispatchMouse()
 void
 JXWindow::DispatchCursor()
 {
-	Window rootWindow, childWindow;
-	int root_x, root_y, x,y;
+	JPoint pt, ptR;
 	unsigned int state;
 	JXWindow* window;
 	if (IsVisible() &&
-		XQueryPointer(*itsDisplay, itsXWindow, &rootWindow, &childWindow,
-					  &root_x, &root_y, &x, &y, &state) &&
 		itsDisplay->GetMouseContainer(&window) &&
-		window == this)
+		window == this &&
+		GetPointerPosition(&pt, &ptR, &state))
 		{
 		itsButtonPressReceiver->
-			DispatchCursor(JPoint(x,y), JXKeyModifiers(itsDisplay, state));
+			DispatchCursor(pt, JXKeyModifiers(itsDisplay, state));
+		}
+}
+
+/******************************************************************************
+ GetPointerPosition (private)
+
+	Returns the mouse position relative to this window and the root window,
+	plus the button and key modifier state.  We only call this when the
+	mouse is inside this window, so the latest event is accurate and we
+	only need to ask the server if there hasn't been one yet.
+
+ ******************************************************************************/
+
+JBoolean
+JXWindow::GetPointerPosition
+	(
+	JPoint*			pt,
+	JPoint*			ptR,
+	unsigned int*	state
+	)
+	const
+{
+	Window xWindow;
+	if (itsDisplay->GetLatestPointerPosition(&xWindow, pt, ptR))
+		{
+		if (xWindow != itsXWindow)
+			{
+			*pt = RootToGlobal(*ptR);
+			}
+		*state = (itsDisplay->GetLatestButtonStates()).GetState() |
+				 (itsDisplay->GetLatestKeyModifiers()).GetState();
+		return kJTrue;
+		}
+
+	Window rootWindow, childWindow;
+	int root_x, root_y, x,y;
+	itsDisplay->CountRoundTrip();
+	if (XQueryPointer(*itsDisplay, itsXWindow, &rootWindow, &childWindow,
+					  &root_x, &root_y, &x, &y, state))
+		{
+		pt->Set(x, y);
+		ptR->Set(root_x, root_y);
+		return kJTrue;
+		}
+	else
+		{
+		return kJFalse;
 		}
 }
 
@@ -986,6 +1033,8 @@ JXWindow::Update()
 	// so it gets changed back if an exception occurs
 	bool_value_change _preserve_value(itsUpdating, kJTrue);
 
+	J_TRACE_ZONE("JXWindow::Update");
+
 	// We clear itsUpdateRegion first so widgets call call Refresh() inside Draw()
 
 	Region updateRegion = JXCopyRegion(itsUpdateRegion);
@@ -998,6 +1047,7 @@ JXWindow::Update()
 	DrawAll(p, rect);
 
 	FinishUpdate(rect, updateRegion);
+	itsDisplay->CountDamage(rect);
 }
 
 /******************************************************************************
@@ -1344,6 +1394,7 @@ JXWindow::CalcDesktopLocation
 
 	int x,y;
 	Window childWindow;
+	itsDisplay->CountRoundTrip();
 	if (XTranslateCoordinates(*itsDisplay, itsXWindow, rootChild,
 							  0,0, &x,&y, &childWindow))
 		{
@@ -1388,6 +1439,7 @@ JXWindow::GetRootChild
 		Window rootWindow, parentWindow;
 		Window* childList;
 		unsigned int childCount;
+		itsDisplay->CountRoundTrip();
 		if (!XQueryTree(*itsDisplay, currWindow, &rootWindow,
 						&parentWindow, &childList, &childCount))
 			{
@@ -1671,6 +1723,7 @@ JXWindow::UpdateFrame()
 	Window rootWindow;
 	int x,y;
 	unsigned int w,h, bw, depth;
+	itsDisplay->CountRoundTrip();
 	const Status ok1 = XGetGeometry(*itsDisplay, itsXWindow, &rootWindow,
 									&x, &y, &w, &h, &bw, &depth);
 	assert( ok1 );
@@ -1680,6 +1733,7 @@ JXWindow::UpdateFrame()
 	// After XGetGeometry(), x=0 and y=0 (at least for fvwm)
 
 	Window childWindow;
+	itsDisplay->CountRoundTrip();
 	const Bool ok2 = XTranslateCoordinates(*itsDisplay, itsXWindow, rootWindow,
 										   0,0, &x, &y, &childWindow);
 	assert( ok2 );
@@ -2622,45 +2676,35 @@ JXWindow::HandleMotionNotify
 	const XMotionEvent& xEvent
 	)
 {
-	XEvent discardEvent;
-	while (XCheckMaskEvent(*itsDisplay, PointerMotionMask, &discardEvent))
-		{ };
+	// JXDisplay has already discarded stale motion events, so the
+	// coordinates in the event are current enough.  Asking the server
+	// would cost a round trip for every event.
 
-	// XQueryPointer returns the current mouse state, not the state
-	// when the XMotionEvent was generated.  This can cause HandleMouseDrag()
-	// before HandleMouseDown().
+	const JPoint ptG(xEvent.x, xEvent.y);
 
-	Window rootWindow, childWindow;
-	int x_root, y_root, x,y;
-	unsigned int state;
-	if (XQueryPointer(*itsDisplay, itsXWindow, &rootWindow, &childWindow,
-					  &x_root, &y_root, &x, &y, &state))
+	const JBoolean isDrag = JNegate(JXButtonStates::AllOff(xEvent.state));
+	if (itsIsDraggingFlag && isDrag &&			// otherwise wait for ButtonPress
+		itsProcessDragFlag && itsMouseContainer != NULL)
 		{
-		const JBoolean isDrag = JNegate(JXButtonStates::AllOff(xEvent.state));
-		if (itsIsDraggingFlag && isDrag &&			// otherwise wait for ButtonPress
-			itsProcessDragFlag && itsMouseContainer != NULL)
-			{
-			JXDisplay* display = itsDisplay;	// need local copy, since we might be deleted
-			Display* xDisplay  = *display;
-			Window xWindow     = itsXWindow;
+		JXDisplay* display = itsDisplay;	// need local copy, since we might be deleted
+		Display* xDisplay  = *display;
+		Window xWindow     = itsXWindow;
 
-			const JPoint pt = itsMouseContainer->GlobalToLocal(x,y);
-			itsMouseContainer->DispatchMouseDrag(pt, JXButtonStates(xEvent.state),
-												 JXKeyModifiers(itsDisplay, xEvent.state));
+		const JPoint pt = itsMouseContainer->GlobalToLocal(ptG);
+		itsMouseContainer->DispatchMouseDrag(pt, JXButtonStates(xEvent.state),
+											 JXKeyModifiers(itsDisplay, xEvent.state));
 
-			if (JXDisplay::WindowExists(display, xDisplay, xWindow))
-				{
-				Update();
-				}
-			}
-		else if (!itsIsDraggingFlag && !isDrag && itsButtonPressReceiver->IsVisible())
+		if (JXDisplay::WindowExists(display, xDisplay, xWindow))
 			{
-			itsButtonPressReceiver->
-				DispatchNewMouseEvent(MotionNotify, JPoint(x,y),
-									  kJXNoButton, xEvent.state);
+			Update();
 			}
-		// otherwise wait for ButtonRelease
 		}
+	else if (!itsIsDraggingFlag && !isDrag && itsButtonPressReceiver->IsVisible())
+		{
+		itsButtonPressReceiver->
+			DispatchNewMouseEvent(MotionNotify, ptG, kJXNoButton, xEvent.state);
+		}
+	// otherwise wait for ButtonRelease
 }
 
 /******************************************************************************
@@ -4381,6 +4425,7 @@ JXWindow::HandleWMStateChange()
 	unsigned long itemCount, remainingBytes;
 	unsigned char* xdata;
 
+	itsDisplay->CountRoundTrip();
 	const int result =
 		XGetWindowProperty(*itsDisplay, itsXWindow, itsDisplay->GetWMStateXAtom(),
 						   0, LONG_MAX, False, AnyPropertyType,
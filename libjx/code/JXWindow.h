@@ -424,6 +424,7 @@ private:
 	void		HandleEnterNotify(const XCrossingEvent& xEvent);
 	void		HandleLeaveNotify(const XCrossingEvent& xEvent);
 	void		HandleMotionNotify(const XMotionEvent& xEvent);
+	JBoolean	GetPointerPosition(JPoint* pt, JPoint* ptR, unsigned int* state) const;
 	JBoolean	HandleButtonPress(const XButtonEvent& xEvent);
 	JBoolean	HandleButtonRelease(const XButtonEvent& xEvent);
 
@@ -223,6 +223,10 @@ SOURCE=.\code\JXContainer.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\code\JXContainerIndex.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\code\JXCreatePG.cpp
 # End Source File
 # Begin Source File
@@ -444,6 +448,10 @@ SOURCE=.\code\JXFLWildcardInput.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\code\JXFontCatalog.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\code\JXFontCharSetMenu.cpp
 # End Source File
 # Begin Source File
@@ -801,6 +809,10 @@ SOURCE=.\code\JXSelectionManager_Win32.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\code\JXSelectionTransfer.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\code\JXSelectTabTask.cpp
 # End Source File
 # Begin Source File
@@ -1196,6 +1208,10 @@ SOURCE=.\code\JXContainer.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\code\JXContainerIndex.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\code\JXCreatePG.h
 # End Source File
 # Begin Source File
@@ -1408,6 +1424,10 @@ SOURCE=.\code\JXFLWildcardInput.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\code\JXFontCatalog.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\code\JXFontCharSetMenu.h
 # End Source File
 # Begin Source File
@@ -1752,6 +1772,10 @@ SOURCE=.\code\JXSelectionManager.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\code\JXSelectionTransfer.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\code\JXSelectTabTask.h
 # End Source File
 # Begin Source File
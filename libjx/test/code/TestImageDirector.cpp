@@ -21,6 +21,7 @@
 #include <JXPSPrinter.h>
 #include <JXEPSPrinter.h>
 #include <JXColormap.h>
+#include <JStopWatch.h>
 #include <jGlobals.h>
 #include <jAssert.h>
 
@@ -30,7 +31,8 @@ static const JCharacter* kFileMenuTitleStr  = "File";
 static const JCharacter* kFileMenuShortcuts = "#F";
 static const JCharacter* kFileMenuStr =
 	"    Open...             %h o %k Ctrl-O"
-	"  | Save as GIF...      %h g %k Ctrl-G"
+	"  | Time loading...     %h t"
+	"%l| Save as GIF...      %h g %k Ctrl-G"
 	"  | Save as PNG...      %h n %k Ctrl-N"
 	"  | Save as JPEG...     %h j %k Ctrl-J"
 	"  | Save as XPM...      %h x %k Ctrl-X"
@@ -44,7 +46,7 @@ static const JCharacter* kFileMenuStr =
 
 enum
 {
-	kOpenImageCmd = 1,
+	kOpenImageCmd = 1, kTimeLoadImageCmd,
 	kSaveGIFCmd, kSavePNGCmd, kSaveJPEGCmd,
 	kSaveXPMCmd, kSaveMaskXBMCmd,
 	kCopyImageCmd, kPasteImageCmd,
@@ -197,6 +199,7 @@ void
 TestImageDirector::UpdateFileMenu()
 {
 	itsFileMenu->EnableItem(kOpenImageCmd);
+	itsFileMenu->EnableItem(kTimeLoadImageCmd);
 	itsFileMenu->EnableItem(kPasteImageCmd);
 	itsFileMenu->EnableItem(kPageSetupCmd);
 	itsFileMenu->EnableItem(kCloseCmd);
@@ -234,6 +237,10 @@ TestImageDirector::HandleFileMenu
 		{
 		LoadImage();
 		}
+	else if (index == kTimeLoadImageCmd)
+		{
+		TimeLoadImage();
+		}
 	else if (index == kSaveGIFCmd)
 		{
 		SaveImage(JImage::kGIFType);
@@ -343,6 +350,65 @@ TestImageDirector::LoadImage()
 		}
 }
 
+/******************************************************************************
+ TimeLoadImage (private)
+
+	Benchmark for the GIF/PNG/JPEG decoders:  loads the file several times
+	and reports the average time per load.
+
+ ******************************************************************************/
+
+void
+TestImageDirector::TimeLoadImage()
+{
+	const JSize kLoadCount = 10;
+
+	JString fullName;
+	if (!(JGetChooseSaveFile())->ChooseFile("Image to time:", NULL, &fullName))
+		{
+		return;
+		}
+
+	JXDisplay* display = GetDisplay();
+	JXColormap* cmap   = GetColormap();
+
+	JStopWatch timer;
+	timer.StartTimer();
+
+	JError err = JNoError();
+	JCoordinate w = 0, h = 0;
+	for (JIndex i=1; i<=kLoadCount; i++)
+		{
+		JXImage* image;
+		err = JXImage::CreateFromFile(display, cmap, fullName, &image);
+		if (!err.OK())
+			{
+			break;
+			}
+
+		w = image->GetWidth();
+		h = image->GetHeight();
+		delete image;
+		}
+
+	timer.StopTimer();
+
+	if (err.OK())
+		{
+		JString msg = JString(w, 0) + " x " + JString(h, 0);
+		msg += "\n\nAverage load time: ";
+		msg += JString(1000.0 * timer.GetCPUTimeInterval() / kLoadCount, 1);
+		msg += " ms";
+		(JGetUserNotification())->DisplayMessage(msg);
+		}
+	else
+		{
+		JString msg = "Unable to open the file because\n\n";
+		msg += err.GetMessage();
+		(JGetUserNotification())->ReportError(msg);
+		}
+}
+
 /******************************************************************************
  SaveImage (private)
 
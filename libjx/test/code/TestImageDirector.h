@@ -58,6 +58,7 @@ private:
 	void	HandleFileMenu(const JIndex item);
 
 	void	LoadImage();
+	void	TimeLoadImage();
 	void	SaveImage(const JImage::FileType type) const;
 	void	SaveMask() const;
 
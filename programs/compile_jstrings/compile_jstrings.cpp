@@ -15,6 +15,7 @@
 #include <jVCSUtil.h>
 #include <jCommandLine.h>
 #include <sstream>
+#include <iomanip>
 #include <stdlib.h>
 #include <jAssert.h>
 
@@ -22,7 +23,7 @@
 
 static const JCharacter* kVersionStr =
 
-	"compile_jstrings 1.1.0\n"
+	"compile_jstrings 1.2.0\n"
 	"\n"
 	"Copyright  2000-05 John Lindal.  All rights reserved.\n"
 	"\n"
@@ -33,7 +34,11 @@ static const JCharacter* kVersionStr =
 void GetOptions(const JSize argc, char* argv[],
 				JPtrArray<JString>* inputFileList,
 				JString* dataVarName, JString* outputFileName,
-				JString* databaseFileName, JBoolean* debug);
+				JString* databaseFileName, JBoolean* binary,
+				JBoolean* debug);
+
+JString	BuildTextCode(const JStringManager& mgr, const JString& dataVarName);
+JString	BuildBinaryCode(const JStringManager& mgr, const JString& dataVarName);
 
 void PrintHelp();
 void PrintVersion();
@@ -54,9 +59,10 @@ main
 
 	JPtrArray<JString> inputFileList(JPtrArrayT::kDeleteAll);
 	JString dataVarName, outputFileName, databaseFileName;
-	JBoolean debug;
+	JBoolean binary, debug;
 	GetOptions(argc, argv, &inputFileList,
-			   &dataVarName, &outputFileName, &databaseFileName, &debug);
+			   &dataVarName, &outputFileName, &databaseFileName,
+			   &binary, &debug);
 
 	const JSize inputCount = inputFileList.GetElementCount();
 
@@ -120,70 +126,28 @@ main
 			}
 		}
 
-	// generate the output file
+	// generate the output files
 
-	std::ostringstream data1;
-	mgr.WriteFile(data1);
-
-	JString data1Str = data1.str();
 	if (!databaseFileName.IsEmpty())
 		{
 		ofstream dbOutput(databaseFileName);
-		data1Str.Print(dbOutput);
-		}
-
-	if (!outputFileName.IsEmpty())
-		{
-		JIndex i = 1;
-		while (data1Str.LocateNextSubstring("\\", &i))
-			{
-			data1Str.ReplaceSubstring(i,i, "\\\\");
-			i += 2;
-			}
-		i = 1;
-		while (data1Str.LocateNextSubstring("\"", &i))
-			{
-			data1Str.ReplaceSubstring(i,i, "\\\"");
-			i += 2;
-			}
-		i = 1;
-		while (data1Str.LocateNextSubstring("\n", &i))
+		if (binary)
 			{
-			data1Str.ReplaceSubstring(i,i, "\\n");
-			i += 2;
+			mgr.WriteBinaryFile(dbOutput);
 			}
-
-		std::ostringstream data2;
-		data2 << "#include <jTypes.h>" << endl;
-		data2 << "static const JCharacter* ";
-		dataVarName.Print(data2);
-		data2 << "[] = {" << endl;
-
-		// Visual C++ cannot handle file with more than 2048 characters on a line
-		// and cannot compile string constant more than 2048 characters!
-
-		const JSize l1 = data1Str.GetLength();
-		for (i=0; i<l1; )
+		else
 			{
-			JSize l2 = JMin((JSize) 2040, l1 - i);
-			while (l2 > 0 && data1Str.GetCharacter(i+l2) == '\\')
-				{
-				l2--;
-				}
-			assert( l2 > 0 );
-
-			data2 << "\"";
-			data2.write(((const char*) data1Str) + i, l2);
-			data2 << "\"," << endl;
-
-			i += l2;
+			mgr.WriteFile(dbOutput);
 			}
+		}
 
-		data2 << "NULL };" << endl;
+	if (!outputFileName.IsEmpty())
+		{
+		const JString s2 = (binary ? BuildBinaryCode(mgr, dataVarName) :
+									 BuildTextCode(mgr, dataVarName));
 
 		// if the file won't change, don't re-write it
 
-		const JString s2 = data2.str();
 		if (JFileExists(outputFileName))
 			{
 			JString origData;
@@ -212,6 +176,120 @@ main
 	return 0;
 }
 
+/******************************************************************************
+ BuildTextCode
+
+	Returns a source file defining an array of strings containing the
+	text database.
+
+ ******************************************************************************/
+
+JString
+BuildTextCode
+	(
+	const JStringManager&	mgr,
+	const JString&			dataVarName
+	)
+{
+	std::ostringstream data1;
+	mgr.WriteFile(data1);
+
+	JString data1Str = data1.str();
+
+	JIndex i = 1;
+	while (data1Str.LocateNextSubstring("\\", &i))
+		{
+		data1Str.ReplaceSubstring(i,i, "\\\\");
+		i += 2;
+		}
+	i = 1;
+	while (data1Str.LocateNextSubstring("\"", &i))
+		{
+		data1Str.ReplaceSubstring(i,i, "\\\"");
+		i += 2;
+		}
+	i = 1;
+	while (data1Str.LocateNextSubstring("\n", &i))
+		{
+		data1Str.ReplaceSubstring(i,i, "\\n");
+		i += 2;
+		}
+
+	std::ostringstream data2;
+	data2 << "#include <jTypes.h>" << endl;
+	data2 << "static const JCharacter* ";
+	dataVarName.Print(data2);
+	data2 << "[] = {" << endl;
+
+	// Visual C++ cannot handle file with more than 2048 characters on a line
+	// and cannot compile string constant more than 2048 characters!
+
+	const JSize l1 = data1Str.GetLength();
+	for (i=0; i<l1; )
+		{
+		JSize l2 = JMin((JSize) 2040, l1 - i);
+		while (l2 > 0 && data1Str.GetCharacter(i+l2) == '\\')
+			{
+			l2--;
+			}
+		assert( l2 > 0 );
+
+		data2 << "\"";
+		data2.write(((const char*) data1Str) + i, l2);
+		data2 << "\"," << endl;
+
+		i += l2;
+		}
+
+	data2 << "NULL };" << endl;
+
+	return data2.str();
+}
+
+/******************************************************************************
+ BuildBinaryCode
+
+	Returns a source file defining an array of bytes containing the binary
+	table.  The program passes this and its sizeof() to
+	JStringManager::Register().
+
+ ******************************************************************************/
+
+JString
+BuildBinaryCode
+	(
+	const JStringManager&	mgr,
+	const JString&			dataVarName
+	)
+{
+	std::ostringstream data1;
+	mgr.WriteBinaryFile(data1);
+
+	const std::string s        = data1.str();
+	const std::string data1Str = s.substr(s.find('\n') + 1);	// skip file format
+
+	std::ostringstream data2;
+	data2 << "#include <jTypes.h>" << endl;
+	data2 << "static const unsigned char ";
+	dataVarName.Print(data2);
+	data2 << "[] = {" << endl;
+
+	const JSize l1 = data1Str.length();
+	for (JIndex i=0; i<l1; i++)
+		{
+		data2 << "0x" << std::hex << std::setw(2) << std::setfill('0')
+			  << (int) (unsigned char) data1Str[i] << ',';
+		if (i % 16 == 15)
+			{
+			data2 << endl;
+			}
+		}
+
+	data2 << std::dec << endl << "};" << endl;
+
+	return data2.str();
+}
+
 /******************************************************************************
  GetOptions
 
@@ -228,6 +306,7 @@ GetOptions
 	JString*			dataVarName,
 	JString*			outputFileName,
 	JString*			databaseFileName,
+	JBoolean*			binary,
 	JBoolean*			debug
 	)
 {
@@ -235,7 +314,8 @@ GetOptions
 	dataVarName->Clear();
 	outputFileName->Clear();
 	databaseFileName->Clear();
-	*debug = kJFalse;
+	*binary = kJFalse;
+	*debug  = kJFalse;
 
 	JIndex index = 1;
 	while (index < argc)
@@ -265,6 +345,11 @@ GetOptions
 			*databaseFileName = argv[index];
 			}
 
+		else if (strcmp(argv[index], "--binary") == 0)
+			{
+			*binary = kJTrue;
+			}
+
 		else if (strcmp(argv[index], "--debug") == 0)
 			{
 			*debug = kJTrue;
@@ -321,6 +406,8 @@ PrintHelp()
 	cout << "-v      prints version information" << endl;
 	cout << "--code  var_name output_file: generates source file defining var_name" << endl;
 	cout << "--db    output_file: generates string database file from input files" << endl;
+	cout << "--binary  generate binary tables instead of text:  faster to load" << endl;
+	cout << "          (pass --code output to JStringManager::Register() with sizeof())" << endl;
 	cout << endl;
 }
 
@@ -10,20 +10,35 @@
 
 #include <JRegex.h>
 #include <JPtrArray-JString.h>
+#include <JStringPtrMap.h>
+#include <JTrace.h>
+#include <JMinMax.h>
 #include <jFStreamUtil.h>
 #include <jStreamUtil.h>
 #include <jFileUtil.h>
 #include <jVCSUtil.h>
 #include <JProcess.h>
 #include <jCommandLine.h>
+#include <ace/OS_NS_sys_stat.h>
+#include <ace/OS_NS_unistd.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <ctype.h>
 
 #ifdef _J_ARRAY_NEW_OVERRIDABLE
 #include <JMemoryManager.h>
 #endif
 
+// JMemoryManager is not thread-safe.
+
+#if defined ACE_HAS_THREADS && ACE_MT_SAFE && ! defined _J_ARRAY_NEW_OVERRIDABLE
+#define J_MAKEMAKE_THREADS
+#include <ace/Thread.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Guard_T.h>
+#endif
+
 #include <jAssert.h>
 
 // Turn this on to generate a Makefile that allows #include loops.
@@ -39,7 +54,7 @@
 
 static const JCharacter* kVersionStr =
 
-	"makemake 3.3.0\n"
+	"makemake 3.4.0\n"
 	"\n"
 	"Copyright  1994-2005 by John Lindal.  All rights reserved.\n"
 	"\n"
@@ -61,6 +76,7 @@ static const JCharacter* kMakedependMarkerStr =
 static const JCharacter* kObjDirArg   = "--obj-dir";
 static const JCharacter* kNoStdIncArg = "--no-std-inc";
 static const JCharacter* kAutoGenArg  = "--assume-autogen";
+static const JCharacter* kTimingArg   = "--timing";
 
 static const JCharacter* kCurrentDir    = "./";
 static const JCharacter* kSysIncludeDir = "/usr/include/";
@@ -114,7 +130,7 @@ void GetOptions(const JSize argc, char* argv[], JString* defSuffix,
 				JString* defineText, JString* headerName,
 				JString* inputName, JString* outputName, JString* outputDirName,
 				JPtrArray<JString>* userTargetList, JBoolean* searchSysDir,
-				JBoolean* assumeAutoGen,
+				JBoolean* assumeAutoGen, JBoolean* printTiming,
 				JPtrArray<JString>* suffixMapIn, JPtrArray<JString>* suffixMapOut);
 JBoolean FindFile(const JCharacter* fileName, const JPtrArray<JString>& pathList,
 				  JString* fullName);
@@ -150,14 +166,14 @@ main
 
 	JString defSuffix, defineText, headerName, inputName, outputName, outputDirName;
 	JPtrArray<JString> userTargetList(JPtrArrayT::kDeleteAll);	// empty => include all targets
-	JBoolean searchSysDir, assumeAutoGen;
+	JBoolean searchSysDir, assumeAutoGen, printTiming;
 
 	JPtrArray<JString> suffixMapIn(JPtrArrayT::kDeleteAll),
 					   suffixMapOut(JPtrArrayT::kDeleteAll);
 
 	GetOptions(argc, argv, &defSuffix, &defineText, &headerName, &inputName,
 			   &outputName, &outputDirName, &userTargetList, &searchSysDir,
-			   &assumeAutoGen, &suffixMapIn, &suffixMapOut);
+			   &assumeAutoGen, &printTiming, &suffixMapIn, &suffixMapOut);
 
 	// process the input file
 
@@ -721,6 +737,10 @@ main
 		{
 		output << ' ' << kAutoGenArg;
 		}
+	if (printTiming)
+		{
+		output << ' ' << kTimingArg;
+		}
 	output << " -- ${DEPENDFLAGS} -- ";
 
 #if USE_TEMP_FILE_FOR_DEPEND
@@ -997,6 +1017,7 @@ GetOptions
 	JPtrArray<JString>*	userTargetList,
 	JBoolean*			searchSysDir,
 	JBoolean*			assumeAutoGen,
+	JBoolean*			printTiming,
 	JPtrArray<JString>*	suffixMapIn,
 	JPtrArray<JString>*	suffixMapOut
 	)
@@ -1011,6 +1032,7 @@ GetOptions
 	*outputName    = "Makefile";
 	*searchSysDir  = kJTrue;
 	*assumeAutoGen = kJFalse;
+	*printTiming   = kJFalse;
 
 	{
 	JString* s = new JString(".java");
@@ -1130,6 +1152,11 @@ GetOptions
 			*assumeAutoGen = kJTrue;
 			}
 
+		else if (strcmp(argv[index], kTimingArg) == 0)
+			{
+			*printTiming = kJTrue;
+			}
+
 		else if (strcmp(argv[index], "--check") == 0)
 			{
 			checkModTimes = kJTrue;
@@ -1356,6 +1383,7 @@ PrintHelp
 	cout << kObjDirArg << "         <variable name>     - specifies directory for all .o files" << endl;
 	cout << kNoStdIncArg << "      exclude dependencies on files in /usr/include" << endl;
 	cout << kAutoGenArg << "  assume unfound \"...\" files reside in includer's directory" << endl;
+	cout << kTimingArg << "          print how long it takes to calculate dependencies" << endl;
 	cout << "--check           only rebuild output file if input files are newer" << endl;
 	cout << "--choose          interactively choose the targets" << endl;
 	cout << "--make-name       <make binary> - default " << kMakeBinary << endl;
@@ -1385,53 +1413,94 @@ PrintVersion()
 /******************************************************************************
  Dependency graph
 
+	Every file that is reached while following the #include's gets a
+	FileDep.  The #include's found in each file are also saved in a cache
+	next to the Makefile, so the next run only has to parse the files that
+	have changed.  The cache stores the names exactly as they are written
+	in the file, so it remains valid when the search paths change.
+
  ******************************************************************************/
 
-struct HeaderDep
-{
-	JString*			fileName;
-	JPtrArray<JString>*	depList;	// list of files that fileName -explicitly- #includes
+static const JCharacter* kDependCacheSuffix  = ".jdepend";
+static const JCharacter* kDependCacheVersion = "# makemake dependency cache 1";
 
-	HeaderDep()
-		:
-		fileName(NULL), depList(NULL)
-	{ };
+const JSize kMaxScanThreadCount = 8;
 
-	HeaderDep(JString* name, JPtrArray<JString>* list)
+struct FileDep
+{
+	JString				fileName;
+	time_t				modTime;
+	JSize				fileSize;
+	JString				includeText;	// one line per #include:  '"' or '<', then the name
+	JSize				includeCount;
+	JBoolean			cached;			// includeText was read from the cache
+	JBoolean			valid;			// includeText matches the file on disk
+	JBoolean			parsed;			// file was parsed during this run
+	JBoolean			included;		// file is #included by another file
+	JPtrArray<JString>*	depList;		// list of files that fileName -explicitly- #includes
+										// (NULL until file is reached during this run)
+
+	FileDep(const JCharacter* name)
 		:
-		fileName(name), depList(list)
+		fileName(name), modTime(0), fileSize(0), includeCount(0),
+		cached(kJFalse), valid(kJFalse), parsed(kJFalse), included(kJFalse),
+		depList(NULL)
 	{ };
+
+	~FileDep()
+	{
+		delete depList;
+	};
+};
+
+struct ScanQueue
+{
+	JPtrArray<FileDep>*	fileList;
+	JIndex				nextFile;	// protected by lock
+
+#ifdef J_MAKEMAKE_THREADS
+	ACE_Thread_Mutex	lock;
+
+	static ACE_THR_FUNC_RETURN	Main(void* data);
+#endif
 };
 
 void		WriteDependencies(ostream& output, const JCharacter* fileName,
 							  const JCharacter* makeName,
-							  const JPtrArray<JString>& pathList1,
-							  const JPtrArray<JString>& pathList2,
-							  const JBoolean assumeAutoGen,
 							  const JCharacter* outputDirName,
-							  JArray<HeaderDep>* headerList);
+							  JStringPtrMap<FileDep>& fileMap);
 void		PrintDependencies(ostream& output, const JCharacter* outputDirName,
 							  const JCharacter* makeName,
 							  const JPtrArray<JString>& depList);
 void		AddDependency(JPtrArray<JString>* depList, const JString& headerName,
-						  const JPtrArray<JString>& pathList1,
-						  const JPtrArray<JString>& pathList2,
-						  const JBoolean assumeAutoGen,
-						  JArray<HeaderDep>* headerList,
-						  const JBoolean addToDepList = kJTrue);
-HeaderDep	ParseHeaderFile(const JString& fileName,
+						  JStringPtrMap<FileDep>& fileMap);
+JBoolean	ReachFile(const JCharacter* fileName, JStringPtrMap<FileDep>* fileMap,
+					  JPtrArray<FileDep>* fileList, FileDep** dep);
+void		ResolveIncludes(FileDep* dep,
 							const JPtrArray<JString>& pathList1,
 							const JPtrArray<JString>& pathList2,
 							const JBoolean assumeAutoGen,
-							JArray<HeaderDep>* headerList);
-JBoolean	GetNextIncludedFile(const JCharacter* inputFileName, istream& input,
-								const JPtrArray<JString>& pathList1,
-								const JPtrArray<JString>& pathList2,
-								const JBoolean assumeAutoGen,
-								JString* fileName);
+							JStringPtrMap<JString>* pathCache,
+							JStringPtrMap<FileDep>* fileMap,
+							JPtrArray<FileDep>* fileList,
+							JPtrArray<FileDep>* nextScanList);
+JBoolean	FindIncludedFile(const JCharacter* inputFileName,
+							 const JCharacter c, const JString& name,
+							 const JPtrArray<JString>& pathList1,
+							 const JPtrArray<JString>& pathList2,
+							 const JBoolean assumeAutoGen,
+							 JStringPtrMap<JString>* pathCache,
+							 JString* fileName);
+JSize		GetScanThreadCount();
+void		ScanFiles(JPtrArray<FileDep>& fileList, const JSize maxThreadCount);
+void		ScanNextFiles(ScanQueue* queue);
+void		ScanFile(FileDep* dep);
+JSize		ParseIncludes(const JString& text, JString* includeText);
+void		ReadDependCache(const JCharacter* fileName, JStringPtrMap<FileDep>* fileMap);
+void		WriteDependCache(const JCharacter* fileName, const JPtrArray<FileDep>& fileList);
 void		TruncateMakefile(const JCharacter* fileName);
 
-JOrderedSetT::CompareResult CompareHeaderFiles(const HeaderDep& h1, const HeaderDep& h2);
+JOrderedSetT::CompareResult CompareFileDeps(FileDep* const & f1, FileDep* const & f2);
 
 /******************************************************************************
  CalcDepend
@@ -1460,11 +1529,14 @@ CalcDepend
 
 #endif
 
+	const JTraceTime startTime = JTrace::GetTime();
+
 	// parse command line arguments
 
 	JString outputDirName;
 	JBoolean searchSysDir  = kJTrue;
 	JBoolean assumeAutoGen = kJFalse;
+	JBoolean printTiming   = kJFalse;
 
 	JIndex i = startArg;
 
@@ -1486,6 +1558,10 @@ CalcDepend
 			{
 			assumeAutoGen = kJTrue;
 			}
+		else if (strcmp(argv[i], kTimingArg) == 0)
+			{
+			printTiming = kJTrue;
+			}
 		else
 			{
 			cerr << "Unknown argument " << argv[i] << " in \"makemake --depend\"" << endl;
@@ -1565,15 +1641,10 @@ CalcDepend
 		pathList2.Append(kSysIncludeDir);
 		}
 
-	// append dependencies to input file
-
-	TruncateMakefile(makefileName);
+	// read the list of source files
 
-	ofstream output(makefileName, ios::app);
-	output << '\n';
-
-	JArray<HeaderDep> headerList;		// header files that have been processed
-	headerList.SetCompareFunction(CompareHeaderFiles);
+	JPtrArray<JString> fileNameList(JPtrArrayT::kDeleteAll),
+					   makeNameList(JPtrArrayT::kDeleteAll);
 
 #if USE_TEMP_FILE_FOR_DEPEND
 
@@ -1588,31 +1659,125 @@ CalcDepend
 			break;
 			}
 		makeName = JReadLine(input);
-		WriteDependencies(output, fileName, makeName, pathList1, pathList2,
-						  assumeAutoGen, outputDirName, &headerList);
+		fileNameList.Append(fileName);
+		makeNameList.Append(makeName);
 		}
 
+	input.close();
+
 #else
 
 	for ( ; i<argc; i+=2)
 		{
-		WriteDependencies(output, argv[i], argv[i+1], pathList1, pathList2,
-						  assumeAutoGen, outputDirName, &headerList);
+		fileNameList.Append(argv[i]);
+		makeNameList.Append(argv[i+1]);
 		}
 
 #endif
 
+	// Follow the #include's one level at a time.  All the files in a level
+	// are parsed in parallel, and then the names that they #include are
+	// resolved to build the next level.
+
+	JString cacheName = makefileName;
+	cacheName        += kDependCacheSuffix;
+
+	JStringPtrMap<FileDep> fileMap(JPtrArrayT::kDeleteAll);
+	ReadDependCache(cacheName, &fileMap);
+
+	JPtrArray<FileDep> fileList(JPtrArrayT::kForgetAll),		// files reached during this run
+					   scanList(JPtrArrayT::kForgetAll),
+					   nextScanList(JPtrArrayT::kForgetAll);
+
+	const JSize sourceCount = fileNameList.GetElementCount();
+	for (i=1; i<=sourceCount; i++)
+		{
+		FileDep* dep;
+		if (ReachFile(*(fileNameList.NthElement(i)), &fileMap, &fileList, &dep))
+			{
+			scanList.Append(dep);
+			}
+		}
+
+	JStringPtrMap<JString> pathCache(JPtrArrayT::kDeleteAll);
+
+	const JSize threadCount = GetScanThreadCount();
+	while (!scanList.IsEmpty())
+		{
+		ScanFiles(scanList, threadCount);
+
+		const JSize scanCount = scanList.GetElementCount();
+		for (i=1; i<=scanCount; i++)
+			{
+			ResolveIncludes(scanList.NthElement(i), pathList1, pathList2,
+							assumeAutoGen, &pathCache, &fileMap, &fileList,
+							&nextScanList);
+			}
+
+		scanList.CopyPointers(nextScanList, JPtrArrayT::kForgetAll, kJFalse);
+		nextScanList.RemoveAll();
+		}
+
+	WriteDependCache(cacheName, fileList);
+
+	// append dependencies to input file
+
+	TruncateMakefile(makefileName);
+
+	ofstream output(makefileName, ios::app);
+	output << '\n';
+
+	for (i=1; i<=sourceCount; i++)
+		{
+		WriteDependencies(output, *(fileNameList.NthElement(i)),
+						  *(makeNameList.NthElement(i)), outputDirName, fileMap);
+		}
+
 #if ! ALLOW_INCLUDE_LOOPS
 
-	const JSize headerCount = headerList.GetElementCount();
-	for (i=1; i<=headerCount; i++)
+	fileList.SetCompareFunction(CompareFileDeps);
+	fileList.Sort();
+
+	const JSize fileCount = fileList.GetElementCount();
+	for (i=1; i<=fileCount; i++)
 		{
-		const HeaderDep info = headerList.GetElement(i);
-		PrintDependencies(output, outputDirName, *(info.fileName), *(info.depList));
+		const FileDep* dep = fileList.NthElement(i);
+		if (dep->included)
+			{
+			PrintDependencies(output, outputDirName, dep->fileName, *(dep->depList));
+			}
 		}
 
 #endif
 
+	output.close();
+
+	if (printTiming)
+		{
+		JSize parsedCount = 0, cachedCount = 0;
+
+		const JSize fileCount = fileList.GetElementCount();
+		for (i=1; i<=fileCount; i++)
+			{
+			const FileDep* dep = fileList.NthElement(i);
+			if (dep->parsed)
+				{
+				parsedCount++;
+				}
+			else if (dep->valid)
+				{
+				cachedCount++;
+				}
+			}
+
+		const JTraceTime endTime = JTrace::GetTime();
+
+		cout << "makemake: " << fileCount << " files, ";
+		cout << parsedCount << " parsed, " << cachedCount << " from cache, ";
+		cout << threadCount << (threadCount == 1 ? " thread, " : " threads, ");
+		cout << (unsigned long) ((endTime - startTime) / 1000000) << " ms" << endl;
+		}
+
 	// We should clean up, but it's not worth the trouble.
 	// (and pathList1 and pathList2 share objects)
 }
@@ -1632,14 +1797,11 @@ CalcDepend
 void
 WriteDependencies
 	(
-	ostream&					output,
-	const JCharacter*			fileName,
-	const JCharacter*			makeName,
-	const JPtrArray<JString>&	pathList1,
-	const JPtrArray<JString>&	pathList2,
-	const JBoolean				assumeAutoGen,
-	const JCharacter*			outputDirName,
-	JArray<HeaderDep>*			headerList
+	ostream&				output,
+	const JCharacter*		fileName,
+	const JCharacter*		makeName,
+	const JCharacter*		outputDirName,
+	JStringPtrMap<FileDep>&	fileMap
 	)
 {
 	if (!JFileExists(fileName))
@@ -1648,18 +1810,20 @@ WriteDependencies
 		return;
 		}
 
+	FileDep* dep;
+	const JBoolean found = fileMap.GetElement(fileName, &dep);
+	assert( found && dep->depList != NULL );
+
 	// build dependency list
 
 	JPtrArray<JString> depList(JPtrArrayT::kForgetAll);
 	depList.SetCompareFunction(JCompareStringsCaseSensitive);
 
-	ifstream input(fileName);
-	JString headerName;
-	while (GetNextIncludedFile(fileName, input, pathList1, pathList2, assumeAutoGen, &headerName))
+	const JSize count = (dep->depList)->GetElementCount();
+	for (JIndex i=1; i<=count; i++)
 		{
-		AddDependency(&depList, headerName, pathList1, pathList2, assumeAutoGen, headerList);
+		AddDependency(&depList, *((dep->depList)->NthElement(i)), fileMap);
 		}
-	input.close();
 
 	// write dependencies
 
@@ -1717,207 +1881,566 @@ PrintDependencies
 void
 AddDependency
 	(
-	JPtrArray<JString>*			depList,
-	const JString&				headerName,
-	const JPtrArray<JString>&	pathList1,
-	const JPtrArray<JString>&	pathList2,
-	const JBoolean				assumeAutoGen,
-	JArray<HeaderDep>*			headerList,
-	const JBoolean				addToDepList
+	JPtrArray<JString>*		depList,
+	const JString&			headerName,
+	JStringPtrMap<FileDep>&	fileMap
 	)
 {
-	const HeaderDep info = ParseHeaderFile(headerName, pathList1, pathList2, assumeAutoGen, headerList);
+	FileDep* info;
+	const JBoolean found = fileMap.GetElement(headerName, &info);
+	assert( found && info->depList != NULL );
 
 	JBoolean isDuplicate;
 	const JIndex index =
-		depList->GetInsertionSortIndex(const_cast<JString*>(&headerName), &isDuplicate);
+		depList->GetInsertionSortIndex(&(info->fileName), &isDuplicate);
 	if (!isDuplicate)
 		{
-		if (addToDepList)
-			{
-			// must use info.fileName so we have a valid JString*
-			depList->InsertAtIndex(index, info.fileName);
-			}
+		// must use info->fileName so we have a valid JString*
+		depList->InsertAtIndex(index, &(info->fileName));
 
 		#if ALLOW_INCLUDE_LOOPS
-		const JBoolean addSubToDepList = kJTrue;
-		#else
-		const JBoolean addSubToDepList = kJFalse;
-		#endif
 
-		const JSize count = (info.depList)->GetElementCount();
+		const JSize count = (info->depList)->GetElementCount();
 		for (JIndex i=1; i<=count; i++)
 			{
-			const JString* includedFileName = (info.depList)->NthElement(i);
+			AddDependency(depList, *((info->depList)->NthElement(i)), fileMap);
+			}
 
-			#if ! ALLOW_INCLUDE_LOOPS
+		#endif
+		}
+}
 
-			// check if it already exists
+/******************************************************************************
+ ReachFile
 
-			HeaderDep info(const_cast<JString*>(includedFileName), NULL);
-			JIndex j;
-			if (headerList->SearchSorted(info, JOrderedSetT::kAnyMatch, &j))
-				{
-				continue;
-				}
+	Returns kJTrue if this is the first time that the file has been
+	reached during this run.  In this case, the caller must arrange for
+	its #include's to be resolved.
 
-			#endif
+ ******************************************************************************/
+
+JBoolean
+ReachFile
+	(
+	const JCharacter*		fileName,
+	JStringPtrMap<FileDep>*	fileMap,
+	JPtrArray<FileDep>*		fileList,
+	FileDep**				dep
+	)
+{
+	if (!fileMap->GetElement(fileName, dep))
+		{
+		*dep = new FileDep(fileName);
+		assert( *dep != NULL );
+		fileMap->SetNewElement(fileName, *dep);
+		}
+
+	if ((**dep).depList != NULL)
+		{
+		return kJFalse;
+		}
 
-			AddDependency(depList, *includedFileName,
-						  pathList1, pathList2, assumeAutoGen,
-						  headerList, addSubToDepList);
+	(**dep).depList = new JPtrArray<JString>(JPtrArrayT::kForgetAll);
+	assert( (**dep).depList != NULL );
+	((**dep).depList)->SetCompareFunction(JCompareStringsCaseSensitive);
+
+	fileList->Append(*dep);
+	return kJTrue;
+}
+
+/******************************************************************************
+ ResolveIncludes
+
+	Search for the files that dep #includes and add them to its depList.
+	Files that have not been reached before are appended to nextScanList,
+	except for system header files, from which we do not extract
+	dependencies.
+
+ ******************************************************************************/
+
+void
+ResolveIncludes
+	(
+	FileDep*					dep,
+	const JPtrArray<JString>&	pathList1,
+	const JPtrArray<JString>&	pathList2,
+	const JBoolean				assumeAutoGen,
+	JStringPtrMap<JString>*		pathCache,
+	JStringPtrMap<FileDep>*		fileMap,
+	JPtrArray<FileDep>*			fileList,
+	JPtrArray<FileDep>*			nextScanList
+	)
+{
+	JString name, fullName;
+
+	const JCharacter* s = dep->includeText;
+	while (*s != '\0')
+		{
+		const JCharacter* end = strchr(s, '\n');
+		assert( end != NULL );
+
+		const JCharacter c = *s;
+		name.Set(s+1, end - s - 1);
+		s = end + 1;
+
+		if (name.BeginsWith("ace/") ||
+			name.EndsWith("StdInc.h") ||
+			!FindIncludedFile(dep->fileName, c, name, pathList1, pathList2,
+							  assumeAutoGen, pathCache, &fullName))
+			{
+			continue;
+			}
+
+		FileDep* includedDep;
+		if (ReachFile(fullName, fileMap, fileList, &includedDep) &&
+			!fullName.BeginsWith(kSysIncludeDir))
+			{
+			nextScanList->Append(includedDep);
+			}
+		includedDep->included = kJTrue;
+
+		JBoolean isDuplicate;
+		const JIndex i =
+			(dep->depList)->GetInsertionSortIndex(&(includedDep->fileName), &isDuplicate);
+		if (!isDuplicate)
+			{
+			(dep->depList)->InsertAtIndex(i, &(includedDep->fileName));
 			}
 		}
 }
 
 /******************************************************************************
- ParseHeaderFile
+ FindIncludedFile
 
-	Add a record to headerList describing the depencies of the given file.
+	Search for a file that was #included with the given delimiter.  The
+	result of the search does not depend on the including file, so it is
+	remembered in pathCache.
 
  ******************************************************************************/
 
-HeaderDep
-ParseHeaderFile
+JBoolean
+FindIncludedFile
 	(
-	const JString&				fileName,
+	const JCharacter*			inputFileName,
+	const JCharacter			c,
+	const JString&				name,
 	const JPtrArray<JString>&	pathList1,
 	const JPtrArray<JString>&	pathList2,
 	const JBoolean				assumeAutoGen,
-	JArray<HeaderDep>*			headerList
+	JStringPtrMap<JString>*		pathCache,
+	JString*					fileName
 	)
 {
-	// check if it already exists
+	JString key = name;
+	key.PrependCharacter(c);
 
-	HeaderDep info(const_cast<JString*>(&fileName), (JPtrArray<JString>*) NULL);
-	JBoolean found;
-	const JIndex index =
-		headerList->SearchSorted1(info, JOrderedSetT::kAnyMatch, &found);
-	if (found)
+	JString* path;
+	if (!pathCache->GetElement(key, &path))
+		{
+		path = new JString;
+		assert( path != NULL );
+
+		if (!(c == '"' && FindFile(name, pathList1, path)))
+			{
+			FindFile(name, pathList2, path);
+			}
+		pathCache->SetNewElement(key, path);
+		}
+
+	if (!path->IsEmpty())
+		{
+		*fileName = *path;
+		return kJTrue;
+		}
+	else if (c == '"' && assumeAutoGen)	// assume in same dir as including file
 		{
-		return headerList->GetElement(index);
+		JString p, n;
+		if (!JSplitPathAndName(inputFileName, &p, &n))
+			{
+			p = "./";
+			}
+		*fileName = JCombinePathAndName(p, name);
+		return kJTrue;
 		}
+	else
+		{
+		fileName->Clear();
+		return kJFalse;
+		}
+}
+
+/******************************************************************************
+ GetScanThreadCount
+
+	One thread per processor, up to kMaxScanThreadCount.
+
+ ******************************************************************************/
+
+JSize
+GetScanThreadCount()
+{
+#ifdef J_MAKEMAKE_THREADS
+
+	const long cpuCount = ACE_OS::num_processors_online();
+	return JMin(kMaxScanThreadCount, (JSize) JMax(1L, cpuCount));
+
+#else
+
+	return 1;
+
+#endif
+}
+
+/******************************************************************************
+ ScanFiles
 
-	// add it to headerList
+	Brings includeText up to date for every file in the list.  The main
+	thread does its share of the work.
 
-	info.fileName = new JString(fileName);
-	assert( info.fileName != NULL );
+ ******************************************************************************/
 
-	info.depList = new JPtrArray<JString>(JPtrArrayT::kDeleteAll);
-	assert( info.depList != NULL );
-	(info.depList)->SetCompareFunction(JCompareStringsCaseSensitive);
+void
+ScanFiles
+	(
+	JPtrArray<FileDep>&	fileList,
+	const JSize			maxThreadCount
+	)
+{
+	ScanQueue queue;
+	queue.fileList = &fileList;
+	queue.nextFile = 1;
 
-	headerList->InsertElementAtIndex(index, info);
+#ifdef J_MAKEMAKE_THREADS
 
-	// extract dependencies only from non-system header files
+	const JSize threadCount =
+		JMin(maxThreadCount, fileList.GetElementCount()) - 1;
 
-	if (fileName.BeginsWith(kSysIncludeDir))
+	ACE_thread_t* threadList = NULL;
+	JSize startCount         = 0;
+	if (threadCount > 0)
 		{
-		return info;
+		threadList = new ACE_thread_t [ threadCount ];
+		assert( threadList != NULL );
+
+		while (startCount < threadCount &&
+			   ACE_Thread::spawn(ScanQueue::Main, &queue, THR_NEW_LWP | THR_JOINABLE,
+								 threadList + startCount) == 0)
+			{
+			startCount++;
+			}
 		}
 
-	// find the files that fileName depends on and add them to depList
+	ScanNextFiles(&queue);
 
-	ifstream input(fileName);
-	JString headerName;
-	while (GetNextIncludedFile(fileName, input, pathList1, pathList2, assumeAutoGen, &headerName))
+	for (JIndex i=0; i<startCount; i++)
 		{
-		JBoolean isDuplicate;
-		const JIndex i = (info.depList)->GetInsertionSortIndex(&headerName, &isDuplicate);
-		if (!isDuplicate)
+		ACE_thread_t departed;
+		ACE_THR_FUNC_RETURN status;
+		ACE_Thread::join(threadList[i], &departed, &status);
+		}
+
+	delete [] threadList;
+
+#else
+
+	ScanNextFiles(&queue);
+
+#endif
+}
+
+/******************************************************************************
+ ScanNextFiles
+
+	Scans files until there are none left in the queue.
+
+ ******************************************************************************/
+
+#ifdef J_MAKEMAKE_THREADS
+
+ACE_THR_FUNC_RETURN
+ScanQueue::Main
+	(
+	void* data
+	)
+{
+	ScanNextFiles(static_cast<ScanQueue*>(data));
+	return 0;
+}
+
+#endif
+
+void
+ScanNextFiles
+	(
+	ScanQueue* queue
+	)
+{
+	const JSize count = (queue->fileList)->GetElementCount();
+	while (1)
+		{
+		JIndex i;
+		{
+#ifdef J_MAKEMAKE_THREADS
+		ACE_Guard<ACE_Thread_Mutex> guard(queue->lock);
+#endif
+		i = queue->nextFile++;
+		}
+
+		if (i > count)
 			{
-			(info.depList)->InsertAtIndex(i, headerName);
+			break;
 			}
+
+		ScanFile((queue->fileList)->NthElement(i));
+		}
+}
+
+/******************************************************************************
+ ScanFile
+
+	Parses the file, unless the cached includeText is still valid.  If
+	the file cannot be read, it is treated as empty and is not cached.
+
+	This is called from several threads at once, so it must not modify
+	anything except dep.
+
+ ******************************************************************************/
+
+void
+ScanFile
+	(
+	FileDep* dep
+	)
+{
+	ACE_stat info;
+	const JBoolean exists =
+		JI2B( ACE_OS::stat(dep->fileName, &info) == 0 && S_ISREG(info.st_mode) );
+
+	if (exists && dep->cached && dep->modTime == info.st_mtime &&
+		dep->fileSize == (JSize) info.st_size)
+		{
+		dep->valid = kJTrue;
+		return;
+		}
+
+	(dep->includeText).Clear();
+	dep->includeCount = 0;
+	if (!exists)
+		{
+		return;
 		}
 
-	return info;
+	ifstream input(dep->fileName);
+	if (input.fail())
+		{
+		return;
+		}
+
+	JString text;
+	JReadFile(input, &text);
+	input.close();
+
+	dep->modTime      = info.st_mtime;
+	dep->fileSize     = info.st_size;
+	dep->includeCount = ParseIncludes(text, &(dep->includeText));
+	dep->valid        = kJTrue;
+	dep->parsed       = kJTrue;
 }
 
 /******************************************************************************
- GetNextIncludedFile
+ ParseIncludes
 
-	Get the next #include from the given input stream.
-	Returns kJFalse if there are no more.
+	Extracts the #include's from the given text and returns the number
+	that were found.  Each one is stored as a line containing the opening
+	delimiter followed by the name.
 
  ******************************************************************************/
 
 static const JCharacter* kIncludeMarker = "include";
 const JSize kIncludeMarkerLength        = strlen(kIncludeMarker);
 
-JBoolean
-GetNextIncludedFile
+inline JBoolean
+IsWhitespace
 	(
-	const JCharacter*			inputFileName,
-	istream&					input,
-	const JPtrArray<JString>&	pathList1,
-	const JPtrArray<JString>&	pathList2,
-	const JBoolean				assumeAutoGen,
-	JString*					fileName
+	const JCharacter c
 	)
 {
-	while (!input.eof() && !input.fail())
+	return JI2B( isspace((unsigned char) c) );
+}
+
+JSize
+ParseIncludes
+	(
+	const JString&	text,
+	JString*		includeText
+	)
+{
+	includeText->Clear();
+
+	JSize count = 0;
+
+	const JCharacter* s   = text.GetCString();
+	const JCharacter* end = s + text.GetLength();
+	while (s < end)
 		{
-		input >> ws;
-		if (input.peek() != '#')
+		while (s < end && IsWhitespace(*s))
 			{
-			JIgnoreLine(input);
+			s++;
 			}
-		else
+
+		if (s < end && *s == '#')
 			{
-			input.ignore();
-			input >> ws;
-			JString line = JReadLine(input);
-			if (line.BeginsWith(kIncludeMarker))
+			s++;
+			while (s < end && IsWhitespace(*s))
+				{
+				s++;
+				}
+
+			const JCharacter* lineEnd =
+				static_cast<const JCharacter*>(memchr(s, '\n', end - s));
+			if (lineEnd == NULL)
 				{
-				line.RemoveSubstring(1, kIncludeMarkerLength);
-				line.TrimWhitespace();
+				lineEnd = end;
+				}
 
-				JCharacter c = line.GetFirstCharacter();
-				if (c == '"' || c == '<')
+			if (lineEnd - s > (long) kIncludeMarkerLength &&
+				strncmp(s, kIncludeMarker, kIncludeMarkerLength) == 0)
+				{
+				const JCharacter* name = s + kIncludeMarkerLength;
+				while (name < lineEnd && IsWhitespace(*name))
 					{
-					if (c == '<')
-						{
-						c = '>';
-						}
+					name++;
+					}
 
-					const JSize length = line.GetLength();
-					JIndex i = 2;
-					while (i <= length && line.GetCharacter(i) != c)
+				if (name < lineEnd && (*name == '"' || *name == '<'))
+					{
+					const JCharacter c = (*name == '<' ? '>' : '"');
+
+					const JCharacter* nameEnd = name+1;
+					while (nameEnd < lineEnd && *nameEnd != c)
 						{
-						i++;
+						nameEnd++;
 						}
 
-					if (i <= length)
+					if (nameEnd < lineEnd &&
+						memchr(name, '\0', nameEnd - name) == NULL)
 						{
-						const JString name = line.GetSubstring(2, i-1);
-						if (name.BeginsWith("ace/") ||
-							name.EndsWith("StdInc.h"))
-							{
-							// skip
-							}
-						else if ((c == '"' && FindFile(name, pathList1, fileName)) ||
-								 FindFile(name, pathList2, fileName))
-							{
-							return kJTrue;
-							}
-						else if (c == '"' && assumeAutoGen)	// assume in same dir as including file
-							{
-							JString p, n;
-							if (!JSplitPathAndName(inputFileName, &p, &n))
-								{
-								p = "./";
-								}
-							*fileName = JCombinePathAndName(p, name);
-							return kJTrue;
-							}
+						includeText->Append(name, nameEnd - name);
+						includeText->AppendCharacter('\n');
+						count++;
 						}
 					}
 				}
+
+			s = lineEnd;
 			}
+
+		const JCharacter* lineEnd =
+			static_cast<const JCharacter*>(memchr(s, '\n', end - s));
+		s = (lineEnd == NULL ? end : lineEnd + 1);
 		}
 
-	fileName->Clear();
-	return kJFalse;
+	return count;
+}
+
+/******************************************************************************
+ ReadDependCache
+
+	Loads the #include's that were found during the previous run.  If the
+	cache is damaged, everything after the damage is ignored.
+
+ ******************************************************************************/
+
+void
+ReadDependCache
+	(
+	const JCharacter*		fileName,
+	JStringPtrMap<FileDep>*	fileMap
+	)
+{
+	ifstream input(fileName);
+	if (JReadLine(input) != kDependCacheVersion)
+		{
+		return;
+		}
+
+	JString name, line;
+	while (1)
+		{
+		name = JReadLine(input);
+
+		long modTime;
+		JSize fileSize, includeCount;
+		input >> modTime >> fileSize >> includeCount;
+		JIgnoreLine(input);
+		if (input.eof() || input.fail())
+			{
+			break;
+			}
+
+		FileDep* dep = new FileDep(name);
+		assert( dep != NULL );
+
+		dep->modTime      = modTime;
+		dep->fileSize     = fileSize;
+		dep->includeCount = includeCount;
+
+		JBoolean ok = kJTrue;
+		for (JIndex i=1; i<=includeCount; i++)
+			{
+			line = JReadLine(input);
+			if (input.eof() || input.fail() ||
+				(!line.BeginsWith("\"") && !line.BeginsWith("<")))
+				{
+				ok = kJFalse;
+				break;
+				}
+			(dep->includeText).Append(line);
+			(dep->includeText).AppendCharacter('\n');
+			}
+
+		if (!ok)
+			{
+			delete dep;
+			break;
+			}
+
+		dep->cached = kJTrue;
+		fileMap->SetElement(name, dep, JPtrArrayT::kDelete);
+		}
+}
+
+/******************************************************************************
+ WriteDependCache
+
+	Saves the #include's found in every file that was scanned during this
+	run.  Files that were not reached are dropped.
+
+ ******************************************************************************/
+
+void
+WriteDependCache
+	(
+	const JCharacter*			fileName,
+	const JPtrArray<FileDep>&	fileList
+	)
+{
+	ofstream output(fileName);
+	output << kDependCacheVersion << '\n';
+
+	const JSize count = fileList.GetElementCount();
+	for (JIndex i=1; i<=count; i++)
+		{
+		const FileDep* dep = fileList.NthElement(i);
+		if (dep->valid)
+			{
+			(dep->fileName).Print(output);
+			output << '\n';
+			output << (long) dep->modTime << ' ' << dep->fileSize;
+			output << ' ' << dep->includeCount << '\n';
+			(dep->includeText).Print(output);
+			}
+		}
 }
 
 /******************************************************************************
@@ -2000,37 +2523,29 @@ TruncateMakefile
 }
 
 /******************************************************************************
- CompareHeaderFiles
+ CompareFileDeps
 
 	UNIX file names are case sensitive.
 
  ******************************************************************************/
 
 JOrderedSetT::CompareResult
-CompareHeaderFiles
+CompareFileDeps
 	(
-	const HeaderDep& h1,
-	const HeaderDep& h2
+	FileDep* const & f1,
+	FileDep* const & f2
 	)
 {
-	const int r = JStringCompare(*(h1.fileName), *(h2.fileName), kJTrue);
-
-	if (r > 0)
-		{
-		return JOrderedSetT::kFirstGreaterSecond;
-		}
-	else if (r < 0)
-		{
-		return JOrderedSetT::kFirstLessSecond;
-		}
-	else
-		{
-		return JOrderedSetT::kFirstEqualSecond;
-		}
+	return JCompareStringsCaseSensitive(&(f1->fileName), &(f2->fileName));
 }
 
-#define JTemplateType HeaderDep
-#include <JArray.tmpls>
+#define JTemplateType FileDep
+#include <JPtrArray.tmpls>
+#include <JStringPtrMap.tmpls>
+#undef JTemplateType
+
+#define JTemplateType JStrValue<FileDep*>
+#include <JHashTable.tmpls>
 #undef JTemplateType
 
 #define JTemplateType JBoolean